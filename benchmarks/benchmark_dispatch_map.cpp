@@ -4,6 +4,7 @@
 //
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <iostream>
 #include <random>
@@ -11,102 +12,52 @@
 
 #include <benchmark/benchmark.h>
 
-#include <dispatcher.hpp>
-
+#include <dynd/arithmetic.hpp>
 #include <dynd/dispatcher.hpp>
 #include <dynd/type.hpp>
-#include <dynd/type_registry.hpp>
 
 using namespace std;
 using namespace dynd;
 
-template <size_t N>
-class DispatchFixture : public ::benchmark::Fixture {
-public:
-  vector<type_id_t[N]> ids;
+namespace {
 
-  void SetUp(const benchmark::State &state) {
-    ids.resize(state.range_x());
+const ndt::type &random_numeric_type(default_random_engine &generator) {
+  static const ndt::type tps[] = {ndt::make_type<int8_t>(),  ndt::make_type<int16_t>(),  ndt::make_type<int32_t>(),
+                                  ndt::make_type<int64_t>(), ndt::make_type<uint8_t>(),  ndt::make_type<uint16_t>(),
+                                  ndt::make_type<uint32_t>(), ndt::make_type<uint64_t>(), ndt::make_type<float>(),
+                                  ndt::make_type<double>()};
+  uniform_int_distribution<size_t> d(0, sizeof(tps) / sizeof(tps[0]) - 1);
 
-    default_random_engine generator;
-    uniform_int_distribution<underlying_type_t<type_id_t>> d(bool_id, callable_id);
+  return tps[d(generator)];
+}
 
-    for (auto &id : ids) {
-      for (size_t i = 0; i < N; ++i) {
-        id[i] = static_cast<type_id_t>(d(generator));
-      }
-    }
-  }
-};
+} // unnamed namespace
 
-template <>
-class DispatchFixture<1> : public ::benchmark::Fixture {
+template <size_t N>
+class DispatchFixture : public ::benchmark::Fixture {
 public:
-  vector<pair<type_id_t, type_id_t>> pairs;
+  vector<array<ndt::type, N>> args;
 
   void SetUp(const benchmark::State &state) {
-    pairs.resize(state.range_x());
+    args.resize(state.range_x());
 
     default_random_engine generator;
-    uniform_int_distribution<underlying_type_t<type_id_t>> d(bool_id, callable_id);
-
-    for (auto &pair : pairs) {
-      pair.first = static_cast<type_id_t>(d(generator));
-      pair.second = static_cast<type_id_t>(d(generator));
+    for (auto &arg : args) {
+      for (size_t i = 0; i < N; ++i) {
+        arg[i] = random_numeric_type(generator);
+      }
     }
   }
 };
 
-typedef DispatchFixture<1> X;
-
-/*
-BENCHMARK_DEFINE_F(X, BM_IsBaseIDOf)(benchmark::State &state)
-{
-  while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-      benchmark::DoNotOptimize(is_base_id_of(pair.first, pair.second));
-    }
-  }
-  state.SetItemsProcessed(10 * state.iterations() * state.range_x());
-}
-
-BENCHMARK_REGISTER_F(X, BM_IsBaseIDOf)->Arg(100)->Arg(1000)->Arg(10000);
-*/
-
 typedef DispatchFixture<1> UnaryDispatchFixture;
 typedef DispatchFixture<2> BinaryDispatchFixture;
 
-/*
-BENCHMARK_DEFINE_F(BinaryDispatchFixture, BM_Supercedes)(benchmark::State &state)
-{
-  while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(supercedes(pair.first, pair.second));
-    }
-  }
-  state.SetItemsProcessed(state.iterations() * state.range_x());
-}
-*/
-
-// BENCHMARK_REGISTER_F(BinaryDispatchFixture, BM_Supercedes)->Arg(10)->Arg(100)->Arg(1000);
-
 BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_UnaryDispatch)(benchmark::State &state) {
-  dispatcher<1, int> dispatcher{{{any_kind_id}, 0}, {{scalar_kind_id}, 1}, {{bool_id}, 2},    {{int8_id}, 3},
-                                {{int16_id}, 4},    {{int32_id}, 5},       {{int64_id}, 6},   {{int128_id}, 7},
-                                {{uint8_id}, 8},    {{uint16_id}, 9},      {{uint32_id}, 10}, {{uint64_id}, 11},
-                                {{uint128_id}, 12}, {{float32_id}, 13},    {{float64_id}, 14}};
+  nd::base_callable *f = nd::minus.get();
   while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(dispatcher(pair.first));
+    for (const auto &arg : args) {
+      benchmark::DoNotOptimize(&f->specialize(ndt::type(), 1, arg.data()));
     }
   }
   state.SetItemsProcessed(state.iterations() * state.range_x());
@@ -114,29 +65,27 @@ BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_UnaryDispatch)(benchmark::State &sta
 
 BENCHMARK_REGISTER_F(UnaryDispatchFixture, BM_UnaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
 
-/*
-static void BM_VirtualDispatch(benchmark::State &state)
-{
+// Binary arithmetic has an overload for every pair of numeric types
+BENCHMARK_DEFINE_F(BinaryDispatchFixture, BM_BinaryDispatch)(benchmark::State &state) {
+  nd::base_callable *f = nd::add.get();
   while (state.KeepRunning()) {
-    benchmark::DoNotOptimize((*item)());
+    for (const auto &arg : args) {
+      benchmark::DoNotOptimize(&f->specialize(ndt::type(), 2, arg.data()));
+    }
   }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
 }
 
-BENCHMARK(BM_VirtualDispatch);
-*/
+BENCHMARK_REGISTER_F(BinaryDispatchFixture, BM_BinaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
 
-BENCHMARK_DEFINE_F(UnaryDispatchFixture, BM_BinaryDispatch)(benchmark::State &state) {
-  dispatcher<2, int> dispatcher{{{any_kind_id, int64_id}, 0},
-                                {{scalar_kind_id, int64_id}, 1},
-                                {{int32_id, int64_id}, 2},
-                                {{float32_id, int64_id}, 3},
-                                {{any_kind_id, any_kind_id}, 4}};
+BENCHMARK_DEFINE_F(BinaryDispatchFixture, BM_BinaryDispatchThreaded)(benchmark::State &state) {
+  nd::base_callable *f = nd::add.get();
   while (state.KeepRunning()) {
-    for (const auto &pair : pairs) {
-      benchmark::DoNotOptimize(dispatcher(pair.first, pair.second));
+    for (const auto &arg : args) {
+      benchmark::DoNotOptimize(&f->specialize(ndt::type(), 2, arg.data()));
     }
   }
   state.SetItemsProcessed(state.iterations() * state.range_x());
 }
 
-BENCHMARK_REGISTER_F(UnaryDispatchFixture, BM_BinaryDispatch)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(BinaryDispatchFixture, BM_BinaryDispatchThreaded)->Arg(1000)->Threads(2)->Threads(8);
@@ -0,0 +1,62 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+// Measures the time a program linked against libdynd spends starting up,
+// including the static initialization of the global callables, and the cost
+// of the first call to a multidispatch callable, which builds its dispatch
+// table on demand.
+//
+// Usage: benchmark_startup [repetitions]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <dynd/arithmetic.hpp>
+
+using namespace std;
+using namespace dynd;
+
+typedef chrono::steady_clock clock_type;
+
+static double elapsed_ms(clock_type::time_point begin) {
+  return chrono::duration<double, milli>(clock_type::now() - begin).count();
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "--child") == 0) {
+    // Keeps the library linked without doing any work after startup
+    return nd::add.is_null() ? 1 : 0;
+  }
+
+  int repetitions = argc > 1 ? atoi(argv[1]) : 20;
+  std::string child = std::string("\"") + argv[0] + "\" --child";
+
+  clock_type::time_point begin = clock_type::now();
+  for (int i = 0; i < repetitions; ++i) {
+    if (system(child.c_str()) != 0) {
+      cerr << "child process failed" << endl;
+      return 1;
+    }
+  }
+  cout << "process startup: " << elapsed_ms(begin) / repetitions << " ms" << endl;
+
+  nd::array a{1, 2, 3};
+  nd::array b{1.5, 2.5, 3.5};
+
+  begin = clock_type::now();
+  nd::array c = a + b;
+  cout << "first add: " << elapsed_ms(begin) << " ms" << endl;
+
+  begin = clock_type::now();
+  for (int i = 0; i < repetitions; ++i) {
+    c = a + b;
+  }
+  cout << "later add: " << elapsed_ms(begin) / repetitions << " ms" << endl;
+
+  return 0;
+}
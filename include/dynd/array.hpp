@@ -761,6 +761,34 @@ namespace nd {
    */
   DYND_API array combine_into_tuple(size_t field_count, const array *field_values);
 
+  /**
+   * Creates an uninitialized array of the fields of ``dim_size * struct_tp``
+   * stored in columns, a struct of ``dim_size * T`` for each field ``T``,
+   * such as ``{id: 4 * int64, name: 4 * string}``. Each column is contiguous
+   * at the size of its field, one after the other in a single allocation, so
+   * a field, as from nd::array::p, is scanned without reading the others.
+   */
+  DYND_API array empty_columnar(intptr_t dim_size, const ndt::type &struct_tp);
+
+  /**
+   * Whether ``a`` is a struct of one-dimensional columns of the same size,
+   * as created by nd::empty_columnar. Its rows are sliced in every column at
+   * once, as in ``a(irange(), irange(2, 5))``, which is columnar too.
+   */
+  DYND_API bool is_columnar(const array &a);
+
+  /**
+   * Copies a ``N * struct`` array into columns, as created by
+   * nd::empty_columnar, one field at a time.
+   */
+  DYND_API array to_columnar(const array &a);
+
+  /**
+   * Copies a columnar array back into a ``N * struct`` array in rows, one
+   * field at a time.
+   */
+  DYND_API array to_rowwise(const array &a);
+
   /**
    * Creates a memory block for holding an nd::array (i.e. a container for nd::array arrmeta)
    *
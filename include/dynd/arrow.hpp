@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include <dynd/array.hpp>
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+// The structures of the Apache Arrow C data interface, as specified by Arrow
+extern "C" {
+
+struct ArrowSchema {
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Imports an array from the Arrow C data interface. Its buffers are used
+   * in place wherever dynd has the same layout:
+   *
+   *   - a primitive array of length N is a ``N * T`` view of its values,
+   *   - a fixed-size list is a ``N * M * T`` view of its child,
+   *   - a list is ``N * var * T``, whose elements are in its child,
+   *   - a struct is a struct of its children as columns, ``{name: N * T, ...}``.
+   *
+   * Primitive and boolean values with nulls become option types, and nulls
+   * elsewhere are not supported. A valid value that is the missing value
+   * of its option type, such as a uint8 255 or a NaN, cannot be imported
+   * with nulls. Booleans, strings, binary values and
+   * structs nested in lists are copied into the dynd layout.
+   *
+   * The result takes ownership of ``array``, which it releases when it is
+   * destroyed, and leaves it marked as released. The caller keeps ownership
+   * of ``schema``.
+   */
+  DYND_API array from_arrow(const ArrowSchema *schema, ArrowArray *array);
+
+  /**
+   * Exports an array with the Arrow C data interface, with the mapping of
+   * nd::from_arrow. The array is either a column ``N * T`` or a struct of
+   * columns of the same length. Contiguous values are exported in place,
+   * kept alive until the consumer releases ``out_array``, and the rest is
+   * copied into the Arrow layout.
+   */
+  DYND_API void to_arrow(const array &a, ArrowSchema *out_schema, ArrowArray *out_array);
+
+} // namespace dynd::nd
+} // namespace dynd
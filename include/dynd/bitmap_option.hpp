@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Packs a ``N * ?T`` or ``N * T`` array into a bitmap option,
+   * ``{values: N * T, valid: M * uint64}``, which stores its values without
+   * sentinels and their validity as bits, 64 to a word. A missing value is
+   * stored as 0, and the bits after the last value are clear. Unlike an
+   * option, a bitmap option can hold every value of ``T``.
+   */
+  DYND_API array to_bitmap_option(const array &a);
+
+  /**
+   * Unpacks a bitmap option into a ``N * ?T`` array.
+   */
+  DYND_API array from_bitmap_option(const array &a);
+
+  namespace bitmap_option {
+
+    /**
+     * Element-wise arithmetic on two bitmap options of the same size and
+     * value type, int32, int64, uint32, uint64, float32 or float64. A value
+     * is valid when both of its arguments are, and also, for the integer
+     * division, when its divisor is not zero.
+     */
+    extern DYND_API callable add;
+    extern DYND_API callable subtract;
+    extern DYND_API callable multiply;
+    extern DYND_API callable divide;
+
+    /**
+     * Reductions over the valid values of a bitmap option, which return a
+     * bitmap option of one value, ``{values: 1 * T, valid: 1 * uint64}``,
+     * rather than a ``?T``, whose sentinel is also a valid result. The
+     * result is missing if no value is valid.
+     */
+    extern DYND_API callable sum;
+    extern DYND_API callable min;
+    extern DYND_API callable max;
+
+    /** The number of valid values of a bitmap option, as int64. */
+    extern DYND_API callable count;
+
+  } // namespace dynd::nd::bitmap_option
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Packs a ``N * bool`` array into a bitmask, ``{size: int64, bits: M * uint64}``,
+   * which holds N booleans as bits, 64 to a word, in an eighth of the
+   * memory of bool. The bits after the last one are clear.
+   */
+  DYND_API array to_bitmask(const array &a);
+
+  /**
+   * Unpacks a bitmask into a ``N * bool`` array.
+   */
+  DYND_API array from_bitmask(const array &mask);
+
+  /**
+   * The number of true values of a bitmask, counted a word at a time, or of
+   * a ``N * bool`` array, as int64.
+   */
+  extern DYND_API callable count_nonzero;
+
+  namespace bitmask {
+
+    /**
+     * Element-wise comparisons of two ``N * T`` arrays of the same size and
+     * type, int32, int64, uint32, uint64, float32 or float64, whose results
+     * are written into a bitmask as bits.
+     */
+    extern DYND_API callable less;
+    extern DYND_API callable less_equal;
+    extern DYND_API callable equal;
+    extern DYND_API callable not_equal;
+    extern DYND_API callable greater_equal;
+    extern DYND_API callable greater;
+
+    /**
+     * Logical operations on bitmasks of the same size, on whole words.
+     */
+    extern DYND_API callable logical_and;
+    extern DYND_API callable logical_or;
+    extern DYND_API callable logical_xor;
+    extern DYND_API callable logical_not;
+
+    /**
+     * Takes the elements of a ``N * T`` array whose bits are set in a
+     * bitmask into a ``var * T``, as nd::take does with a ``N * bool``.
+     */
+    extern DYND_API callable take;
+
+  } // namespace dynd::nd::bitmask
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/sort_callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Returns the permutation that stably sorts a one-dimensional array, or
+   * each row of a two-dimensional one.
+   */
+  class argsort_callable : public base_callable {
+  public:
+    argsort_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(ndt::type("Dims... * Fixed * int64"),
+                                                           {ndt::type("Dims... * Fixed * Scalar")})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      intptr_t ndim = detail::check_sort_type("argsort", src_tp[0]);
+      const ndt::type &src0_element_tp = src_tp[0].get_dtype();
+      ndt::type res_tp = src_tp[0].with_replaced_dtype(ndt::make_type<int64_t>());
+
+      if (detail::with_sort_type<builtin_sort_types>::apply(src0_element_tp.get_id(), [&cg, ndim](auto value) {
+            typedef decltype(value) src0_element_type;
+            cg.emplace_back([ndim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                   const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+              detail::sort_shape dst_shape(ndim, dst_arrmeta);
+              detail::sort_shape src0_shape(ndim, src_arrmeta[0]);
+              kb.emplace_back<builtin_argsort_kernel<src0_element_type>>(
+                  kernreq, dst_shape.row_stride, dst_shape.stride, src0_shape.nrow, src0_shape.row_stride,
+                  src0_shape.size, src0_shape.stride);
+            });
+          })) {
+        return res_tp;
+      }
+
+      cg.emplace_back([ndim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                             const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        detail::sort_shape dst_shape(ndim, dst_arrmeta);
+        detail::sort_shape src0_shape(ndim, src_arrmeta[0]);
+        kb.emplace_back<argsort_kernel>(kernreq, dst_shape.row_stride, dst_shape.stride, src0_shape.nrow,
+                                        src0_shape.row_stride, src0_shape.size, src0_shape.stride);
+
+        kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
+      });
+
+      const ndt::type child_src_tp[2] = {src0_element_tp, src0_element_tp};
+      less->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 2, child_src_tp, 0, nullptr, tp_vars);
+
+      return res_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
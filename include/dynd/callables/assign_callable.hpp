@@ -8,6 +8,7 @@
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/kernels/assignment_kernels.hpp>
+#include <dynd/types/categorical_kind_type.hpp>
 #include <dynd/types/fixed_bytes_kind_type.hpp>
 #include <dynd/types/fixed_string_kind_type.hpp>
 #include <dynd/types/float_kind_type.hpp>
@@ -517,13 +518,20 @@ namespace nd {
     ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
                       const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp, size_t nkwd,
                       const array *kwds, const std::map<std::string, ndt::type> &tp_vars) {
-      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
-                         size_t nsrc, const char *const *src_arrmeta) {
+      // The NA of a builtin type is the same bits in the src and the dst, so copying the bytes copies it too
+      const ndt::type &src_val_tp = src_tp[0].extended<ndt::option_type>()->get_value_type();
+      size_t value_copy_size = 0;
+      if (src_val_tp.is_builtin() && src_val_tp == dst_tp.extended<ndt::option_type>()->get_value_type()) {
+        value_copy_size = src_val_tp.get_data_size();
+      }
+
+      cg.emplace_back([value_copy_size](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                        const char *dst_arrmeta, size_t nsrc, const char *const *src_arrmeta) {
         intptr_t ckb_offset = kb.size();
         intptr_t root_ckb_offset = ckb_offset;
         typedef detail::assignment_kernel<ndt::option_type, ndt::option_type, assign_error_nocheck> self_type;
 
-        kb.emplace_back<self_type>(kernreq);
+        kb.emplace_back<self_type>(kernreq, value_copy_size);
         ckb_offset = kb.size();
         // instantiate src_is_avail
         kb(kernreq | kernel_request_data_only, nullptr, nullptr, nsrc, src_arrmeta);
@@ -546,7 +554,6 @@ namespace nd {
       is_na->resolve(this, nullptr, cg, ndt::make_type<bool1>(), 1, src_tp, nkwd, kwds, tp_vars);
       assign_na->resolve(this, nullptr, cg, dst_tp, 1, nullptr, nkwd, kwds, tp_vars);
 
-      const ndt::type &src_val_tp = src_tp[0].extended<ndt::option_type>()->get_value_type();
       assign->resolve(this, nullptr, cg, dst_tp.extended<ndt::option_type>()->get_value_type(), 1, &src_val_tp, nkwd,
                       kwds, tp_vars);
 
@@ -685,14 +692,16 @@ namespace nd {
         throw type_error(ss.str());
       }
 
-      std::array<uintptr_t, 8> dst_arrmeta_offsets;
-      std::array<uintptr_t, 8> src_arrmeta_offsets;
-      for (int i = 0; i < field_count; ++i) {
-        src_arrmeta_offsets[i] = src_sd->get_arrmeta_offsets()[i];
-        dst_arrmeta_offsets[i] = dst_sd->get_arrmeta_offsets()[i];
+      const std::vector<uintptr_t> &dst_arrmeta_offsets = dst_sd->get_arrmeta_offsets();
+      const std::vector<uintptr_t> &src_arrmeta_offsets = src_sd->get_arrmeta_offsets();
+      const std::vector<ndt::type> &dst_field_tp = dst_sd->get_field_types();
+      const std::vector<ndt::type> &src_field_tp = src_sd->get_field_types();
+      std::vector<ndt::type> copy_tps(field_count);
+      for (intptr_t i = 0; i < field_count; ++i) {
+        copy_tps[i] = nd::get_copy_type(dst_field_tp[i], src_field_tp[i]);
       }
 
-      cg.emplace_back([field_count, dst_arrmeta_offsets, src_arrmeta_offsets](
+      cg.emplace_back([field_count, dst_arrmeta_offsets, src_arrmeta_offsets, copy_tps](
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
           size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
         shortvector<const char *> src_fields_arrmeta(field_count);
@@ -707,25 +716,14 @@ namespace nd {
 
         const uintptr_t *dst_data_offsets = reinterpret_cast<const uintptr_t *>(dst_arrmeta);
         const uintptr_t *src_data_offsets = reinterpret_cast<const uintptr_t *>(src_arrmeta[0]);
-
-        intptr_t self_offset = kb.size();
-        kb.emplace_back<nd::tuple_unary_op_ck>(kernreq);
-        nd::tuple_unary_op_ck *self = kb.get_at<nd::tuple_unary_op_ck>(self_offset);
-        self->m_fields.resize(field_count);
-        for (intptr_t i = 0; i < field_count; ++i) {
-          self = kb.get_at<nd::tuple_unary_op_ck>(self_offset);
-          nd::tuple_unary_op_item &field = self->m_fields[i];
-          field.child_kernel_offset = kb.size() - self_offset;
-          field.dst_data_offset = dst_data_offsets[i];
-          field.src_data_offset = src_data_offsets[i];
-          kb(kernel_request_single, nullptr, dst_fields_arrmeta[i], 1, &src_fields_arrmeta[i]);
-        }
+        nd::emplace_tuple_unary_op(kb, kernreq, field_count, dst_data_offsets, dst_fields_arrmeta.get(),
+                                   src_data_offsets, src_fields_arrmeta.get(), copy_tps.data());
       });
 
-      const std::vector<ndt::type> &dst_field_tp = dst_sd->get_field_types();
-      const std::vector<ndt::type> &src_field_tp = src_sd->get_field_types();
       for (intptr_t i = 0; i < field_count; ++i) {
-        assign->resolve(this, nullptr, cg, dst_field_tp[i], 1, &src_field_tp[i], nkwd, kwds, tp_vars);
+        if (copy_tps[i].is_null()) {
+          assign->resolve(this, nullptr, cg, dst_field_tp[i], 1, &src_field_tp[i], nkwd, kwds, tp_vars);
+        }
       }
 
       return dst_tp;
@@ -746,9 +744,8 @@ namespace nd {
       const ndt::struct_type *dst_sd = dst_tp.extended<ndt::struct_type>();
       const ndt::struct_type *src_sd = src_tp[0].extended<ndt::struct_type>();
       intptr_t field_count = dst_sd->get_field_count();
-      std::array<intptr_t, 8> src_permutation;
-      std::array<uintptr_t, 8> src_fields_arrmeta_offsets;
-      std::array<uintptr_t, 8> dst_arrmeta_offsets;
+      std::vector<intptr_t> src_permutation(field_count);
+      std::vector<uintptr_t> src_fields_arrmeta_offsets(field_count);
 
       if (field_count != src_sd->get_field_count()) {
         std::stringstream ss;
@@ -778,12 +775,13 @@ namespace nd {
       }
 
       const std::vector<ndt::type> &dst_fields_tp = dst_sd->get_field_types();
-      const std::vector<uintptr_t> &dst_arrmeta_offsets_vec = dst_sd->get_arrmeta_offsets();
+      const std::vector<uintptr_t> &dst_arrmeta_offsets = dst_sd->get_arrmeta_offsets();
+      std::vector<ndt::type> copy_tps(field_count);
       for (intptr_t i = 0; i < field_count; ++i) {
-        dst_arrmeta_offsets[i] = dst_arrmeta_offsets_vec[i];
+        copy_tps[i] = nd::get_copy_type(dst_fields_tp[i], src_fields_tp[i]);
       }
 
-      cg.emplace_back([field_count, src_permutation, src_fields_arrmeta_offsets, dst_arrmeta_offsets](
+      cg.emplace_back([field_count, src_permutation, src_fields_arrmeta_offsets, dst_arrmeta_offsets, copy_tps](
           kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
           size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
         const uintptr_t *src_data_offsets_orig = reinterpret_cast<const uintptr_t *>(src_arrmeta[0]);
@@ -794,7 +792,7 @@ namespace nd {
         for (intptr_t i = 0; i != field_count; ++i) {
           intptr_t src_i = src_permutation[i];
           src_data_offsets[i] = src_data_offsets_orig[src_i];
-          src_fields_arrmeta[i] = src_arrmeta[0] + src_fields_arrmeta_offsets[src_i];
+          src_fields_arrmeta[i] = src_arrmeta[0] + src_fields_arrmeta_offsets[i];
         }
 
         shortvector<const char *> dst_fields_arrmeta(field_count);
@@ -803,29 +801,61 @@ namespace nd {
         }
 
         const uintptr_t *dst_offsets = reinterpret_cast<const uintptr_t *>(dst_arrmeta);
-
-        intptr_t self_offset = kb.size();
-        kb.emplace_back<nd::tuple_unary_op_ck>(kernreq);
-        nd::tuple_unary_op_ck *self = kb.get_at<nd::tuple_unary_op_ck>(self_offset);
-        self->m_fields.resize(field_count);
-        for (intptr_t i = 0; i < field_count; ++i) {
-          self = kb.get_at<nd::tuple_unary_op_ck>(self_offset);
-          nd::tuple_unary_op_item &field = self->m_fields[i];
-          field.child_kernel_offset = kb.size() - self_offset;
-          field.dst_data_offset = dst_offsets[i];
-          field.src_data_offset = src_data_offsets[i];
-          kb(kernel_request_single, nullptr, dst_fields_arrmeta[i], 1, &src_fields_arrmeta[i]);
-        }
+        nd::emplace_tuple_unary_op(kb, kernreq, field_count, dst_offsets, dst_fields_arrmeta.get(),
+                                   src_data_offsets.get(), src_fields_arrmeta.get(), copy_tps.data());
       });
 
       for (intptr_t i = 0; i < field_count; ++i) {
-        nd::assign->resolve(this, nullptr, cg, dst_fields_tp[i], 1, &src_fields_tp[i], nkwd, kwds, tp_vars);
+        if (copy_tps[i].is_null()) {
+          nd::assign->resolve(this, nullptr, cg, dst_fields_tp[i], 1, &src_fields_tp[i], nkwd, kwds, tp_vars);
+        }
       }
 
       return dst_tp;
     }
   };
 
+  /**
+   * Assigns to a categorical type. Values of the category type are encoded
+   * directly, and values of other types are converted to it first.
+   */
+  template <>
+  class assign_callable<ndt::categorical_type, ndt::scalar_kind_type> : public base_callable {
+  public:
+    assign_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::categorical_kind_type>(), {ndt::make_type<ndt::scalar_kind_type>()},
+              {{ndt::make_type<ndt::option_type>(ndt::make_type<assign_error_mode>()), "error_mode"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp, size_t nkwd, const array *kwds,
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      const ndt::type &category_tp = dst_tp.extended<ndt::categorical_type>()->get_category_type();
+      if (src_tp[0] != category_tp) {
+        callable f = functional::compose(assign, callable(this, true), category_tp);
+        return f->resolve(this, nullptr, cg, dst_tp, nsrc, src_tp, nkwd, kwds, tp_vars);
+      }
+
+      cg.emplace_back([dst_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                               const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                               const char *const *src_arrmeta) {
+        switch (dst_tp.extended<ndt::categorical_type>()->get_storage_type().get_id()) {
+        case uint8_id:
+          kb.emplace_back<detail::categorical_assignment_kernel<uint8_t>>(kernreq, dst_tp, src_arrmeta[0]);
+          break;
+        case uint16_id:
+          kb.emplace_back<detail::categorical_assignment_kernel<uint16_t>>(kernreq, dst_tp, src_arrmeta[0]);
+          break;
+        default:
+          kb.emplace_back<detail::categorical_assignment_kernel<uint32_t>>(kernreq, dst_tp, src_arrmeta[0]);
+          break;
+        }
+      });
+
+      return dst_tp;
+    }
+  };
+
   class option_to_value_callable : public base_callable {
   public:
     option_to_value_callable()
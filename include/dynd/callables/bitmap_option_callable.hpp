@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/bitmap_option_kernels.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    // The pattern of a bitmap option of values of the given type
+    inline ndt::type make_bitmap_option_pattern(const std::string &value_tp) {
+      return ndt::type("{values: Fixed * " + value_tp + ", valid: Fixed * uint64}");
+    }
+
+    // The type of a bitmap option of ``size`` values of the given type
+    inline ndt::type make_bitmap_option_type(intptr_t size, const ndt::type &value_tp) {
+      ndt::type valid_tp = ndt::make_fixed_dim(get_bitmap_word_count(size), ndt::make_type<uint64_t>());
+      return ndt::make_type<ndt::struct_type>({"values", "valid"}, {ndt::make_fixed_dim(size, value_tp), valid_tp});
+    }
+
+    // The number of values of a bitmap option, checking that its bitmap has a bit for each
+    inline intptr_t get_bitmap_option_size(const char *name, const ndt::type &tp) {
+      const ndt::struct_type *sd = tp.extended<ndt::struct_type>();
+      intptr_t size = sd->get_field_type(0).extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+      if (sd->get_field_type(1).extended<ndt::fixed_dim_type>()->get_fixed_dim_size() != get_bitmap_word_count(size)) {
+        std::stringstream ss;
+        ss << "nd::bitmap_option::" << name << ": the bitmap of " << tp << " does not have a bit for each value";
+        throw std::invalid_argument(ss.str());
+      }
+
+      return size;
+    }
+
+  } // namespace dynd::nd::detail
+
+  template <typename T, typename OpType>
+  class bitmap_option_binary_callable : public base_callable {
+    const char *m_name;
+
+  public:
+    bitmap_option_binary_callable(const char *name)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              detail::make_bitmap_option_pattern(ndt::make_type<T>().str()),
+              {detail::make_bitmap_option_pattern(ndt::make_type<T>().str()),
+               detail::make_bitmap_option_pattern(ndt::make_type<T>().str())})),
+          m_name(name) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      intptr_t size = detail::get_bitmap_option_size(m_name, src_tp[0]);
+      if (detail::get_bitmap_option_size(m_name, src_tp[1]) != size) {
+        std::stringstream ss;
+        ss << "nd::bitmap_option::" << m_name << ": the sizes of " << src_tp[0] << " and " << src_tp[1]
+           << " do not match";
+        throw std::invalid_argument(ss.str());
+      }
+
+      ndt::type dst_tp = detail::make_bitmap_option_type(size, ndt::make_type<T>());
+      ndt::type src0_tp = src_tp[0], src1_tp = src_tp[1];
+      cg.emplace_back([dst_tp, src0_tp, src1_tp](kernel_builder &kb, kernel_request_t kernreq,
+                                                 char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                 size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<bitmap_option_binary_kernel<T, OpType>>(kernreq, dst_tp, dst_arrmeta, src0_tp, src_arrmeta[0],
+                                                                src1_tp, src_arrmeta[1]);
+      });
+
+      return dst_tp;
+    }
+  };
+
+  template <typename T, typename OpType>
+  class bitmap_option_reduce_callable : public base_callable {
+    const char *m_name;
+
+  public:
+    bitmap_option_reduce_callable(const char *name)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              detail::make_bitmap_option_type(1, ndt::make_type<T>()),
+              {detail::make_bitmap_option_pattern(ndt::make_type<T>().str())})),
+          m_name(name) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      detail::get_bitmap_option_size(m_name, src_tp[0]);
+
+      ndt::type dst_tp = detail::make_bitmap_option_type(1, ndt::make_type<T>()), src0_tp = src_tp[0];
+      cg.emplace_back([dst_tp, src0_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                        const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                        const char *const *src_arrmeta) {
+        kb.emplace_back<bitmap_option_reduce_kernel<T, OpType>>(kernreq, dst_tp, dst_arrmeta, src0_tp, src_arrmeta[0]);
+      });
+
+      return dst_tp;
+    }
+  };
+
+  class bitmap_option_count_callable : public base_callable {
+  public:
+    bitmap_option_count_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<int64_t>(),
+                                                           {detail::make_bitmap_option_pattern("Scalar")})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      detail::get_bitmap_option_size("count", src_tp[0]);
+
+      ndt::type src0_tp = src_tp[0];
+      cg.emplace_back([src0_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                                const char *const *src_arrmeta) {
+        kb.emplace_back<bitmap_option_count_kernel>(kernreq, src0_tp, src_arrmeta[0]);
+      });
+
+      return dst_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
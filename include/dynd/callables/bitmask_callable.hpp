@@ -0,0 +1,196 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/assignment.hpp>
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/bitmask_kernels.hpp>
+#include <dynd/types/any_kind_type.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    // The pattern of a bitmask of any size
+    inline ndt::type make_bitmask_pattern() { return ndt::type("{size: int64, bits: Fixed * uint64}"); }
+
+    // The type of a bitmask with ``size`` bits
+    inline ndt::type make_bitmask_type(intptr_t size) {
+      return ndt::make_type<ndt::struct_type>(
+          {"size", "bits"},
+          {ndt::make_type<int64_t>(), ndt::make_fixed_dim(get_bitmap_word_count(size), ndt::make_type<uint64_t>())});
+    }
+
+    inline intptr_t get_bitmask_word_count(const ndt::type &tp) {
+      return tp.extended<ndt::struct_type>()->get_field_type(1).extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+    }
+
+  } // namespace dynd::nd::detail
+
+  template <typename T, typename OpType>
+  class bitmask_compare_callable : public base_callable {
+    const char *m_name;
+
+  public:
+    bitmask_compare_callable(const char *name)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              detail::make_bitmask_pattern(), {ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<T>()),
+                                               ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<T>())})),
+          m_name(name) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      intptr_t size = src_tp[0].extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+      if (src_tp[1].extended<ndt::fixed_dim_type>()->get_fixed_dim_size() != size) {
+        std::stringstream ss;
+        ss << "nd::bitmask::" << m_name << ": the sizes of " << src_tp[0] << " and " << src_tp[1] << " do not match";
+        throw std::invalid_argument(ss.str());
+      }
+
+      ndt::type dst_tp = detail::make_bitmask_type(size);
+      cg.emplace_back([dst_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                               const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<bitmask_compare_kernel<T, OpType>>(kernreq, dst_tp, dst_arrmeta, src_arrmeta[0],
+                                                           src_arrmeta[1]);
+      });
+
+      return dst_tp;
+    }
+  };
+
+  template <typename OpType>
+  class bitmask_logical_callable : public base_callable {
+    const char *m_name;
+
+  public:
+    bitmask_logical_callable(const char *name)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              detail::make_bitmask_pattern(), {detail::make_bitmask_pattern(), detail::make_bitmask_pattern()})),
+          m_name(name) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      if (detail::get_bitmask_word_count(src_tp[0]) != detail::get_bitmask_word_count(src_tp[1])) {
+        std::stringstream ss;
+        ss << "nd::bitmask::" << m_name << ": the sizes of " << src_tp[0] << " and " << src_tp[1] << " do not match";
+        throw std::invalid_argument(ss.str());
+      }
+
+      ndt::type dst_tp = src_tp[0], src0_tp = src_tp[0], src1_tp = src_tp[1];
+      cg.emplace_back([dst_tp, src0_tp, src1_tp](kernel_builder &kb, kernel_request_t kernreq,
+                                                 char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                 size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<bitmask_logical_kernel<OpType>>(kernreq, dst_tp, dst_arrmeta, src0_tp, src_arrmeta[0], src1_tp,
+                                                        src_arrmeta[1]);
+      });
+
+      return dst_tp;
+    }
+  };
+
+  class bitmask_logical_not_callable : public base_callable {
+  public:
+    bitmask_logical_not_callable()
+        : base_callable(
+              ndt::make_type<ndt::callable_type>(detail::make_bitmask_pattern(), {detail::make_bitmask_pattern()})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      ndt::type src0_tp = src_tp[0];
+      cg.emplace_back([src0_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<bitmask_logical_not_kernel>(kernreq, src0_tp, dst_arrmeta, src0_tp, src_arrmeta[0]);
+      });
+
+      return src0_tp;
+    }
+  };
+
+  class bitmask_count_nonzero_callable : public base_callable {
+  public:
+    bitmask_count_nonzero_callable()
+        : base_callable(
+              ndt::make_type<ndt::callable_type>(ndt::make_type<int64_t>(), {detail::make_bitmask_pattern()})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      ndt::type src0_tp = src_tp[0];
+      cg.emplace_back([src0_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                                const char *const *src_arrmeta) {
+        kb.emplace_back<bitmask_count_nonzero_kernel>(kernreq, src0_tp, src_arrmeta[0]);
+      });
+
+      return ndt::make_type<int64_t>();
+    }
+  };
+
+  class bool_count_nonzero_callable : public base_callable {
+  public:
+    bool_count_nonzero_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<int64_t>(), {ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<bool1>())})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc),
+                      const ndt::type *DYND_UNUSED(src_tp), size_t DYND_UNUSED(nkwd),
+                      const array *DYND_UNUSED(kwds), const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                         const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                         const char *const *src_arrmeta) {
+        kb.emplace_back<bool_count_nonzero_kernel>(kernreq, src_arrmeta[0]);
+      });
+
+      return ndt::make_type<int64_t>();
+    }
+  };
+
+  class bitmask_take_callable : public base_callable {
+  public:
+    bitmask_take_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::var_dim_type>(ndt::make_type<ndt::any_kind_type>()),
+              {ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<ndt::any_kind_type>()),
+               detail::make_bitmask_pattern()})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      ndt::type mask_tp = src_tp[1];
+      cg.emplace_back([mask_tp](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<bitmask_take_kernel>(kernreq, dst_arrmeta, src_arrmeta[0], mask_tp, src_arrmeta[1]);
+
+        // Create the child element assignment ckernel
+        const char *src0_el_meta = src_arrmeta[0] + sizeof(size_stride_t);
+        kb(kernel_request_strided, nullptr, dst_arrmeta + sizeof(ndt::var_dim_type::metadata_type), 1, &src0_el_meta);
+      });
+
+      ndt::type src0_element_tp = src_tp[0].extended<ndt::base_dim_type>()->get_element_type();
+
+      nd::array error_mode = assign_error_default;
+      assign->resolve(this, nullptr, cg, src0_element_tp, 1, &src0_element_tp, 1, &error_mode, tp_vars);
+
+      return ndt::make_type<ndt::var_dim_type>(src0_element_tp);
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
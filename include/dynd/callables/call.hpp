@@ -44,6 +44,20 @@ namespace nd {
       new (reinterpret_cast<char *>(self) + aligned_size(sizeof(call_node)))
           ClosureType(std::forward<ArgTypes>(args)...);
     }
+
+    /**
+     * Returns the closure stored after this node. The caller must know the
+     * type it was constructed with.
+     */
+    template <typename ClosureType>
+    ClosureType *get_closure() {
+      return reinterpret_cast<ClosureType *>(reinterpret_cast<char *>(this) + aligned_size(sizeof(call_node)));
+    }
+
+    /**
+     * Returns the node immediately following this one in its call graph.
+     */
+    call_node *next() { return reinterpret_cast<call_node *>(reinterpret_cast<char *>(this) + data_size); }
   };
 
 } // namespace dynd::nd
@@ -5,15 +5,13 @@
 
 #pragma once
 
-#include <dynd/callables/apply_function_callable.hpp>
-#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/callables/math_callable.hpp>
 
 namespace dynd {
 namespace nd {
 
   template <typename Arg0Type>
-  using cbrt_callable = functional::apply_function_callable<decltype(&dynd::detail::inline_cbrt<Arg0Type>::f),
-                                                            &dynd::detail::inline_cbrt<Arg0Type>::f>;
+  using cbrt_callable = math_callable<dynd::detail::math_cbrt, Arg0Type>;
 
 } // namespace dynd::nd
 } // namespace dynd
@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/dft_kernel.hpp>
+#include <dynd/types/callable_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    // Returns the type "(Fixed**N * src_tp, ...) -> Fixed**N * dst_tp", with the given keywords
+    inline ndt::type make_dft_type(const ndt::type &dst_tp, const ndt::type &src_tp, const std::string &kwds) {
+      std::stringstream ss;
+      ss << "(Fixed**N * " << src_tp << kwds << ") -> Fixed**N * " << dst_tp;
+      return ndt::type(ss.str());
+    }
+
+    // Returns the shape of the fixed array type ``tp``, which must have at least one dimension
+    inline std::vector<intptr_t> get_dft_shape(const char *name, const ndt::type &tp) {
+      intptr_t ndim = tp.get_ndim();
+      if (ndim == 0) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": expected at least one dimension, not " << tp;
+        throw std::invalid_argument(ss.str());
+      }
+
+      std::vector<intptr_t> shape(ndim);
+      tp.extended()->get_shape(ndim, 0, shape.data(), NULL, NULL);
+      return shape;
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * The complex discrete Fourier transform along the last dimension, in either
+   * direction, batched over the leading dimensions. The result is multiplied
+   * by the optional ``scale``.
+   */
+  template <typename Real>
+  class dft_callable : public base_callable {
+    bool m_inverse;
+
+  public:
+    dft_callable(bool inverse)
+        : base_callable(detail::make_dft_type(ndt::make_type<complex<Real>>(), ndt::make_type<complex<Real>>(),
+                                              ", scale: ?float64")),
+          m_inverse(inverse) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds,
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      std::vector<intptr_t> shape = detail::get_dft_shape(m_inverse ? "ifft" : "fft", src_tp[0]);
+      intptr_t ndim = shape.size();
+
+      detail::complex_fft_row<Real> transform{get_fft_plan<Real>(shape.back(), m_inverse),
+                                              kwds[0].is_na() ? 1 : static_cast<Real>(kwds[0].as<double>())};
+      cg.emplace_back([transform, ndim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                        const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                        const char *const *src_arrmeta) {
+        kb.emplace_back<fft_kernel<detail::complex_fft_row<Real>>>(kernreq, transform, ndim, dst_arrmeta,
+                                                                    src_arrmeta[0]);
+      });
+
+      return ndt::make_type(ndim, shape.data(), ndt::make_type<complex<Real>>());
+    }
+  };
+
+  /**
+   * The transform of reals along the last dimension, which keeps the
+   * ``n / 2 + 1`` values of the spectrum that the rest mirror.
+   */
+  template <typename Real>
+  class real_dft_callable : public base_callable {
+  public:
+    real_dft_callable()
+        : base_callable(
+              detail::make_dft_type(ndt::make_type<complex<Real>>(), ndt::make_type<Real>(), ", scale: ?float64")) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds,
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      std::vector<intptr_t> shape = detail::get_dft_shape("rfft", src_tp[0]);
+      intptr_t ndim = shape.size();
+      if (shape.back() == 0) {
+        throw std::invalid_argument("nd::rfft: cannot transform zero values");
+      }
+
+      detail::real_fft_row<Real> transform{get_real_fft_plan<Real>(shape.back(), false),
+                                           kwds[0].is_na() ? 1 : static_cast<Real>(kwds[0].as<double>())};
+      cg.emplace_back([transform, ndim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                        const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                        const char *const *src_arrmeta) {
+        kb.emplace_back<fft_kernel<detail::real_fft_row<Real>>>(kernreq, transform, ndim, dst_arrmeta,
+                                                                 src_arrmeta[0]);
+      });
+
+      shape.back() = shape.back() / 2 + 1;
+      return ndt::make_type(ndim, shape.data(), ndt::make_type<complex<Real>>());
+    }
+  };
+
+  /**
+   * The inverse of real_dft_callable, which returns ``n`` reals, by default
+   * ``2 (m - 1)`` for ``m`` values of the spectrum.
+   */
+  template <typename Real>
+  class real_idft_callable : public base_callable {
+  public:
+    real_idft_callable()
+        : base_callable(detail::make_dft_type(ndt::make_type<Real>(), ndt::make_type<complex<Real>>(),
+                                              ", n: ?Int, scale: ?float64")) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds,
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      std::vector<intptr_t> shape = detail::get_dft_shape("irfft", src_tp[0]);
+      intptr_t ndim = shape.size();
+      size_t src_size = shape.back();
+      intptr_t size = kwds[0].is_na() ? 2 * (shape.back() - 1) : kwds[0].as<intptr_t>();
+      if (size < 1) {
+        std::stringstream ss;
+        ss << "nd::irfft: cannot transform to " << size << " values";
+        throw std::invalid_argument(ss.str());
+      }
+
+      detail::real_ifft_row<Real> transform{get_real_fft_plan<Real>(size, true),
+                                            kwds[1].is_na() ? 1 : static_cast<Real>(kwds[1].as<double>()), src_size};
+      cg.emplace_back([transform, ndim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                        const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
+                                        const char *const *src_arrmeta) {
+        kb.emplace_back<fft_kernel<detail::real_ifft_row<Real>>>(kernreq, transform, ndim, dst_arrmeta,
+                                                                  src_arrmeta[0]);
+      });
+
+      shape.back() = size;
+      return ndt::make_type(ndim, shape.data(), ndt::make_type<Real>());
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
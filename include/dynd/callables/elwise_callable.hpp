@@ -8,6 +8,7 @@
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/callables/base_elwise_callable.hpp>
 #include <dynd/kernels/elwise_kernel.hpp>
+#include <dynd/shape_tools.hpp>
 
 namespace dynd {
 namespace nd {
@@ -43,50 +44,157 @@ namespace nd {
 
     template <typename TraitsType, size_t N>
     class elwise_callable<fixed_dim_id, fixed_dim_id, TraitsType, N> : public base_elwise_callable<N> {
+      typedef typename base_elwise_callable<N>::codata_type codata_type;
       typedef typename base_elwise_callable<N>::data_type data_type;
 
-    public:
-      void subresolve(call_graph &cg, const char *data) {
-        bool res_broadcast = reinterpret_cast<const data_type *>(data)->res_ignore;
-        const std::array<bool, N> &arg_broadcast = reinterpret_cast<const data_type *>(data)->arg_broadcast;
-
-        cg.emplace_back([res_broadcast, arg_broadcast](kernel_builder &kb, kernel_request_t kernreq, char *data,
-                                                       const char *dst_arrmeta, size_t DYND_UNUSED(nsrc),
-                                                       const char *const *src_arrmeta) {
-          size_t size;
-          if (res_broadcast) {
-            size = reinterpret_cast<const size_stride_t *>(src_arrmeta[0])->dim_size;
-          } else {
-            size = reinterpret_cast<const size_stride_t *>(dst_arrmeta)->dim_size;
+      /**
+       * The call node for one fixed dimension. When the following nodes of the
+       * same lifting are also fixed dimensions, the first node instantiates all of
+       * them together, coalescing dimensions whose strides are compatible and,
+       * when the result is not broadcast, ordering the loops by stride magnitude.
+       */
+      struct node_type {
+        bool res_broadcast;
+        std::array<bool, N> arg_broadcast;
+        // The number of consecutive fixed dimensions, starting with this one,
+        // that are instantiated by this node
+        size_t ndim;
+
+        node_type(bool res_broadcast, const std::array<bool, N> &arg_broadcast)
+            : res_broadcast(res_broadcast), arg_broadcast(arg_broadcast), ndim(1) {}
+
+        void operator()(kernel_builder &kb, kernel_request_t kernreq, char *data, const char *dst_arrmeta,
+                        size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          // The strides are stored operand-major, with the dst first
+          dimvector size(ndim), stride((N + 1) * ndim);
+
+          const char *child_dst_arrmeta = dst_arrmeta;
+          std::array<const char *, N> child_src_arrmeta;
+          for (size_t i = 0; i < N; ++i) {
+            child_src_arrmeta[i] = src_arrmeta[i];
+          }
+
+          call_node *node = kb.get_call();
+          for (size_t j = 0; j < ndim; ++j, node = node->next()) {
+            const node_type *level = node->get_closure<node_type>();
+
+            if (res_broadcast) {
+              size[j] = reinterpret_cast<const size_stride_t *>(child_src_arrmeta[0])->dim_size;
+              stride[j] = 0;
+            } else {
+              size[j] = reinterpret_cast<const size_stride_t *>(child_dst_arrmeta)->dim_size;
+              stride[j] = reinterpret_cast<const size_stride_t *>(child_dst_arrmeta)->stride;
+              child_dst_arrmeta += sizeof(size_stride_t);
+            }
+
+            for (size_t i = 0; i < N; ++i) {
+              if (level->arg_broadcast[i]) {
+                stride[(i + 1) * ndim + j] = 0;
+              } else {
+                stride[(i + 1) * ndim + j] = reinterpret_cast<const size_stride_t *>(child_src_arrmeta[i])->stride;
+                child_src_arrmeta[i] += sizeof(size_stride_t);
+              }
+            }
           }
 
-          intptr_t dst_stride;
-          const char *child_dst_arrmeta;
-          if (res_broadcast) {
-            dst_stride = 0;
-            child_dst_arrmeta = dst_arrmeta;
+          // The loop order, from outermost to innermost
+          shortvector<int> order(ndim);
+          if (res_broadcast || ndim == 1) {
+            for (size_t j = 0; j < ndim; ++j) {
+              order[j] = static_cast<int>(j);
+            }
           } else {
-            dst_stride = reinterpret_cast<const size_stride_t *>(dst_arrmeta)->stride;
-            child_dst_arrmeta = dst_arrmeta + sizeof(size_stride_t);
+            shortvector<const intptr_t *> operstrides(N + 1);
+            for (size_t i = 0; i <= N; ++i) {
+              operstrides[i] = stride.get() + i * ndim;
+            }
+
+            shortvector<int> axis_perm(ndim);
+            multistrides_to_axis_perm(ndim, N + 1, operstrides.get(), axis_perm.get());
+            for (size_t j = 0; j < ndim; ++j) {
+              order[j] = axis_perm[ndim - j - 1];
+            }
           }
 
-          std::array<intptr_t, N> src_stride;
-          std::array<const char *, N> child_src_arrmeta;
-          for (size_t i = 0; i < N; ++i) {
-            if (arg_broadcast[i]) {
-              src_stride[i] = 0;
-              child_src_arrmeta[i] = src_arrmeta[i];
-            } else {
-              src_stride[i] = reinterpret_cast<const size_stride_t *>(src_arrmeta[i])->stride;
-              child_src_arrmeta[i] = src_arrmeta[i] + sizeof(size_stride_t);
+          // Merge each dimension into the one outside it when the outer stride
+          // steps over exactly one full run of the inner dimension for every operand
+          dimvector coalesced_size(ndim), coalesced_stride((N + 1) * ndim);
+          size_t coalesced_ndim = 0;
+          for (size_t j = 0; j < ndim; ++j) {
+            int axis = order[j];
+            if (coalesced_ndim > 0) {
+              size_t k = coalesced_ndim - 1;
+              if (size[axis] == 1) {
+                continue;
+              }
+
+              bool compatible = true;
+              for (size_t i = 0; i <= N && compatible && coalesced_size[k] != 1; ++i) {
+                compatible = coalesced_stride[i * ndim + k] == stride[i * ndim + axis] * size[axis];
+              }
+
+              if (compatible) {
+                coalesced_size[k] *= size[axis];
+                for (size_t i = 0; i <= N; ++i) {
+                  coalesced_stride[i * ndim + k] = stride[i * ndim + axis];
+                }
+                continue;
+              }
             }
+
+            coalesced_size[coalesced_ndim] = size[axis];
+            for (size_t i = 0; i <= N; ++i) {
+              coalesced_stride[i * ndim + coalesced_ndim] = stride[i * ndim + axis];
+            }
+            ++coalesced_ndim;
+          }
+
+          for (size_t j = 0; j < coalesced_ndim; ++j) {
+            std::array<intptr_t, N> src_stride;
+            for (size_t i = 0; i < N; ++i) {
+              src_stride[i] = coalesced_stride[(i + 1) * ndim + j];
+            }
+
+            kernel_request_t child_kernreq = (j == 0) ? kernreq : static_cast<kernel_request_t>(kernel_request_strided);
+            kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(
+                child_kernreq, data, coalesced_size[j], coalesced_stride[j], src_stride.data());
           }
 
-          kb.emplace_back<elwise_kernel<fixed_dim_id, fixed_dim_id, TraitsType, N>>(kernreq, data, size, dst_stride,
-                                                                                    src_stride.data());
+          // Skip the nodes of the dimensions that were merged away
+          for (size_t j = coalesced_ndim; j < ndim; ++j) {
+            kb.pass();
+          }
 
           kb(kernel_request_strided, TraitsType::child_data(data), child_dst_arrmeta, N, child_src_arrmeta.data());
-        });
+        }
+      };
+
+    public:
+      ndt::type resolve(base_callable *caller, char *codata, call_graph &cg, const ndt::type &res_tp, size_t narg,
+                        const ndt::type *arg_tp, size_t nkwd, const array *kwds,
+                        const std::map<std::string, ndt::type> &tp_vars) {
+        size_t offset = cg.size();
+        size_t ndim = reinterpret_cast<codata_type *>(codata)->ndim;
+
+        ndt::type res_element_tp =
+            base_elwise_callable<N>::resolve(caller, codata, cg, res_tp, narg, arg_tp, nkwd, kwds, tp_vars);
+
+        // Stateful children index each dimension separately, so only stateless
+        // ones have their dimensions instantiated together
+        if (std::is_same<TraitsType, no_traits>::value && ndim > 1) {
+          call_node *node = cg.template get_at<call_node>(offset);
+          call_node *next = node->next();
+          if (offset + node->data_size < cg.size() && next->instantiate == node->instantiate) {
+            node->get_closure<node_type>()->ndim = next->get_closure<node_type>()->ndim + 1;
+          }
+        }
+
+        return res_element_tp;
+      }
+
+      void subresolve(call_graph &cg, const char *data) {
+        cg.emplace_back<node_type>(reinterpret_cast<const data_type *>(data)->res_ignore,
+                                   reinterpret_cast<const data_type *>(data)->arg_broadcast);
       }
 
       ndt::type with_return_type(intptr_t ret_size, const ndt::type &ret_element_tp) {
@@ -23,32 +23,37 @@ namespace nd {
     ndt::type resolve(base_callable *caller, char *DYND_UNUSED(data), call_graph &cg, const ndt::type &dst_tp,
                       size_t DYND_UNUSED(nsrc), const ndt::type *src_tp, size_t nkwd, const array *kwds,
                       const std::map<std::string, ndt::type> &tp_vars) {
-      cg.emplace_back([](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *dst_arrmeta,
-                         size_t nsrc, const char *const *src_arrmeta) {
+      ndt::type src_value_tp[2];
+      for (intptr_t i = 0; i < 2; ++i) {
+        src_value_tp[i] = src_tp[i];
+      }
+      // The NA of a floating point value is a NaN, on which the child can compute, so the kernel can be blockwise
+      bool blockwise = true;
+      for (intptr_t i : std::array<index_t, sizeof...(I)>({I...})) {
+        src_value_tp[i] = src_value_tp[i].extended<ndt::option_type>()->get_value_type();
+        type_id_t base_id = src_value_tp[i].get_base_id();
+        blockwise &= src_value_tp[i].is_builtin() && (base_id == float_kind_id || base_id == complex_kind_id);
+      }
+
+      cg.emplace_back([blockwise](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                  const char *dst_arrmeta, size_t nsrc, const char *const *src_arrmeta) {
+        kernel_request_t child_kernreq = blockwise ? kernel_request_strided : kernel_request_single;
         size_t self_offset = kb.size();
-        kb.emplace_back<forward_na_kernel<I...>>(kernreq);
+        kb.emplace_back<forward_na_kernel<I...>>(kernreq, blockwise);
 
-        kb(kernel_request_single, nullptr, dst_arrmeta, nsrc, src_arrmeta);
+        kb(child_kernreq, nullptr, dst_arrmeta, nsrc, src_arrmeta);
 
         for (intptr_t i : std::array<index_t, sizeof...(I)>({I...})) {
           size_t is_na_offset = kb.size() - self_offset;
-          kb(kernel_request_single, nullptr, nullptr, 1, src_arrmeta + i);
+          kb(child_kernreq, nullptr, nullptr, 1, src_arrmeta + i);
           kb.get_at<forward_na_kernel<I...>>(self_offset)->is_na_offset[i] = is_na_offset;
         }
 
         size_t assign_na_offset = kb.size() - self_offset;
-        kb(kernel_request_single, nullptr, nullptr, 0, nullptr);
+        kb(child_kernreq, nullptr, nullptr, 0, nullptr);
         kb.get_at<forward_na_kernel<I...>>(self_offset)->assign_na_offset = assign_na_offset;
       });
 
-      ndt::type src_value_tp[2];
-      for (intptr_t i = 0; i < 2; ++i) {
-        src_value_tp[i] = src_tp[i];
-      }
-      for (intptr_t i : std::array<index_t, sizeof...(I)>({I...})) {
-        src_value_tp[i] = src_value_tp[i].extended<ndt::option_type>()->get_value_type();
-      }
-
       base_callable *child;
       if (m_child.is_null()) {
         child = caller;
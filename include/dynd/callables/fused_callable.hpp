@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/fused_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * One operation in a fused expression. Each entry of ``args`` is either
+     * the index of an input to the fused callable, or the number of inputs
+     * plus the index of an earlier node.
+     */
+    struct fused_node {
+      callable op;
+      std::vector<size_t> args;
+    };
+
+    /**
+     * A callable that evaluates a topologically sorted list of scalar
+     * operations with a single fused_kernel. The result is the result of
+     * the last node.
+     */
+    class fused_callable : public base_callable {
+      std::vector<fused_node> m_nodes;
+
+      // Resolves every node into ``cg``, returning the resolved node types
+      std::vector<ndt::type> resolve_nodes(call_graph &cg, const ndt::type &dst_tp, const ndt::type *src_tp,
+                                           size_t nsrc, size_t nkwd, const array *kwds,
+                                           const std::map<std::string, ndt::type> &tp_vars) {
+        std::vector<ndt::type> node_tp(m_nodes.size());
+        std::vector<ndt::type> arg_tp;
+        for (size_t k = 0; k < m_nodes.size(); ++k) {
+          const fused_node &node = m_nodes[k];
+          arg_tp.clear();
+          for (size_t arg : node.args) {
+            arg_tp.push_back(arg < nsrc ? src_tp[arg] : node_tp[arg - nsrc]);
+          }
+
+          ndt::type ret_tp =
+              (k + 1 == m_nodes.size() && !dst_tp.is_symbolic()) ? dst_tp : node.op->get_ret_type();
+          node_tp[k] =
+              node.op->resolve(this, nullptr, cg, ret_tp, arg_tp.size(), arg_tp.data(), nkwd, kwds, tp_vars);
+        }
+
+        return node_tp;
+      }
+
+    public:
+      fused_callable(const ndt::type &tp, const std::vector<fused_node> &nodes) : base_callable(tp), m_nodes(nodes) {}
+
+      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                        const ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp, size_t nkwd, const array *kwds,
+                        const std::map<std::string, ndt::type> &tp_vars) {
+        // The intermediate types are needed by the kernel, which comes before
+        // the children in the call graph, so they are resolved once up front
+        call_graph scratch_cg;
+        std::vector<ndt::type> node_tp = resolve_nodes(scratch_cg, dst_tp, src_tp, nsrc, nkwd, kwds, tp_vars);
+
+        std::vector<ndt::type> buffer_tp(node_tp.begin(), node_tp.end() - 1);
+        std::vector<size_t> arg_begin{0};
+        std::vector<size_t> args;
+        for (const fused_node &node : m_nodes) {
+          args.insert(args.end(), node.args.begin(), node.args.end());
+          arg_begin.push_back(args.size());
+        }
+
+        cg.emplace_back([nsrc, buffer_tp, arg_begin, args](kernel_builder &kb, kernel_request_t kernreq,
+                                                           char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                           size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          intptr_t root_kb_offset = kb.size();
+          kb.emplace_back<fused_kernel>(kernreq, nsrc, buffer_tp, arg_begin, args);
+
+          size_t nnode = arg_begin.size() - 1;
+          std::vector<const char *> arg_arrmeta;
+          for (size_t k = 0; k < nnode; ++k) {
+            fused_kernel *self = kb.get_at<fused_kernel>(root_kb_offset);
+            self->m_offsets[k] = kb.size() - root_kb_offset;
+
+            arg_arrmeta.clear();
+            for (size_t j = arg_begin[k]; j < arg_begin[k + 1]; ++j) {
+              arg_arrmeta.push_back(args[j] < nsrc ? src_arrmeta[args[j]] : self->m_bufs[args[j] - nsrc].get_arrmeta());
+            }
+            kb(kernel_request_strided, nullptr, (k + 1 == nnode) ? dst_arrmeta : self->m_bufs[k].get_arrmeta(),
+               arg_arrmeta.size(), arg_arrmeta.data());
+          }
+        });
+
+        resolve_nodes(cg, dst_tp, src_tp, nsrc, nkwd, kwds, tp_vars);
+
+        return node_tp.back();
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,82 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/math_kernel.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/option_type.hpp>
+
+namespace dynd {
+namespace nd {
+
+  template <template <typename> class FuncType, typename T, size_t N = 1>
+  class math_callable;
+
+  /**
+   * A unary function from vector_math.hpp on float or double. The optional
+   * ``ulp`` keyword is the error, in units in the last place, that the caller
+   * accepts; the polynomial implementation is used when it is at least the
+   * function's ``fast_ulp``, and the libm one otherwise.
+   */
+  template <template <typename> class FuncType, typename T>
+  class math_callable<FuncType, T, 1> : public base_callable {
+  public:
+    math_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<T>(), {ndt::make_type<T>()},
+              {{ndt::make_type<ndt::option_type>(ndt::make_type<int32_t>()), "ulp"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc),
+                      const ndt::type *DYND_UNUSED(src_tp), size_t nkwd, const array *kwds,
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      // Callers that do not forward keywords, such as the arithmetic
+      // dispatchers and compose, get the default accuracy
+      int ulp = dynd::detail::precise_math_ulp;
+      if (nkwd > 0 && !kwds[0].is_null() && !kwds[0].is_na()) {
+        ulp = kwds[0].as<int32_t>();
+      }
+
+      bool fast = ulp >= FuncType<T>::fast_ulp;
+      cg.emplace_back([fast](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                             const char *const *DYND_UNUSED(src_arrmeta)) {
+        kb.emplace_back<math_kernel<FuncType, T, 1>>(kernreq, fast);
+      });
+
+      return ndt::make_type<T>();
+    }
+  };
+
+  /**
+   * A binary function from vector_math.hpp on float or double, evaluated to
+   * the default accuracy.
+   */
+  template <template <typename> class FuncType, typename T>
+  class math_callable<FuncType, T, 2> : public base_callable {
+  public:
+    math_callable()
+        : base_callable(
+              ndt::make_type<ndt::callable_type>(ndt::make_type<T>(), {ndt::make_type<T>(), ndt::make_type<T>()})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc),
+                      const ndt::type *DYND_UNUSED(src_tp), size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      bool fast = dynd::detail::precise_math_ulp >= FuncType<T>::fast_ulp;
+      cg.emplace_back([fast](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                             const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                             const char *const *DYND_UNUSED(src_arrmeta)) {
+        kb.emplace_back<math_kernel<FuncType, T, 2>>(kernreq, fast);
+      });
+
+      return ndt::make_type<T>();
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
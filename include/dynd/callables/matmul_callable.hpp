@@ -0,0 +1,120 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/matmul_kernel.hpp>
+#include <dynd/types/callable_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    inline std::vector<intptr_t> get_fixed_shape(const ndt::type &tp) {
+      std::vector<intptr_t> shape(tp.get_ndim());
+      if (!shape.empty()) {
+        tp.extended()->get_shape(shape.size(), 0, shape.data(), NULL, NULL);
+      }
+
+      return shape;
+    }
+
+    inline std::vector<intptr_t> make_dim_range(intptr_t begin, intptr_t end) {
+      std::vector<intptr_t> dims;
+      for (intptr_t i = begin; i < end; ++i) {
+        dims.push_back(i);
+      }
+
+      return dims;
+    }
+
+    // Emplaces the kernel for a product of values of type T
+    template <typename T>
+    void emplace_gemm(call_graph &cg, const gemm_dims &dims) {
+      cg.emplace_back([dims](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                             const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        kb.emplace_back<gemm_kernel<T>>(kernreq, dims, dst_arrmeta, src_arrmeta[0], src_arrmeta[1]);
+      });
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * The matrix product of the last two dimensions of the arguments, batched
+   * over the rest, which are broadcast against each other. As in NumPy, an
+   * argument with one dimension is a row vector on the left and a column
+   * vector on the right, and that dimension is dropped from the result.
+   */
+  template <typename T>
+  class matmul_callable : public base_callable {
+  public:
+    matmul_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::type("Fixed**R * " + ndt::make_type<T>().str()),
+              {ndt::type("Fixed**N * " + ndt::make_type<T>().str()),
+               ndt::type("Fixed**M * " + ndt::make_type<T>().str())})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      std::vector<intptr_t> src0_shape = detail::get_fixed_shape(src_tp[0]);
+      std::vector<intptr_t> src1_shape = detail::get_fixed_shape(src_tp[1]);
+      intptr_t src0_ndim = src0_shape.size(), src1_ndim = src1_shape.size();
+      if (src0_ndim == 0 || src1_ndim == 0) {
+        throw std::invalid_argument("nd::matmul: expected arguments with at least one dimension");
+      }
+
+      gemm_dims dims;
+      intptr_t src0_nbatch = std::max<intptr_t>(src0_ndim - 2, 0);
+      intptr_t src1_nbatch = std::max<intptr_t>(src1_ndim - 2, 0);
+      intptr_t nbatch = std::max(src0_nbatch, src1_nbatch);
+      std::vector<intptr_t> shape;
+      for (intptr_t i = 0; i < nbatch; ++i) {
+        intptr_t src0_dim = i - (nbatch - src0_nbatch), src1_dim = i - (nbatch - src1_nbatch);
+        intptr_t src0_size = src0_dim < 0 ? 1 : src0_shape[src0_dim];
+        intptr_t src1_size = src1_dim < 0 ? 1 : src1_shape[src1_dim];
+        if (src0_size != src1_size && src0_size != 1 && src1_size != 1) {
+          std::stringstream ss;
+          ss << "nd::matmul: cannot broadcast the dimensions of " << src_tp[0] << " and " << src_tp[1];
+          throw std::invalid_argument(ss.str());
+        }
+
+        dims.dst_batch.push_back(i);
+        dims.src0_batch.push_back(src0_dim < 0 ? -1 : src0_dim);
+        dims.src1_batch.push_back(src1_dim < 0 ? -1 : src1_dim);
+        shape.push_back(std::max(src0_size, src1_size));
+      }
+
+      if (src0_ndim > 1) {
+        dims.src0_m.push_back(src0_ndim - 2);
+        dims.dst_m.push_back(shape.size());
+        shape.push_back(src0_shape[src0_ndim - 2]);
+      }
+      dims.src0_k.push_back(src0_ndim - 1);
+      dims.src1_k.push_back(src1_ndim == 1 ? 0 : src1_ndim - 2);
+      if (src1_ndim > 1) {
+        dims.src1_n.push_back(src1_ndim - 1);
+        dims.dst_n.push_back(shape.size());
+        shape.push_back(src1_shape[src1_ndim - 1]);
+      }
+
+      if (src0_shape[dims.src0_k[0]] != src1_shape[dims.src1_k[0]]) {
+        std::stringstream ss;
+        ss << "nd::matmul: the inner dimensions of " << src_tp[0] << " and " << src_tp[1] << " do not match";
+        throw std::invalid_argument(ss.str());
+      }
+
+      detail::emplace_gemm<T>(cg, dims);
+
+      return ndt::make_type(shape.size(), shape.data(), ndt::make_type<T>());
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
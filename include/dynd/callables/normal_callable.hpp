@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/random_callable.hpp>
+#include <dynd/kernels/normal_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+
+    /**
+     * Draws values from the normal distribution with mean ``loc``, by default
+     * 0, and standard deviation ``scale``, by default 1.
+     */
+    template <typename ReturnType, typename GeneratorType>
+    class normal_callable : public base_callable {
+      static std::vector<std::pair<ndt::type, std::string>> kwd_types() {
+        std::vector<std::pair<ndt::type, std::string>> kwds{
+            {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "loc"},
+            {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "scale"}};
+        for (const auto &kwd : detail::seed_and_stream_kwds()) {
+          kwds.push_back(kwd);
+        }
+
+        return kwds;
+      }
+
+    public:
+      normal_callable()
+          : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<ReturnType>(), {}, kwd_types())) {}
+
+      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                        const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
+                        size_t DYND_UNUSED(nkwd), const array *kwds,
+                        const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+        ReturnType loc = kwds[0].is_na() ? 0 : kwds[0].as<ReturnType>();
+        ReturnType scale = kwds[1].is_na() ? 1 : kwds[1].as<ReturnType>();
+        normal_distribution<ReturnType> distribution(loc, scale);
+
+        uint64_t seed;
+        uint32_t stream;
+        detail::get_seed_and_stream(kwds[2], kwds[3], seed, stream);
+
+        cg.emplace_back([distribution, seed, stream](kernel_builder &kb, kernel_request_t kernreq,
+                                                     char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+                                                     size_t DYND_UNUSED(nsrc),
+                                                     const char *const *DYND_UNUSED(src_arrmeta)) {
+          kb.emplace_back<normal_kernel<ReturnType, GeneratorType>>(kernreq, distribution, seed, stream);
+        });
+
+        return dst_tp;
+      }
+    };
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -6,14 +6,37 @@
 #pragma once
 
 #include <dynd/callables/apply_function_callable.hpp>
+#include <dynd/callables/math_callable.hpp>
 #include <dynd/kernels/arithmetic.hpp>
 
 namespace dynd {
 namespace nd {
 
+  namespace detail {
+
+    template <typename Arg0Type, typename Arg1Type>
+    struct pow_callable {
+      typedef functional::apply_function_callable<decltype(&dynd::detail::inline_pow<Arg0Type, Arg1Type>::f),
+                                                  &dynd::detail::inline_pow<Arg0Type, Arg1Type>::f>
+          type;
+    };
+
+    // Same-type floating point arguments keep their type, and are evaluated a
+    // block at a time
+    template <>
+    struct pow_callable<float, float> {
+      typedef math_callable<dynd::detail::math_pow, float, 2> type;
+    };
+
+    template <>
+    struct pow_callable<double, double> {
+      typedef math_callable<dynd::detail::math_pow, double, 2> type;
+    };
+
+  } // namespace dynd::nd::detail
+
   template <typename Arg0Type, typename Arg1Type>
-  using pow_callable = functional::apply_function_callable<decltype(&dynd::detail::inline_pow<Arg0Type, Arg1Type>::f),
-                                                           &dynd::detail::inline_pow<Arg0Type, Arg1Type>::f>;
+  using pow_callable = typename detail::pow_callable<Arg0Type, Arg1Type>::type;
 
 } // namespace dynd::nd
 } // namespace dynd
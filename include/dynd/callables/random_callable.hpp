@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <limits>
+#include <sstream>
+
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/philox.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/int_kind_type.hpp>
+#include <dynd/types/option_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+    namespace detail {
+
+      /**
+       * Reads the optional ``seed`` and ``stream`` keywords of a random
+       * callable. Without a seed, a different one is made for every call.
+       */
+      inline void get_seed_and_stream(const array &seed_kwd, const array &stream_kwd, uint64_t &seed,
+                                      uint32_t &stream) {
+        seed = seed_kwd.is_na() ? dynd::random::make_seed() : static_cast<uint64_t>(seed_kwd.as<int64_t>());
+
+        stream = 0;
+        if (!stream_kwd.is_na()) {
+          int64_t value = stream_kwd.as<int64_t>();
+          if (value < 0 || value > std::numeric_limits<uint32_t>::max()) {
+            std::stringstream ss;
+            ss << "random stream " << value << " is out of range, it must be in [0, 2**32)";
+            throw std::invalid_argument(ss.str());
+          }
+          stream = static_cast<uint32_t>(value);
+        }
+      }
+
+      /**
+       * Returns the keywords every random callable takes after the parameters
+       * of its distribution.
+       */
+      inline std::vector<std::pair<ndt::type, std::string>> seed_and_stream_kwds() {
+        return {{ndt::make_type<ndt::option_type>(ndt::make_type<ndt::int_kind_type>()), "seed"},
+                {ndt::make_type<ndt::option_type>(ndt::make_type<ndt::int_kind_type>()), "stream"}};
+      }
+
+    } // namespace dynd::nd::random::detail
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,154 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <sstream>
+
+#include <dynd/assignment.hpp>
+#include <dynd/callables/base_callable.hpp>
+#include <dynd/kernels/scatter_kernel.hpp>
+#include <dynd/types/any_kind_type.hpp>
+#include <dynd/types/callable_type.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    /**
+     * Checks the arguments of a put or a scatter, the array ``N * T`` passed
+     * as ``dst``, then ``M * intptr`` and either ``M * S`` or a single ``S``,
+     * returning ``S``.
+     */
+    inline ndt::type check_scatter_types(const char *name, const ndt::type &dst_tp, const ndt::type *src_tp) {
+      if (dst_tp.is_symbolic()) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": the array to assign into should be passed as \"dst\"";
+        throw std::invalid_argument(ss.str());
+      }
+      if (dst_tp.get_ndim() != 1 || src_tp[0].get_ndim() != 1) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": expected one-dimensional arrays, not " << dst_tp << " and " << src_tp[0];
+        throw std::invalid_argument(ss.str());
+      }
+      if (src_tp[0].get_dtype().get_id() != ndt::make_type<intptr_t>().get_id()) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": index type should be intptr, not " << src_tp[0].get_dtype();
+        throw type_error(ss.str());
+      }
+
+      if (src_tp[1].get_ndim() == 0) {
+        return src_tp[1];
+      }
+      if (src_tp[1].get_id() != fixed_dim_id || src_tp[1].get_ndim() != 1 ||
+          src_tp[1].extended<ndt::fixed_dim_type>()->get_fixed_dim_size() !=
+              src_tp[0].extended<ndt::fixed_dim_type>()->get_fixed_dim_size()) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": expected a value for each index of " << src_tp[0] << ", not " << src_tp[1];
+        throw std::invalid_argument(ss.str());
+      }
+
+      return src_tp[1].extended<ndt::fixed_dim_type>()->get_element_type();
+    }
+
+    // The stride of the values of a put or a scatter, which is zero for a single value
+    inline intptr_t get_scatter_values_stride(bool values_dim, const char *values_arrmeta) {
+      return values_dim ? reinterpret_cast<const size_stride_t *>(values_arrmeta)->stride : 0;
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Assigns values to the array passed as ``dst`` in place at the positions
+   * of an index array.
+   */
+  class put_callable : public base_callable {
+  public:
+    put_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<ndt::any_kind_type>()),
+              {ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<intptr_t>()),
+               ndt::make_type<ndt::any_kind_type>()})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &tp_vars) {
+      ndt::type values_element_tp = detail::check_scatter_types("put", dst_tp, src_tp);
+      ndt::type dst_element_tp = dst_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+
+      // Builtin elements of the type of the values are copied without the child
+      size_t element_size = 0;
+      if (dst_element_tp.is_builtin() && dst_element_tp == values_element_tp) {
+        element_size = dst_element_tp.get_data_size();
+      }
+
+      bool values_dim = src_tp[1].get_ndim() == 1;
+      cg.emplace_back([element_size, values_dim](kernel_builder &kb, kernel_request_t kernreq,
+                                                 char *DYND_UNUSED(data), const char *dst_arrmeta,
+                                                 size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        const size_stride_t *dst_md = reinterpret_cast<const size_stride_t *>(dst_arrmeta);
+        const size_stride_t *index_md = reinterpret_cast<const size_stride_t *>(src_arrmeta[0]);
+        kb.emplace_back<put_kernel>(kernreq, dst_md->dim_size, dst_md->stride, index_md->dim_size, index_md->stride,
+                                    detail::get_scatter_values_stride(values_dim, src_arrmeta[1]), element_size);
+
+        // Create the child element assignment ckernel
+        const char *values_el_meta = values_dim ? src_arrmeta[1] + sizeof(size_stride_t) : src_arrmeta[1];
+        kb(kernel_request_single, nullptr, dst_arrmeta + sizeof(size_stride_t), 1, &values_el_meta);
+      });
+
+      nd::array error_mode = assign_error_default;
+      assign->resolve(this, nullptr, cg, dst_element_tp, 1, &values_element_tp, 1, &error_mode, tp_vars);
+
+      return dst_tp;
+    }
+  };
+
+  /**
+   * Accumulates values into the array of builtin type ``T`` passed as
+   * ``dst`` in place at the positions of an index array, with an operation
+   * such as scatter_add_op.
+   */
+  template <typename T, typename OpType>
+  class scatter_callable : public base_callable {
+    const char *m_name;
+
+  public:
+    scatter_callable(const char *name)
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<T>()),
+              {ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_type<intptr_t>()),
+               ndt::make_type<ndt::any_kind_type>()})),
+          m_name(name) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      ndt::type values_element_tp = detail::check_scatter_types(m_name, dst_tp, src_tp);
+      if (values_element_tp != ndt::make_type<T>()) {
+        std::stringstream ss;
+        ss << "nd::" << m_name << ": expected values of type " << ndt::make_type<T>() << ", not " << values_element_tp;
+        throw type_error(ss.str());
+      }
+
+      bool values_dim = src_tp[1].get_ndim() == 1;
+      cg.emplace_back([values_dim](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                   const char *dst_arrmeta, size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        const size_stride_t *dst_md = reinterpret_cast<const size_stride_t *>(dst_arrmeta);
+        const size_stride_t *index_md = reinterpret_cast<const size_stride_t *>(src_arrmeta[0]);
+        kb.emplace_back<scatter_kernel<T, OpType>>(kernreq, dst_md->dim_size, dst_md->stride, index_md->dim_size,
+                                                   index_md->stride,
+                                                   detail::get_scatter_values_stride(values_dim, src_arrmeta[1]));
+      });
+
+      return dst_tp;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
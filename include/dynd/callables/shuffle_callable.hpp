@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/random_callable.hpp>
+#include <dynd/kernels/shuffle_kernel.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+    namespace detail {
+
+      // Returns whether elements of type ``tp`` with arrmeta ``arrmeta`` each occupy one block of memory
+      inline bool is_contiguous_element(ndt::type tp, const char *arrmeta) {
+        while (tp.get_id() == fixed_dim_id) {
+          const ndt::type &element_tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+          if (reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta)->stride !=
+              static_cast<intptr_t>(element_tp.get_default_data_size())) {
+            return false;
+          }
+          tp = element_tp;
+          arrmeta += sizeof(fixed_dim_type_arrmeta);
+        }
+
+        return tp.get_ndim() == 0;
+      }
+
+    } // namespace dynd::nd::random::detail
+
+    /**
+     * Shuffles an array in place along its outermost dimension. The rows of
+     * a multidimensional array are moved as a whole, so each must be
+     * contiguous.
+     */
+    template <typename GeneratorType>
+    class shuffle_callable : public base_callable {
+    public:
+      shuffle_callable()
+          : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Any")},
+                                                             detail::seed_and_stream_kwds())) {}
+
+      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                        const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                        size_t DYND_UNUSED(nkwd), const array *kwds,
+                        const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+        uint64_t seed;
+        uint32_t stream;
+        detail::get_seed_and_stream(kwds[0], kwds[1], seed, stream);
+
+        ndt::type src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+        cg.emplace_back([seed, stream, src0_element_tp](kernel_builder &kb, kernel_request_t kernreq,
+                                                        char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+                                                        size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+          const fixed_dim_type_arrmeta *src0_md = reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0]);
+          if (!detail::is_contiguous_element(src0_element_tp, src_arrmeta[0] + sizeof(fixed_dim_type_arrmeta))) {
+            std::stringstream ss;
+            ss << "nd::random::shuffle: the elements of type " << src0_element_tp << " are not contiguous";
+            throw std::invalid_argument(ss.str());
+          }
+
+          kb.emplace_back<shuffle_kernel<GeneratorType>>(kernreq, seed, stream, src0_md->dim_size, src0_md->stride,
+                                                         src0_element_tp.get_default_data_size());
+        });
+
+        return dst_tp;
+      }
+    };
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,30 +5,124 @@
 
 #pragma once
 
+#include <sstream>
+
 #include <dynd/callables/base_callable.hpp>
 #include <dynd/comparison.hpp>
 #include <dynd/kernels/sort_kernel.hpp>
 
 namespace dynd {
 namespace nd {
+  namespace detail {
+
+    /**
+     * Calls ``f`` with a value of the type in ``TypeSequence`` whose id is
+     * ``id``. Returns false, without calling ``f``, if there is no such type.
+     */
+    template <typename TypeSequence>
+    struct with_sort_type;
+
+    template <>
+    struct with_sort_type<type_sequence<>> {
+      template <typename F>
+      static bool apply(type_id_t DYND_UNUSED(id), F &&DYND_UNUSED(f)) {
+        return false;
+      }
+    };
+
+    template <typename T0, typename... T>
+    struct with_sort_type<type_sequence<T0, T...>> {
+      template <typename F>
+      static bool apply(type_id_t id, F &&f) {
+        if (id == ndt::id_of<T0>::value) {
+          f(T0());
+          return true;
+        }
+
+        return with_sort_type<type_sequence<T...>>::apply(id, std::forward<F>(f));
+      }
+    };
+
+    /**
+     * The rows of a one or two-dimensional fixed array, as the sort kernels
+     * see them. A one-dimensional array is a single row.
+     */
+    struct sort_shape {
+      intptr_t nrow;
+      intptr_t row_stride;
+      intptr_t size;
+      intptr_t stride;
+
+      sort_shape(intptr_t ndim, const char *arrmeta) {
+        const fixed_dim_type_arrmeta *md = reinterpret_cast<const fixed_dim_type_arrmeta *>(arrmeta);
+        if (ndim == 1) {
+          nrow = 1;
+          row_stride = 0;
+        } else {
+          nrow = md->dim_size;
+          row_stride = md->stride;
+          ++md;
+        }
+        size = md->dim_size;
+        stride = md->stride;
+      }
+    };
 
+    // Checks that ``tp`` is a one or two-dimensional fixed array, returning the number of dimensions
+    inline intptr_t check_sort_type(const char *name, const ndt::type &tp) {
+      intptr_t ndim = tp.get_ndim();
+      if (ndim < 1 || ndim > 2 || tp.get_id() != fixed_dim_id ||
+          (ndim == 2 && tp.extended<ndt::fixed_dim_type>()->get_element_type().get_id() != fixed_dim_id)) {
+        std::stringstream ss;
+        ss << "nd::" << name << ": expected a one or two-dimensional fixed array, not " << tp;
+        throw std::invalid_argument(ss.str());
+      }
+
+      return ndim;
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Sorts a one-dimensional array in place, or each row of a two-dimensional
+   * one. The stable variant keeps equal elements in their original order.
+   */
   class sort_callable : public base_callable {
+    bool m_stable;
+
   public:
-    sort_callable()
-        : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Fixed * Scalar")})) {}
+    sort_callable(bool stable = false)
+        : base_callable(
+              ndt::make_type<ndt::callable_type>(ndt::make_type<void>(), {ndt::type("Dims... * Fixed * Scalar")})),
+          m_stable(stable) {}
 
     ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
                       const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
                       size_t DYND_UNUSED(nkwd), const array *DYND_UNUSED(kwds),
                       const std::map<std::string, ndt::type> &tp_vars) {
-      const ndt::type &src0_element_tp = src_tp[0].extended<ndt::fixed_dim_type>()->get_element_type();
+      intptr_t ndim = detail::check_sort_type(m_stable ? "stable_sort" : "sort", src_tp[0]);
+      bool stable = m_stable;
+      const ndt::type &src0_element_tp = src_tp[0].get_dtype();
+      if (detail::with_sort_type<builtin_sort_types>::apply(src0_element_tp.get_id(), [&cg, ndim, stable](auto value) {
+            typedef decltype(value) src0_element_type;
+            cg.emplace_back([ndim, stable](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
+                                           const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
+                                           const char *const *src_arrmeta) {
+              detail::sort_shape shape(ndim, src_arrmeta[0]);
+              kb.emplace_back<builtin_sort_kernel<src0_element_type>>(kernreq, shape.nrow, shape.row_stride,
+                                                                      shape.size, shape.stride, stable);
+            });
+          })) {
+        return dst_tp;
+      }
+
       size_t src0_element_data_size = src0_element_tp.get_data_size();
-      cg.emplace_back([src0_element_data_size](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
-                                               const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
-                                               const char *const *src_arrmeta) {
-        kb.emplace_back<sort_kernel>(
-            kernreq, reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->dim_size,
-            reinterpret_cast<const fixed_dim_type_arrmeta *>(src_arrmeta[0])->stride, src0_element_data_size);
+      cg.emplace_back([ndim, stable, src0_element_data_size](
+          kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+          size_t DYND_UNUSED(nsrc), const char *const *src_arrmeta) {
+        detail::sort_shape shape(ndim, src_arrmeta[0]);
+        kb.emplace_back<sort_kernel>(kernreq, shape.nrow, shape.row_stride, shape.size, shape.stride,
+                                     src0_element_data_size, stable);
 
         kb(kernel_request_single, nullptr, nullptr, 2, nullptr);
       });
@@ -5,15 +5,13 @@
 
 #pragma once
 
-#include <dynd/callables/apply_function_callable.hpp>
-#include <dynd/kernels/arithmetic.hpp>
+#include <dynd/callables/math_callable.hpp>
 
 namespace dynd {
 namespace nd {
 
   template <typename Arg0Type>
-  using sqrt_callable = functional::apply_function_callable<decltype(&dynd::detail::inline_sqrt<Arg0Type>::f),
-                                                            &dynd::detail::inline_sqrt<Arg0Type>::f>;
+  using sqrt_callable = math_callable<dynd::detail::math_sqrt, Arg0Type>;
 
 } // namespace dynd::nd
 } // namespace dynd
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callables/matmul_callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * The sum of products over the last ``axes`` dimensions of the first
+   * argument and the first ``axes`` dimensions of the second, by default 2.
+   * The result has the remaining dimensions of the first argument followed
+   * by those of the second.
+   */
+  template <typename T>
+  class tensordot_callable : public base_callable {
+  public:
+    tensordot_callable()
+        : base_callable(ndt::make_type<ndt::callable_type>(
+              ndt::type("Fixed**R * " + ndt::make_type<T>().str()),
+              {ndt::type("Fixed**N * " + ndt::make_type<T>().str()),
+               ndt::type("Fixed**M * " + ndt::make_type<T>().str())},
+              {{ndt::type("?Int"), "axes"}})) {}
+
+    ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
+                      const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc), const ndt::type *src_tp,
+                      size_t DYND_UNUSED(nkwd), const array *kwds,
+                      const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
+      std::vector<intptr_t> src0_shape = detail::get_fixed_shape(src_tp[0]);
+      std::vector<intptr_t> src1_shape = detail::get_fixed_shape(src_tp[1]);
+      intptr_t src0_ndim = src0_shape.size(), src1_ndim = src1_shape.size();
+
+      intptr_t axes = kwds[0].is_na() ? 2 : kwds[0].as<intptr_t>();
+      if (axes < 0 || axes > src0_ndim || axes > src1_ndim) {
+        std::stringstream ss;
+        ss << "nd::tensordot: cannot contract " << axes << " dimensions of " << src_tp[0] << " and " << src_tp[1];
+        throw std::invalid_argument(ss.str());
+      }
+
+      for (intptr_t i = 0; i < axes; ++i) {
+        if (src0_shape[src0_ndim - axes + i] != src1_shape[i]) {
+          std::stringstream ss;
+          ss << "nd::tensordot: the contracted dimensions of " << src_tp[0] << " and " << src_tp[1]
+             << " do not match";
+          throw std::invalid_argument(ss.str());
+        }
+      }
+
+      gemm_dims dims;
+      dims.src0_m = detail::make_dim_range(0, src0_ndim - axes);
+      dims.src0_k = detail::make_dim_range(src0_ndim - axes, src0_ndim);
+      dims.src1_k = detail::make_dim_range(0, axes);
+      dims.src1_n = detail::make_dim_range(axes, src1_ndim);
+      dims.dst_m = detail::make_dim_range(0, src0_ndim - axes);
+      dims.dst_n = detail::make_dim_range(src0_ndim - axes, src0_ndim + src1_ndim - 2 * axes);
+      detail::emplace_gemm<T>(cg, dims);
+
+      std::vector<intptr_t> shape(src0_shape.begin(), src0_shape.end() - axes);
+      shape.insert(shape.end(), src1_shape.begin() + axes, src1_shape.end());
+      return ndt::make_type(shape.size(), shape.data(), ndt::make_type<T>());
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
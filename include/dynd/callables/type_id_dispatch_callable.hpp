@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include <dynd/callables/base_dispatch_callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Picks a child from a map keyed on the type id of the data type of the
+   * first argument. The first ``nmatch`` arguments, or all of them if there
+   * are fewer, must have the same data type. Arguments with no child, or
+   * whose data types differ, are a type_error.
+   *
+   * A dispatcher that looks somewhere other than at the data type, such as
+   * at a field of a struct, overrides get_dispatch_type.
+   */
+  class type_id_dispatch_callable : public base_dispatch_callable {
+    std::string m_name;
+    intptr_t m_nmatch;
+    std::map<type_id_t, callable> m_children;
+
+  public:
+    type_id_dispatch_callable(const std::string &name, const ndt::type &tp, intptr_t nmatch,
+                              const std::map<type_id_t, callable> &children)
+        : base_dispatch_callable(tp), m_name(name), m_nmatch(nmatch), m_children(children) {}
+
+    const std::string &get_name() const { return m_name; }
+
+    // The type whose id picks the child
+    virtual ndt::type get_dispatch_type(const ndt::type &arg_tp) const { return arg_tp.get_dtype(); }
+
+    const callable &specialize(const ndt::type &DYND_UNUSED(dst_tp), intptr_t nsrc, const ndt::type *src_tp) {
+      ndt::type dispatch_tp = get_dispatch_type(src_tp[0]);
+      auto it = m_children.find(dispatch_tp.get_id());
+      bool match = it != m_children.end();
+      for (intptr_t i = 1; i < std::min(m_nmatch, nsrc); ++i) {
+        match = match && get_dispatch_type(src_tp[i]) == dispatch_tp;
+      }
+
+      if (!match) {
+        std::stringstream ss;
+        ss << "nd::" << m_name << ": no kernel for arguments of types";
+        for (intptr_t i = 0; i < nsrc; ++i) {
+          ss << (i == 0 ? " " : ", ") << src_tp[i];
+        }
+        throw type_error(ss.str());
+      }
+
+      return it->second;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,132 +5,79 @@
 
 #pragma once
 
-#include <dynd/callables/base_callable.hpp>
+#include <limits>
+
+#include <dynd/callables/random_callable.hpp>
 #include <dynd/kernels/uniform_kernel.hpp>
-#include <dynd/types/callable_type.hpp>
-#include <dynd/types/option_type.hpp>
 
 namespace dynd {
 namespace nd {
   namespace random {
-
-    template <typename ReturnType, typename GeneratorType, typename Enable = void>
-    class uniform_callable;
-
-    template <typename ReturnType, typename GeneratorType>
-    class uniform_callable<ReturnType, GeneratorType, std::enable_if_t<is_integral<ReturnType>::value>>
-        : public base_callable {
-    public:
-      uniform_callable()
-          : base_callable(ndt::make_type<ndt::callable_type>(
-                ndt::make_type<ReturnType>(), {},
-                {{ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "a"},
-                 {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "b"}})) {}
-
-      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
-                        const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
-                        size_t DYND_UNUSED(nkwd), const array *kwds,
-                        const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
-        std::shared_ptr<GeneratorType> g = get_random_device();
-
-        ReturnType a;
-        if (kwds[0].is_na()) {
-          a = 0;
-        } else {
-          a = kwds[0].as<ReturnType>();
-        }
-
-        ReturnType b;
-        if (kwds[1].is_na()) {
-          b = std::numeric_limits<ReturnType>::max();
-        } else {
-          b = kwds[1].as<ReturnType>();
-        }
-
-        cg.emplace_back([g, a, b](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
-                                  const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
-                                  const char *const *DYND_UNUSED(src_arrmeta)) {
-          kb.emplace_back<uniform_kernel<ReturnType, GeneratorType>>(kernreq, g.get(), a, b);
-        });
-
-        return dst_tp;
-      }
-    };
-
+    namespace detail {
+
+      template <typename ReturnType, typename Enable = void>
+      struct uniform_bounds;
+
+      template <typename ReturnType>
+      struct uniform_bounds<ReturnType, std::enable_if_t<is_integral<ReturnType>::value>> {
+        static ReturnType a() { return 0; }
+        static ReturnType b() { return std::numeric_limits<ReturnType>::max(); }
+      };
+
+      template <typename ReturnType>
+      struct uniform_bounds<ReturnType, std::enable_if_t<is_floating_point<ReturnType>::value>> {
+        static ReturnType a() { return 0; }
+        static ReturnType b() { return 1; }
+      };
+
+      template <typename ReturnType>
+      struct uniform_bounds<ReturnType, std::enable_if_t<is_complex<ReturnType>::value>> {
+        static ReturnType a() { return ReturnType(0, 0); }
+        static ReturnType b() { return ReturnType(1, 1); }
+      };
+
+    } // namespace dynd::nd::random::detail
+
+    /**
+     * Draws values uniformly from ``[a, b]`` for integers, and ``[a, b)``
+     * otherwise. The same ``seed`` and ``stream`` always give the same
+     * values, however many threads fill them in, and different streams with
+     * the same seed are independent.
+     */
     template <typename ReturnType, typename GeneratorType>
-    class uniform_callable<ReturnType, GeneratorType, std::enable_if_t<is_floating_point<ReturnType>::value>>
-        : public base_callable {
-    public:
-      uniform_callable()
-          : base_callable(ndt::make_type<ndt::callable_type>(
-                ndt::make_type<ReturnType>(), {},
-                {{ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "a"},
-                 {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "b"}})) {}
-
-      ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
-                        const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
-                        size_t DYND_UNUSED(nkwd), const array *kwds,
-                        const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
-        std::shared_ptr<GeneratorType> g = get_random_device();
-
-        ReturnType a;
-        if (kwds[0].is_na()) {
-          a = 0;
-        } else {
-          a = kwds[0].as<ReturnType>();
-        }
-
-        ReturnType b;
-        if (kwds[1].is_na()) {
-          b = 1;
-        } else {
-          b = kwds[1].as<ReturnType>();
+    class uniform_callable : public base_callable {
+      static std::vector<std::pair<ndt::type, std::string>> kwd_types() {
+        std::vector<std::pair<ndt::type, std::string>> kwds{
+            {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "a"},
+            {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "b"}};
+        for (const auto &kwd : detail::seed_and_stream_kwds()) {
+          kwds.push_back(kwd);
         }
 
-        cg.emplace_back([g, a, b](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
-                                  const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
-                                  const char *const *DYND_UNUSED(src_arrmeta)) {
-          kb.emplace_back<uniform_kernel<ReturnType, GeneratorType>>(kernreq, g.get(), a, b);
-        });
-
-        return dst_tp;
+        return kwds;
       }
-    };
 
-    template <typename ReturnType, typename GeneratorType>
-    class uniform_callable<ReturnType, GeneratorType, std::enable_if_t<is_complex<ReturnType>::value>>
-        : public base_callable {
     public:
       uniform_callable()
-          : base_callable(ndt::make_type<ndt::callable_type>(
-                ndt::make_type<ReturnType>(), {},
-                {{ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "a"},
-                 {ndt::make_type<ndt::option_type>(ndt::make_type<ReturnType>()), "b"}})) {}
+          : base_callable(ndt::make_type<ndt::callable_type>(ndt::make_type<ReturnType>(), {}, kwd_types())) {}
 
       ndt::type resolve(base_callable *DYND_UNUSED(caller), char *DYND_UNUSED(data), call_graph &cg,
                         const ndt::type &dst_tp, size_t DYND_UNUSED(nsrc), const ndt::type *DYND_UNUSED(src_tp),
                         size_t DYND_UNUSED(nkwd), const array *kwds,
                         const std::map<std::string, ndt::type> &DYND_UNUSED(tp_vars)) {
-        std::shared_ptr<GeneratorType> g = get_random_device();
-
-        ReturnType a;
-        if (kwds[0].is_na()) {
-          a = ReturnType(0, 0);
-        } else {
-          a = kwds[0].as<ReturnType>();
-        }
-
-        ReturnType b;
-        if (kwds[1].is_na()) {
-          b = ReturnType(1, 1);
-        } else {
-          b = kwds[1].as<ReturnType>();
-        }
-
-        cg.emplace_back([g, a, b](kernel_builder &kb, kernel_request_t kernreq, char *DYND_UNUSED(data),
-                                  const char *DYND_UNUSED(dst_arrmeta), size_t DYND_UNUSED(nsrc),
-                                  const char *const *DYND_UNUSED(src_arrmeta)) {
-          kb.emplace_back<uniform_kernel<ReturnType, GeneratorType>>(kernreq, g.get(), a, b);
+        ReturnType a = kwds[0].is_na() ? detail::uniform_bounds<ReturnType>::a() : kwds[0].as<ReturnType>();
+        ReturnType b = kwds[1].is_na() ? detail::uniform_bounds<ReturnType>::b() : kwds[1].as<ReturnType>();
+        uniform_distribution<ReturnType> distribution(a, b);
+
+        uint64_t seed;
+        uint32_t stream;
+        detail::get_seed_and_stream(kwds[2], kwds[3], seed, stream);
+
+        cg.emplace_back([distribution, seed, stream](kernel_builder &kb, kernel_request_t kernreq,
+                                                     char *DYND_UNUSED(data), const char *DYND_UNUSED(dst_arrmeta),
+                                                     size_t DYND_UNUSED(nsrc),
+                                                     const char *const *DYND_UNUSED(src_arrmeta)) {
+          kb.emplace_back<uniform_kernel<ReturnType, GeneratorType>>(kernreq, distribution, seed, stream);
         });
 
         return dst_tp;
@@ -29,8 +29,22 @@
  */
 #define DYND_UNUSED(x)
 
-/** The number of elements to process at once when doing chunking/buffering */
+/**
+ * The number of elements to process at once when doing chunking/buffering.
+ * This is normally set by the DYND_BUFFER_CHUNK_SIZE CMake variable.
+ */
+#ifndef DYND_BUFFER_CHUNK_SIZE
 #define DYND_BUFFER_CHUNK_SIZE 128
+#endif
+
+/**
+ * How many indices ahead a gather prefetches the elements it reads. This is
+ * normally set by the DYND_GATHER_PREFETCH_DISTANCE CMake variable, and 0
+ * disables prefetching.
+ */
+#ifndef DYND_GATHER_PREFETCH_DISTANCE
+#define DYND_GATHER_PREFETCH_DISTANCE 16
+#endif
 
 #ifdef __clang__
 
@@ -5,9 +5,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
-
-// #include <sparsehash/dense_hash_map>
+#include <mutex>
 
 #include <dynd/type_registry.hpp>
 
@@ -91,6 +91,90 @@ namespace detail {
     }
   }
 
+  /**
+   * A lock-free cache from the type ids of a dispatch signature to the index
+   * of the child it dispatched to. Each entry packs the ids, 16 bits each,
+   * and the index plus one into a single atomic word, so a lookup is one load
+   * per probe and never blocks. Signatures that do not fit in an entry, or
+   * that arrive once the table is full, are simply not cached.
+   */
+  template <size_t N>
+  class dispatch_cache {
+    static const size_t capacity = 512;
+    static const size_t max_probe = 16;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> m_entries;
+
+    static size_t slot(uint64_t key) { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 55); }
+
+  public:
+    dispatch_cache() : m_entries(new std::atomic<uint64_t>[capacity]) { clear(); }
+
+    // The cached indices belong to one dispatcher, so copies start empty
+    dispatch_cache(const dispatch_cache &DYND_UNUSED(other)) : dispatch_cache() {}
+
+    dispatch_cache &operator=(const dispatch_cache &DYND_UNUSED(other)) {
+      clear();
+      return *this;
+    }
+
+    void clear() {
+      for (size_t i = 0; i < capacity; ++i) {
+        m_entries[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    /** Packs ``ids`` into ``key``, returning false if they do not fit. */
+    static bool make_key(const std::array<type_id_t, N> &ids, uint64_t &key) {
+      if (16 * (N + 1) > 64) {
+        return false;
+      }
+
+      key = 0;
+      for (type_id_t id : ids) {
+        if (static_cast<uint64_t>(id) >= 0xFFFF) {
+          return false;
+        }
+        key = (key << 16) | static_cast<uint64_t>(id);
+      }
+
+      return true;
+    }
+
+    bool find(uint64_t key, size_t &index) const {
+      size_t i = slot(key);
+      for (size_t probe = 0; probe < max_probe; ++probe) {
+        uint64_t entry = m_entries[(i + probe) % capacity].load(std::memory_order_acquire);
+        if (entry == 0) {
+          return false;
+        }
+        if ((entry >> 16) == key) {
+          index = static_cast<size_t>(entry & 0xFFFF) - 1;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    void insert(uint64_t key, size_t index) {
+      if (index >= 0xFFFF - 1) {
+        return;
+      }
+
+      uint64_t entry = (key << 16) | static_cast<uint64_t>(index + 1);
+      size_t i = slot(key);
+      for (size_t probe = 0; probe < max_probe; ++probe) {
+        uint64_t expected = 0;
+        if (m_entries[(i + probe) % capacity].compare_exchange_strong(expected, entry, std::memory_order_release,
+                                                                      std::memory_order_acquire) ||
+            (expected >> 16) == key) {
+          return;
+        }
+      }
+    }
+  };
+
 } // namespace dynd::detail
 
 template <typename VertexIterator, typename EdgeIterator, typename Iterator>
@@ -132,21 +216,22 @@ inline std::ostream &print_ids(std::ostream &o, size_t nids, const ndt::type *tp
 
 template <size_t N, typename T>
 class dispatcher {
-  typedef std::map<size_t, T> Map;
-
 public:
   typedef T value_type;
 
-  typedef Map map_type;
-  //  typedef google::dense_hash_map<size_t, value_type> map_type;
-
   typedef typename std::vector<T>::iterator iterator;
   typedef typename std::vector<T>::const_iterator const_iterator;
 
 private:
   std::vector<T> m_children;
-  //  map_type m_map;
+  // The dispatch signature of each child, in the same order
+  std::vector<std::array<ndt::type, N>> m_signatures;
   dispatch_t m_dispatch;
+  detail::dispatch_cache<N> m_cache;
+  // Children are sorted by specificity on first use rather than on assignment,
+  // so global callables cost little before they are called
+  std::atomic<bool> m_sorted;
+  std::mutex m_sort_mutex;
 
   static size_t hash_combine(size_t seed, type_id_t id) { return seed ^ (id + (seed << 6) + (seed >> 2)); }
 
@@ -164,45 +249,33 @@ private:
     return seed;
   }
 
-public:
-  dispatcher(dispatch_t dispatch) : m_dispatch(dispatch) {}
-
-  dispatcher(const dispatcher &other) : m_children(other.m_children), m_dispatch(other.m_dispatch) {}
-
-  template <typename Iterator>
-  dispatcher(dispatch_t dispatch, Iterator begin, Iterator end) : m_dispatch(dispatch) {
-    //    m_map.set_empty_key(uninitialized_id);
-
-    assign(begin, end);
-  }
-
-  dispatcher(dispatch_t dispatch, std::initializer_list<T> pairs) : dispatcher(dispatch, pairs.begin(), pairs.end()) {}
+  void sort() {
+    if (m_sorted.load(std::memory_order_acquire)) {
+      return;
+    }
 
-  template <typename Iterator>
-  void assign(Iterator begin, Iterator end) {
-    m_children.resize(end - begin);
+    std::lock_guard<std::mutex> lock(m_sort_mutex);
+    if (m_sorted.load(std::memory_order_relaxed)) {
+      return;
+    }
 
-    std::vector<std::vector<size_t>> edges(m_children.size());
-    for (size_t i = 0; i < edges.size(); ++i) {
-      const auto &f_i = begin[i];
-      std::array<ndt::type, N> tp_i =
-          as_array<N>(m_dispatch(f_i->get_ret_type(), f_i->get_narg(), f_i->get_arg_types().data()));
+    size_t size = m_children.size();
+    std::vector<std::array<ndt::type, N>> signatures(size);
+    for (size_t i = 0; i < size; ++i) {
+      const T &f = m_children[i];
+      signatures[i] = as_array<N>(m_dispatch(f->get_ret_type(), f->get_narg(), f->get_arg_types().data()));
+    }
 
-      for (size_t j = i + 1; j < edges.size(); ++j) {
-        const auto &f_j = begin[j];
-        std::array<ndt::type, N> tp_j =
-            as_array<N>(m_dispatch(f_j->get_ret_type(), f_j->get_narg(), f_j->get_arg_types().data()));
+    std::vector<std::vector<size_t>> edges(size);
+    for (size_t i = 0; i < size; ++i) {
+      const std::array<ndt::type, N> &tp_i = signatures[i];
+      for (size_t j = i + 1; j < size; ++j) {
+        const std::array<ndt::type, N> &tp_j = signatures[j];
 
         if (ambiguous(tp_i, tp_j)) {
           bool ok = false;
-          for (size_t k = 0; k < edges.size(); ++k) {
-            const auto &f_k = begin[k];
-            std::array<ndt::type, N> tp_k =
-                as_array<N>(m_dispatch(f_k->get_ret_type(), f_k->get_narg(), f_k->get_arg_types().data()));
-
-            if (supercedes(tp_k, tp_i) && supercedes(tp_k, tp_j)) {
-              ok = true;
-            }
+          for (size_t k = 0; k < size && !ok; ++k) {
+            ok = supercedes(signatures[k], tp_i) && supercedes(signatures[k], tp_j);
           }
 
           if (!ok) {
@@ -223,58 +296,107 @@ public:
       }
     }
 
-    topological_sort(begin, end, edges, m_children.begin());
+    std::vector<size_t> vertices(size);
+    for (size_t i = 0; i < size; ++i) {
+      vertices[i] = i;
+    }
+    std::vector<size_t> order(size);
+    topological_sort(vertices.begin(), vertices.end(), edges, order.begin());
+
+    std::vector<T> children(size);
+    m_signatures.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      children[i] = m_children[order[i]];
+      m_signatures[i] = signatures[order[i]];
+    }
+    m_children.swap(children);
+    m_cache.clear();
+
+    m_sorted.store(true, std::memory_order_release);
+  }
+
+public:
+  dispatcher(dispatch_t dispatch) : m_dispatch(dispatch), m_sorted(true) {}
+
+  dispatcher(const dispatcher &other)
+      : m_children(other.m_children), m_signatures(other.m_signatures), m_dispatch(other.m_dispatch),
+        m_sorted(other.m_sorted.load(std::memory_order_acquire)) {}
 
-    //    m_map.clear();
+  template <typename Iterator>
+  dispatcher(dispatch_t dispatch, Iterator begin, Iterator end) : m_dispatch(dispatch), m_sorted(false) {
+    assign(begin, end);
+  }
+
+  dispatcher(dispatch_t dispatch, std::initializer_list<T> pairs) : dispatcher(dispatch, pairs.begin(), pairs.end()) {}
+
+  /**
+   * Replaces the children. They are checked for ambiguity and sorted from
+   * most to least specific the first time the dispatcher is used.
+   */
+  template <typename Iterator>
+  void assign(Iterator begin, Iterator end) {
+    std::lock_guard<std::mutex> lock(m_sort_mutex);
+    m_children.assign(begin, end);
+    m_signatures.clear();
+    m_sorted.store(false, std::memory_order_release);
   }
 
   void assign(std::initializer_list<T> pairs) { assign(pairs.begin(), pairs.end()); }
 
   template <typename Iterator>
   void insert(Iterator begin, Iterator end) {
-    std::vector<T> vertices = m_children;
-    vertices.insert(vertices.end(), begin, end);
-
-    assign(vertices.begin(), vertices.end());
+    std::lock_guard<std::mutex> lock(m_sort_mutex);
+    m_children.insert(m_children.end(), begin, end);
+    m_signatures.clear();
+    m_sorted.store(false, std::memory_order_release);
   }
 
   void insert(const T &pair) { insert(&pair, &pair + 1); }
 
   void insert(std::initializer_list<T> pairs) { insert(pairs.begin(), pairs.end()); }
 
-  iterator begin() { return m_children.begin(); }
-  const_iterator begin() const { return m_children.begin(); }
-  const_iterator cbegin() const { return m_children.cbegin(); }
+  iterator begin() {
+    sort();
+    return m_children.begin();
+  }
 
-  iterator end() { return m_children.end(); }
-  const_iterator end() const { return m_children.end(); }
-  const_iterator cend() const { return m_children.cend(); }
+  iterator end() {
+    sort();
+    return m_children.end();
+  }
 
+  /**
+   * Returns the most specific child whose signature matches. Signatures made
+   * only of builtin types are fully determined by their type ids, so the
+   * result for those is cached by id and later lookups skip the scan.
+   */
   const value_type &operator()(const ndt::type &dst_tp, size_t nsrc, const ndt::type *src_tp) {
+    sort();
+
     std::vector<ndt::type> vector_tps = m_dispatch(dst_tp, nsrc, src_tp);
     std::array<ndt::type, N> tps;
 
+    bool builtin = true;
     std::array<type_id_t, N> ids;
     for (size_t i = 0; i < N; ++i) {
       tps[i] = vector_tps[i];
       ids[i] = tps[i].get_id();
+      builtin &= tps[i].is_builtin();
     }
 
-    //    size_t key = hash(ids);
+    uint64_t key;
+    bool cacheable = builtin && detail::dispatch_cache<N>::make_key(ids, key);
+    size_t index;
+    if (cacheable && m_cache.find(key, index)) {
+      return m_children[index];
+    }
 
-    /*
-        const auto &it = m_map.find(key);
-        if (it != m_map.end()) {
-          return it->second;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+      if (supercedes(tps, m_signatures[i])) {
+        if (cacheable) {
+          m_cache.insert(key, i);
         }
-    */
-
-    for (const T &child : m_children) {
-      std::array<ndt::type, N> other_tps =
-          as_array<N>(m_dispatch(child->get_ret_type(), child->get_narg(), child->get_arg_types().data()));
-
-      if (supercedes(tps, other_tps)) {
-        return child;
+        return m_children[i];
       }
     }
 
@@ -288,8 +410,6 @@ public:
     throw std::out_of_range(ss.str());
   }
 
-  //  const value_type &operator()(std::initializer_list<type_id_t> ids) { return operator()(ids.size(), ids.begin()); }
-
   static bool edge(const std::array<type_id_t, N> &u, const std::array<type_id_t, N> &v) {
     if (supercedes(u, v)) {
       if (supercedes(v, u)) {
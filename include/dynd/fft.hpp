@@ -0,0 +1,37 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * The discrete Fourier transform of complex[float32] or complex[float64]
+   * values along the last dimension, batched over the leading dimensions.
+   * Any length works, and the plans for a length are cached for the life of
+   * the process. The result is multiplied by the optional ``scale``.
+   */
+  extern DYND_API callable fft;
+
+  /** The inverse of fft, which is not normalized unless a ``scale`` is given. */
+  extern DYND_API callable ifft;
+
+  /**
+   * The transform of float32 or float64 values along the last dimension,
+   * keeping the first ``n / 2 + 1`` values of each spectrum.
+   */
+  extern DYND_API callable rfft;
+
+  /**
+   * The inverse of rfft, which returns ``n`` reals along the last dimension,
+   * by default ``2 (m - 1)`` for ``m`` values of the spectrum.
+   */
+  extern DYND_API callable irfft;
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -13,10 +13,29 @@ namespace nd {
   extern DYND_API callable index;
 
   /**
-   * An callable which applies either a boolean masked or
+   * A callable which applies either a boolean masked or
    * an indexed take/"fancy indexing" operation.
    */
   extern DYND_API callable take;
 
+  /**
+   * A callable which assigns values in place to a one-dimensional array,
+   * passed as ``dst``, at the positions of a ``M * intptr`` index array, the
+   * inverse of an indexed take, as in ``put({index, values}, {{"dst", a}})``.
+   * The values are either ``M * T``, one for each index, or a single value
+   * assigned at every index. For an index repeated, the last value is kept.
+   */
+  extern DYND_API callable put;
+
+  /**
+   * Callables which accumulate values into a one-dimensional array of a
+   * builtin numeric type, passed as ``dst``, in place at the positions of an
+   * index array, as put does, but combining every value for an index
+   * repeated with a sum or a maximum. A histogram is a scatter_add of a
+   * single 1.
+   */
+  extern DYND_API callable scatter_add;
+  extern DYND_API callable scatter_max;
+
 } // namespace dynd::nd
 } // namespace dynd
@@ -10,7 +10,27 @@
 namespace dynd {
 namespace nd {
 
+  /**
+   * Writes an array into a bytes value in a self-describing binary format,
+   * which holds the datashape of the array followed by its data in aligned
+   * blocks. The array may have fixed and var dimensions, tuples, structs,
+   * options, strings, bytes and scalars.
+   */
   extern DYND_API callable serialize;
 
+  /**
+   * Reads an array written by nd::serialize from a bytes array. Blocks of
+   * data without strings or bytes are not copied, so the result points into
+   * ``buffer``, which it keeps alive. The result is read-only.
+   */
+  DYND_API array deserialize(const array &buffer);
+
+  /**
+   * Reads an array written by nd::serialize from ``size`` bytes at ``data``,
+   * for example a memory-mapped file. The ``owner`` memory block must keep
+   * the data alive, and is kept alive by the result.
+   */
+  DYND_API array deserialize(const char *data, size_t size, const memory_block &owner);
+
 } // namespace dynd::nd
 } // namespace dynd
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <stdexcept>
 
 #include <dynd/assignment.hpp>
@@ -751,6 +752,13 @@ namespace nd {
       // This child is the dst assign_na ckernel
       size_t m_dst_assign_na_offset;
       size_t m_value_assign_offset;
+      // The size of a value whose bytes, NA included, are copied as they are,
+      // as they can be for the same builtin value type, or 0 if each element
+      // is checked. The value assignment is not used for the copy, since one
+      // such as bool's normalizes the bytes and would turn an NA into a value.
+      size_t m_value_copy_size;
+
+      assignment_kernel(size_t value_copy_size = 0) : m_value_copy_size(value_copy_size) {}
 
       ~assignment_kernel() {
         // src_is_avail
@@ -762,6 +770,11 @@ namespace nd {
       }
 
       void single(char *dst, char *const *src) {
+        if (m_value_copy_size != 0) {
+          memcpy(dst, src[0], m_value_copy_size);
+          return;
+        }
+
         // Check whether the value is available
         // TODO: Would be nice to do this as a predicate
         //       instead of having to go through a dst pointer
@@ -790,6 +803,14 @@ namespace nd {
         kernel_strided_t value_assign_fn = value_assign->get_function<kernel_strided_t>();
         kernel_prefix *dst_assign_na = this->get_child(m_dst_assign_na_offset);
         kernel_strided_t dst_assign_na_fn = dst_assign_na->get_function<kernel_strided_t>();
+        if (m_value_copy_size != 0) {
+          const char *src0 = src[0];
+          for (size_t i = 0; i != count; ++i, dst += dst_stride, src0 += src_stride[0]) {
+            memcpy(dst, src0, m_value_copy_size);
+          }
+          return;
+        }
+
         // Process in chunks using the dynd default buffer size
         bool1 missing[DYND_BUFFER_CHUNK_SIZE];
         while (count > 0) {
@@ -1447,6 +1468,54 @@ namespace nd {
       }
     };
 
+    /**
+     * Assigns values of the category type to a categorical type with the
+     * given storage type, looking them up in the hash table of the categories.
+     * The strided version hashes a block of values before looking up any of
+     * them, so the lookups can overlap their cache misses.
+     */
+    template <typename StorageType>
+    struct categorical_assignment_kernel : base_strided_kernel<categorical_assignment_kernel<StorageType>, 1> {
+      ndt::type dst_categorical_tp;
+      const char *src_arrmeta;
+
+      categorical_assignment_kernel(const ndt::type &dst_tp, const char *src_arrmeta)
+          : dst_categorical_tp(dst_tp), src_arrmeta(src_arrmeta) {}
+
+      void single(char *dst, char *const *src) {
+        *reinterpret_cast<StorageType *>(dst) = static_cast<StorageType>(
+            dst_categorical_tp.extended<ndt::categorical_type>()->get_value_from_category(src_arrmeta, src[0]));
+      }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        const ndt::categorical_type *dst_tp = dst_categorical_tp.extended<ndt::categorical_type>();
+        const dynd::detail::category_hash_table &table = dst_tp->get_category_table();
+        uint64_t hashes[DYND_BUFFER_CHUNK_SIZE];
+
+        const char *src0 = src[0];
+        intptr_t src0_stride = src_stride[0];
+        for (size_t i = 0; i < count; i += DYND_BUFFER_CHUNK_SIZE) {
+          size_t size = std::min<size_t>(count - i, DYND_BUFFER_CHUNK_SIZE);
+
+          for (size_t j = 0; j < size; ++j) {
+            hashes[j] = table.hash(src0 + j * src0_stride);
+            table.prefetch(hashes[j]);
+          }
+
+          for (size_t j = 0; j < size; ++j) {
+            intptr_t index = table.find(src0, hashes[j]);
+            if (index < 0) {
+              dst_tp->throw_unrecognized_category(src_arrmeta, src0);
+            }
+            *reinterpret_cast<StorageType *>(dst) =
+                static_cast<StorageType>(dst_tp->get_value_from_category_index(index));
+            dst += dst_stride;
+            src0 += src0_stride;
+          }
+        }
+      }
+    };
+
   } // namespace dynd::nd::detail
 
   template <typename ReturnType, typename Arg0Type>
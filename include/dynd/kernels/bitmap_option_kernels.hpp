@@ -0,0 +1,319 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/bitmap_words.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/struct_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    /**
+     * Where the values and the validity words of a bitmap option,
+     * ``{values: N * T, valid: M * uint64}``, are, from its arrmeta.
+     */
+    struct bitmap_option_layout {
+      intptr_t size;
+      uintptr_t values_offset;
+      intptr_t values_stride;
+      uintptr_t valid_offset;
+      intptr_t valid_stride;
+
+      bitmap_option_layout(const ndt::type &tp, const char *arrmeta) {
+        const ndt::struct_type *sd = tp.extended<ndt::struct_type>();
+        const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+        const size_stride_t *values = reinterpret_cast<const size_stride_t *>(arrmeta + sd->get_arrmeta_offset(0));
+        const size_stride_t *valid = reinterpret_cast<const size_stride_t *>(arrmeta + sd->get_arrmeta_offset(1));
+        size = values->dim_size;
+        values_offset = data_offsets[0];
+        values_stride = values->stride;
+        valid_offset = data_offsets[1];
+        valid_stride = valid->stride;
+      }
+
+      uint64_t get_valid(const char *data, intptr_t word) const {
+        uint64_t res;
+        std::memcpy(&res, data + valid_offset + word * valid_stride, sizeof(uint64_t));
+        return res;
+      }
+
+      void set_valid(char *data, intptr_t word, uint64_t valid) const {
+        std::memcpy(data + valid_offset + word * valid_stride, &valid, sizeof(uint64_t));
+      }
+
+      // Copies the ``count`` values from ``begin`` into a block, which is padded with zeros
+      template <typename T>
+      void load(const char *data, intptr_t begin, intptr_t count, T *block) const {
+        const char *values = data + values_offset + begin * values_stride;
+        if (values_stride == static_cast<intptr_t>(sizeof(T))) {
+          std::memcpy(block, values, count * sizeof(T));
+        } else {
+          for (intptr_t i = 0; i < count; ++i) {
+            std::memcpy(block + i, values + i * values_stride, sizeof(T));
+          }
+        }
+        std::fill(block + count, block + bitmap_word_size, T(0));
+      }
+
+      template <typename T>
+      void store(char *data, intptr_t begin, intptr_t count, const T *block) const {
+        char *values = data + values_offset + begin * values_stride;
+        if (values_stride == static_cast<intptr_t>(sizeof(T))) {
+          std::memcpy(values, block, count * sizeof(T));
+        } else {
+          for (intptr_t i = 0; i < count; ++i) {
+            std::memcpy(values + i * values_stride, block + i, sizeof(T));
+          }
+        }
+      }
+    };
+
+    // Integers wrap around instead of overflowing, as the values under a clear bit are arbitrary
+    template <typename T, bool IsIntegral = std::is_integral<T>::value>
+    struct bitmap_arithmetic {
+      typedef std::make_unsigned_t<T> type;
+    };
+
+    template <typename T>
+    struct bitmap_arithmetic<T, false> {
+      typedef T type;
+    };
+
+    template <typename T>
+    using bitmap_arithmetic_type = typename bitmap_arithmetic<T>::type;
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * The operations of the bitmap option kernels compute a block of 64 values
+   * from every lane, valid or not, so the loop has no branches, and return
+   * the validity of the results.
+   */
+  struct bitmap_option_add {
+    template <typename T>
+    static uint64_t apply(const T *src0, const T *src1, T *dst, uint64_t valid) {
+      typedef detail::bitmap_arithmetic_type<T> U;
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        dst[i] = static_cast<T>(static_cast<U>(src0[i]) + static_cast<U>(src1[i]));
+      }
+      return valid;
+    }
+  };
+
+  struct bitmap_option_subtract {
+    template <typename T>
+    static uint64_t apply(const T *src0, const T *src1, T *dst, uint64_t valid) {
+      typedef detail::bitmap_arithmetic_type<T> U;
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        dst[i] = static_cast<T>(static_cast<U>(src0[i]) - static_cast<U>(src1[i]));
+      }
+      return valid;
+    }
+  };
+
+  struct bitmap_option_multiply {
+    template <typename T>
+    static uint64_t apply(const T *src0, const T *src1, T *dst, uint64_t valid) {
+      typedef detail::bitmap_arithmetic_type<T> U;
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        dst[i] = static_cast<T>(static_cast<U>(src0[i]) * static_cast<U>(src1[i]));
+      }
+      return valid;
+    }
+  };
+
+  /**
+   * Integer division by zero is missing, and the signed division of the
+   * lowest value by -1 wraps around to the lowest value, as the other
+   * operations do. Lanes that are missing, divide by zero or would overflow
+   * divide by one instead, so no lane traps.
+   */
+  struct bitmap_option_divide {
+    // The lanes whose division overflows, the lowest value divided by -1
+    template <typename T>
+    static std::enable_if_t<std::is_signed<T>::value, uint64_t> overflow(const T *src0, const T *src1) {
+      uint64_t res = 0;
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        res |= static_cast<uint64_t>((src0[i] == std::numeric_limits<T>::min()) & (src1[i] == T(-1))) << i;
+      }
+      return res;
+    }
+
+    template <typename T>
+    static std::enable_if_t<!std::is_signed<T>::value, uint64_t> overflow(const T *DYND_UNUSED(src0),
+                                                                           const T *DYND_UNUSED(src1)) {
+      return 0;
+    }
+
+    template <typename T>
+    static std::enable_if_t<std::is_integral<T>::value, uint64_t> apply(const T *src0, const T *src1, T *dst,
+                                                                         uint64_t valid) {
+      uint64_t nonzero = 0;
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        nonzero |= static_cast<uint64_t>(src1[i] != 0) << i;
+      }
+      valid &= nonzero;
+      // The lowest value divided by one is the wrapped result of dividing it by -1
+      uint64_t divide = valid & ~overflow(src0, src1);
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        dst[i] = src0[i] / (((divide >> i) & 1) ? src1[i] : T(1));
+      }
+      return valid;
+    }
+
+    template <typename T>
+    static std::enable_if_t<!std::is_integral<T>::value, uint64_t> apply(const T *src0, const T *src1, T *dst,
+                                                                          uint64_t valid) {
+      for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+        dst[i] = src0[i] / src1[i];
+      }
+      return valid;
+    }
+  };
+
+  /**
+   * Applies an operation to two bitmap options of the same size, a block of
+   * 64 values and one validity word at a time. The validity of the
+   * arguments is combined with a bitwise and of their words.
+   */
+  template <typename T, typename OpType>
+  struct bitmap_option_binary_kernel : base_strided_kernel<bitmap_option_binary_kernel<T, OpType>, 2> {
+    detail::bitmap_option_layout m_dst;
+    detail::bitmap_option_layout m_src0;
+    detail::bitmap_option_layout m_src1;
+
+    bitmap_option_binary_kernel(const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src0_tp,
+                                const char *src0_arrmeta, const ndt::type &src1_tp, const char *src1_arrmeta)
+        : m_dst(dst_tp, dst_arrmeta), m_src0(src0_tp, src0_arrmeta), m_src1(src1_tp, src1_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      T src0_block[detail::bitmap_word_size], src1_block[detail::bitmap_word_size], dst_block[detail::bitmap_word_size];
+      for (intptr_t begin = 0, word = 0; begin < m_dst.size; begin += detail::bitmap_word_size, ++word) {
+        intptr_t count = std::min(m_dst.size - begin, detail::bitmap_word_size);
+        m_src0.load(src[0], begin, count, src0_block);
+        m_src1.load(src[1], begin, count, src1_block);
+        uint64_t valid = m_src0.get_valid(src[0], word) & m_src1.get_valid(src[1], word) & detail::low_bits(count);
+        m_dst.set_valid(dst, word, OpType::apply(src0_block, src1_block, dst_block, valid));
+        m_dst.store(dst, begin, count, dst_block);
+      }
+    }
+  };
+
+  struct bitmap_option_sum {
+    template <typename T>
+    static T identity() {
+      return T(0);
+    }
+
+    template <typename T>
+    static T combine(T lhs, T rhs) {
+      typedef detail::bitmap_arithmetic_type<T> U;
+      return static_cast<T>(static_cast<U>(lhs) + static_cast<U>(rhs));
+    }
+  };
+
+  struct bitmap_option_min {
+    template <typename T>
+    static T identity() {
+      return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    }
+
+    template <typename T>
+    static T combine(T lhs, T rhs) {
+      return (rhs < lhs) ? rhs : lhs;
+    }
+  };
+
+  struct bitmap_option_max {
+    template <typename T>
+    static T identity() {
+      return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                  : std::numeric_limits<T>::lowest();
+    }
+
+    template <typename T>
+    static T combine(T lhs, T rhs) {
+      return (lhs < rhs) ? rhs : lhs;
+    }
+  };
+
+  /**
+   * Reduces the valid values of a bitmap option into a bitmap option of one
+   * value, which is missing when no value is valid, so every value of ``T``
+   * can be a result. Missing lanes are replaced by the identity of the
+   * reduction with a select, and the block is reduced into independent
+   * lanes, so the loop vectorizes for floating point too.
+   */
+  template <typename T, typename OpType>
+  struct bitmap_option_reduce_kernel : base_strided_kernel<bitmap_option_reduce_kernel<T, OpType>, 1> {
+    static const intptr_t lane_count = 8;
+
+    detail::bitmap_option_layout m_dst;
+    detail::bitmap_option_layout m_src0;
+
+    bitmap_option_reduce_kernel(const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src0_tp,
+                                const char *src0_arrmeta)
+        : m_dst(dst_tp, dst_arrmeta), m_src0(src0_tp, src0_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      const T identity = OpType::template identity<T>();
+      T lanes[lane_count];
+      std::fill(lanes, lanes + lane_count, identity);
+
+      T block[detail::bitmap_word_size];
+      uint64_t any_valid = 0;
+      for (intptr_t begin = 0, word = 0; begin < m_src0.size; begin += detail::bitmap_word_size, ++word) {
+        intptr_t count = std::min(m_src0.size - begin, detail::bitmap_word_size);
+        m_src0.load(src[0], begin, count, block);
+        uint64_t valid = m_src0.get_valid(src[0], word) & detail::low_bits(count);
+        any_valid |= valid;
+        for (intptr_t i = 0; i < detail::bitmap_word_size; ++i) {
+          lanes[i % lane_count] = OpType::combine(lanes[i % lane_count], ((valid >> i) & 1) ? block[i] : identity);
+        }
+      }
+
+      // A missing result is stored as 0, as to_bitmap_option stores it
+      T res = T(0);
+      if (any_valid != 0) {
+        res = lanes[0];
+        for (intptr_t i = 1; i < lane_count; ++i) {
+          res = OpType::combine(res, lanes[i]);
+        }
+      }
+      m_dst.store(dst, 0, 1, &res);
+      m_dst.set_valid(dst, 0, any_valid != 0);
+    }
+  };
+
+  /**
+   * Counts the valid values of a bitmap option, a word at a time.
+   */
+  struct bitmap_option_count_kernel : base_strided_kernel<bitmap_option_count_kernel, 1> {
+    detail::bitmap_option_layout m_src0;
+
+    bitmap_option_count_kernel(const ndt::type &src0_tp, const char *src0_arrmeta) : m_src0(src0_tp, src0_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      intptr_t word_count = detail::get_bitmap_word_count(m_src0.size);
+      int64_t res = 0;
+      for (intptr_t word = 0; word < word_count; ++word) {
+        res += detail::popcount(m_src0.get_valid(src[0], word) &
+                                detail::low_bits(m_src0.size - word * detail::bitmap_word_size));
+      }
+      *reinterpret_cast<int64_t *>(dst) = res;
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
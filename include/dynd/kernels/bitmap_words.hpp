@@ -0,0 +1,46 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    // The number of values that share one word of a bitmap
+    static const intptr_t bitmap_word_size = 64;
+
+    inline intptr_t get_bitmap_word_count(intptr_t size) { return (size + bitmap_word_size - 1) / bitmap_word_size; }
+
+    // A word with the low ``count`` bits set
+    inline uint64_t low_bits(intptr_t count) {
+      return (count >= bitmap_word_size) ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+    }
+
+    inline intptr_t popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(word);
+#else
+      word = word - ((word >> 1) & 0x5555555555555555ULL);
+      word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+      word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+      return static_cast<intptr_t>((word * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // The index of the lowest set bit of a word, which must not be zero
+    inline intptr_t count_trailing_zeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(word);
+#else
+      return popcount((word & (~word + 1)) - 1);
+#endif
+    }
+
+  } // namespace dynd::nd::detail
+} // namespace dynd::nd
+} // namespace dynd
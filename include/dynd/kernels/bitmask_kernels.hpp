@@ -0,0 +1,286 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/bitmap_words.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    /**
+     * Where the size and the words of a bitmask, ``{size: int64, bits: M * uint64}``,
+     * are, from its arrmeta.
+     */
+    struct bitmask_layout {
+      uintptr_t size_offset;
+      uintptr_t bits_offset;
+      intptr_t bits_stride;
+      intptr_t word_count;
+
+      bitmask_layout(const ndt::type &tp, const char *arrmeta) {
+        const ndt::struct_type *sd = tp.extended<ndt::struct_type>();
+        const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+        const size_stride_t *bits = reinterpret_cast<const size_stride_t *>(arrmeta + sd->get_arrmeta_offset(1));
+        size_offset = data_offsets[0];
+        bits_offset = data_offsets[1];
+        bits_stride = bits->stride;
+        word_count = bits->dim_size;
+      }
+
+      // The size of a bitmask, checking that it has a word for each 64 bits
+      intptr_t get_size(const char *data) const {
+        int64_t size;
+        std::memcpy(&size, data + size_offset, sizeof(int64_t));
+        if (size < 0 || get_bitmap_word_count(size) != word_count) {
+          std::stringstream ss;
+          ss << "bitmask: a size of " << size << " does not fit in " << word_count << " words";
+          throw std::invalid_argument(ss.str());
+        }
+
+        return static_cast<intptr_t>(size);
+      }
+
+      void set_size(char *data, intptr_t size) const {
+        int64_t size64 = size;
+        std::memcpy(data + size_offset, &size64, sizeof(int64_t));
+      }
+
+      uint64_t get_word(const char *data, intptr_t word) const {
+        uint64_t res;
+        std::memcpy(&res, data + bits_offset + word * bits_stride, sizeof(uint64_t));
+        return res;
+      }
+
+      // A word with the bits after ``size`` cleared
+      uint64_t get_word(const char *data, intptr_t word, intptr_t size) const {
+        return get_word(data, word) & low_bits(size - word * bitmap_word_size);
+      }
+
+      void set_word(char *data, intptr_t word, uint64_t bits) const {
+        std::memcpy(data + bits_offset + word * bits_stride, &bits, sizeof(uint64_t));
+      }
+    };
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Compares two ``N * T`` arrays into a bitmask, 64 values to a word. A
+   * block of values is compared in a loop without branches, each result
+   * shifted into its bit of the word, so no bool1 is ever stored.
+   */
+  template <typename T, typename OpType>
+  struct bitmask_compare_kernel : base_strided_kernel<bitmask_compare_kernel<T, OpType>, 2> {
+    detail::bitmask_layout m_dst;
+    intptr_t m_size;
+    intptr_t m_src0_stride;
+    intptr_t m_src1_stride;
+
+    bitmask_compare_kernel(const ndt::type &dst_tp, const char *dst_arrmeta, const char *src0_arrmeta,
+                           const char *src1_arrmeta)
+        : m_dst(dst_tp, dst_arrmeta), m_size(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->dim_size),
+          m_src0_stride(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->stride),
+          m_src1_stride(reinterpret_cast<const size_stride_t *>(src1_arrmeta)->stride) {}
+
+    // The values from ``src``, in place if they are contiguous and otherwise gathered into ``block``
+    static const T *load(const char *src, intptr_t stride, intptr_t count, T *block) {
+      if (stride == static_cast<intptr_t>(sizeof(T))) {
+        return reinterpret_cast<const T *>(src);
+      }
+
+      for (intptr_t i = 0; i < count; ++i) {
+        std::memcpy(block + i, src + i * stride, sizeof(T));
+      }
+      return block;
+    }
+
+    void single(char *dst, char *const *src) {
+      OpType op;
+      T src0_block[detail::bitmap_word_size], src1_block[detail::bitmap_word_size];
+      for (intptr_t begin = 0, word = 0; begin < m_size; begin += detail::bitmap_word_size, ++word) {
+        intptr_t count = std::min(m_size - begin, detail::bitmap_word_size);
+        const T *src0 = load(src[0] + begin * m_src0_stride, m_src0_stride, count, src0_block);
+        const T *src1 = load(src[1] + begin * m_src1_stride, m_src1_stride, count, src1_block);
+        uint64_t bits = 0;
+        for (intptr_t i = 0; i < count; ++i) {
+          bits |= static_cast<uint64_t>(op(src0[i], src1[i])) << i;
+        }
+        m_dst.set_word(dst, word, bits);
+      }
+      m_dst.set_size(dst, m_size);
+    }
+  };
+
+  /**
+   * Combines the words of two bitmasks of the same size with a bitwise
+   * operation, such as std::bit_and.
+   */
+  template <typename OpType>
+  struct bitmask_logical_kernel : base_strided_kernel<bitmask_logical_kernel<OpType>, 2> {
+    detail::bitmask_layout m_dst;
+    detail::bitmask_layout m_src0;
+    detail::bitmask_layout m_src1;
+
+    bitmask_logical_kernel(const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src0_tp,
+                           const char *src0_arrmeta, const ndt::type &src1_tp, const char *src1_arrmeta)
+        : m_dst(dst_tp, dst_arrmeta), m_src0(src0_tp, src0_arrmeta), m_src1(src1_tp, src1_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      intptr_t size = m_src0.get_size(src[0]);
+      if (m_src1.get_size(src[1]) != size) {
+        std::stringstream ss;
+        ss << "bitmask: the sizes " << size << " and " << m_src1.get_size(src[1]) << " do not match";
+        throw std::invalid_argument(ss.str());
+      }
+
+      OpType op;
+      for (intptr_t word = 0; word < m_dst.word_count; ++word) {
+        m_dst.set_word(dst, word, op(m_src0.get_word(src[0], word), m_src1.get_word(src[1], word)));
+      }
+      m_dst.set_size(dst, size);
+    }
+  };
+
+  /**
+   * Inverts a bitmask, leaving the bits after its size clear.
+   */
+  struct bitmask_logical_not_kernel : base_strided_kernel<bitmask_logical_not_kernel, 1> {
+    detail::bitmask_layout m_dst;
+    detail::bitmask_layout m_src0;
+
+    bitmask_logical_not_kernel(const ndt::type &dst_tp, const char *dst_arrmeta, const ndt::type &src0_tp,
+                               const char *src0_arrmeta)
+        : m_dst(dst_tp, dst_arrmeta), m_src0(src0_tp, src0_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      intptr_t size = m_src0.get_size(src[0]);
+      for (intptr_t word = 0; word < m_dst.word_count; ++word) {
+        uint64_t bits = ~m_src0.get_word(src[0], word);
+        m_dst.set_word(dst, word, bits & detail::low_bits(size - word * detail::bitmap_word_size));
+      }
+      m_dst.set_size(dst, size);
+    }
+  };
+
+  /**
+   * Counts the set bits of a bitmask, a word at a time.
+   */
+  struct bitmask_count_nonzero_kernel : base_strided_kernel<bitmask_count_nonzero_kernel, 1> {
+    detail::bitmask_layout m_src0;
+
+    bitmask_count_nonzero_kernel(const ndt::type &src0_tp, const char *src0_arrmeta) : m_src0(src0_tp, src0_arrmeta) {}
+
+    void single(char *dst, char *const *src) {
+      intptr_t size = m_src0.get_size(src[0]);
+      int64_t res = 0;
+      for (intptr_t word = 0; word < m_src0.word_count; ++word) {
+        res += detail::popcount(m_src0.get_word(src[0], word, size));
+      }
+      *reinterpret_cast<int64_t *>(dst) = res;
+    }
+  };
+
+  /**
+   * Counts the true values of a ``N * bool``.
+   */
+  struct bool_count_nonzero_kernel : base_strided_kernel<bool_count_nonzero_kernel, 1> {
+    intptr_t m_size;
+    intptr_t m_src0_stride;
+
+    bool_count_nonzero_kernel(const char *src0_arrmeta)
+        : m_size(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->dim_size),
+          m_src0_stride(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->stride) {}
+
+    void single(char *dst, char *const *src) {
+      const char *src0 = src[0];
+      int64_t res = 0;
+      for (intptr_t i = 0; i < m_size; ++i, src0 += m_src0_stride) {
+        res += (*src0 != 0);
+      }
+      *reinterpret_cast<int64_t *>(dst) = res;
+    }
+  };
+
+  /**
+   * Takes the elements of a ``N * T`` whose bits are set in a bitmask into a
+   * ``var * T``. Zero words are skipped whole, and the runs of set bits,
+   * found with count_trailing_zeros and merged across words, are each
+   * copied with a single strided call of the child.
+   */
+  struct bitmask_take_kernel : base_strided_kernel<bitmask_take_kernel, 2> {
+    const char *m_dst_meta;
+    intptr_t m_src0_size;
+    intptr_t m_src0_stride;
+    detail::bitmask_layout m_mask;
+
+    bitmask_take_kernel(const char *dst_arrmeta, const char *src0_arrmeta, const ndt::type &mask_tp,
+                        const char *mask_arrmeta)
+        : m_dst_meta(dst_arrmeta), m_src0_size(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->dim_size),
+          m_src0_stride(reinterpret_cast<const size_stride_t *>(src0_arrmeta)->stride),
+          m_mask(mask_tp, mask_arrmeta) {}
+
+    ~bitmask_take_kernel() { get_child()->destroy(); }
+
+    void single(char *dst, char *const *src) {
+      intptr_t size = m_mask.get_size(src[1]);
+      if (size != m_src0_size) {
+        std::stringstream ss;
+        ss << "bitmask take: source data and mask have different sizes, " << m_src0_size << " and " << size;
+        throw std::invalid_argument(ss.str());
+      }
+
+      intptr_t dst_size = 0;
+      for (intptr_t word = 0; word < m_mask.word_count; ++word) {
+        dst_size += detail::popcount(m_mask.get_word(src[1], word, size));
+      }
+
+      const ndt::var_dim_type::metadata_type *dst_md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta);
+      ndt::var_dim_type::data_type *vdd = reinterpret_cast<ndt::var_dim_type::data_type *>(dst);
+      vdd->begin = dst_md->blockref->alloc(dst_size);
+      vdd->size = dst_size;
+
+      kernel_prefix *child = get_child();
+      char *dst_ptr = vdd->begin;
+      intptr_t run_begin = 0, run_end = 0;
+      for (intptr_t word = 0; word < m_mask.word_count; ++word) {
+        intptr_t base = word * detail::bitmap_word_size;
+        uint64_t bits = m_mask.get_word(src[1], word, size);
+        while (bits != 0) {
+          intptr_t begin = detail::count_trailing_zeros(bits);
+          uint64_t rest = ~(bits >> begin);
+          intptr_t end = (rest == 0) ? detail::bitmap_word_size : begin + detail::count_trailing_zeros(rest);
+          if (base + begin != run_end) {
+            copy_run(child, dst_ptr, src[0], run_begin, run_end);
+            run_begin = base + begin;
+          }
+          run_end = base + end;
+          bits &= ~detail::low_bits(end);
+        }
+      }
+      copy_run(child, dst_ptr, src[0], run_begin, run_end);
+    }
+
+    void copy_run(kernel_prefix *child, char *&dst_ptr, char *src0, intptr_t begin, intptr_t end) {
+      if (end > begin) {
+        intptr_t dst_stride = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta)->stride;
+        char *child_src0 = src0 + begin * m_src0_stride;
+        child->strided(dst_ptr, dst_stride, &child_src0, &m_src0_stride, end - begin);
+        dst_ptr += (end - begin) * dst_stride;
+      }
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
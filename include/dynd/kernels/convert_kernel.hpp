@@ -6,6 +6,7 @@
 #pragma once
 
 #include <dynd/assignment.hpp>
+#include <dynd/shortvector.hpp>
 
 namespace dynd {
 namespace nd {
@@ -60,6 +61,21 @@ namespace nd {
               throw;
             }
           }
+          internal_initialize(DYND_BUFFER_CHUNK_SIZE);
+        }
+      }
+
+      // Puts the first ``count`` elements in the state nd::empty would leave them
+      void internal_initialize(size_t count)
+      {
+        uint32_t flags = m_type.get_flags();
+        if (flags & type_flag_zeroinit) {
+          memset(m_storage, 0, count * m_stride);
+        }
+        if (flags & type_flag_construct) {
+          for (size_t i = 0; i < count; ++i) {
+            m_type.extended()->data_construct(m_arrmeta, m_storage + i * m_stride);
+          }
         }
       }
 
@@ -121,6 +137,22 @@ namespace nd {
           m_type.extended()->arrmeta_reset_buffers(m_arrmeta);
         }
       }
+
+      /**
+       * Resets the first ``count`` elements of the buffer, along with the
+       * arrmeta, so they can be written again. This is a no-op for POD types.
+       */
+      void reset(size_t count = DYND_BUFFER_CHUNK_SIZE)
+      {
+        uint32_t flags = m_type.get_flags();
+        if (flags & (type_flag_blockref | type_flag_zeroinit | type_flag_construct | type_flag_destructor)) {
+          if (flags & type_flag_destructor) {
+            m_type.extended()->data_destruct_strided(m_arrmeta, m_storage, m_stride, count);
+          }
+          reset_arrmeta();
+          internal_initialize(count);
+        }
+      }
     };
 
     /**
@@ -131,8 +163,15 @@ namespace nd {
       intptr_t narg;
       std::vector<intptr_t> m_src_buf_ck_offsets;
       std::vector<buffer_storage> m_bufs;
+      // Scratch for the pointers and strides passed to the child, allocated once
+      std::vector<char *> m_buf_src;
+      std::vector<intptr_t> m_buf_stride;
 
-      convert_kernel(intptr_t narg) : narg(narg), m_src_buf_ck_offsets(this->narg), m_bufs(this->narg) {}
+      convert_kernel(intptr_t narg)
+          : narg(narg), m_src_buf_ck_offsets(this->narg), m_bufs(this->narg), m_buf_src(this->narg),
+            m_buf_stride(this->narg)
+      {
+      }
 
       void call(array *dst, const array *src)
       {
@@ -145,37 +184,38 @@ namespace nd {
 
       void single(char *dst, char *const *src)
       {
-        std::vector<char *> buf_src(narg);
         for (intptr_t i = 0; i < narg; ++i) {
           if (!m_bufs[i].is_null()) {
-            m_bufs[i].reset_arrmeta();
+            m_bufs[i].reset(1);
             kernel_prefix *ck = get_child(m_src_buf_ck_offsets[i]);
             ck->single(m_bufs[i].get_storage(), &src[i]);
-            buf_src[i] = m_bufs[i].get_storage();
+            m_buf_src[i] = m_bufs[i].get_storage();
           }
           else {
-            buf_src[i] = src[i];
+            m_buf_src[i] = src[i];
           }
         }
         kernel_prefix *child = get_child();
-        child->single(dst, &buf_src[0]);
+        child->single(dst, m_buf_src.data());
       }
 
       void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count)
       {
-        std::vector<char *> buf_src(narg);
-        std::vector<intptr_t> buf_stride(narg);
         kernel_prefix *child = get_child();
         kernel_strided_t child_fn = child->get_function<kernel_strided_t>();
 
+        // Unbuffered operands are passed straight through and advanced in
+        // place; buffered ones are converted a chunk at a time into storage
+        // this kernel owns
+        shortvector<char *> src_loop(narg, src);
         for (intptr_t i = 0; i < narg; ++i) {
           if (!m_bufs[i].is_null()) {
-            buf_src[i] = m_bufs[i].get_storage();
-            buf_stride[i] = m_bufs[i].get_stride();
+            m_buf_src[i] = m_bufs[i].get_storage();
+            m_buf_stride[i] = m_bufs[i].get_stride();
           }
           else {
-            buf_src[i] = src[i];
-            buf_stride[i] = src_stride[i];
+            m_buf_src[i] = src[i];
+            m_buf_stride[i] = src_stride[i];
           }
         }
 
@@ -183,24 +223,20 @@ namespace nd {
           size_t chunk_size = std::min(count, (size_t)DYND_BUFFER_CHUNK_SIZE);
           for (intptr_t i = 0; i < narg; ++i) {
             if (!m_bufs[i].is_null()) {
-              m_bufs[i].reset_arrmeta();
+              m_bufs[i].reset(chunk_size);
               kernel_prefix *ck = get_child(m_src_buf_ck_offsets[i]);
               kernel_strided_t ck_fn = ck->get_function<kernel_strided_t>();
-              ck_fn(ck, m_bufs[i].get_storage(), m_bufs[i].get_stride(), &src[i], &src_stride[i], chunk_size);
+              ck_fn(ck, m_bufs[i].get_storage(), m_bufs[i].get_stride(), &src_loop[i], &src_stride[i], chunk_size);
             }
           }
-          child_fn(child, dst, dst_stride, &buf_src[0], &buf_stride[0], chunk_size);
+          child_fn(child, dst, dst_stride, m_buf_src.data(), m_buf_stride.data(), chunk_size);
           for (intptr_t i = 0; i < narg; ++i) {
-            if (!m_bufs[i].is_null()) {
-              m_bufs[i].reset_arrmeta();
-              kernel_prefix *ck = get_child(m_src_buf_ck_offsets[i]);
-              kernel_strided_t ck_fn = ck->get_function<kernel_strided_t>();
-              ck_fn(ck, m_bufs[i].get_storage(), buf_stride[i], &src[i], &src_stride[i], chunk_size);
-            }
-            else {
-              buf_src[i] += chunk_size * buf_stride[i];
+            src_loop[i] += chunk_size * src_stride[i];
+            if (m_bufs[i].is_null()) {
+              m_buf_src[i] += chunk_size * m_buf_stride[i];
             }
           }
+          dst += chunk_size * dst_stride;
           count -= chunk_size;
         }
       }
@@ -0,0 +1,578 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <dynd/complex.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/parallel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  template <typename Real>
+  class fft_plan;
+
+  template <typename Real>
+  class real_fft_plan;
+
+  /**
+   * Returns the plan for complex transforms of length ``size`` in the given
+   * direction, from a process-wide cache, so the twiddle factors of a length
+   * are computed once. Plans work on contiguous values, so the strides and
+   * leading dimensions of the arrays being transformed are not part of the
+   * key. This is thread-safe.
+   */
+  template <typename Real>
+  DYND_API std::shared_ptr<const fft_plan<Real>> get_fft_plan(size_t size, bool inverse);
+
+  /**
+   * Returns the cached plan for transforms between ``size`` reals and the
+   * ``size / 2 + 1`` complex values of their Hermitian spectrum.
+   */
+  template <typename Real>
+  DYND_API std::shared_ptr<const real_fft_plan<Real>> get_real_fft_plan(size_t size, bool inverse);
+
+  namespace detail {
+
+    // Returns exp(-2 pi i k / n), or its conjugate for the inverse transform
+    template <typename Real>
+    complex<Real> fft_root(size_t k, size_t n, bool inverse) {
+      double theta = 6.283185307179586476925286766559005768 * static_cast<double>(k % n) / static_cast<double>(n);
+      return complex<Real>(static_cast<Real>(std::cos(theta)),
+                           static_cast<Real>(inverse ? std::sin(theta) : -std::sin(theta)));
+    }
+
+    template <typename Real>
+    complex<Real> fft_add(const complex<Real> &a, const complex<Real> &b) {
+      return complex<Real>(a.m_real + b.m_real, a.m_imag + b.m_imag);
+    }
+
+    template <typename Real>
+    complex<Real> fft_sub(const complex<Real> &a, const complex<Real> &b) {
+      return complex<Real>(a.m_real - b.m_real, a.m_imag - b.m_imag);
+    }
+
+    template <typename Real>
+    complex<Real> fft_mul(const complex<Real> &a, const complex<Real> &b) {
+      return complex<Real>(a.m_real * b.m_real - a.m_imag * b.m_imag, a.m_real * b.m_imag + a.m_imag * b.m_real);
+    }
+
+    template <typename Real>
+    complex<Real> fft_conj(const complex<Real> &a) {
+      return complex<Real>(a.m_real, -a.m_imag);
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * A plan for the discrete Fourier transform of one length, in one
+   * direction. The inverse transform is not normalized.
+   *
+   * The length is split into radices of 4, 2, 3 and any other primes up to
+   * ``max_radix``, and transformed by the Stockham autosort algorithm, one
+   * pass per radix. The passes go back and forth between the output and a
+   * work array and leave the result in order, and the innermost loop of each
+   * pass runs over contiguous values. Lengths with a larger prime factor are
+   * transformed with Bluestein's algorithm, as a convolution of a power of
+   * two length.
+   */
+  template <typename Real>
+  class fft_plan {
+  public:
+    typedef complex<Real> complex_type;
+
+    static const size_t max_radix = 64;
+
+  private:
+    struct pass {
+      size_t radix;
+      size_t length;
+      size_t stride;
+      size_t twiddle_offset;
+      size_t root_offset;
+    };
+
+    size_t m_size;
+    bool m_inverse;
+    std::vector<pass> m_passes;
+    std::vector<complex_type> m_twiddles;
+
+    // Used only by Bluestein's algorithm
+    size_t m_convolution_size;
+    std::shared_ptr<const fft_plan> m_forward;
+    std::shared_ptr<const fft_plan> m_backward;
+    std::vector<complex_type> m_chirp;
+    std::vector<complex_type> m_chirp_spectrum;
+
+    static std::vector<size_t> factor(size_t n) {
+      std::vector<size_t> radices;
+      if (n == 0) {
+        return radices;
+      }
+
+      for (; n % 4 == 0; n /= 4) {
+        radices.push_back(4);
+      }
+      for (; n % 2 == 0; n /= 2) {
+        radices.push_back(2);
+      }
+      for (size_t p = 3; p * p <= n; p += 2) {
+        for (; n % p == 0; n /= p) {
+          radices.push_back(p);
+        }
+      }
+      if (n > 1) {
+        radices.push_back(n);
+      }
+
+      return radices;
+    }
+
+    void init_bluestein() {
+      m_convolution_size = 1;
+      while (m_convolution_size < 2 * m_size - 1) {
+        m_convolution_size *= 2;
+      }
+      m_forward = get_fft_plan<Real>(m_convolution_size, false);
+      m_backward = get_fft_plan<Real>(m_convolution_size, true);
+
+      // w_k = exp(-pi i k^2 / n), with k^2 reduced mod 2 n incrementally
+      m_chirp.resize(m_size);
+      for (size_t k = 0, k2 = 0; k < m_size; ++k) {
+        m_chirp[k] = detail::fft_root<Real>(k2, 2 * m_size, m_inverse);
+        k2 = (k2 + 2 * k + 1) % (2 * m_size);
+      }
+
+      std::vector<complex_type> b(m_convolution_size), work(m_forward->work_size());
+      b[0] = detail::fft_conj(m_chirp[0]);
+      for (size_t k = 1; k < m_size; ++k) {
+        b[k] = b[m_convolution_size - k] = detail::fft_conj(m_chirp[k]);
+      }
+      m_chirp_spectrum.resize(m_convolution_size);
+      m_forward->execute(b.data(), m_chirp_spectrum.data(), work.data());
+
+      Real scale = static_cast<Real>(1) / static_cast<Real>(m_convolution_size);
+      for (complex_type &value : m_chirp_spectrum) {
+        value = complex_type(value.m_real * scale, value.m_imag * scale);
+      }
+    }
+
+    void execute_bluestein(const complex_type *in, complex_type *out, complex_type *work) const {
+      complex_type *a = work, *b = work + m_convolution_size, *sub_work = work + 2 * m_convolution_size;
+
+      for (size_t k = 0; k < m_size; ++k) {
+        a[k] = detail::fft_mul(in[k], m_chirp[k]);
+      }
+      std::fill(a + m_size, a + m_convolution_size, complex_type(0, 0));
+
+      m_forward->execute(a, b, sub_work);
+      for (size_t k = 0; k < m_convolution_size; ++k) {
+        b[k] = detail::fft_mul(b[k], m_chirp_spectrum[k]);
+      }
+      m_backward->execute(b, a, sub_work);
+
+      for (size_t k = 0; k < m_size; ++k) {
+        out[k] = detail::fft_mul(a[k], m_chirp[k]);
+      }
+    }
+
+    // Multiplies by -i for the forward transform, and i for the inverse
+    complex_type rotate(const complex_type &z) const {
+      return m_inverse ? complex_type(-z.m_imag, z.m_real) : complex_type(z.m_imag, -z.m_real);
+    }
+
+    void execute_pass(const pass &ps, const complex_type *x, complex_type *y) const {
+      const size_t r = ps.radix, m = ps.length / r, s = ps.stride;
+      const complex_type *w = m_twiddles.data() + ps.twiddle_offset;
+
+      switch (r) {
+      case 2:
+        for (size_t p = 0; p < m; ++p) {
+          const complex_type w1 = w[p];
+          for (size_t q = 0; q < s; ++q) {
+            complex_type a0 = x[q + s * p], a1 = x[q + s * (p + m)];
+            y[q + s * 2 * p] = detail::fft_add(a0, a1);
+            y[q + s * (2 * p + 1)] = detail::fft_mul(detail::fft_sub(a0, a1), w1);
+          }
+        }
+        break;
+      case 3: {
+        const Real sin3 = static_cast<Real>(m_inverse ? 0.866025403784438646763723170752936183
+                                                      : -0.866025403784438646763723170752936183);
+        for (size_t p = 0; p < m; ++p) {
+          const complex_type w1 = w[2 * p], w2 = w[2 * p + 1];
+          for (size_t q = 0; q < s; ++q) {
+            complex_type a0 = x[q + s * p], a1 = x[q + s * (p + m)], a2 = x[q + s * (p + 2 * m)];
+            complex_type t = detail::fft_add(a1, a2), d = detail::fft_sub(a1, a2);
+            complex_type u(a0.m_real - t.m_real / 2, a0.m_imag - t.m_imag / 2);
+            complex_type v(-sin3 * d.m_imag, sin3 * d.m_real);
+            y[q + s * 3 * p] = detail::fft_add(a0, t);
+            y[q + s * (3 * p + 1)] = detail::fft_mul(detail::fft_add(u, v), w1);
+            y[q + s * (3 * p + 2)] = detail::fft_mul(detail::fft_sub(u, v), w2);
+          }
+        }
+        break;
+      }
+      case 4:
+        for (size_t p = 0; p < m; ++p) {
+          const complex_type w1 = w[3 * p], w2 = w[3 * p + 1], w3 = w[3 * p + 2];
+          for (size_t q = 0; q < s; ++q) {
+            complex_type a0 = x[q + s * p], a1 = x[q + s * (p + m)], a2 = x[q + s * (p + 2 * m)],
+                         a3 = x[q + s * (p + 3 * m)];
+            complex_type t0 = detail::fft_add(a0, a2), t1 = detail::fft_sub(a0, a2), t2 = detail::fft_add(a1, a3),
+                         t3 = rotate(detail::fft_sub(a1, a3));
+            y[q + s * 4 * p] = detail::fft_add(t0, t2);
+            y[q + s * (4 * p + 1)] = detail::fft_mul(detail::fft_add(t1, t3), w1);
+            y[q + s * (4 * p + 2)] = detail::fft_mul(detail::fft_sub(t0, t2), w2);
+            y[q + s * (4 * p + 3)] = detail::fft_mul(detail::fft_sub(t1, t3), w3);
+          }
+        }
+        break;
+      default: {
+        const complex_type *roots = m_twiddles.data() + ps.root_offset;
+        complex_type a[max_radix];
+        for (size_t p = 0; p < m; ++p) {
+          for (size_t q = 0; q < s; ++q) {
+            for (size_t k = 0; k < r; ++k) {
+              a[k] = x[q + s * (p + k * m)];
+            }
+            for (size_t t = 0; t < r; ++t) {
+              complex_type b = a[0];
+              for (size_t k = 1, tk = t; k < r; ++k, tk = (tk + t) % r) {
+                b = detail::fft_add(b, detail::fft_mul(a[k], roots[tk]));
+              }
+              y[q + s * (r * p + t)] = t == 0 ? b : detail::fft_mul(b, w[(r - 1) * p + t - 1]);
+            }
+          }
+        }
+      }
+      }
+    }
+
+  public:
+    fft_plan(size_t size, bool inverse) : m_size(size), m_inverse(inverse), m_convolution_size(0) {
+      std::vector<size_t> radices = factor(size);
+      if (!radices.empty() && *std::max_element(radices.begin(), radices.end()) > max_radix) {
+        init_bluestein();
+        return;
+      }
+
+      // The twiddles of a pass of radix r over length L are w_L^(p t), for p < L / r and 0 < t < r
+      for (size_t i = 0, length = size, stride = 1; i < radices.size(); ++i) {
+        size_t r = radices[i], m = length / r;
+        m_passes.push_back({r, length, stride, m_twiddles.size(), 0});
+        for (size_t p = 0; p < m; ++p) {
+          for (size_t t = 1; t < r; ++t) {
+            m_twiddles.push_back(detail::fft_root<Real>(p * t, length, inverse));
+          }
+        }
+        if (r > 4) {
+          m_passes.back().root_offset = m_twiddles.size();
+          for (size_t t = 0; t < r; ++t) {
+            m_twiddles.push_back(detail::fft_root<Real>(t, r, inverse));
+          }
+        }
+
+        length = m;
+        stride *= r;
+      }
+    }
+
+    size_t size() const { return m_size; }
+
+    bool inverse() const { return m_inverse; }
+
+    /**
+     * The number of values of work space that execute needs.
+     */
+    size_t work_size() const { return m_convolution_size == 0 ? m_size : 3 * m_convolution_size; }
+
+    /**
+     * Transforms the ``size()`` contiguous values at ``in``, writing them to
+     * ``out``. The arrays may not overlap.
+     */
+    void execute(const complex_type *in, complex_type *out, complex_type *work) const {
+      if (m_convolution_size != 0) {
+        execute_bluestein(in, out, work);
+      } else if (m_passes.empty()) {
+        std::copy(in, in + m_size, out);
+      } else {
+        const complex_type *x = in;
+        for (size_t i = 0; i < m_passes.size(); ++i) {
+          // Alternate so that the last pass writes to out
+          complex_type *y = (m_passes.size() - 1 - i) % 2 == 0 ? out : work;
+          execute_pass(m_passes[i], x, y);
+          x = y;
+        }
+      }
+    }
+  };
+
+  /**
+   * A plan for the transform of ``size`` reals to the first ``size / 2 + 1``
+   * values of their spectrum, or the inverse. For an even size, the reals
+   * are packed into a complex transform of half the length, which is
+   * separated into the spectrum afterwards. The inverse transform is not
+   * normalized.
+   */
+  template <typename Real>
+  class real_fft_plan {
+  public:
+    typedef complex<Real> complex_type;
+
+  private:
+    size_t m_size;
+    bool m_inverse;
+    std::shared_ptr<const fft_plan<Real>> m_plan;
+    std::vector<complex_type> m_twiddles;
+
+    bool is_packed() const { return m_size % 2 == 0; }
+
+  public:
+    real_fft_plan(size_t size, bool inverse) : m_size(size), m_inverse(inverse) {
+      if (is_packed()) {
+        m_plan = get_fft_plan<Real>(size / 2, inverse);
+        for (size_t k = 0; k <= size / 2; ++k) {
+          m_twiddles.push_back(detail::fft_root<Real>(k, size, false));
+        }
+      } else {
+        m_plan = get_fft_plan<Real>(size, inverse);
+      }
+    }
+
+    size_t size() const { return m_size; }
+
+    bool inverse() const { return m_inverse; }
+
+    size_t work_size() const { return 2 * m_plan->size() + m_plan->work_size(); }
+
+    /**
+     * Transforms the ``size()`` reals at ``in`` to ``size() / 2 + 1`` values
+     * of their spectrum at ``out``.
+     */
+    void forward(const Real *in, complex_type *out, complex_type *work) const {
+      size_t n = m_plan->size();
+      complex_type *z = work, *spectrum = work + n;
+      if (is_packed()) {
+        for (size_t k = 0; k < n; ++k) {
+          z[k] = complex_type(in[2 * k], in[2 * k + 1]);
+        }
+      } else {
+        for (size_t k = 0; k < n; ++k) {
+          z[k] = complex_type(in[k], 0);
+        }
+      }
+      m_plan->execute(z, spectrum, work + 2 * n);
+
+      if (!is_packed()) {
+        std::copy(spectrum, spectrum + m_size / 2 + 1, out);
+        return;
+      }
+
+      // The spectra of the even and odd reals are E = (Z_k + conj(Z_(n-k))) / 2 and O = (Z_k - conj(Z_(n-k))) / 2i
+      for (size_t k = 0; k <= n; ++k) {
+        complex_type zk = spectrum[k % n], zc = detail::fft_conj(spectrum[(n - k) % n]);
+        const Real half = static_cast<Real>(0.5);
+        complex_type e(half * (zk.m_real + zc.m_real), half * (zk.m_imag + zc.m_imag));
+        complex_type o(half * (zk.m_imag - zc.m_imag), -half * (zk.m_real - zc.m_real));
+        out[k] = detail::fft_add(e, detail::fft_mul(m_twiddles[k], o));
+      }
+    }
+
+    /**
+     * Transforms ``size() / 2 + 1`` values of a Hermitian spectrum at ``in``
+     * to the ``size()`` reals at ``out``.
+     */
+    void backward(const complex_type *in, Real *out, complex_type *work) const {
+      size_t n = m_plan->size();
+      complex_type *z = work, *values = work + n;
+      if (is_packed()) {
+        for (size_t k = 0; k < n; ++k) {
+          complex_type xk = in[k], xc = detail::fft_conj(in[n - k]);
+          complex_type e = detail::fft_add(xk, xc);
+          complex_type o = detail::fft_mul(detail::fft_sub(xk, xc), detail::fft_conj(m_twiddles[k]));
+          z[k] = complex_type(e.m_real - o.m_imag, e.m_imag + o.m_real);
+        }
+      } else {
+        z[0] = in[0];
+        for (size_t k = 1; k <= n / 2; ++k) {
+          z[k] = in[k];
+          z[n - k] = detail::fft_conj(in[k]);
+        }
+      }
+      m_plan->execute(z, values, work + 2 * n);
+
+      if (is_packed()) {
+        for (size_t k = 0; k < n; ++k) {
+          out[2 * k] = values[k].m_real;
+          out[2 * k + 1] = values[k].m_imag;
+        }
+      } else {
+        for (size_t k = 0; k < n; ++k) {
+          out[k] = values[k].m_real;
+        }
+      }
+    }
+  };
+
+  namespace detail {
+
+    /**
+     * Transforms one row of complex values with an fft_plan.
+     */
+    template <typename Real>
+    struct complex_fft_row {
+      typedef complex<Real> complex_type;
+
+      std::shared_ptr<const fft_plan<Real>> plan;
+      Real scale;
+
+      size_t buffer_size() const { return 2 * plan->size() + plan->work_size(); }
+
+      void operator()(const char *src, intptr_t src_stride, char *dst, intptr_t dst_stride,
+                      complex_type *buffer) const {
+        size_t n = plan->size();
+        complex_type *in = buffer, *out = buffer + n;
+        for (size_t i = 0; i < n; ++i) {
+          in[i] = *reinterpret_cast<const complex_type *>(src + i * src_stride);
+        }
+        plan->execute(in, out, buffer + 2 * n);
+        for (size_t i = 0; i < n; ++i) {
+          *reinterpret_cast<complex_type *>(dst + i * dst_stride) =
+              complex_type(scale * out[i].m_real, scale * out[i].m_imag);
+        }
+      }
+    };
+
+    /**
+     * Transforms one row of reals to the first half of its spectrum.
+     */
+    template <typename Real>
+    struct real_fft_row {
+      typedef complex<Real> complex_type;
+
+      std::shared_ptr<const real_fft_plan<Real>> plan;
+      Real scale;
+
+      size_t buffer_size() const { return (plan->size() + 1) / 2 + plan->size() / 2 + 1 + plan->work_size(); }
+
+      void operator()(const char *src, intptr_t src_stride, char *dst, intptr_t dst_stride,
+                      complex_type *buffer) const {
+        size_t n = plan->size(), m = n / 2 + 1;
+        Real *in = reinterpret_cast<Real *>(buffer);
+        complex_type *out = buffer + (n + 1) / 2;
+        for (size_t i = 0; i < n; ++i) {
+          in[i] = *reinterpret_cast<const Real *>(src + i * src_stride);
+        }
+        plan->forward(in, out, out + m);
+        for (size_t i = 0; i < m; ++i) {
+          *reinterpret_cast<complex_type *>(dst + i * dst_stride) =
+              complex_type(scale * out[i].m_real, scale * out[i].m_imag);
+        }
+      }
+    };
+
+    /**
+     * Transforms the first half of a Hermitian spectrum back to a row of
+     * reals. A shorter row is padded with zeros, and a longer one cut off.
+     */
+    template <typename Real>
+    struct real_ifft_row {
+      typedef complex<Real> complex_type;
+
+      std::shared_ptr<const real_fft_plan<Real>> plan;
+      Real scale;
+      size_t src_size;
+
+      size_t buffer_size() const { return plan->size() / 2 + 1 + (plan->size() + 1) / 2 + plan->work_size(); }
+
+      void operator()(const char *src, intptr_t src_stride, char *dst, intptr_t dst_stride,
+                      complex_type *buffer) const {
+        size_t n = plan->size(), m = n / 2 + 1;
+        complex_type *in = buffer;
+        Real *out = reinterpret_cast<Real *>(buffer + m);
+        for (size_t i = 0; i < m; ++i) {
+          in[i] = i < src_size ? *reinterpret_cast<const complex_type *>(src + i * src_stride) : complex_type(0, 0);
+        }
+        plan->backward(in, out, buffer + m + (n + 1) / 2);
+        for (size_t i = 0; i < n; ++i) {
+          *reinterpret_cast<Real *>(dst + i * dst_stride) = scale * out[i];
+        }
+      }
+    };
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Applies a row transform along the last dimension of a fixed array,
+   * batched over the leading dimensions. Large batches are split between
+   * get_num_threads() threads, each with its own buffer.
+   */
+  template <typename RowTransformType>
+  struct fft_kernel : base_strided_kernel<fft_kernel<RowTransformType>, 1> {
+    typedef typename RowTransformType::complex_type complex_type;
+
+    static const size_t parallel_grain = 65536;
+
+    RowTransformType m_transform;
+    std::vector<intptr_t> m_shape;
+    std::vector<intptr_t> m_dst_strides;
+    std::vector<intptr_t> m_src0_strides;
+    intptr_t m_dst_stride;
+    intptr_t m_src0_stride;
+    size_t m_row_size;
+
+    fft_kernel(const RowTransformType &transform, intptr_t ndim, const char *dst_arrmeta, const char *src0_arrmeta)
+        : m_transform(transform) {
+      const size_stride_t *dst_ss = reinterpret_cast<const size_stride_t *>(dst_arrmeta);
+      const size_stride_t *src0_ss = reinterpret_cast<const size_stride_t *>(src0_arrmeta);
+      for (intptr_t i = 0; i < ndim - 1; ++i) {
+        m_shape.push_back(dst_ss[i].dim_size);
+        m_dst_strides.push_back(dst_ss[i].stride);
+        m_src0_strides.push_back(src0_ss[i].stride);
+      }
+      m_dst_stride = dst_ss[ndim - 1].stride;
+      m_src0_stride = src0_ss[ndim - 1].stride;
+      m_row_size = std::max<size_t>(dst_ss[ndim - 1].dim_size, src0_ss[ndim - 1].dim_size);
+    }
+
+    void transform_rows(char *dst, const char *src0, size_t begin, size_t end) const {
+      std::vector<complex_type> buffer(m_transform.buffer_size());
+      for (size_t row = begin; row < end; ++row) {
+        intptr_t dst_offset = 0, src0_offset = 0;
+        for (size_t i = m_shape.size(), j = row; i-- > 0; j /= m_shape[i]) {
+          dst_offset += (j % m_shape[i]) * m_dst_strides[i];
+          src0_offset += (j % m_shape[i]) * m_src0_strides[i];
+        }
+        m_transform(src0 + src0_offset, m_src0_stride, dst + dst_offset, m_dst_stride, buffer.data());
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      size_t nrow = 1;
+      for (intptr_t size : m_shape) {
+        nrow *= size;
+      }
+
+      const char *src0 = src[0];
+      size_t nchunk = std::min(std::min(get_num_threads(), nrow), nrow * m_row_size / parallel_grain);
+      if (nchunk > 1) {
+        parallel_for(nchunk, [this, dst, src0, nrow, nchunk](size_t i) {
+          transform_rows(dst, src0, nrow * i / nchunk, nrow * (i + 1) / nchunk);
+        });
+      } else {
+        transform_rows(dst, src0, 0, nrow);
+      }
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,49 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/uniform_kernel.hpp>
+#include <dynd/kernels/vector_math.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+
+    /**
+     * Reals exponentially distributed with mean ``scale``, by inverting the
+     * distribution function.
+     */
+    template <typename ReturnType>
+    struct exponential_distribution {
+      typedef ReturnType value_type;
+      typedef detail::unit_real<ReturnType> unit_type;
+
+      static const size_t words = unit_type::words;
+
+      ReturnType m_scale;
+
+      exponential_distribution(ReturnType scale) : m_scale(scale) {
+        if (!(scale > 0)) {
+          throw std::invalid_argument("exponential: the mean scale must be positive");
+        }
+      }
+
+      template <typename GeneratorType>
+      void operator()(const GeneratorType &DYND_UNUSED(g), uint32_t DYND_UNUSED(stream), uint64_t DYND_UNUSED(first),
+                      size_t size, const uint32_t *w, value_type *res) const {
+        for (size_t j = 0; j < size; ++j) {
+          // 1 - u is in (0, 1], so the logarithm is finite
+          res[j] = -m_scale * dynd::detail::fast_log(1 - unit_type::get(w + j * words));
+        }
+      }
+    };
+
+    template <typename ReturnType, typename GeneratorType>
+    using exponential_kernel = random_kernel<exponential_distribution<ReturnType>, GeneratorType>;
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,17 +5,38 @@
 
 #pragma once
 
+#include <cstring>
+
 #include <dynd/option.hpp>
 
 namespace dynd {
 namespace nd {
 
+  /**
+   * Forwards an NA in any of the arguments I to the result, and otherwise
+   * calls the child on the values.
+   *
+   * When the child can be called on an NA without failing, as it can for
+   * floating point values, whose NA is a NaN, the kernel is blockwise. It
+   * calls the child over a whole block of DYND_BUFFER_CHUNK_SIZE elements,
+   * combines the is_na masks of the arguments, and then assigns an NA over
+   * the runs of missing elements in the block. The children of a blockwise
+   * kernel are strided, and those of an elementwise kernel are single.
+   */
   template <intptr_t... I>
   struct forward_na_kernel : base_strided_kernel<forward_na_kernel<I...>, 2> {
     size_t is_na_offset[2];
     size_t assign_na_offset;
+    bool blockwise;
+
+    forward_na_kernel(bool blockwise = false) : blockwise(blockwise) {}
 
     void single(char *res, char *const *args) {
+      if (blockwise) {
+        static const intptr_t args_stride[2] = {0, 0};
+        return strided(res, 0, args, args_stride, 1);
+      }
+
       for (intptr_t i : std::array<intptr_t, sizeof...(I)>({I...})) {
         bool1 is_na;
         this->get_child(is_na_offset[i])->single(reinterpret_cast<char *>(&is_na), args + i);
@@ -30,6 +51,54 @@ namespace nd {
       // call the actual child
       this->get_child()->single(res, args);
     }
+
+    void strided(char *res, intptr_t res_stride, char *const *args, const intptr_t *args_stride, size_t count) {
+      if (!blockwise) {
+        return base_strided_kernel<forward_na_kernel<I...>, 2>::strided(res, res_stride, args, args_stride, count);
+      }
+
+      // The bool1 masks, as bytes that combine with a bitwise or
+      char missing[DYND_BUFFER_CHUNK_SIZE];
+      char is_na[DYND_BUFFER_CHUNK_SIZE];
+      char *args_copy[2] = {args[0], args[1]};
+      while (count > 0) {
+        size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+
+        // Compute every element, including the missing ones
+        this->get_child()->strided(res, res_stride, args_copy, args_stride, chunk_size);
+
+        // Combine the masks of the optional arguments
+        memset(missing, 0, chunk_size);
+        for (intptr_t i : std::array<intptr_t, sizeof...(I)>({I...})) {
+          this->get_child(is_na_offset[i])
+              ->strided(is_na, sizeof(bool1), args_copy + i, args_stride + i, chunk_size);
+          for (size_t j = 0; j < chunk_size; ++j) {
+            missing[j] |= is_na[j];
+          }
+        }
+
+        // Patch the runs of missing elements
+        const char *begin = missing;
+        for (size_t j = 0; j < chunk_size;) {
+          const char *run_begin = static_cast<const char *>(memchr(begin + j, 1, chunk_size - j));
+          if (run_begin == nullptr) {
+            break;
+          }
+          const char *run_end = static_cast<const char *>(memchr(run_begin, 0, begin + chunk_size - run_begin));
+          size_t run_end_index = (run_end == nullptr) ? chunk_size : static_cast<size_t>(run_end - begin);
+          this->get_child(assign_na_offset)
+              ->strided(res + (run_begin - begin) * res_stride, res_stride, nullptr, nullptr,
+                        run_end_index - (run_begin - begin));
+          j = run_end_index;
+        }
+
+        res += chunk_size * res_stride;
+        for (intptr_t j = 0; j < 2; ++j) {
+          args_copy[j] += chunk_size * args_stride[j];
+        }
+        count -= chunk_size;
+      }
+    }
   };
 
 } // namespace dynd::nd
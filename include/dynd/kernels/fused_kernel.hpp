@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <vector>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/convert_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace functional {
+
+    /**
+     * A kernel that evaluates a chain of elementwise child kernels in a
+     * single pass. The input is streamed in blocks of DYND_BUFFER_CHUNK_SIZE
+     * elements; for each block, every child runs in turn, writing into a
+     * kernel-owned buffer that later children read from, and the last child
+     * writes directly into the destination.
+     *
+     * The arguments of child ``k`` are ``m_args[m_arg_begin[k]]`` through
+     * ``m_args[m_arg_begin[k + 1] - 1]``. An index less than ``m_narg`` refers
+     * to an input of the fused kernel, and ``m_narg + j`` refers to the
+     * result of child ``j``.
+     */
+    // All methods are inlined, so this does not need to be declared DYND_API.
+    struct fused_kernel : base_strided_kernel<fused_kernel> {
+      size_t m_narg;
+      std::vector<size_t> m_arg_begin;
+      std::vector<size_t> m_args;
+      std::vector<intptr_t> m_offsets; // The offsets to the child kernels
+      std::vector<buffer_storage> m_bufs;
+      // Scratch space for the per-block argument pointers and strides
+      std::vector<char *> m_src;
+      std::vector<char *> m_arg_data;
+      std::vector<intptr_t> m_arg_stride;
+      std::vector<intptr_t> m_zero_stride;
+
+      fused_kernel(size_t narg, const std::vector<ndt::type> &buffer_tp, const std::vector<size_t> &arg_begin,
+                   const std::vector<size_t> &args)
+          : m_narg(narg), m_arg_begin(arg_begin), m_args(args), m_offsets(arg_begin.size() - 1, 0), m_src(narg),
+            m_arg_data(args.size()), m_arg_stride(args.size()), m_zero_stride(narg, 0) {
+        m_bufs.reserve(buffer_tp.size());
+        for (const ndt::type &tp : buffer_tp) {
+          m_bufs.emplace_back(tp);
+        }
+      }
+
+      ~fused_kernel() {
+        for (intptr_t offset : m_offsets) {
+          // A zero offset is a child that was never instantiated
+          if (offset != 0) {
+            get_child(offset)->destroy();
+          }
+        }
+      }
+
+      void call(array *dst, const array *src) {
+        for (size_t i = 0; i < m_narg; ++i) {
+          m_src[i] = const_cast<char *>(src[i].cdata());
+        }
+        strided(const_cast<char *>(dst->cdata()), 0, m_src.data(), m_zero_stride.data(), 1);
+      }
+
+      void single(char *dst, char *const *src) { strided(dst, 0, src, m_zero_stride.data(), 1); }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+        size_t nnode = m_offsets.size();
+
+        for (size_t j = 0; j < m_args.size(); ++j) {
+          size_t arg = m_args[j];
+          if (arg < m_narg) {
+            m_arg_stride[j] = src_stride[arg];
+          } else {
+            m_arg_data[j] = m_bufs[arg - m_narg].get_storage();
+            m_arg_stride[j] = m_bufs[arg - m_narg].get_stride();
+          }
+        }
+        for (size_t i = 0; i < m_narg; ++i) {
+          m_src[i] = src[i];
+        }
+
+        while (count) {
+          size_t chunk_size = std::min(count, static_cast<size_t>(DYND_BUFFER_CHUNK_SIZE));
+          for (size_t j = 0; j < m_args.size(); ++j) {
+            if (m_args[j] < m_narg) {
+              m_arg_data[j] = m_src[m_args[j]];
+            }
+          }
+
+          for (size_t k = 0; k < nnode; ++k) {
+            kernel_prefix *child = get_child(m_offsets[k]);
+            kernel_strided_t child_func = child->get_function<kernel_strided_t>();
+            if (k + 1 == nnode) {
+              child_func(child, dst, dst_stride, m_arg_data.data() + m_arg_begin[k],
+                         m_arg_stride.data() + m_arg_begin[k], chunk_size);
+            } else {
+              m_bufs[k].reset(chunk_size);
+              child_func(child, m_bufs[k].get_storage(), m_bufs[k].get_stride(), m_arg_data.data() + m_arg_begin[k],
+                         m_arg_stride.data() + m_arg_begin[k], chunk_size);
+            }
+          }
+
+          for (size_t i = 0; i < m_narg; ++i) {
+            m_src[i] += chunk_size * src_stride[i];
+          }
+          dst += chunk_size * dst_stride;
+          count -= chunk_size;
+        }
+      }
+    };
+
+  } // namespace dynd::nd::functional
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/vector_math.hpp>
+
+namespace dynd {
+namespace nd {
+
+  template <template <typename> class FuncType, typename T, size_t N>
+  struct math_kernel;
+
+  /**
+   * Applies a function from vector_math.hpp to blocks of up to
+   * DYND_BUFFER_CHUNK_SIZE elements. Strided inputs are gathered into a
+   * contiguous block first, so the fast pass always runs over contiguous
+   * memory, and the results go through a block buffer, so the libm pass for
+   * arguments outside the fast domain still sees the original inputs when
+   * ``dst`` aliases ``src``.
+   */
+  template <template <typename> class FuncType, typename T>
+  struct math_kernel<FuncType, T, 1> : base_strided_kernel<math_kernel<FuncType, T, 1>, 1> {
+    typedef FuncType<T> func_type;
+
+    bool m_fast;
+
+    math_kernel(bool fast) : m_fast(fast) {}
+
+    void single(char *dst, char *const *src) {
+      T x = *reinterpret_cast<T *>(src[0]);
+      *reinterpret_cast<T *>(dst) = (m_fast && func_type::in_domain(x)) ? func_type::fast(x) : func_type::precise(x);
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      T src0_buf[DYND_BUFFER_CHUNK_SIZE];
+      T res[DYND_BUFFER_CHUNK_SIZE];
+
+      const char *src0 = src[0];
+      for (size_t i = 0; i < count; i += DYND_BUFFER_CHUNK_SIZE) {
+        size_t size = std::min<size_t>(count - i, DYND_BUFFER_CHUNK_SIZE);
+
+        const T *x = reinterpret_cast<const T *>(src0);
+        if (src_stride[0] != static_cast<intptr_t>(sizeof(T))) {
+          for (size_t j = 0; j < size; ++j) {
+            src0_buf[j] = *reinterpret_cast<const T *>(src0 + j * src_stride[0]);
+          }
+          x = src0_buf;
+        }
+
+        if (m_fast) {
+          for (size_t j = 0; j < size; ++j) {
+            res[j] = func_type::fast(func_type::in_domain(x[j]) ? x[j] : func_type::safe());
+          }
+          for (size_t j = 0; j < size; ++j) {
+            if (!func_type::in_domain(x[j])) {
+              res[j] = func_type::precise(x[j]);
+            }
+          }
+        } else {
+          for (size_t j = 0; j < size; ++j) {
+            res[j] = func_type::precise(x[j]);
+          }
+        }
+
+        if (dst_stride == static_cast<intptr_t>(sizeof(T))) {
+          memcpy(dst, res, size * sizeof(T));
+        } else {
+          for (size_t j = 0; j < size; ++j) {
+            *reinterpret_cast<T *>(dst + j * dst_stride) = res[j];
+          }
+        }
+
+        dst += size * dst_stride;
+        src0 += size * src_stride[0];
+      }
+    }
+  };
+
+  template <template <typename> class FuncType, typename T>
+  struct math_kernel<FuncType, T, 2> : base_strided_kernel<math_kernel<FuncType, T, 2>, 2> {
+    typedef FuncType<T> func_type;
+
+    bool m_fast;
+
+    math_kernel(bool fast) : m_fast(fast) {}
+
+    void single(char *dst, char *const *src) {
+      T x = *reinterpret_cast<T *>(src[0]);
+      T y = *reinterpret_cast<T *>(src[1]);
+      *reinterpret_cast<T *>(dst) =
+          (m_fast && func_type::in_domain(x, y)) ? func_type::fast(x, y) : func_type::precise(x, y);
+    }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      T src0_buf[DYND_BUFFER_CHUNK_SIZE];
+      T src1_buf[DYND_BUFFER_CHUNK_SIZE];
+      T res[DYND_BUFFER_CHUNK_SIZE];
+
+      const char *src0 = src[0];
+      const char *src1 = src[1];
+      for (size_t i = 0; i < count; i += DYND_BUFFER_CHUNK_SIZE) {
+        size_t size = std::min<size_t>(count - i, DYND_BUFFER_CHUNK_SIZE);
+
+        const T *x = reinterpret_cast<const T *>(src0);
+        if (src_stride[0] != static_cast<intptr_t>(sizeof(T))) {
+          for (size_t j = 0; j < size; ++j) {
+            src0_buf[j] = *reinterpret_cast<const T *>(src0 + j * src_stride[0]);
+          }
+          x = src0_buf;
+        }
+        const T *y = reinterpret_cast<const T *>(src1);
+        if (src_stride[1] != static_cast<intptr_t>(sizeof(T))) {
+          for (size_t j = 0; j < size; ++j) {
+            src1_buf[j] = *reinterpret_cast<const T *>(src1 + j * src_stride[1]);
+          }
+          y = src1_buf;
+        }
+
+        if (m_fast) {
+          for (size_t j = 0; j < size; ++j) {
+            bool valid = func_type::in_domain(x[j], y[j]);
+            res[j] = func_type::fast(valid ? x[j] : func_type::safe(), valid ? y[j] : func_type::safe());
+          }
+          for (size_t j = 0; j < size; ++j) {
+            if (!func_type::in_domain(x[j], y[j])) {
+              res[j] = func_type::precise(x[j], y[j]);
+            }
+          }
+        } else {
+          for (size_t j = 0; j < size; ++j) {
+            res[j] = func_type::precise(x[j], y[j]);
+          }
+        }
+
+        if (dst_stride == static_cast<intptr_t>(sizeof(T))) {
+          memcpy(dst, res, size * sizeof(T));
+        } else {
+          for (size_t j = 0; j < size; ++j) {
+            *reinterpret_cast<T *>(dst + j * dst_stride) = res[j];
+          }
+        }
+
+        dst += size * dst_stride;
+        src0 += size * src_stride[0];
+        src1 += size * src_stride[1];
+      }
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,351 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <dynd/complex.hpp>
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/parallel.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * Which dimensions of the arguments and the result of a product
+   * ``C = A B`` form the rows (``m``), the contracted dimensions (``k``) and
+   * the columns (``n``), and which dimensions of the result are batched over.
+   * Each is a list of dimension indices, flattened in order. A batch
+   * dimension of an argument is -1 if the argument does not have it, and the
+   * argument is then broadcast, as it is if its dimension has size 1.
+   */
+  struct gemm_dims {
+    std::vector<intptr_t> dst_batch, src0_batch, src1_batch;
+    std::vector<intptr_t> src0_m, src0_k;
+    std::vector<intptr_t> src1_k, src1_n;
+    std::vector<intptr_t> dst_m, dst_n;
+  };
+
+  namespace detail {
+
+    /**
+     * The register and cache blocking of the product of values of type T.
+     * The micro-kernel accumulates an ``mr`` by ``nr`` block of the result
+     * from panels of A and B that are packed contiguously, so its loops have
+     * fixed bounds and compile to SIMD code. A block of ``mc`` by ``kc`` values
+     * of A is packed to stay in L2, and a panel of ``kc`` by ``nc`` values of B
+     * to stay in L3.
+     */
+    template <typename T>
+    struct gemm_traits {
+      typedef T real_type;
+
+      static const intptr_t lanes = 1;
+      static const intptr_t mr = 4;
+      static const intptr_t nr = 32 / sizeof(T);
+      static const intptr_t kc = 256;
+      static const intptr_t mc = 128;
+      static const intptr_t nc = 1024;
+
+      // Stores ``x`` in a panel that is ``width`` values wide
+      static void pack(real_type *dst, intptr_t DYND_UNUSED(width), T x) { *dst = x; }
+
+      static void micro_kernel(intptr_t kc, const real_type *a, const real_type *b, T *acc) {
+        real_type c[mr * nr] = {};
+        for (intptr_t p = 0; p < kc; ++p, a += mr, b += nr) {
+          for (intptr_t i = 0; i < mr; ++i) {
+            for (intptr_t j = 0; j < nr; ++j) {
+              c[i * nr + j] += a[i] * b[j];
+            }
+          }
+        }
+
+        std::copy(c, c + mr * nr, acc);
+      }
+    };
+
+    /**
+     * Complex values are packed with the real parts of a row of a panel
+     * followed by its imaginary parts, so the micro-kernel works on reals.
+     */
+    template <typename Real>
+    struct gemm_traits<complex<Real>> {
+      typedef Real real_type;
+
+      static const intptr_t lanes = 2;
+      static const intptr_t mr = 2;
+      static const intptr_t nr = 32 / sizeof(Real);
+      static const intptr_t kc = 128;
+      static const intptr_t mc = 128;
+      static const intptr_t nc = 1024;
+
+      static void pack(real_type *dst, intptr_t width, complex<Real> x) {
+        dst[0] = x.m_real;
+        dst[width] = x.m_imag;
+      }
+
+      static void micro_kernel(intptr_t kc, const real_type *a, const real_type *b, complex<Real> *acc) {
+        real_type c_real[mr * nr] = {};
+        real_type c_imag[mr * nr] = {};
+        for (intptr_t p = 0; p < kc; ++p, a += 2 * mr, b += 2 * nr) {
+          for (intptr_t i = 0; i < mr; ++i) {
+            for (intptr_t j = 0; j < nr; ++j) {
+              c_real[i * nr + j] += a[i] * b[j] - a[mr + i] * b[nr + j];
+              c_imag[i * nr + j] += a[i] * b[nr + j] + a[mr + i] * b[j];
+            }
+          }
+        }
+
+        for (intptr_t i = 0; i < mr * nr; ++i) {
+          acc[i] = complex<Real>(c_real[i], c_imag[i]);
+        }
+      }
+    };
+
+    template <typename T>
+    const intptr_t gemm_traits<T>::mr;
+
+    template <typename T>
+    const intptr_t gemm_traits<T>::nr;
+
+    template <typename T>
+    const intptr_t gemm_traits<T>::kc;
+
+    template <typename T>
+    const intptr_t gemm_traits<T>::mc;
+
+    template <typename T>
+    const intptr_t gemm_traits<T>::nc;
+
+    template <typename Real>
+    const intptr_t gemm_traits<complex<Real>>::mr;
+
+    template <typename Real>
+    const intptr_t gemm_traits<complex<Real>>::nr;
+
+    template <typename Real>
+    const intptr_t gemm_traits<complex<Real>>::kc;
+
+    template <typename Real>
+    const intptr_t gemm_traits<complex<Real>>::mc;
+
+    template <typename Real>
+    const intptr_t gemm_traits<complex<Real>>::nc;
+
+    // The byte offsets of the elements of the given dimensions, flattened in row-major order
+    inline std::vector<intptr_t> gemm_offsets(const size_stride_t *ss, const std::vector<intptr_t> &dims) {
+      std::vector<intptr_t> offsets(1, 0);
+      for (intptr_t dim : dims) {
+        std::vector<intptr_t> next;
+        next.reserve(offsets.size() * ss[dim].dim_size);
+        for (intptr_t offset : offsets) {
+          for (intptr_t i = 0; i < ss[dim].dim_size; ++i) {
+            next.push_back(offset + i * ss[dim].stride);
+          }
+        }
+        offsets.swap(next);
+      }
+
+      return offsets;
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Computes ``C = A B`` for each batch, where the rows, columns and
+   * contracted dimensions of the operands may be any of their dimensions, in
+   * any order. Each element is addressed through tables of the byte offsets
+   * of its row and column, so strided and permuted views need no copies.
+   *
+   * Large products are blocked for the cache, and the operands copied into
+   * contiguous panels for the micro-kernel as they are used. The output tiles
+   * are split across threads, each of which writes its own tiles, so the
+   * result does not depend on the number of threads. Small products skip
+   * the packing and accumulate each element of the result directly.
+   */
+  template <typename T>
+  struct gemm_kernel : base_strided_kernel<gemm_kernel<T>, 2> {
+    typedef detail::gemm_traits<T> traits;
+    typedef typename traits::real_type real_type;
+
+    // The number of multiply-adds below which the product is not packed
+    static const size_t naive_size = 4096;
+    // The number of multiply-adds that is worth a thread
+    static const size_t parallel_grain = 1 << 20;
+
+    std::vector<intptr_t> m_batch_shape;
+    std::vector<intptr_t> m_dst_batch_strides, m_src0_batch_strides, m_src1_batch_strides;
+    std::vector<intptr_t> m_src0_rows, m_src0_cols, m_src1_rows, m_src1_cols, m_dst_rows, m_dst_cols;
+
+    gemm_kernel(const gemm_dims &dims, const char *dst_arrmeta, const char *src0_arrmeta, const char *src1_arrmeta) {
+      const size_stride_t *dst_ss = reinterpret_cast<const size_stride_t *>(dst_arrmeta);
+      const size_stride_t *src0_ss = reinterpret_cast<const size_stride_t *>(src0_arrmeta);
+      const size_stride_t *src1_ss = reinterpret_cast<const size_stride_t *>(src1_arrmeta);
+
+      for (size_t i = 0; i < dims.dst_batch.size(); ++i) {
+        m_batch_shape.push_back(dst_ss[dims.dst_batch[i]].dim_size);
+        m_dst_batch_strides.push_back(dst_ss[dims.dst_batch[i]].stride);
+        m_src0_batch_strides.push_back(get_batch_stride(src0_ss, dims.src0_batch[i]));
+        m_src1_batch_strides.push_back(get_batch_stride(src1_ss, dims.src1_batch[i]));
+      }
+
+      m_src0_rows = detail::gemm_offsets(src0_ss, dims.src0_m);
+      m_src0_cols = detail::gemm_offsets(src0_ss, dims.src0_k);
+      m_src1_rows = detail::gemm_offsets(src1_ss, dims.src1_k);
+      m_src1_cols = detail::gemm_offsets(src1_ss, dims.src1_n);
+      m_dst_rows = detail::gemm_offsets(dst_ss, dims.dst_m);
+      m_dst_cols = detail::gemm_offsets(dst_ss, dims.dst_n);
+    }
+
+    static intptr_t get_batch_stride(const size_stride_t *ss, intptr_t dim) {
+      return (dim < 0 || ss[dim].dim_size == 1) ? 0 : ss[dim].stride;
+    }
+
+    intptr_t m() const { return m_dst_rows.size(); }
+
+    intptr_t n() const { return m_dst_cols.size(); }
+
+    intptr_t k() const { return m_src0_cols.size(); }
+
+    // Copies the rows [i0, i0 + mc) and columns [p0, p0 + kc) of A into panels of ``mr`` rows
+    void pack_src0(real_type *packed, const char *src0, intptr_t i0, intptr_t mc, intptr_t p0, intptr_t kc) const {
+      for (intptr_t ib = 0; ib < mc; ib += traits::mr, packed += traits::lanes * traits::mr * kc) {
+        for (intptr_t i = 0; i < traits::mr; ++i) {
+          if (ib + i < mc) {
+            const char *row = src0 + m_src0_rows[i0 + ib + i];
+            for (intptr_t p = 0; p < kc; ++p) {
+              traits::pack(packed + traits::lanes * traits::mr * p + i, traits::mr,
+                           *reinterpret_cast<const T *>(row + m_src0_cols[p0 + p]));
+            }
+          } else {
+            for (intptr_t p = 0; p < kc; ++p) {
+              traits::pack(packed + traits::lanes * traits::mr * p + i, traits::mr, T());
+            }
+          }
+        }
+      }
+    }
+
+    // Copies the rows [p0, p0 + kc) and columns [j0, j0 + nc) of B into panels of ``nr`` columns
+    void pack_src1(real_type *packed, const char *src1, intptr_t p0, intptr_t kc, intptr_t j0, intptr_t nc) const {
+      for (intptr_t jb = 0; jb < nc; jb += traits::nr, packed += traits::lanes * traits::nr * kc) {
+        intptr_t nr = std::min(traits::nr, nc - jb);
+        for (intptr_t p = 0; p < kc; ++p) {
+          const char *row = src1 + m_src1_rows[p0 + p];
+          real_type *dst = packed + traits::lanes * traits::nr * p;
+          for (intptr_t j = 0; j < nr; ++j) {
+            traits::pack(dst + j, traits::nr, *reinterpret_cast<const T *>(row + m_src1_cols[j0 + jb + j]));
+          }
+          for (intptr_t j = nr; j < traits::nr; ++j) {
+            traits::pack(dst + j, traits::nr, T());
+          }
+        }
+      }
+    }
+
+    // Computes the tile [i0, i0 + mc) x [j0, j0 + nc) of C, given buffers for the packed panels
+    void tile(char *dst, const char *src0, const char *src1, intptr_t i0, intptr_t mc, intptr_t j0, intptr_t nc,
+              real_type *packed_src0, real_type *packed_src1) const {
+      T acc[traits::mr * traits::nr];
+      for (intptr_t p0 = 0; p0 < k(); p0 += traits::kc) {
+        intptr_t kc = std::min(traits::kc, k() - p0);
+        pack_src1(packed_src1, src1, p0, kc, j0, nc);
+        pack_src0(packed_src0, src0, i0, mc, p0, kc);
+
+        for (intptr_t jb = 0; jb < nc; jb += traits::nr) {
+          intptr_t nr = std::min(traits::nr, nc - jb);
+          for (intptr_t ib = 0; ib < mc; ib += traits::mr) {
+            intptr_t mr = std::min(traits::mr, mc - ib);
+            traits::micro_kernel(kc, packed_src0 + traits::lanes * ib * kc, packed_src1 + traits::lanes * jb * kc,
+                                 acc);
+
+            for (intptr_t i = 0; i < mr; ++i) {
+              char *row = dst + m_dst_rows[i0 + ib + i];
+              for (intptr_t j = 0; j < nr; ++j) {
+                T &c = *reinterpret_cast<T *>(row + m_dst_cols[j0 + jb + j]);
+                c = (p0 == 0) ? acc[i * traits::nr + j] : c + acc[i * traits::nr + j];
+              }
+            }
+          }
+        }
+      }
+    }
+
+    void naive(char *dst, const char *src0, const char *src1) const {
+      for (intptr_t i = 0; i < m(); ++i) {
+        for (intptr_t j = 0; j < n(); ++j) {
+          T c = T();
+          for (intptr_t p = 0; p < k(); ++p) {
+            c = c + *reinterpret_cast<const T *>(src0 + m_src0_rows[i] + m_src0_cols[p]) *
+                        *reinterpret_cast<const T *>(src1 + m_src1_rows[p] + m_src1_cols[j]);
+          }
+          *reinterpret_cast<T *>(dst + m_dst_rows[i] + m_dst_cols[j]) = c;
+        }
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      size_t nbatch = 1;
+      for (intptr_t size : m_batch_shape) {
+        nbatch *= size;
+      }
+
+      size_t size = static_cast<size_t>(m()) * n() * std::max<intptr_t>(k(), 1);
+      if (size <= naive_size || k() == 0) {
+        for (size_t batch = 0; batch < nbatch; ++batch) {
+          intptr_t dst_offset, src0_offset, src1_offset;
+          get_batch_offsets(batch, dst_offset, src0_offset, src1_offset);
+          naive(dst + dst_offset, src[0] + src0_offset, src[1] + src1_offset);
+        }
+        return;
+      }
+
+      // Narrow the tiles if there are too few of them to go around the threads
+      size_t nthread = std::min(get_num_threads(), nbatch * size / parallel_grain);
+      intptr_t mtile = (m() + traits::mc - 1) / traits::mc;
+      intptr_t nc = std::min(traits::nc, n());
+      if (nthread > nbatch * mtile) {
+        intptr_t ntile = (nthread + nbatch * mtile - 1) / (nbatch * mtile);
+        nc = std::max(traits::nr, ((n() + ntile - 1) / ntile + traits::nr - 1) / traits::nr * traits::nr);
+      }
+      intptr_t ntile = (n() + nc - 1) / nc;
+
+      size_t ntask = nbatch * mtile * ntile;
+      const char *src0 = src[0], *src1 = src[1];
+      auto run = [this, dst, src0, src1, mtile, ntile, nc](size_t begin, size_t end) {
+        std::vector<real_type> packed_src0(traits::lanes * traits::mc * traits::kc);
+        std::vector<real_type> packed_src1(traits::lanes * (nc + traits::nr) * traits::kc);
+        for (size_t task = begin; task < end; ++task) {
+          intptr_t dst_offset, src0_offset, src1_offset;
+          get_batch_offsets(task / (mtile * ntile), dst_offset, src0_offset, src1_offset);
+          intptr_t i0 = (task / ntile) % mtile * traits::mc, j0 = task % ntile * nc;
+          tile(dst + dst_offset, src0 + src0_offset, src1 + src1_offset, i0, std::min(traits::mc, m() - i0), j0,
+               std::min(nc, n() - j0), packed_src0.data(), packed_src1.data());
+        }
+      };
+
+      size_t nchunk = std::min(nthread, ntask);
+      if (nchunk > 1) {
+        parallel_for(nchunk, [&run, ntask, nchunk](size_t i) { run(ntask * i / nchunk, ntask * (i + 1) / nchunk); });
+      } else {
+        run(0, ntask);
+      }
+    }
+
+    void get_batch_offsets(size_t batch, intptr_t &dst_offset, intptr_t &src0_offset, intptr_t &src1_offset) const {
+      dst_offset = src0_offset = src1_offset = 0;
+      for (size_t i = m_batch_shape.size(); i-- > 0; batch /= m_batch_shape[i]) {
+        intptr_t j = batch % m_batch_shape[i];
+        dst_offset += j * m_dst_batch_strides[i];
+        src0_offset += j * m_src0_batch_strides[i];
+        src1_offset += j * m_src1_batch_strides[i];
+      }
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
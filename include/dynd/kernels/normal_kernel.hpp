@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cmath>
+
+#include <dynd/kernels/uniform_kernel.hpp>
+#include <dynd/kernels/vector_math.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+
+    /**
+     * Reals normally distributed with mean ``loc`` and standard deviation
+     * ``scale``, by the Box-Muller transform. Elements ``2k`` and ``2k + 1``
+     * are the cosine and sine halves of one transform of the words of both
+     * elements, so a block costs one logarithm and one square root per pair.
+     * A pair split by the start or end of a block is recomputed from its
+     * words on both sides, which keeps the values independent of the
+     * blocking.
+     */
+    template <typename ReturnType>
+    struct normal_distribution {
+      typedef ReturnType value_type;
+      typedef detail::unit_real<ReturnType> unit_type;
+
+      static const size_t words = unit_type::words;
+
+      ReturnType m_loc;
+      ReturnType m_scale;
+
+      normal_distribution(ReturnType loc, ReturnType scale) : m_loc(loc), m_scale(scale) {
+        if (!(scale >= 0)) {
+          throw std::invalid_argument("normal: the standard deviation scale must be nonnegative");
+        }
+      }
+
+      // Writes the two values of the pair whose words start at ``w``
+      void transform(const uint32_t *w, ReturnType &c, ReturnType &s) const {
+        // 1 - u is in (0, 1], so the logarithm is finite
+        ReturnType r = m_scale * std::sqrt(-2 * dynd::detail::fast_log(1 - unit_type::get(w)));
+        ReturnType theta = static_cast<ReturnType>(6.283185307179586476925286766559005768) * unit_type::get(w + words);
+        c = m_loc + r * dynd::detail::fast_cos(theta);
+        s = m_loc + r * dynd::detail::fast_sin(theta);
+      }
+
+      template <typename GeneratorType>
+      void operator()(const GeneratorType &g, uint32_t stream, uint64_t first, size_t size, const uint32_t *w,
+                      value_type *res) const {
+        uint32_t pair[2 * words];
+        ReturnType c, s;
+
+        size_t j = 0;
+        if (first % 2 == 1) {
+          g.generate_words((first - 1) * words, stream, 0, 2 * words, pair);
+          transform(pair, c, res[0]);
+          j = 1;
+        }
+
+        for (; j + 1 < size; j += 2) {
+          transform(w + j * words, res[j], res[j + 1]);
+        }
+
+        if (j < size) {
+          g.generate_words((first + j) * words, stream, 0, 2 * words, pair);
+          transform(pair, res[j], s);
+        }
+      }
+    };
+
+    template <typename ReturnType, typename GeneratorType>
+    using normal_kernel = random_kernel<normal_distribution<ReturnType>, GeneratorType>;
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+namespace random {
+
+  /**
+   * The Philox4x32-10 counter-based generator of Salmon et al., "Parallel
+   * Random Numbers: As Easy as 1, 2, 3" (SC11). The generator is a keyed
+   * bijection from 128-bit counters to 128-bit blocks of output, so any block
+   * can be computed without computing the ones before it. This is what lets
+   * a kernel fill its output in parallel, and give the same result for the
+   * same seed however the work is split up.
+   *
+   * Here the key is a 64-bit seed, and the counter is made up of a 64-bit
+   * block index, a 32-bit stream, and 32 more bits which distributions use
+   * for draws beyond the first, such as in rejection sampling.
+   */
+  class philox4x32 {
+    uint32_t m_key[2];
+
+    static const size_t batch_size = 16;
+
+    static void mulhilo(uint32_t a, uint32_t b, uint32_t &hi, uint32_t &lo) {
+      uint64_t product = static_cast<uint64_t>(a) * b;
+      hi = static_cast<uint32_t>(product >> 32);
+      lo = static_cast<uint32_t>(product);
+    }
+
+  public:
+    static const size_t words_per_block = 4;
+
+    explicit philox4x32(uint64_t seed) {
+      m_key[0] = static_cast<uint32_t>(seed);
+      m_key[1] = static_cast<uint32_t>(seed >> 32);
+    }
+
+    /**
+     * Writes the output blocks for the counters ``(first + i, stream, extra)``,
+     * for ``i`` in ``[0, count)``, to ``out[4 * i]`` through
+     * ``out[4 * i + 3]``. The blocks are generated a batch at a time, with
+     * the rounds applied across the batch, so the compiler can vectorize them.
+     */
+    void generate(uint64_t first, uint32_t stream, uint32_t extra, size_t count, uint32_t *out) const {
+      uint32_t c0[batch_size], c1[batch_size], c2[batch_size], c3[batch_size];
+
+      for (size_t i = 0; i < count; i += batch_size) {
+        size_t size = std::min(count - i, batch_size);
+        for (size_t j = 0; j < batch_size; ++j) {
+          uint64_t block = first + i + j;
+          c0[j] = static_cast<uint32_t>(block);
+          c1[j] = static_cast<uint32_t>(block >> 32);
+          c2[j] = stream;
+          c3[j] = extra;
+        }
+
+        uint32_t k0 = m_key[0], k1 = m_key[1];
+        for (int round = 0; round < 10; ++round) {
+          for (size_t j = 0; j < batch_size; ++j) {
+            uint32_t hi0, lo0, hi1, lo1;
+            mulhilo(0xD2511F53, c0[j], hi0, lo0);
+            mulhilo(0xCD9E8D57, c2[j], hi1, lo1);
+            uint32_t x0 = hi1 ^ c1[j] ^ k0;
+            uint32_t x2 = hi0 ^ c3[j] ^ k1;
+            c0[j] = x0;
+            c1[j] = lo1;
+            c2[j] = x2;
+            c3[j] = lo0;
+          }
+          k0 += 0x9E3779B9;
+          k1 += 0xBB67AE85;
+        }
+
+        for (size_t j = 0; j < size; ++j) {
+          out[4 * (i + j)] = c0[j];
+          out[4 * (i + j) + 1] = c1[j];
+          out[4 * (i + j) + 2] = c2[j];
+          out[4 * (i + j) + 3] = c3[j];
+        }
+      }
+    }
+
+    /**
+     * Writes ``count`` words of the stream ``stream``, starting at word
+     * ``first``, to ``out``.
+     */
+    void generate_words(uint64_t first, uint32_t stream, uint32_t extra, size_t count, uint32_t *out) const {
+      uint32_t block[words_per_block * batch_size];
+
+      uint64_t block_index = first / words_per_block;
+      size_t skip = static_cast<size_t>(first % words_per_block);
+      while (count > 0) {
+        size_t nblock = std::min((skip + count + words_per_block - 1) / words_per_block, batch_size);
+        generate(block_index, stream, extra, nblock, block);
+
+        size_t size = std::min(nblock * words_per_block - skip, count);
+        std::copy(block + skip, block + skip + size, out);
+
+        out += size;
+        count -= size;
+        block_index += nblock;
+        skip = 0;
+      }
+    }
+  };
+
+  /**
+   * Returns a seed for a generator that the caller did not seed, different
+   * every time. This is thread-safe, and only reads the system's random
+   * device once.
+   */
+  inline uint64_t make_seed() {
+    static const uint64_t base = []() {
+      std::random_device device;
+      return (static_cast<uint64_t>(device()) << 32) | device();
+    }();
+    static std::atomic<uint64_t> count(0);
+
+    // The finalizer of SplitMix64, so that consecutive seeds are unrelated
+    uint64_t z = base + 0x9E3779B97F4A7C15ULL * ++count;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+} // namespace dynd::random
+} // namespace dynd
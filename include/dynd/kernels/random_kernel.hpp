@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstring>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/philox.hpp>
+#include <dynd/parallel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+
+    /**
+     * Fills its output with draws from a distribution, using a counter-based
+     * generator such as philox4x32. The ``i``-th element written by the
+     * kernel is computed from words ``i * DistributionType::words`` onwards of
+     * the generator's stream, so the output depends only on the seed, the
+     * stream and the position, and not on how the calls are split up. Long
+     * runs are split into chunks that get_num_threads() threads fill at the
+     * same time.
+     *
+     * A DistributionType has a ``value_type``, the number of 32-bit ``words``
+     * it uses per value, and a function that turns a block of words into a
+     * block of values. That function gets the generator too, for distributions
+     * that sometimes need more words than ``words``, like rejection samplers.
+     * Those draw the extra words from the same position with a nonzero
+     * ``extra`` counter word.
+     */
+    template <typename DistributionType, typename GeneratorType>
+    struct random_kernel : base_strided_kernel<random_kernel<DistributionType, GeneratorType>, 0> {
+      typedef typename DistributionType::value_type value_type;
+
+      static const size_t parallel_grain = 65536;
+
+      DistributionType m_distribution;
+      GeneratorType m_generator;
+      uint32_t m_stream;
+      uint64_t m_offset;
+
+      random_kernel(const DistributionType &distribution, uint64_t seed, uint32_t stream)
+          : m_distribution(distribution), m_generator(seed), m_stream(stream), m_offset(0) {}
+
+      void fill(char *dst, intptr_t dst_stride, uint64_t first, size_t count) const {
+        uint32_t words[DistributionType::words * DYND_BUFFER_CHUNK_SIZE];
+        value_type res[DYND_BUFFER_CHUNK_SIZE];
+
+        for (size_t i = 0; i < count; i += DYND_BUFFER_CHUNK_SIZE) {
+          size_t size = std::min<size_t>(count - i, DYND_BUFFER_CHUNK_SIZE);
+
+          m_generator.generate_words((first + i) * DistributionType::words, m_stream, 0,
+                                     size * DistributionType::words, words);
+          m_distribution(m_generator, m_stream, first + i, size, words, res);
+
+          if (dst_stride == static_cast<intptr_t>(sizeof(value_type))) {
+            memcpy(dst, res, size * sizeof(value_type));
+          } else {
+            for (size_t j = 0; j < size; ++j) {
+              *reinterpret_cast<value_type *>(dst + j * dst_stride) = res[j];
+            }
+          }
+          dst += size * dst_stride;
+        }
+      }
+
+      void single(char *dst, char *const *DYND_UNUSED(src)) {
+        fill(dst, sizeof(value_type), m_offset, 1);
+        ++m_offset;
+      }
+
+      void strided(char *dst, intptr_t dst_stride, char *const *DYND_UNUSED(src),
+                   const intptr_t *DYND_UNUSED(src_stride), size_t count) {
+        size_t nchunk = std::min(get_num_threads(), count / parallel_grain);
+        if (nchunk > 1) {
+          uint64_t offset = m_offset;
+          parallel_for(nchunk, [this, dst, dst_stride, offset, count, nchunk](size_t i) {
+            size_t begin = count * i / nchunk, end = count * (i + 1) / nchunk;
+            fill(dst + begin * dst_stride, dst_stride, offset + begin, end - begin);
+          });
+        } else {
+          fill(dst, dst_stride, m_offset, count);
+        }
+
+        m_offset += count;
+      }
+    };
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
@@ -0,0 +1,199 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <dynd/kernels/take_kernel.hpp>
+#include <dynd/parallel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace detail {
+
+    // Throws if the array a put or a scatter writes into in place is not writable
+    inline void check_scatter_dst(const array &dst) {
+      if ((dst.get_flags() & write_access_flag) == 0) {
+        std::stringstream ss;
+        ss << "cannot put or scatter into an array of type " << dst.get_type() << " that is not writable";
+        throw std::invalid_argument(ss.str());
+      }
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Assigns values to the elements of the ``N * T`` destination at the
+   * indices of a ``M * intptr``, the inverse of an indexed take, in the
+   * order of the indices, so the last value for an index repeated is the one
+   * that is kept. The values are a ``M * S`` or a single ``S`` assigned to
+   * every index. The destination must be writable, and all the indices are
+   * validated, before anything is assigned. Elements of the same builtin
+   * type as the values are copied directly, and others are assigned by the
+   * child, a single unary operation.
+   */
+  struct DYND_API put_kernel : base_strided_kernel<put_kernel, 2> {
+    intptr_t m_dst_dim_size, m_dst_stride;
+    intptr_t m_index_dim_size, m_index_stride;
+    intptr_t m_values_stride;
+    size_t m_element_size;
+
+    put_kernel(intptr_t dst_dim_size, intptr_t dst_stride, intptr_t index_dim_size, intptr_t index_stride,
+               intptr_t values_stride, size_t element_size)
+        : m_dst_dim_size(dst_dim_size), m_dst_stride(dst_stride), m_index_dim_size(index_dim_size),
+          m_index_stride(index_stride), m_values_stride(values_stride), m_element_size(element_size) {}
+
+    ~put_kernel() { get_child()->destroy(); }
+
+    void call(array *dst, const array *src) {
+      detail::check_scatter_dst(*dst);
+      base_strided_kernel<put_kernel, 2>::call(dst, src);
+    }
+
+    void single(char *dst, char *const *src) {
+      const char *index = src[0];
+      char *values = src[1];
+      detail::validate_indices(index, m_index_stride, m_index_dim_size, m_dst_dim_size);
+
+      if (m_element_size != 0) {
+        for (intptr_t i = 0; i < m_index_dim_size; ++i, index += m_index_stride, values += m_values_stride) {
+          intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
+          memcpy(dst + (ix + (ix < 0 ? m_dst_dim_size : 0)) * m_dst_stride, values, m_element_size);
+        }
+        return;
+      }
+
+      kernel_prefix *child = get_child();
+      kernel_single_t child_fn = child->get_function<kernel_single_t>();
+      for (intptr_t i = 0; i < m_index_dim_size; ++i, index += m_index_stride, values += m_values_stride) {
+        intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
+        child_fn(child, dst + (ix + (ix < 0 ? m_dst_dim_size : 0)) * m_dst_stride, &values);
+      }
+    }
+  };
+
+  struct scatter_add_op {
+    template <typename T>
+    static T identity() {
+      return T(0);
+    }
+
+    // Integers wrap around instead of overflowing
+    template <typename T>
+    static std::enable_if_t<std::is_integral<T>::value, T> combine(T lhs, T rhs) {
+      typedef std::make_unsigned_t<T> U;
+      return static_cast<T>(static_cast<U>(lhs) + static_cast<U>(rhs));
+    }
+
+    template <typename T>
+    static std::enable_if_t<!std::is_integral<T>::value, T> combine(T lhs, T rhs) {
+      return lhs + rhs;
+    }
+  };
+
+  struct scatter_max_op {
+    template <typename T>
+    static T identity() {
+      return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                  : std::numeric_limits<T>::lowest();
+    }
+
+    template <typename T>
+    static T combine(T lhs, T rhs) {
+      return (lhs < rhs) ? rhs : lhs;
+    }
+  };
+
+  /**
+   * Accumulates values into the elements of a contiguous or strided
+   * ``N * T`` destination at the indices of a ``M * intptr`` with an operation such as
+   * scatter_add_op, so repeated indices accumulate all of their values. The
+   * values are a ``M * T`` or a single ``T``.
+   *
+   * When there are many more indices than elements, as for a histogram, the
+   * indices are split into chunks across threads. Each chunk accumulates
+   * into its own buffer, which starts at the identity of the operation, so
+   * no two threads update the same element, and the buffers are then
+   * combined into the array, in parallel over ranges of its elements.
+   */
+  template <typename T, typename OpType>
+  struct scatter_kernel : base_strided_kernel<scatter_kernel<T, OpType>, 2> {
+    // The number of indices from which a scatter is split across threads
+    static const intptr_t parallel_scatter_threshold = 65536;
+
+    intptr_t m_dst_dim_size, m_dst_stride;
+    intptr_t m_index_dim_size, m_index_stride;
+    intptr_t m_values_stride;
+
+    scatter_kernel(intptr_t dst_dim_size, intptr_t dst_stride, intptr_t index_dim_size, intptr_t index_stride,
+                   intptr_t values_stride)
+        : m_dst_dim_size(dst_dim_size), m_dst_stride(dst_stride), m_index_dim_size(index_dim_size),
+          m_index_stride(index_stride), m_values_stride(values_stride) {}
+
+    void call(array *dst, const array *src) {
+      detail::check_scatter_dst(*dst);
+      base_strided_kernel<scatter_kernel<T, OpType>, 2>::call(dst, src);
+    }
+
+    // Accumulates the values at the indices ``[begin, end)`` into ``dst``
+    void accumulate(char *dst, intptr_t dst_stride, const char *index, const char *values, intptr_t begin,
+                    intptr_t end) const {
+      index += begin * m_index_stride;
+      values += begin * m_values_stride;
+      for (intptr_t i = begin; i < end; ++i, index += m_index_stride, values += m_values_stride) {
+        intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
+        T *element = reinterpret_cast<T *>(dst + (ix + (ix < 0 ? m_dst_dim_size : 0)) * dst_stride);
+        *element = OpType::combine(*element, *reinterpret_cast<const T *>(values));
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      const char *index = src[0];
+      const char *values = src[1];
+      intptr_t dst_dim_size = m_dst_dim_size, index_dim_size = m_index_dim_size;
+      detail::validate_indices(index, m_index_stride, index_dim_size, dst_dim_size);
+
+      size_t nchunk = 1;
+      if (index_dim_size >= parallel_scatter_threshold && dst_dim_size > 0) {
+        // Only split while the buffers are small next to the work they save
+        nchunk = std::min(get_num_threads(), static_cast<size_t>(index_dim_size / (4 * dst_dim_size)));
+      }
+      if (nchunk < 2) {
+        accumulate(dst, m_dst_stride, index, values, 0, index_dim_size);
+        return;
+      }
+
+      intptr_t chunk_size = (index_dim_size + nchunk - 1) / nchunk;
+      std::vector<T> buffers(nchunk * dst_dim_size, OpType::template identity<T>());
+      parallel_for(nchunk, [&](size_t c) {
+        intptr_t begin = c * chunk_size, end = std::min(index_dim_size, begin + chunk_size);
+        accumulate(reinterpret_cast<char *>(buffers.data() + c * dst_dim_size), sizeof(T), index, values, begin,
+                   end);
+      });
+
+      intptr_t range_size = (dst_dim_size + nchunk - 1) / nchunk;
+      parallel_for(nchunk, [&](size_t r) {
+        intptr_t begin = r * range_size, end = std::min(dst_dim_size, begin + range_size);
+        for (intptr_t j = begin; j < end; ++j) {
+          T *element = reinterpret_cast<T *>(dst + j * m_dst_stride);
+          T res = *element;
+          for (size_t c = 0; c < nchunk; ++c) {
+            res = OpType::combine(res, buffers[c * dst_dim_size + j]);
+          }
+          *element = res;
+        }
+      });
+    }
+  };
+
+} // namespace dynd::nd
+} // namespace dynd
@@ -5,23 +5,285 @@
 
 #pragma once
 
-#include <dynd/kernels/base_kernel.hpp>
+#include <cstring>
+#include <string>
+
+#include <dynd/assignment.hpp>
+#include <dynd/bytes.hpp>
 #include <dynd/kernels/base_strided_kernel.hpp>
-#include <dynd/types/scalar_kind_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/tuple_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
 
 namespace dynd {
 namespace nd {
+  namespace detail {
+
+    /**
+     * The binary format of nd::serialize starts with this header, followed by
+     * the datashape of the array. The value of the array comes next, at
+     * ``root_offset``, in the default layout of its type. Each var_dim,
+     * string or bytes value in it is replaced by a serialize_ref to the
+     * elements or characters it refers to, which are stored after it in
+     * blocks aligned for their type. All offsets are from the start of the
+     * header, and all values are in the byte order of the machine that wrote
+     * them.
+     */
+    struct serialize_header {
+      char magic[8];
+      uint32_t version;
+      uint32_t byte_order;
+      uint64_t root_offset;
+      uint64_t datashape_size;
+    };
+
+    struct serialize_ref {
+      uint64_t offset;
+      uint64_t size;
+    };
+
+    static const char serialize_magic[8] = {'D', 'Y', 'N', 'D', 'B', 'I', 'N', '\0'};
+    static const uint32_t serialize_version = 1;
+    static const uint32_t serialize_byte_order = 0x01020304;
+    // The value is aligned for SIMD loads of it in place
+    static const size_t serialize_root_alignment = 64;
+
+    // Whether values of the type refer to data outside of them
+    inline bool has_references(const ndt::type &tp) {
+      return (tp.get_flags() & (type_flag_blockref | type_flag_destructor)) != 0;
+    }
+
+    // Calls ``f(field_tp, field_arrmeta, field_offset)`` for each field of a tuple or struct
+    template <typename FuncType>
+    void for_each_field(const ndt::type &tp, const char *arrmeta, FuncType f) {
+      const std::vector<ndt::type> &field_tps = (tp.get_id() == struct_id)
+                                                    ? tp.extended<ndt::struct_type>()->get_field_types()
+                                                    : tp.extended<ndt::tuple_type>()->get_field_types();
+      const std::vector<uintptr_t> &arrmeta_offsets = (tp.get_id() == struct_id)
+                                                          ? tp.extended<ndt::struct_type>()->get_arrmeta_offsets()
+                                                          : tp.extended<ndt::tuple_type>()->get_arrmeta_offsets();
+      const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(arrmeta);
+      for (size_t i = 0; i < field_tps.size(); ++i) {
+        f(field_tps[i], arrmeta + arrmeta_offsets[i], data_offsets[i]);
+      }
+    }
+
+    inline void check_serializable(const ndt::type &tp) {
+      switch (tp.get_id()) {
+      case fixed_dim_id:
+      case var_dim_id:
+        check_serializable(tp.extended<ndt::base_dim_type>()->get_element_type());
+        return;
+      case tuple_id:
+      case struct_id:
+        for (const ndt::type &field_tp : (tp.get_id() == struct_id)
+                                             ? tp.extended<ndt::struct_type>()->get_field_types()
+                                             : tp.extended<ndt::tuple_type>()->get_field_types()) {
+          check_serializable(field_tp);
+        }
+        return;
+      case option_id:
+        check_serializable(tp.extended<ndt::option_type>()->get_value_type());
+        return;
+      case fixed_bytes_id:
+      case bytes_id:
+      case fixed_string_id:
+      case string_id:
+        return;
+      default:
+        if (tp.is_builtin()) {
+          return;
+        }
+
+        std::stringstream ss;
+        ss << "cannot serialize values of type " << tp;
+        throw type_error(ss.str());
+      }
+    }
+
+    // Whether the arrmeta describes the default layout of the type
+    inline bool is_default_layout(const ndt::type &tp, const char *arrmeta) {
+      switch (tp.get_id()) {
+      case fixed_dim_id: {
+        const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+        const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+        return (ss->dim_size <= 1 || ss->stride == static_cast<intptr_t>(element_tp.get_default_data_size())) &&
+               is_default_layout(element_tp, arrmeta + sizeof(size_stride_t));
+      }
+      case var_dim_id: {
+        const ndt::var_dim_type::metadata_type *md =
+            reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+        const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+        return md->stride == static_cast<intptr_t>(element_tp.get_default_data_size()) &&
+               is_default_layout(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type));
+      }
+      case tuple_id:
+      case struct_id: {
+        bool res = true;
+        size_t default_offset = 0;
+        for_each_field(tp, arrmeta, [&](const ndt::type &field_tp, const char *field_arrmeta, uintptr_t offset) {
+          default_offset = inc_to_alignment(default_offset, field_tp.get_data_alignment());
+          res = res && offset == default_offset && is_default_layout(field_tp, field_arrmeta);
+          default_offset += field_tp.get_default_data_size();
+        });
+        return res;
+      }
+      case option_id:
+        return is_default_layout(tp.extended<ndt::option_type>()->get_value_type(), arrmeta);
+      default:
+        return true;
+      }
+    }
+
+    /**
+     * Writes an array in the binary format of nd::serialize. A writer without
+     * an output only counts the bytes, so the output can be allocated once.
+     */
+    class binary_writer {
+      char *m_data;
+      size_t m_size;
+
+    public:
+      binary_writer(char *data) : m_data(data), m_size(0) {}
+
+      size_t size() const { return m_size; }
+
+      // Writes the header and a value in the default layout of its type
+      void write(const ndt::type &tp, const char *arrmeta, const char *data) {
+        std::string datashape = tp.str();
+
+        serialize_header header;
+        std::memcpy(header.magic, serialize_magic, sizeof(serialize_magic));
+        header.version = serialize_version;
+        header.byte_order = serialize_byte_order;
+        header.root_offset = inc_to_alignment(sizeof(serialize_header) + datashape.size(), serialize_root_alignment);
+        header.datashape_size = datashape.size();
+        append(reinterpret_cast<const char *>(&header), sizeof(serialize_header), 1);
+        append(datashape.data(), datashape.size(), 1);
+
+        write_block(tp, arrmeta, data, 1, serialize_root_alignment);
+      }
+
+      size_t append(const char *data, size_t size, size_t alignment) {
+        size_t offset = inc_to_alignment(m_size, alignment);
+        if (m_data != NULL) {
+          std::memset(m_data + m_size, 0, offset - m_size);
+          if (size > 0) {
+            std::memcpy(m_data + offset, data, size);
+          }
+        }
+        m_size = offset + size;
+
+        return offset;
+      }
+
+      // Writes ``count`` contiguous values, then the data they refer to
+      size_t write_block(const ndt::type &tp, const char *arrmeta, const char *data, size_t count, size_t alignment) {
+        size_t size = tp.get_default_data_size();
+        size_t offset = append(data, count * size, alignment);
+        if (has_references(tp)) {
+          for (size_t i = 0; i < count; ++i) {
+            write_references(tp, arrmeta, data + i * size, offset + i * size);
+          }
+        }
+
+        return offset;
+      }
+
+      void write_ref(size_t offset, size_t ref_offset, size_t ref_size) {
+        if (m_data != NULL) {
+          serialize_ref ref = {ref_offset, ref_size};
+          std::memcpy(m_data + offset, &ref, sizeof(serialize_ref));
+        }
+      }
+
+      // Replaces the references in the value written at ``offset`` by the offsets of what they refer to
+      void write_references(const ndt::type &tp, const char *arrmeta, const char *data, size_t offset) {
+        switch (tp.get_id()) {
+        case fixed_dim_id: {
+          const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+          const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+          for (intptr_t i = 0; i < ss->dim_size; ++i) {
+            write_references(element_tp, arrmeta + sizeof(size_stride_t), data + i * ss->stride,
+                             offset + i * ss->stride);
+          }
+          break;
+        }
+        case var_dim_id: {
+          const ndt::var_dim_type::metadata_type *md =
+              reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+          const ndt::var_dim_type::data_type *d = reinterpret_cast<const ndt::var_dim_type::data_type *>(data);
+          const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+          size_t block = write_block(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type),
+                                     d->begin + md->offset, d->size, element_tp.get_data_alignment());
+          write_ref(offset, block, d->size);
+          break;
+        }
+        case tuple_id:
+        case struct_id:
+          for_each_field(tp, arrmeta,
+                         [&](const ndt::type &field_tp, const char *field_arrmeta, uintptr_t field_offset) {
+                           write_references(field_tp, field_arrmeta, data + field_offset, offset + field_offset);
+                         });
+          break;
+        case option_id:
+          write_references(tp.extended<ndt::option_type>()->get_value_type(), arrmeta, data, offset);
+          break;
+        case string_id: {
+          const string *s = reinterpret_cast<const string *>(data);
+          write_ref(offset, append(s->data(), s->size(), 1), s->size());
+          break;
+        }
+        case bytes_id: {
+          const bytes *b = reinterpret_cast<const bytes *>(data);
+          write_ref(offset, append(b->data(), b->size(), 1), b->size());
+          break;
+        }
+        default:
+          break;
+        }
+      }
+    };
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Writes its argument into a bytes value in the binary format of
+   * nd::serialize. The output is measured first and allocated once, and the
+   * data of the argument is copied in contiguous blocks. A view that is not
+   * in the default layout of its type is copied into that layout first.
+   */
+  struct serialize_kernel : base_strided_kernel<serialize_kernel, 1> {
+    ndt::type m_src0_tp;
+    const char *m_src0_arrmeta;
+
+    serialize_kernel(const ndt::type &src0_tp, const char *src0_arrmeta)
+        : m_src0_tp(src0_tp), m_src0_arrmeta(src0_arrmeta) {}
 
-  template <typename Arg0Type>
-  struct serialize_kernel;
+    void single(char *dst, char *const *src) {
+      const char *arrmeta = m_src0_arrmeta;
+      const char *data = src[0];
 
-  template <>
-  struct serialize_kernel<ndt::scalar_kind_type> : base_strided_kernel<serialize_kernel<ndt::scalar_kind_type>, 1> {
-    size_t data_size;
+      array copy;
+      if (!detail::is_default_layout(m_src0_tp, m_src0_arrmeta)) {
+        copy = empty(m_src0_tp);
+        array error_mode = assign_error_default;
+        assign->call(m_src0_tp, copy->metadata(), copy.data(), 1, &m_src0_tp, &m_src0_arrmeta, src, 1, &error_mode,
+                     std::map<std::string, ndt::type>());
+        arrmeta = copy->metadata();
+        data = copy.cdata();
+      }
 
-    serialize_kernel(size_t data_size) : data_size(data_size) {}
+      detail::binary_writer counter(NULL);
+      counter.write(m_src0_tp, arrmeta, data);
 
-    void single(char *dst, char *const *src) { reinterpret_cast<bytes *>(dst)->append(src[0], data_size); }
+      bytes *res = reinterpret_cast<bytes *>(dst);
+      res->resize(counter.size());
+      detail::binary_writer(res->data()).write(m_src0_tp, arrmeta, data);
+    }
   };
 
 } // namespace dynd::nd
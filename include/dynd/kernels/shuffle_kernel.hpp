@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cstring>
+
+#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/uniform_kernel.hpp>
+
+namespace dynd {
+namespace nd {
+  namespace random {
+    namespace detail {
+
+      // Exchanges two elements of ``size`` bytes
+      inline void swap_elements(char *a, char *b, size_t size) {
+        switch (size) {
+        case 1:
+          std::swap(*a, *b);
+          break;
+        case 2:
+          std::swap(*reinterpret_cast<uint16_t *>(a), *reinterpret_cast<uint16_t *>(b));
+          break;
+        case 4:
+          std::swap(*reinterpret_cast<uint32_t *>(a), *reinterpret_cast<uint32_t *>(b));
+          break;
+        case 8:
+          std::swap(*reinterpret_cast<uint64_t *>(a), *reinterpret_cast<uint64_t *>(b));
+          break;
+        default: {
+          char tmp[64];
+          for (size_t i = 0; i < size; i += sizeof(tmp)) {
+            size_t n = std::min(size - i, sizeof(tmp));
+            memcpy(tmp, a + i, n);
+            memcpy(a + i, b + i, n);
+            memcpy(b + i, tmp, n);
+          }
+        }
+        }
+      }
+
+      /**
+       * Shuffles ``size`` elements of ``element_size`` bytes in place by the
+       * Fisher-Yates algorithm. Step ``k`` exchanges element ``size - 1 - k``
+       * with one chosen uniformly from the first ``size - k``, using words
+       * ``2 k`` and ``2 k + 1`` of the stream. The choices are drawn a block
+       * at a time, and the elements they pick are prefetched a few steps
+       * ahead of the exchanges, which dominate for large arrays.
+       */
+      template <typename GeneratorType>
+      void shuffle(const GeneratorType &g, uint32_t stream, char *data, intptr_t size, intptr_t stride,
+                   size_t element_size) {
+        static const size_t prefetch_distance = 8;
+
+        uint32_t words[2 * DYND_BUFFER_CHUNK_SIZE];
+        uint64_t targets[DYND_BUFFER_CHUNK_SIZE];
+
+        uint64_t nstep = size > 1 ? static_cast<uint64_t>(size - 1) : 0;
+        for (uint64_t k = 0; k < nstep; k += DYND_BUFFER_CHUNK_SIZE) {
+          size_t count = static_cast<size_t>(std::min<uint64_t>(nstep - k, DYND_BUFFER_CHUNK_SIZE));
+          g.generate_words(2 * k, stream, 0, 2 * count, words);
+
+          for (size_t j = 0; j < count; ++j) {
+            uint64_t range = static_cast<uint64_t>(size) - (k + j);
+            uint64_t lo;
+            targets[j] = mulhilo64(bounded_word<uint64_t>::load(words + 2 * j), range, lo);
+            // Lemire's test, which only needs the exact threshold for the rare products near a multiple of 2^64
+            if (lo < range) {
+              uint64_t threshold = (0ull - range) % range;
+              for (uint32_t extra = 1; lo < threshold; ++extra) {
+                uint32_t retry[2];
+                g.generate_words(2 * (k + j), stream, extra, 2, retry);
+                targets[j] = mulhilo64(bounded_word<uint64_t>::load(retry), range, lo);
+              }
+            }
+          }
+
+          for (size_t j = 0; j < count; ++j) {
+#if defined(__GNUC__)
+            if (j + prefetch_distance < count) {
+              __builtin_prefetch(data + static_cast<intptr_t>(targets[j + prefetch_distance]) * stride);
+            }
+#endif
+            intptr_t i = size - 1 - static_cast<intptr_t>(k + j);
+            if (static_cast<intptr_t>(targets[j]) != i) {
+              swap_elements(data + i * stride, data + static_cast<intptr_t>(targets[j]) * stride, element_size);
+            }
+          }
+        }
+      }
+
+    } // namespace dynd::nd::random::detail
+
+    /**
+     * Shuffles the elements of a fixed dimension in place.
+     */
+    template <typename GeneratorType>
+    struct shuffle_kernel : base_strided_kernel<shuffle_kernel<GeneratorType>, 1> {
+      GeneratorType m_generator;
+      uint32_t m_stream;
+      intptr_t m_size;
+      intptr_t m_stride;
+      size_t m_element_size;
+
+      shuffle_kernel(uint64_t seed, uint32_t stream, intptr_t size, intptr_t stride, size_t element_size)
+          : m_generator(seed), m_stream(stream), m_size(size), m_stride(stride), m_element_size(element_size) {}
+
+      void single(char *DYND_UNUSED(dst), char *const *src) {
+        detail::shuffle(m_generator, m_stream, src[0], m_size, m_stride, m_element_size);
+      }
+    };
+
+  } // namespace dynd::nd::random
+} // namespace dynd::nd
+} // namespace dynd
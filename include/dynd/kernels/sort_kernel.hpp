@@ -5,19 +5,535 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
 #include <dynd/bytes.hpp>
 #include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
 
 namespace dynd {
 namespace nd {
 
+  /**
+   * The builtin types sorted without a comparison child kernel. Integers
+   * and floating point values are radix sorted on the bits of their value.
+   */
+  typedef type_sequence<int8_t, int16_t, int32_t, int64_t, uint8_t, uint16_t, uint32_t, uint64_t, float, double>
+      builtin_sort_types;
+
+  namespace detail {
+
+    // Inputs shorter than this are sorted with pdqsort instead of a radix sort
+    static const size_t radix_sort_threshold = 256;
+
+    // Inputs at least this long are split into runs that are sorted, then merged, on several threads
+    static const size_t parallel_sort_threshold = 65536;
+
+    /**
+     * The ordering used by the builtin sorts. It is ``<``, except that NaNs
+     * compare greater than every other value so they end up at the back.
+     */
+    template <typename T>
+    bool sort_less(T lhs, T rhs) {
+      return lhs < rhs || (rhs != rhs && lhs == lhs);
+    }
+
+    /**
+     * Maps a value onto an unsigned integer key whose order matches
+     * sort_less on the value.
+     */
+    template <typename T, typename Enable = void>
+    struct radix_key;
+
+    template <typename T>
+    struct radix_key<T, std::enable_if_t<std::is_integral<T>::value>> {
+      typedef std::make_unsigned_t<T> type;
+
+      static type get(T value) {
+        // Flipping the sign bit puts negative values before positive ones
+        return static_cast<type>(value) ^
+               (std::is_signed<T>::value ? static_cast<type>(type(1) << (8 * sizeof(T) - 1)) : type(0));
+      }
+    };
+
+    template <typename T>
+    struct radix_key<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+      typedef std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t> type;
+
+      static type get(T value) {
+        static const type sign = type(1) << (8 * sizeof(T) - 1);
+        if (value != value) {
+          return ~type(0);
+        }
+        if (value == 0) {
+          // -0.0 and 0.0 compare equal, so they share a key to keep the sort stable
+          return sign;
+        }
+
+        type bits;
+        memcpy(&bits, &value, sizeof(T));
+        // Negative values reverse their order, positive ones only need the sign bit set
+        return (bits & sign) ? ~bits : (bits | sign);
+      }
+    };
+
+    /**
+     * An LSD radix sort on the bytes of the keys of ``data``, carrying
+     * ``index`` along when it is not null. ``data_tmp`` and ``index_tmp``
+     * must have room for ``size`` elements. All byte histograms are computed
+     * in one pass, and passes where every element has the same byte are
+     * skipped. The sort is stable.
+     */
+    template <typename T, typename IndexType>
+    void radix_sort(T *data, T *data_tmp, IndexType *index, IndexType *index_tmp, size_t size) {
+      typedef radix_key<T> key;
+      static const size_t nbyte = sizeof(T);
+      if (size == 0) {
+        return;
+      }
+
+      std::vector<size_t> counts(nbyte * 256, 0);
+      for (size_t i = 0; i < size; ++i) {
+        typename key::type k = key::get(data[i]);
+        for (size_t b = 0; b < nbyte; ++b) {
+          ++counts[b * 256 + ((k >> (8 * b)) & 0xFF)];
+        }
+      }
+
+      T *src = data, *dst = data_tmp;
+      IndexType *index_src = index, *index_dst = index_tmp;
+      for (size_t b = 0; b < nbyte; ++b) {
+        size_t *count = counts.data() + b * 256;
+        if (count[(key::get(src[0]) >> (8 * b)) & 0xFF] == size) {
+          continue;
+        }
+
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; ++d) {
+          size_t c = count[d];
+          count[d] = offset;
+          offset += c;
+        }
+
+        for (size_t i = 0; i < size; ++i) {
+          size_t j = count[(key::get(src[i]) >> (8 * b)) & 0xFF]++;
+          dst[j] = src[i];
+          if (index != nullptr) {
+            index_dst[j] = index_src[i];
+          }
+        }
+
+        std::swap(src, dst);
+        std::swap(index_src, index_dst);
+      }
+
+      if (src != data) {
+        memcpy(data, src, size * sizeof(T));
+        if (index != nullptr) {
+          memcpy(index, index_src, size * sizeof(IndexType));
+        }
+      }
+    }
+
+    template <typename Iterator, typename Compare>
+    void insertion_sort(Iterator begin, Iterator end, Compare comp) {
+      if (begin == end) {
+        return;
+      }
+
+      for (Iterator cur = begin + 1; cur != end; ++cur) {
+        if (comp(*cur, *(cur - 1))) {
+          auto tmp = std::move(*cur);
+          Iterator sift = cur;
+          do {
+            *sift = std::move(*(sift - 1));
+            --sift;
+          } while (sift != begin && comp(tmp, *(sift - 1)));
+          *sift = std::move(tmp);
+        }
+      }
+    }
+
+    // Insertion sort that gives up, returning false, once it has moved too many elements
+    template <typename Iterator, typename Compare>
+    bool partial_insertion_sort(Iterator begin, Iterator end, Compare comp) {
+      static const size_t limit = 8;
+      if (begin == end) {
+        return true;
+      }
+
+      size_t moved = 0;
+      for (Iterator cur = begin + 1; cur != end; ++cur) {
+        if (comp(*cur, *(cur - 1))) {
+          auto tmp = std::move(*cur);
+          Iterator sift = cur;
+          do {
+            *sift = std::move(*(sift - 1));
+            --sift;
+          } while (sift != begin && comp(tmp, *(sift - 1)));
+          *sift = std::move(tmp);
+          moved += cur - sift;
+        }
+        if (moved > limit) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    template <typename Iterator, typename Compare>
+    void sort3(Iterator a, Iterator b, Iterator c, Compare comp) {
+      if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+      }
+      if (comp(*c, *b)) {
+        std::iter_swap(b, c);
+      }
+      if (comp(*b, *a)) {
+        std::iter_swap(a, b);
+      }
+    }
+
+    /**
+     * Partitions around the pivot at ``*begin``, placing elements equal to
+     * the pivot on the right. Returns the final position of the pivot, and
+     * whether the range was already partitioned.
+     */
+    template <typename Iterator, typename Compare>
+    std::pair<Iterator, bool> partition_right(Iterator begin, Iterator end, Compare comp) {
+      auto pivot = std::move(*begin);
+      Iterator first = begin;
+      Iterator last = end;
+
+      // The median-of-3 guarantees these loops stop before running off the range
+      while (comp(*++first, pivot)) {
+      }
+      if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
+      } else {
+        while (!comp(*--last, pivot)) {
+        }
+      }
+
+      bool already_partitioned = first >= last;
+      while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot)) {
+        }
+        while (!comp(*--last, pivot)) {
+        }
+      }
+
+      Iterator pivot_pos = first - 1;
+      *begin = std::move(*pivot_pos);
+      *pivot_pos = std::move(pivot);
+
+      return std::make_pair(pivot_pos, already_partitioned);
+    }
+
+    // Partitions around ``*begin``, placing elements equal to the pivot on the left
+    template <typename Iterator, typename Compare>
+    Iterator partition_left(Iterator begin, Iterator end, Compare comp) {
+      auto pivot = std::move(*begin);
+      Iterator first = begin;
+      Iterator last = end;
+
+      while (comp(pivot, *--last)) {
+      }
+      if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {
+        }
+      } else {
+        while (!comp(pivot, *++first)) {
+        }
+      }
+
+      while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last)) {
+        }
+        while (!comp(pivot, *++first)) {
+        }
+      }
+
+      Iterator pivot_pos = last;
+      *begin = std::move(*pivot_pos);
+      *pivot_pos = std::move(pivot);
+
+      return pivot_pos;
+    }
+
+    template <typename Iterator, typename Compare>
+    void pdqsort_loop(Iterator begin, Iterator end, Compare comp, int bad_allowed, bool leftmost) {
+      static const std::ptrdiff_t insertion_sort_threshold = 24;
+      static const std::ptrdiff_t ninther_threshold = 128;
+
+      while (true) {
+        std::ptrdiff_t size = end - begin;
+        if (size < insertion_sort_threshold) {
+          insertion_sort(begin, end, comp);
+          return;
+        }
+
+        // Choose the pivot as the median of 3, or the pseudomedian of 9 for large ranges
+        std::ptrdiff_t s2 = size / 2;
+        if (size > ninther_threshold) {
+          sort3(begin, begin + s2, end - 1, comp);
+          sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+          sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+          sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+          std::iter_swap(begin, begin + s2);
+        } else {
+          sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // If the pivot equals the element before this range, everything here
+        // is at least the pivot, so the equal elements are split off directly
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+          begin = partition_left(begin, end, comp) + 1;
+          continue;
+        }
+
+        std::pair<Iterator, bool> part = partition_right(begin, end, comp);
+        Iterator pivot_pos = part.first;
+        std::ptrdiff_t l_size = pivot_pos - begin;
+        std::ptrdiff_t r_size = end - (pivot_pos + 1);
+
+        if (l_size < size / 8 || r_size < size / 8) {
+          // A highly unbalanced partition; fall back to heapsort once this
+          // happens too often, otherwise shuffle some elements to break patterns
+          if (--bad_allowed == 0) {
+            std::make_heap(begin, end, comp);
+            std::sort_heap(begin, end, comp);
+            return;
+          }
+
+          if (l_size >= insertion_sort_threshold) {
+            std::iter_swap(begin, begin + l_size / 4);
+            std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+          }
+          if (r_size >= insertion_sort_threshold) {
+            std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+            std::iter_swap(end - 1, end - r_size / 4);
+          }
+        } else if (part.second && partial_insertion_sort(begin, pivot_pos, comp) &&
+                   partial_insertion_sort(pivot_pos + 1, end, comp)) {
+          // The range was already partitioned and both sides were nearly sorted
+          return;
+        }
+
+        pdqsort_loop(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+      }
+    }
+
+    /**
+     * Pattern-defeating quicksort. This is an introsort that recognizes
+     * sorted and reverse sorted runs and many equal elements, and takes the
+     * comparison as a template parameter so it can be inlined.
+     */
+    template <typename Iterator, typename Compare>
+    void pdqsort(Iterator begin, Iterator end, Compare comp) {
+      std::ptrdiff_t size = end - begin;
+      int log2_size = 0;
+      while (size >>= 1) {
+        ++log2_size;
+      }
+
+      pdqsort_loop(begin, end, comp, log2_size, true);
+    }
+
+
+    /**
+     * Sorts contiguous builtin values in place, using a radix sort for long
+     * inputs and pdqsort, or a stable sort if requested, for short ones.
+     */
+    template <typename T>
+    void builtin_sort(T *data, size_t size, bool stable) {
+      if (size >= radix_sort_threshold) {
+        std::vector<T> tmp(size);
+        radix_sort<T, intptr_t>(data, tmp.data(), nullptr, nullptr, size);
+      } else if (stable) {
+        std::stable_sort(data, data + size, [](T lhs, T rhs) { return sort_less(lhs, rhs); });
+      } else {
+        pdqsort(data, data + size, [](T lhs, T rhs) { return sort_less(lhs, rhs); });
+      }
+    }
+
+    /**
+     * Writes the permutation that stably sorts contiguous builtin values
+     * into ``index``, and sorts the values along with it.
+     */
+    template <typename T, typename IndexType>
+    void builtin_argsort(T *data, IndexType *index, size_t size) {
+      std::iota(index, index + size, IndexType(0));
+      if (size >= radix_sort_threshold) {
+        std::vector<T> data_tmp(size);
+        std::vector<IndexType> index_tmp(size);
+        radix_sort(data, data_tmp.data(), index, index_tmp.data(), size);
+      } else {
+        // Ties are broken by position, so the result is the same as the stable radix sort
+        pdqsort(index, index + size, [data](IndexType lhs, IndexType rhs) {
+          return sort_less(data[lhs], data[rhs]) || (!sort_less(data[rhs], data[lhs]) && lhs < rhs);
+        });
+        std::vector<T> values(data, data + size);
+        for (size_t i = 0; i < size; ++i) {
+          data[i] = values[index[i]];
+        }
+      }
+    }
+
+    /**
+     * Returns how many of the first ``k`` elements of the stable merge of the
+     * sorted runs ``a`` and ``b`` come from ``a``.
+     */
+    template <typename T>
+    size_t merge_split(const T *a, size_t a_size, const T *b, size_t b_size, size_t k) {
+      size_t lo = (k > b_size) ? k - b_size : 0;
+      size_t hi = std::min(k, a_size);
+      // Find the smallest split where the last element taken from b is before the next one in a
+      while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        if (j == 0 || i == a_size || sort_less(b[j - 1], a[i])) {
+          hi = i;
+        } else {
+          lo = i + 1;
+        }
+      }
+
+      return lo;
+    }
+
+    /**
+     * Sorts contiguous builtin values in place on several threads, carrying
+     * ``index`` along when it is not null. Each thread sorts one run, and the
+     * runs are merged pairwise, with every merge split by output position so
+     * all the threads share each round. Merges take equal elements from the
+     * left run first, so the sort is stable whenever the runs are.
+     */
+    template <typename T, typename IndexType>
+    void parallel_sort(T *data, IndexType *index, size_t size, bool stable) {
+      size_t nthread = get_num_threads();
+      if (size < parallel_sort_threshold || nthread < 2) {
+        if (index == nullptr) {
+          builtin_sort(data, size, stable);
+        } else {
+          builtin_argsort(data, index, size);
+        }
+        return;
+      }
+
+      std::vector<size_t> bounds(nthread + 1);
+      for (size_t r = 0; r <= nthread; ++r) {
+        bounds[r] = size * r / nthread;
+      }
+
+      parallel_for(nthread, [&](size_t r) {
+        size_t begin = bounds[r], run_size = bounds[r + 1] - bounds[r];
+        if (index == nullptr) {
+          builtin_sort(data + begin, run_size, stable);
+        } else {
+          builtin_argsort(data + begin, index + begin, run_size);
+          for (size_t i = begin; i < begin + run_size; ++i) {
+            index[i] += begin;
+          }
+        }
+      });
+
+      struct merge_task {
+        size_t a_begin, a_end, b_begin, b_end, dst_begin;
+      };
+
+      std::vector<T> data_tmp(size);
+      std::vector<IndexType> index_tmp((index == nullptr) ? 0 : size);
+      T *src = data, *dst = data_tmp.data();
+      IndexType *index_src = index, *index_dst = (index == nullptr) ? nullptr : index_tmp.data();
+      while (bounds.size() > 2) {
+        std::vector<size_t> merged_bounds;
+        std::vector<merge_task> tasks;
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+          size_t lo = bounds[r], mid = bounds[r + 1], hi = (r + 2 < bounds.size()) ? bounds[r + 2] : mid;
+          merged_bounds.push_back(lo);
+
+          // Split this merge into pieces in proportion to its share of the data
+          size_t npiece = std::max<size_t>(1, nthread * (hi - lo) / size);
+          size_t a_prev = lo, b_prev = mid;
+          for (size_t p = 1; p <= npiece; ++p) {
+            size_t k = (hi - lo) * p / npiece;
+            size_t a_split = lo + merge_split(src + lo, mid - lo, src + mid, hi - mid, k);
+            size_t b_split = mid + (k - (a_split - lo));
+            tasks.push_back({a_prev, a_split, b_prev, b_split, a_prev + b_prev - mid});
+            a_prev = a_split;
+            b_prev = b_split;
+          }
+        }
+        merged_bounds.push_back(size);
+
+        parallel_for(tasks.size(), [&](size_t t) {
+          const merge_task &task = tasks[t];
+          size_t i = task.a_begin, j = task.b_begin, k = task.dst_begin;
+          while (i < task.a_end && j < task.b_end) {
+            size_t from = sort_less(src[j], src[i]) ? j++ : i++;
+            dst[k] = src[from];
+            if (index != nullptr) {
+              index_dst[k] = index_src[from];
+            }
+            ++k;
+          }
+          for (size_t from = i; from < task.a_end; ++from, ++k) {
+            dst[k] = src[from];
+            if (index != nullptr) {
+              index_dst[k] = index_src[from];
+            }
+          }
+          for (size_t from = j; from < task.b_end; ++from, ++k) {
+            dst[k] = src[from];
+            if (index != nullptr) {
+              index_dst[k] = index_src[from];
+            }
+          }
+        });
+
+        std::swap(src, dst);
+        std::swap(index_src, index_dst);
+        bounds.swap(merged_bounds);
+      }
+
+      if (src != data) {
+        memcpy(data, src, size * sizeof(T));
+        if (index != nullptr) {
+          memcpy(index, index_src, size * sizeof(IndexType));
+        }
+      }
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * Sorts a one-dimensional array, or each row of a two-dimensional one, of
+   * any type, using the child kernel as the ``less`` comparison. The stable
+   * variant sorts a permutation and then moves the elements into place.
+   */
   struct sort_kernel : base_strided_kernel<sort_kernel, 1> {
+    const intptr_t src0_nrow;
+    const intptr_t src0_row_stride;
     const intptr_t src0_size;
     const intptr_t src0_stride;
     const intptr_t src0_element_data_size;
+    const bool stable;
 
-    sort_kernel(intptr_t src0_size, intptr_t src0_stride, size_t src0_element_data_size)
-        : src0_size(src0_size), src0_stride(src0_stride), src0_element_data_size(src0_element_data_size)
+    sort_kernel(intptr_t src0_nrow, intptr_t src0_row_stride, intptr_t src0_size, intptr_t src0_stride,
+                size_t src0_element_data_size, bool stable)
+        : src0_nrow(src0_nrow), src0_row_stride(src0_row_stride), src0_size(src0_size), src0_stride(src0_stride),
+          src0_element_data_size(src0_element_data_size), stable(stable)
     {
     }
 
@@ -26,14 +542,178 @@ namespace nd {
     void single(char *DYND_UNUSED(dst), char *const *src)
     {
       kernel_prefix *child = get_child();
-      std::sort(strided_iterator(src[0], src0_element_data_size, src0_stride),
-                strided_iterator(src[0] + src0_size * src0_stride, src0_element_data_size, src0_stride),
-                [child](char *lhs, char *rhs) {
-                  bool1 dst;
-                  char *src[2] = {lhs, rhs};
-                  child->single(reinterpret_cast<char *>(&dst), src);
-                  return dst;
-                });
+      auto less = [child](char *lhs, char *rhs) {
+        bool1 dst;
+        char *src[2] = {lhs, rhs};
+        child->single(reinterpret_cast<char *>(&dst), src);
+        return dst;
+      };
+
+      for (intptr_t row = 0; row < src0_nrow; ++row) {
+        char *src0 = src[0] + row * src0_row_stride;
+        if (!stable) {
+          std::sort(strided_iterator(src0, src0_element_data_size, src0_stride),
+                    strided_iterator(src0 + src0_size * src0_stride, src0_element_data_size, src0_stride), less);
+          continue;
+        }
+
+        std::vector<intptr_t> index(src0_size);
+        std::iota(index.begin(), index.end(), intptr_t(0));
+        std::stable_sort(index.begin(), index.end(), [&](intptr_t lhs, intptr_t rhs) {
+          return less(src0 + lhs * src0_stride, src0 + rhs * src0_stride);
+        });
+
+        // Relocate the elements bitwise, so each one still owns its resources exactly once
+        std::vector<char> values(src0_size * src0_element_data_size);
+        for (intptr_t i = 0; i < src0_size; ++i) {
+          memcpy(values.data() + i * src0_element_data_size, src0 + index[i] * src0_stride, src0_element_data_size);
+        }
+        for (intptr_t i = 0; i < src0_size; ++i) {
+          memcpy(src0 + i * src0_stride, values.data() + i * src0_element_data_size, src0_element_data_size);
+        }
+      }
+    }
+  };
+
+  /**
+   * Sorts a one-dimensional array, or each row of a two-dimensional one, of
+   * one of the builtin_sort_types without a comparison kernel. NaNs are
+   * sorted to the end. Strided input is gathered into a contiguous buffer,
+   * sorted, and scattered back.
+   *
+   * Long one-dimensional inputs are sorted on several threads, and the rows
+   * of a two-dimensional input are spread across threads.
+   */
+  template <typename Arg0Type>
+  struct builtin_sort_kernel : base_strided_kernel<builtin_sort_kernel<Arg0Type>, 1> {
+    const intptr_t src0_nrow;
+    const intptr_t src0_row_stride;
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+    const bool stable;
+
+    builtin_sort_kernel(intptr_t src0_nrow, intptr_t src0_row_stride, intptr_t src0_size, intptr_t src0_stride,
+                        bool stable)
+        : src0_nrow(src0_nrow), src0_row_stride(src0_row_stride), src0_size(src0_size), src0_stride(src0_stride),
+          stable(stable) {}
+
+    void sort_row(char *src0) const {
+      if (src0_stride == sizeof(Arg0Type)) {
+        detail::parallel_sort<Arg0Type, intptr_t>(reinterpret_cast<Arg0Type *>(src0), nullptr, src0_size, stable);
+        return;
+      }
+
+      std::vector<Arg0Type> values(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        values[i] = *reinterpret_cast<Arg0Type *>(src0 + i * src0_stride);
+      }
+      detail::parallel_sort<Arg0Type, intptr_t>(values.data(), nullptr, src0_size, stable);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        *reinterpret_cast<Arg0Type *>(src0 + i * src0_stride) = values[i];
+      }
+    }
+
+    void single(char *DYND_UNUSED(dst), char *const *src) {
+      char *src0 = src[0];
+      if (src0_nrow == 1) {
+        sort_row(src0);
+      } else {
+        parallel_for(src0_nrow, [this, src0](size_t row) { sort_row(src0 + row * src0_row_stride); });
+      }
+    }
+  };
+
+  /**
+   * Writes the permutation that stably sorts a one-dimensional array, or
+   * each row of a two-dimensional one, of any type, using the child kernel
+   * as the ``less`` comparison.
+   */
+  struct argsort_kernel : base_strided_kernel<argsort_kernel, 1> {
+    const intptr_t dst_row_stride;
+    const intptr_t dst_stride;
+    const intptr_t src0_nrow;
+    const intptr_t src0_row_stride;
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+
+    argsort_kernel(intptr_t dst_row_stride, intptr_t dst_stride, intptr_t src0_nrow, intptr_t src0_row_stride,
+                   intptr_t src0_size, intptr_t src0_stride)
+        : dst_row_stride(dst_row_stride), dst_stride(dst_stride), src0_nrow(src0_nrow),
+          src0_row_stride(src0_row_stride), src0_size(src0_size), src0_stride(src0_stride) {}
+
+    ~argsort_kernel() { get_child()->destroy(); }
+
+    void single(char *dst, char *const *src) {
+      kernel_prefix *child = get_child();
+      std::vector<int64_t> index(src0_size);
+
+      for (intptr_t row = 0; row < src0_nrow; ++row) {
+        char *src0 = src[0] + row * src0_row_stride;
+        intptr_t src0_stride = this->src0_stride;
+
+        std::iota(index.begin(), index.end(), int64_t(0));
+        std::stable_sort(index.begin(), index.end(), [child, src0, src0_stride](int64_t lhs, int64_t rhs) {
+          bool1 res;
+          char *child_src[2] = {src0 + lhs * src0_stride, src0 + rhs * src0_stride};
+          child->single(reinterpret_cast<char *>(&res), child_src);
+          return res;
+        });
+
+        char *dst_row = dst + row * dst_row_stride;
+        for (intptr_t i = 0; i < src0_size; ++i) {
+          *reinterpret_cast<int64_t *>(dst_row + i * dst_stride) = index[i];
+        }
+      }
+    }
+  };
+
+  /**
+   * Writes the permutation that stably sorts a one-dimensional array, or
+   * each row of a two-dimensional one, of one of the builtin_sort_types,
+   * without a comparison kernel. Threads are used as in builtin_sort_kernel.
+   */
+  template <typename Arg0Type>
+  struct builtin_argsort_kernel : base_strided_kernel<builtin_argsort_kernel<Arg0Type>, 1> {
+    const intptr_t dst_row_stride;
+    const intptr_t dst_stride;
+    const intptr_t src0_nrow;
+    const intptr_t src0_row_stride;
+    const intptr_t src0_size;
+    const intptr_t src0_stride;
+
+    builtin_argsort_kernel(intptr_t dst_row_stride, intptr_t dst_stride, intptr_t src0_nrow,
+                           intptr_t src0_row_stride, intptr_t src0_size, intptr_t src0_stride)
+        : dst_row_stride(dst_row_stride), dst_stride(dst_stride), src0_nrow(src0_nrow),
+          src0_row_stride(src0_row_stride), src0_size(src0_size), src0_stride(src0_stride) {}
+
+    void argsort_row(char *dst, char *src0) const {
+      // The values are sorted along with the permutation, so this always works on a copy
+      std::vector<Arg0Type> values(src0_size);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        values[i] = *reinterpret_cast<Arg0Type *>(src0 + i * src0_stride);
+      }
+
+      if (dst_stride == sizeof(int64_t)) {
+        detail::parallel_sort(values.data(), reinterpret_cast<int64_t *>(dst), src0_size, true);
+        return;
+      }
+
+      std::vector<int64_t> index(src0_size);
+      detail::parallel_sort(values.data(), index.data(), src0_size, true);
+      for (intptr_t i = 0; i < src0_size; ++i) {
+        *reinterpret_cast<int64_t *>(dst + i * dst_stride) = index[i];
+      }
+    }
+
+    void single(char *dst, char *const *src) {
+      char *src0 = src[0];
+      if (src0_nrow == 1) {
+        argsort_row(dst, src0);
+      } else {
+        parallel_for(src0_nrow, [this, dst, src0](size_t row) {
+          argsort_row(dst + row * dst_row_stride, src0 + row * src0_row_stride);
+        });
+      }
     }
   };
 
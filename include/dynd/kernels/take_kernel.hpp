@@ -5,33 +5,185 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <dynd/shape_tools.hpp>
 #include <dynd/kernels/base_kernel.hpp>
 #include <dynd/assignment.hpp>
+#include <dynd/parallel.hpp>
 
 namespace dynd {
 namespace nd {
 
+  namespace detail {
+
+    // Eight bool1 mask values, one to a byte, as a word
+    inline uint64_t load_mask_word(const char *mask, intptr_t mask_stride) {
+      uint64_t word;
+      if (mask_stride == 1) {
+        memcpy(&word, mask, sizeof(uint64_t));
+      } else {
+        unsigned char bytes[8];
+        for (intptr_t j = 0; j < 8; ++j) {
+          bytes[j] = mask[j * mask_stride];
+        }
+        memcpy(&word, bytes, sizeof(uint64_t));
+      }
+      return word;
+    }
+
+    // The number of true values of a mask, eight at a time
+    inline intptr_t count_mask(const char *mask, intptr_t mask_stride, intptr_t size) {
+      intptr_t res = 0, i = 0;
+      for (; i + 8 <= size; i += 8, mask += 8 * mask_stride) {
+        uint64_t word = load_mask_word(mask, mask_stride);
+        // Each byte is 0 or 1, so the sum of the bytes is the number of true values
+        res += static_cast<intptr_t>((word * 0x0101010101010101ULL) >> 56);
+      }
+      for (; i < size; ++i, mask += mask_stride) {
+        res += (*mask != 0);
+      }
+      return res;
+    }
+
+    /**
+     * Copies the elements of ``size`` bytes whose mask values are true to
+     * the dst, which has room for ``dst_count`` of them, and returns the dst
+     * after them. The mask is read eight values at a time. A block of all
+     * false is skipped and a block of all true copied whole. In a mixed
+     * block every element is stored and the dst advanced by its mask value,
+     * without branches, while the dst has room for the whole block.
+     */
+    template <size_t N>
+    char *masked_compress(char *dst, intptr_t dst_stride, intptr_t dst_count, const char *src0, intptr_t src0_stride,
+                          const char *mask, intptr_t mask_stride, intptr_t size) {
+      char *dst_end = dst + dst_count * dst_stride;
+      intptr_t i = 0;
+      for (; i + 8 <= size; i += 8, src0 += 8 * src0_stride, mask += 8 * mask_stride) {
+        uint64_t word = load_mask_word(mask, mask_stride);
+        if (word == 0) {
+          continue;
+        }
+
+        if (word == 0x0101010101010101ULL && src0_stride == static_cast<intptr_t>(N) &&
+            dst_stride == static_cast<intptr_t>(N)) {
+          memcpy(dst, src0, 8 * N);
+          dst += 8 * N;
+        } else if (dst + 8 * dst_stride <= dst_end) {
+          for (intptr_t j = 0; j < 8; ++j) {
+            memcpy(dst, src0 + j * src0_stride, N);
+            dst += dst_stride * static_cast<intptr_t>((word >> (8 * j)) & 1);
+          }
+        } else {
+          for (intptr_t j = 0; j < 8; ++j) {
+            if ((word >> (8 * j)) & 1) {
+              memcpy(dst, src0 + j * src0_stride, N);
+              dst += dst_stride;
+            }
+          }
+        }
+      }
+      for (; i < size; ++i, src0 += src0_stride, mask += mask_stride) {
+        if (*mask != 0) {
+          memcpy(dst, src0, N);
+          dst += dst_stride;
+        }
+      }
+      return dst;
+    }
+
+    inline char *masked_compress(size_t element_size, char *dst, intptr_t dst_stride, intptr_t dst_count,
+                                 const char *src0, intptr_t src0_stride, const char *mask, intptr_t mask_stride,
+                                 intptr_t size) {
+      switch (element_size) {
+      case 1:
+        return masked_compress<1>(dst, dst_stride, dst_count, src0, src0_stride, mask, mask_stride, size);
+      case 2:
+        return masked_compress<2>(dst, dst_stride, dst_count, src0, src0_stride, mask, mask_stride, size);
+      case 4:
+        return masked_compress<4>(dst, dst_stride, dst_count, src0, src0_stride, mask, mask_stride, size);
+      case 8:
+        return masked_compress<8>(dst, dst_stride, dst_count, src0, src0_stride, mask, mask_stride, size);
+      case 16:
+        return masked_compress<16>(dst, dst_stride, dst_count, src0, src0_stride, mask, mask_stride, size);
+      default:
+        throw std::runtime_error("masked compress: unsupported element size");
+      }
+    }
+
+  } // namespace dynd::nd::detail
+
+  /**
+   * CKernel which does a masked take operation into a var dimension. The
+   * true values of the mask are counted first, so the dst is allocated once
+   * at its final size. Builtin elements, whose size is given by
+   * ``m_element_size``, are copied by detail::masked_compress, and in
+   * parallel over disjoint ranges of the dst for large sizes. Other elements
+   * are copied by the child, a strided call for each run of true values.
+   */
   struct DYND_API masked_take_ck : base_strided_kernel<masked_take_ck, 2> {
+    // The size from which a compress is split across threads
+    static const intptr_t parallel_compress_threshold = 65536;
+
     const char *m_dst_meta;
     intptr_t m_dim_size, m_src0_stride, m_mask_stride;
+    size_t m_element_size;
+
+    masked_take_ck(size_t element_size = 0) : m_element_size(element_size) {}
 
     ~masked_take_ck() { get_child()->destroy(); }
 
     void single(char *dst, char *const *src) {
-      kernel_prefix *child = get_child();
-      kernel_strided_t child_fn = child->get_function<kernel_strided_t>();
       char *src0 = src[0];
       char *mask = src[1];
       intptr_t dim_size = m_dim_size, src0_stride = m_src0_stride, mask_stride = m_mask_stride;
-      // Start with the dst matching the dim size. (Maybe better to
-      // do smaller? This means no resize required in the loop.)
+      const ndt::var_dim_type::metadata_type *dst_md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta);
+      intptr_t dst_stride = dst_md->stride;
       ndt::var_dim_type::data_type *vdd = reinterpret_cast<ndt::var_dim_type::data_type *>(dst);
-      vdd->begin = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta)->blockref->alloc(dim_size);
-      vdd->size = dim_size;
+
+      size_t nchunk = 1;
+      if (m_element_size != 0 && dim_size >= parallel_compress_threshold) {
+        nchunk = std::min(4 * get_num_threads(), static_cast<size_t>(dim_size / (parallel_compress_threshold / 4)));
+      }
+      if (nchunk > 1) {
+        // Count the true values of each chunk, then compress the chunks into disjoint ranges of the dst
+        intptr_t chunk_size = (dim_size + nchunk - 1) / nchunk;
+        std::vector<intptr_t> offsets(nchunk + 1, 0);
+        parallel_for(nchunk, [&](size_t c) {
+          intptr_t begin = c * chunk_size, end = std::min(dim_size, begin + chunk_size);
+          offsets[c + 1] = detail::count_mask(mask + begin * mask_stride, mask_stride, end - begin);
+        });
+        for (size_t c = 0; c < nchunk; ++c) {
+          offsets[c + 1] += offsets[c];
+        }
+
+        vdd->begin = dst_md->blockref->alloc(offsets[nchunk]);
+        vdd->size = offsets[nchunk];
+        char *dst_begin = vdd->begin;
+        parallel_for(nchunk, [&](size_t c) {
+          intptr_t begin = c * chunk_size, end = std::min(dim_size, begin + chunk_size);
+          detail::masked_compress(m_element_size, dst_begin + offsets[c] * dst_stride, dst_stride,
+                                  offsets[c + 1] - offsets[c], src0 + begin * src0_stride, src0_stride,
+                                  mask + begin * mask_stride, mask_stride, end - begin);
+        });
+        return;
+      }
+
+      intptr_t dst_count = detail::count_mask(mask, mask_stride, dim_size);
+      vdd->begin = dst_md->blockref->alloc(dst_count);
+      vdd->size = dst_count;
+      if (m_element_size != 0) {
+        detail::masked_compress(m_element_size, vdd->begin, dst_stride, dst_count, src0, src0_stride, mask,
+                                mask_stride, dim_size);
+        return;
+      }
+
+      kernel_prefix *child = get_child();
+      kernel_strided_t child_fn = child->get_function<kernel_strided_t>();
       char *dst_ptr = vdd->begin;
-      intptr_t dst_stride = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta)->stride;
-      intptr_t dst_count = 0;
       intptr_t i = 0;
       while (i < dim_size) {
         // Run of false
@@ -47,33 +199,135 @@ namespace nd {
           child_fn(child, dst_ptr, dst_stride, &src0, &src0_stride, run_count);
           dst_ptr += run_count * dst_stride;
           src0 += run_count * src0_stride;
-          dst_count += run_count;
         }
       }
-
-      vdd->begin = reinterpret_cast<const ndt::var_dim_type::metadata_type *>(m_dst_meta)
-                       ->blockref->resize(vdd->begin, dst_count);
-      vdd->size = dst_count;
     }
   };
 
+  namespace detail {
+
+    inline void prefetch(const char *DYND_IGNORE_UNUSED(ptr)) {
+#if defined(__GNUC__) || defined(__clang__)
+      __builtin_prefetch(ptr);
+#endif
+    }
+
+    /**
+     * Checks that every index is in ``[-src0_dim_size, src0_dim_size)``, from
+     * their minimum and maximum, which are found in a loop without branches.
+     * The first index out of bounds raises the error of apply_single_index.
+     */
+    inline void validate_indices(const char *index, intptr_t index_stride, intptr_t count, intptr_t src0_dim_size) {
+      intptr_t index_min = 0, index_max = -1;
+      if (count > 0) {
+        index_min = index_max = *reinterpret_cast<const intptr_t *>(index);
+      }
+      for (intptr_t i = 0; i < count; ++i) {
+        intptr_t ix = *reinterpret_cast<const intptr_t *>(index + i * index_stride);
+        index_min = std::min(index_min, ix);
+        index_max = std::max(index_max, ix);
+      }
+      if (index_min >= -src0_dim_size && index_max < src0_dim_size) {
+        return;
+      }
+
+      for (intptr_t i = 0; i < count; ++i) {
+        apply_single_index(*reinterpret_cast<const intptr_t *>(index + i * index_stride), src0_dim_size, NULL);
+      }
+    }
+
+    /**
+     * Copies the elements of ``size`` bytes at validated indices to the dst,
+     * prefetching the element DYND_GATHER_PREFETCH_DISTANCE indices ahead
+     * of the one being copied.
+     */
+    template <size_t N>
+    void gather(char *dst, intptr_t dst_stride, const char *src0, intptr_t src0_stride, intptr_t src0_dim_size,
+                const char *index, intptr_t index_stride, intptr_t count) {
+      const intptr_t distance = DYND_GATHER_PREFETCH_DISTANCE;
+      intptr_t i = 0;
+      if (distance > 0) {
+        for (; i + distance < count; ++i, dst += dst_stride) {
+          intptr_t ahead = *reinterpret_cast<const intptr_t *>(index + (i + distance) * index_stride);
+          prefetch(src0 + (ahead + (ahead < 0 ? src0_dim_size : 0)) * src0_stride);
+
+          intptr_t ix = *reinterpret_cast<const intptr_t *>(index + i * index_stride);
+          memcpy(dst, src0 + (ix + (ix < 0 ? src0_dim_size : 0)) * src0_stride, N);
+        }
+      }
+      for (; i < count; ++i, dst += dst_stride) {
+        intptr_t ix = *reinterpret_cast<const intptr_t *>(index + i * index_stride);
+        memcpy(dst, src0 + (ix + (ix < 0 ? src0_dim_size : 0)) * src0_stride, N);
+      }
+    }
+
+    inline void gather(size_t element_size, char *dst, intptr_t dst_stride, const char *src0, intptr_t src0_stride,
+                       intptr_t src0_dim_size, const char *index, intptr_t index_stride, intptr_t count) {
+      switch (element_size) {
+      case 1:
+        return gather<1>(dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride, count);
+      case 2:
+        return gather<2>(dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride, count);
+      case 4:
+        return gather<4>(dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride, count);
+      case 8:
+        return gather<8>(dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride, count);
+      case 16:
+        return gather<16>(dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride, count);
+      default:
+        throw std::runtime_error("gather: unsupported element size");
+      }
+    }
+
+  } // namespace dynd::nd::detail
+
   /**
    * CKernel which does an indexed take operation. The child ckernel
-   * should be a single unary operation.
+   * should be a single unary operation. Builtin elements, whose size is
+   * given by ``m_element_size``, are gathered by detail::gather once all the
+   * indices have been validated, and in parallel over chunks of the
+   * indices for large sizes.
    */
   struct DYND_API indexed_take_ck : base_strided_kernel<indexed_take_ck, 2> {
+    // The number of indices from which a gather is split across threads
+    static const intptr_t parallel_gather_threshold = 65536;
+
     intptr_t m_dst_dim_size, m_dst_stride, m_index_stride;
     intptr_t m_src0_dim_size, m_src0_stride;
+    size_t m_element_size;
+
+    indexed_take_ck(size_t element_size = 0) : m_element_size(element_size) {}
 
     ~indexed_take_ck() { get_child()->destroy(); }
 
     void single(char *dst, char *const *src) {
-      kernel_prefix *child = get_child();
-      kernel_single_t child_fn = child->get_function<kernel_single_t>();
       char *src0 = src[0];
       const char *index = src[1];
       intptr_t dst_dim_size = m_dst_dim_size, src0_dim_size = m_src0_dim_size, dst_stride = m_dst_stride,
                src0_stride = m_src0_stride, index_stride = m_index_stride;
+      if (m_element_size != 0) {
+        detail::validate_indices(index, index_stride, dst_dim_size, src0_dim_size);
+
+        size_t nchunk = 1;
+        if (dst_dim_size >= parallel_gather_threshold) {
+          nchunk = std::min(4 * get_num_threads(), static_cast<size_t>(dst_dim_size / (parallel_gather_threshold / 4)));
+        }
+        if (nchunk > 1) {
+          intptr_t chunk_size = (dst_dim_size + nchunk - 1) / nchunk;
+          parallel_for(nchunk, [&](size_t c) {
+            intptr_t begin = c * chunk_size, end = std::min(dst_dim_size, begin + chunk_size);
+            detail::gather(m_element_size, dst + begin * dst_stride, dst_stride, src0, src0_stride, src0_dim_size,
+                           index + begin * index_stride, index_stride, end - begin);
+          });
+        } else {
+          detail::gather(m_element_size, dst, dst_stride, src0, src0_stride, src0_dim_size, index, index_stride,
+                         dst_dim_size);
+        }
+        return;
+      }
+
+      kernel_prefix *child = get_child();
+      kernel_single_t child_fn = child->get_function<kernel_single_t>();
       for (intptr_t i = 0; i < dst_dim_size; ++i) {
         intptr_t ix = *reinterpret_cast<const intptr_t *>(index);
         // Handle Python-style negative index, bounds checking
@@ -15,14 +15,23 @@ namespace nd {
     size_t child_kernel_offset;
     size_t dst_data_offset;
     size_t src_data_offset;
+    // If nonzero, the field is a run of POD fields that is copied as a block of this size, without a child kernel
+    size_t copy_size;
   };
 
+  /**
+   * Applies a child kernel to each field of a tuple or struct. For a strided
+   * run of values, each child kernel is called once over the whole run, and
+   * runs of adjacent POD fields are copied as a block.
+   */
   struct tuple_unary_op_ck : nd::base_strided_kernel<tuple_unary_op_ck, 1> {
     std::vector<tuple_unary_op_item> m_fields;
 
     ~tuple_unary_op_ck() {
       for (size_t i = 0; i < m_fields.size(); ++i) {
-        get_child(m_fields[i].child_kernel_offset)->destroy();
+        if (m_fields[i].copy_size == 0) {
+          get_child(m_fields[i].child_kernel_offset)->destroy();
+        }
       }
     }
 
@@ -34,14 +43,96 @@ namespace nd {
 
       for (intptr_t i = 0; i < field_count; ++i) {
         const tuple_unary_op_item &item = fi[i];
+        if (item.copy_size != 0) {
+          memcpy(dst + item.dst_data_offset, src[0] + item.src_data_offset, item.copy_size);
+          continue;
+        }
         child = get_child(item.child_kernel_offset);
         child_fn = child->get_function<kernel_single_t>();
         char *child_src = src[0] + item.src_data_offset;
         child_fn(child, dst + item.dst_data_offset, &child_src);
       }
     }
+
+    void strided(char *dst, intptr_t dst_stride, char *const *src, const intptr_t *src_stride, size_t count) {
+      const tuple_unary_op_item *fi = &m_fields[0];
+      intptr_t field_count = m_fields.size();
+      kernel_prefix *child;
+      kernel_strided_t child_fn;
+
+      for (intptr_t i = 0; i < field_count; ++i) {
+        const tuple_unary_op_item &item = fi[i];
+        char *child_dst = dst + item.dst_data_offset;
+        char *child_src = src[0] + item.src_data_offset;
+        if (item.copy_size == 0) {
+          child = get_child(item.child_kernel_offset);
+          child_fn = child->get_function<kernel_strided_t>();
+          child_fn(child, child_dst, dst_stride, &child_src, src_stride, count);
+        } else if (dst_stride == static_cast<intptr_t>(item.copy_size) && src_stride[0] == dst_stride) {
+          // The values are all POD and contiguous
+          memcpy(child_dst, child_src, count * item.copy_size);
+        } else {
+          for (size_t j = 0; j != count; ++j, child_dst += dst_stride, child_src += src_stride[0]) {
+            memcpy(child_dst, child_src, item.copy_size);
+          }
+        }
+      }
+    }
   };
 
+  /**
+   * Emplaces a tuple_unary_op_ck for ``field_count`` fields, followed by the
+   * child kernels of its fields. A field whose type in ``copy_tps`` is not
+   * null is copied as bytes, and has no child in the call graph. Adjacent
+   * such fields, at the same distances from each other in the source and
+   * destination, are merged into one block copy.
+   */
+  inline void emplace_tuple_unary_op(kernel_builder &kb, kernel_request_t kernreq, intptr_t field_count,
+                                     const uintptr_t *dst_offsets, const char *const *dst_fields_arrmeta,
+                                     const uintptr_t *src_offsets, const char *const *src_fields_arrmeta,
+                                     const ndt::type *copy_tps) {
+    // The children run over the whole run of values when this kernel is strided
+    kernel_request_t child_kernreq =
+        (kernreq == kernel_request_strided) ? kernreq : static_cast<kernel_request_t>(kernel_request_single);
+
+    intptr_t self_offset = kb.size();
+    kb.emplace_back<tuple_unary_op_ck>(kernreq);
+    kb.get_at<tuple_unary_op_ck>(self_offset)->m_fields.reserve(field_count);
+    for (intptr_t i = 0; i < field_count; ++i) {
+      tuple_unary_op_ck *self = kb.get_at<tuple_unary_op_ck>(self_offset);
+      if (copy_tps[i].is_null()) {
+        self->m_fields.push_back({kb.size() - self_offset, dst_offsets[i], src_offsets[i], 0});
+        kb(child_kernreq, nullptr, dst_fields_arrmeta[i], 1, &src_fields_arrmeta[i]);
+        continue;
+      }
+
+      if (!self->m_fields.empty()) {
+        // Extend a block copy of the previous fields through any padding before this one
+        tuple_unary_op_item &prev = self->m_fields.back();
+        size_t alignment = copy_tps[i].get_data_alignment();
+        if (prev.copy_size != 0 &&
+            dst_offsets[i] == inc_to_alignment(prev.dst_data_offset + prev.copy_size, alignment) &&
+            src_offsets[i] - prev.src_data_offset == dst_offsets[i] - prev.dst_data_offset) {
+          prev.copy_size = dst_offsets[i] - prev.dst_data_offset + copy_tps[i].get_data_size();
+          continue;
+        }
+      }
+      self->m_fields.push_back({0, dst_offsets[i], src_offsets[i], copy_tps[i].get_data_size()});
+    }
+  }
+
+  /**
+   * The type of a field that can be assigned by copying its bytes, or a null
+   * type if it needs a child kernel.
+   */
+  inline ndt::type get_copy_type(const ndt::type &dst_tp, const ndt::type &src_tp) {
+    if (dst_tp == src_tp && dst_tp.is_pod() && dst_tp.get_arrmeta_size() == 0) {
+      return dst_tp;
+    }
+
+    return ndt::type();
+  }
+
 } // namespace dynd::nd
 
 /**
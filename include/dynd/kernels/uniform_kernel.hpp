@@ -5,64 +5,219 @@
 
 #pragma once
 
-#include <memory>
-#include <random>
+#include <type_traits>
 
-#include <dynd/kernels/base_kernel.hpp>
-#include <dynd/kernels/base_strided_kernel.hpp>
+#include <dynd/kernels/random_kernel.hpp>
 
 namespace dynd {
+namespace nd {
+  namespace random {
+    namespace detail {
+
+      /**
+       * Returns the high half of the 128-bit product of ``a`` and ``b``, and
+       * sets ``lo`` to the low half.
+       */
+      inline uint64_t mulhilo64(uint64_t a, uint64_t b, uint64_t &lo) {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        lo = static_cast<uint64_t>(product);
+        return static_cast<uint64_t>(product >> 64);
+#else
+        uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+        uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        lo = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+        return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+      }
 
-inline std::shared_ptr<std::default_random_engine> &get_random_device() {
-  static std::random_device random_device;
-  static std::shared_ptr<std::default_random_engine> g(new std::default_random_engine(random_device()));
+      /**
+       * Maps a random word, or two for 64-bit values, onto ``[0, range)`` with
+       * the multiply-shift method of Lemire, "Fast Random Integer Generation
+       * in an Interval" (2019). A range of zero stands for the full range of
+       * the word type. The product of the word and the range is biased only
+       * when its low half is below ``threshold``, which happens with
+       * probability below ``range / 2^32`` (or ``2^64``), so those draws are
+       * rejected and retried with new words.
+       */
+      template <typename WordType>
+      struct bounded_word;
+
+      template <>
+      struct bounded_word<uint32_t> {
+        static const size_t words = 1;
+
+        uint32_t range;
+        uint32_t threshold;
+
+        bounded_word(uint32_t range) : range(range), threshold(range == 0 ? 0 : (0u - range) % range) {}
+
+        static uint32_t load(const uint32_t *w) { return w[0]; }
+
+        uint32_t map(uint32_t x) const {
+          return range == 0 ? x : static_cast<uint32_t>((static_cast<uint64_t>(x) * range) >> 32);
+        }
+
+        bool accept(uint32_t x) const {
+          return range == 0 || static_cast<uint32_t>(static_cast<uint64_t>(x) * range) >= threshold;
+        }
+      };
+
+      template <>
+      struct bounded_word<uint64_t> {
+        static const size_t words = 2;
+
+        uint64_t range;
+        uint64_t threshold;
+
+        bounded_word(uint64_t range) : range(range), threshold(range == 0 ? 0 : (0ull - range) % range) {}
+
+        static uint64_t load(const uint32_t *w) { return (static_cast<uint64_t>(w[1]) << 32) | w[0]; }
+
+        uint64_t map(uint64_t x) const {
+          uint64_t lo;
+          return range == 0 ? x : mulhilo64(x, range, lo);
+        }
+
+        bool accept(uint64_t x) const {
+          uint64_t lo;
+          mulhilo64(x, range, lo);
+          return range == 0 || lo >= threshold;
+        }
+      };
+
+      /**
+       * A float in ``[0, 1)`` with all 24 bits of its significand random.
+       */
+      inline float unit_float(const uint32_t *w) { return static_cast<float>(w[0] >> 8) * (1.0f / 16777216.0f); }
+
+      /**
+       * A double in ``[0, 1)`` with all 53 bits of its significand random.
+       */
+      inline double unit_double(const uint32_t *w) {
+        return static_cast<double>(((static_cast<uint64_t>(w[1]) << 32) | w[0]) >> 11) *
+               (1.0 / 9007199254740992.0);
+      }
 
-  return g;
-}
+      template <typename T>
+      struct unit_real;
 
-namespace nd {
-  namespace random {
+      template <>
+      struct unit_real<float> {
+        static const size_t words = 1;
 
-    template <typename ReturnType, typename GeneratorType, typename Enable = void>
-    struct uniform_kernel;
+        static float get(const uint32_t *w) { return unit_float(w); }
+      };
 
-    template <typename ReturnType, typename GeneratorType>
-    struct uniform_kernel<ReturnType, GeneratorType, std::enable_if_t<is_integral<ReturnType>::value>>
-        : base_strided_kernel<uniform_kernel<ReturnType, GeneratorType>, 0> {
-      GeneratorType &g;
-      std::uniform_int_distribution<ReturnType> d;
+      template <>
+      struct unit_real<double> {
+        static const size_t words = 2;
 
-      uniform_kernel(GeneratorType *g, ReturnType a, ReturnType b) : g(*g), d(a, b) {}
+        static double get(const uint32_t *w) { return unit_double(w); }
+      };
 
-      void single(char *dst, char *const *DYND_UNUSED(src)) { *reinterpret_cast<ReturnType *>(dst) = d(g); }
-    };
+    } // namespace dynd::nd::random::detail
 
-    template <typename ReturnType, typename GeneratorType>
-    struct uniform_kernel<ReturnType, GeneratorType, std::enable_if_t<is_floating_point<ReturnType>::value>>
-        : base_strided_kernel<uniform_kernel<ReturnType, GeneratorType>, 0> {
-      GeneratorType &g;
-      std::uniform_real_distribution<ReturnType> d;
+    template <typename ReturnType, typename Enable = void>
+    struct uniform_distribution;
+
+    /**
+     * Integers uniform on the closed interval ``[a, b]``, without modulo bias.
+     */
+    template <typename ReturnType>
+    struct uniform_distribution<ReturnType, std::enable_if_t<is_integral<ReturnType>::value>> {
+      typedef ReturnType value_type;
+      typedef std::conditional_t<sizeof(ReturnType) <= 4, uint32_t, uint64_t> word_type;
+      typedef detail::bounded_word<word_type> bounded_type;
+
+      static const size_t words = bounded_type::words;
 
-      uniform_kernel(GeneratorType *g, ReturnType a, ReturnType b) : g(*g), d(a, b) {}
+      word_type m_a;
+      bounded_type m_bounded;
 
-      void single(char *dst, char *const *DYND_UNUSED(src)) { *reinterpret_cast<ReturnType *>(dst) = d(g); }
+      uniform_distribution(ReturnType a, ReturnType b)
+          : m_a(static_cast<word_type>(a)),
+            m_bounded(static_cast<word_type>(static_cast<word_type>(b) - static_cast<word_type>(a) + 1)) {
+        if (b < a) {
+          throw std::invalid_argument("uniform: the lower bound a is greater than the upper bound b");
+        }
+      }
+
+      template <typename GeneratorType>
+      void operator()(const GeneratorType &g, uint32_t stream, uint64_t first, size_t size, const uint32_t *w,
+                      value_type *res) const {
+        for (size_t j = 0; j < size; ++j) {
+          res[j] = static_cast<value_type>(m_a + m_bounded.map(bounded_type::load(w + j * words)));
+        }
+
+        for (size_t j = 0; j < size; ++j) {
+          word_type x = bounded_type::load(w + j * words);
+          for (uint32_t extra = 1; !m_bounded.accept(x); ++extra) {
+            uint32_t retry[words];
+            g.generate_words((first + j) * words, stream, extra, words, retry);
+            x = bounded_type::load(retry);
+            res[j] = static_cast<value_type>(m_a + m_bounded.map(x));
+          }
+        }
+      }
     };
 
-    template <typename ReturnType, typename GeneratorType>
-    struct uniform_kernel<ReturnType, GeneratorType, std::enable_if_t<is_complex<ReturnType>::value>>
-        : base_strided_kernel<uniform_kernel<ReturnType, GeneratorType>, 0> {
-      GeneratorType &g;
-      std::uniform_real_distribution<typename ReturnType::value_type> d_real;
-      std::uniform_real_distribution<typename ReturnType::value_type> d_imag;
+    /**
+     * Reals uniform on the half-open interval ``[a, b)``.
+     */
+    template <typename ReturnType>
+    struct uniform_distribution<ReturnType, std::enable_if_t<is_floating_point<ReturnType>::value>> {
+      typedef ReturnType value_type;
+      typedef detail::unit_real<ReturnType> unit_type;
+
+      static const size_t words = unit_type::words;
+
+      ReturnType m_a;
+      ReturnType m_width;
 
-      uniform_kernel(GeneratorType *g, ReturnType a, ReturnType b)
-          : g(*g), d_real(a.real(), b.real()), d_imag(a.imag(), b.imag()) {}
+      uniform_distribution(ReturnType a, ReturnType b) : m_a(a), m_width(b - a) {}
 
-      void single(char *dst, char *const *DYND_UNUSED(src)) {
-        *reinterpret_cast<ReturnType *>(dst) = ReturnType(d_real(g), d_imag(g));
+      template <typename GeneratorType>
+      void operator()(const GeneratorType &DYND_UNUSED(g), uint32_t DYND_UNUSED(stream), uint64_t DYND_UNUSED(first),
+                      size_t size, const uint32_t *w, value_type *res) const {
+        for (size_t j = 0; j < size; ++j) {
+          res[j] = m_a + m_width * unit_type::get(w + j * words);
+        }
       }
     };
 
+    /**
+     * Complex numbers whose real and imaginary parts are independent and
+     * uniform on ``[a.real(), b.real())`` and ``[a.imag(), b.imag())``.
+     */
+    template <typename ReturnType>
+    struct uniform_distribution<ReturnType, std::enable_if_t<is_complex<ReturnType>::value>> {
+      typedef ReturnType value_type;
+      typedef typename ReturnType::value_type real_type;
+      typedef detail::unit_real<real_type> unit_type;
+
+      static const size_t words = 2 * unit_type::words;
+
+      ReturnType m_a;
+      ReturnType m_width;
+
+      uniform_distribution(ReturnType a, ReturnType b)
+          : m_a(a), m_width(b.real() - a.real(), b.imag() - a.imag()) {}
+
+      template <typename GeneratorType>
+      void operator()(const GeneratorType &DYND_UNUSED(g), uint32_t DYND_UNUSED(stream), uint64_t DYND_UNUSED(first),
+                      size_t size, const uint32_t *w, value_type *res) const {
+        for (size_t j = 0; j < size; ++j) {
+          res[j] = ReturnType(m_a.real() + m_width.real() * unit_type::get(w + j * words),
+                              m_a.imag() + m_width.imag() * unit_type::get(w + j * words + unit_type::words));
+        }
+      }
+    };
+
+    template <typename ReturnType, typename GeneratorType>
+    using uniform_kernel = random_kernel<uniform_distribution<ReturnType>, GeneratorType>;
+
   } // namespace dynd::nd::random
 } // namespace dynd::nd
 } // namespace dynd
@@ -0,0 +1,467 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+namespace detail {
+
+  /**
+   * Branch-free polynomial implementations of the elementary functions for
+   * float and double. Each ``fast`` kernel uses only arithmetic, selects and
+   * bit manipulation, so a loop over a contiguous block of inputs compiles to
+   * SIMD code (for double, on x86 this needs the 64-bit lane compares of
+   * SSE4.2 or later). The kernels are valid only on the inputs accepted by
+   * ``in_domain``; the rest (NaNs, infinities, subnormal results, very large
+   * trigonometric arguments) are patched afterwards with the libm function.
+   * Within their domain, the kernels are accurate to ``fast_math_ulp`` units
+   * in the last place.
+   */
+  static const int fast_math_ulp = 4;
+
+  // The error of the libm functions, which is also the default accuracy
+  static const int precise_math_ulp = 1;
+
+  // The accuracy of functions with no fast variant
+  static const int no_fast_math_ulp = std::numeric_limits<int>::max();
+
+  template <typename T>
+  struct float_bits;
+
+  template <>
+  struct float_bits<float> {
+    typedef int32_t int_type;
+    static const int mantissa_bits = 23;
+    static const int exponent_bias = 127;
+  };
+
+  template <>
+  struct float_bits<double> {
+    typedef int64_t int_type;
+    static const int mantissa_bits = 52;
+    static const int exponent_bias = 1023;
+  };
+
+  template <typename T>
+  inline typename float_bits<T>::int_type as_int_bits(T x) {
+    typename float_bits<T>::int_type i;
+    std::memcpy(&i, &x, sizeof(T));
+    return i;
+  }
+
+  template <typename T>
+  inline T from_int_bits(typename float_bits<T>::int_type i) {
+    T x;
+    std::memcpy(&x, &i, sizeof(T));
+    return x;
+  }
+
+  // 1.5 * 2^p, where p is the number of mantissa bits. Adding it to a number
+  // of magnitude below 2^(p - 1) rounds that number to an integer, which is
+  // left in the low bits of the sum.
+  template <typename T>
+  inline T round_shifter() {
+    return static_cast<T>(1.5) *
+           static_cast<T>(typename float_bits<T>::int_type(1) << float_bits<T>::mantissa_bits);
+  }
+
+  // Rounds x to the nearest integer, also returned in ``n`` as an integer.
+  // Unlike std::nearbyint and casts to int64, this vectorizes with SSE2.
+  template <typename T>
+  inline T round_to_int(T x, typename float_bits<T>::int_type &n) {
+    T k = x + round_shifter<T>();
+    n = as_int_bits(k) - as_int_bits(round_shifter<T>());
+    return k - round_shifter<T>();
+  }
+
+  template <typename T>
+  inline T int_to_float(typename float_bits<T>::int_type n) {
+    return from_int_bits<T>(as_int_bits(round_shifter<T>()) + n) - round_shifter<T>();
+  }
+
+  // 2^n for n in the normal exponent range
+  template <typename T>
+  inline T exp2_int(typename float_bits<T>::int_type n) {
+    return from_int_bits<T>((n + float_bits<T>::exponent_bias) << float_bits<T>::mantissa_bits);
+  }
+
+  // Returns ``c ? a : b`` without a branch. A conditional expression whose
+  // arms contain arithmetic that may trap is compiled to a branch, which
+  // stops the loop from vectorizing.
+  template <typename T>
+  inline T select(bool c, T a, T b) {
+    typedef typename float_bits<T>::int_type int_type;
+    int_type mask = -static_cast<int_type>(c);
+    return from_int_bits<T>((as_int_bits(a) & mask) | (as_int_bits(b) & ~mask));
+  }
+
+  template <typename T, size_t N>
+  inline T horner(T x, const T (&c)[N]) {
+    T p = c[N - 1];
+    for (size_t i = N - 1; i > 0; --i) {
+      p = p * x + c[i - 1];
+    }
+    return p;
+  }
+
+  template <typename T>
+  struct math_constants;
+
+  template <>
+  struct math_constants<float> {
+    // Largest argument for which exp has a normal, finite result
+    static float exp_limit() { return 87.0f; }
+    // The trigonometric functions are evaluated in double precision
+    static float trig_limit() { return 1.0e5f; }
+
+    // log(2) split so that multiples of the high part are exact
+    static float ln2_hi() { return 0.693359375f; }
+    static float ln2_lo() { return -2.12194440e-4f; }
+
+    // Taylor coefficients, 1 / k!, of exp on [-log(2) / 2, log(2) / 2]
+    static const float (&exp_coeffs())[8] {
+      static const float c[8] = {1.0f,      1.0f,       1.0f / 2,   1.0f / 6,
+                                 1.0f / 24, 1.0f / 120, 1.0f / 720, 1.0f / 5040};
+      return c;
+    }
+
+    // 2 / (2k + 3), the series of (log(1 + f) - 2s) / s in s^2 with s = f / (2 + f)
+    static const float (&log_coeffs())[5] {
+      static const float c[5] = {2.0f / 3, 2.0f / 5, 2.0f / 7, 2.0f / 9, 2.0f / 11};
+      return c;
+    }
+  };
+
+  template <>
+  struct math_constants<double> {
+    static double exp_limit() { return 708.0; }
+    static double trig_limit() { return 1.0e5; }
+
+    // log(2) and pi / 2 split so that multiples of the leading parts by the
+    // integers that arise within the limits above are exact
+    static double ln2_hi() { return 6.93147180369123816490e-01; }
+    static double ln2_lo() { return 1.90821492927058770002e-10; }
+    static double pio2_1() { return 1.57079632673412561417e+00; }
+    static double pio2_2() { return 6.07710050630396597660e-11; }
+    static double pio2_3() { return 2.02226624871116645580e-21; }
+    static double pio2_3t() { return 8.47842766036889956997e-32; }
+
+    static const double (&exp_coeffs())[14] {
+      static const double c[14] = {1.0,
+                                   1.0,
+                                   1.0 / 2,
+                                   1.0 / 6,
+                                   1.0 / 24,
+                                   1.0 / 120,
+                                   1.0 / 720,
+                                   1.0 / 5040,
+                                   1.0 / 40320,
+                                   1.0 / 362880,
+                                   1.0 / 3628800,
+                                   1.0 / 39916800,
+                                   1.0 / 479001600,
+                                   1.0 / 6227020800.0};
+      return c;
+    }
+
+    static const double (&log_coeffs())[11] {
+      static const double c[11] = {2.0 / 3,  2.0 / 5,  2.0 / 7,  2.0 / 9,  2.0 / 11, 2.0 / 13,
+                                   2.0 / 15, 2.0 / 17, 2.0 / 19, 2.0 / 21, 2.0 / 23};
+      return c;
+    }
+
+    // (-1)^k / (2k + 1)! and (-1)^k / (2k)!, on [-pi / 4, pi / 4]
+    static const double (&sin_coeffs())[9] {
+      static const double c[9] = {1.0,
+                                  -1.0 / 6,
+                                  1.0 / 120,
+                                  -1.0 / 5040,
+                                  1.0 / 362880,
+                                  -1.0 / 39916800,
+                                  1.0 / 6227020800.0,
+                                  -1.0 / 1307674368000.0,
+                                  1.0 / 355687428096000.0};
+      return c;
+    }
+
+    static const double (&cos_coeffs())[9] {
+      static const double c[9] = {1.0,
+                                  -1.0 / 2,
+                                  1.0 / 24,
+                                  -1.0 / 720,
+                                  1.0 / 40320,
+                                  -1.0 / 3628800,
+                                  1.0 / 479001600,
+                                  -1.0 / 87178291200.0,
+                                  1.0 / 20922789888000.0};
+      return c;
+    }
+  };
+
+  template <typename T>
+  inline T fast_exp(T x) {
+    typedef math_constants<T> K;
+
+    typename float_bits<T>::int_type ni;
+    T n = round_to_int(x * static_cast<T>(1.442695040888963407359924681001892137), ni);
+    T r = (x - n * K::ln2_hi()) - n * K::ln2_lo();
+    return horner(r, K::exp_coeffs()) * exp2_int<T>(ni);
+  }
+
+  template <typename T>
+  inline T fast_log(T x) {
+    typedef typename float_bits<T>::int_type int_type;
+    typedef math_constants<T> K;
+    const int_type mantissa_mask = (int_type(1) << float_bits<T>::mantissa_bits) - 1;
+
+    // x = m * 2^e with m in [sqrt(2) / 2, sqrt(2))
+    int_type bits = as_int_bits(x);
+    T e = int_to_float<T>((bits >> float_bits<T>::mantissa_bits) - float_bits<T>::exponent_bias);
+    T m = from_int_bits<T>((bits & mantissa_mask) |
+                           (int_type(float_bits<T>::exponent_bias) << float_bits<T>::mantissa_bits));
+    bool big = m > static_cast<T>(1.414213562373095048801688724209698079);
+    m = select(big, m * static_cast<T>(0.5), m);
+    e = select(big, e + 1, e);
+
+    // log(1 + f) = 2 atanh(s) = f - s (f - R)
+    T f = m - 1;
+    T s = f / (2 + f);
+    T z = s * s;
+    T r = z * horner(z, K::log_coeffs());
+    return e * K::ln2_hi() + ((f - s * (f - r)) + e * K::ln2_lo());
+  }
+
+  template <typename T>
+  inline T fast_log1p(T x) {
+    // Corrects the rounding of 1 + x, as in Goldberg's "What every computer
+    // scientist should know about floating-point arithmetic"
+    T u = 1 + x;
+    T d = u - 1;
+    return select(d == 0, x, fast_log(u) * (x / d));
+  }
+
+  template <typename T>
+  inline T fast_expm1(T x) {
+    // Kahan's correction of exp(x) - 1
+    T u = fast_exp(x);
+    T d = u - 1;
+    T res = select(u == 1, x, d * (x / fast_log(u)));
+    return select(d == -1, static_cast<T>(-1), res);
+  }
+
+  inline double fast_tanh(double x) {
+    // tanh(x) rounds to 1 beyond 20
+    double a = std::fabs(x);
+    a = select(a < 20.0, a, 20.0);
+    double t = fast_expm1(-2 * a);
+    return std::copysign(-t / (t + 2), x);
+  }
+
+  // Reduces x to r in [-pi / 4, pi / 4] with x = r + n pi / 2, returning n mod 4
+  inline int64_t reduce_pio2(double x, double &r) {
+    typedef math_constants<double> K;
+
+    int64_t ni;
+    double n = round_to_int(x * 0.636619772367581343075535053490057448, ni);
+
+    // The first two products are exact, and the rounding error of their
+    // difference is recovered with Knuth's two-sum
+    double a = x - n * K::pio2_1();
+    double b = -(n * K::pio2_2());
+    double hi = a + b;
+    double bv = hi - a;
+    double lo = (a - (hi - bv)) + (b - bv);
+    r = hi + ((lo - n * K::pio2_3()) - n * K::pio2_3t());
+    return ni & 3;
+  }
+
+  inline double fast_sin(double x) {
+    double r;
+    int64_t q = reduce_pio2(x, r);
+    double z = r * r;
+    double s = r * horner(z, math_constants<double>::sin_coeffs());
+    double c = horner(z, math_constants<double>::cos_coeffs());
+    double res = select((q & 1) != 0, c, s);
+    return select((q & 2) != 0, -res, res);
+  }
+
+  inline double fast_cos(double x) {
+    double r;
+    int64_t q = reduce_pio2(x, r);
+    double z = r * r;
+    double s = r * horner(z, math_constants<double>::sin_coeffs());
+    double c = horner(z, math_constants<double>::cos_coeffs());
+    double res = select((q & 1) != 0, s, c);
+    return select(((q + 1) & 2) != 0, -res, res);
+  }
+
+  inline double fast_tan(double x) {
+    double r;
+    int64_t q = reduce_pio2(x, r);
+    double z = r * r;
+    double s = r * horner(z, math_constants<double>::sin_coeffs());
+    double c = horner(z, math_constants<double>::cos_coeffs());
+    return select((q & 1) != 0, -c / s, s / c);
+  }
+
+  // In single precision, the argument reduction and the cancellation in
+  // tanh cost more accuracy than the format has to spare, so these round the
+  // double precision result
+  inline float fast_tanh(float x) { return static_cast<float>(fast_tanh(static_cast<double>(x))); }
+  inline float fast_sin(float x) { return static_cast<float>(fast_sin(static_cast<double>(x))); }
+  inline float fast_cos(float x) { return static_cast<float>(fast_cos(static_cast<double>(x))); }
+  inline float fast_tan(float x) { return static_cast<float>(fast_tan(static_cast<double>(x))); }
+
+  /**
+   * The functions below pair the libm implementation, ``precise``, with the
+   * branch-free one, ``fast``, which is used when the caller accepts an error
+   * of ``fast_ulp`` units in the last place. ``safe`` is an argument in the
+   * domain, used in place of arguments outside of it so that the vectorized
+   * pass never evaluates the kernel on NaN or infinity.
+   */
+
+  template <typename T>
+  struct math_exp {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::exp(x); }
+    static T fast(T x) { return fast_exp(x); }
+    static bool in_domain(T x) { return std::fabs(x) <= math_constants<T>::exp_limit(); }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_expm1 {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::expm1(x); }
+    static T fast(T x) { return fast_expm1(x); }
+    static bool in_domain(T x) { return std::fabs(x) <= math_constants<T>::exp_limit(); }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_log {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::log(x); }
+    static T fast(T x) { return fast_log(x); }
+    static bool in_domain(T x) {
+      return x >= std::numeric_limits<T>::min() && x <= std::numeric_limits<T>::max();
+    }
+    static T safe() { return 1; }
+  };
+
+  template <typename T>
+  struct math_log1p {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::log1p(x); }
+    static T fast(T x) { return fast_log1p(x); }
+    static bool in_domain(T x) { return x > -1 && x <= std::numeric_limits<T>::max() / 2; }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_tanh {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::tanh(x); }
+    static T fast(T x) { return fast_tanh(x); }
+    static bool in_domain(T x) { return x == x; }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_sin {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::sin(x); }
+    static T fast(T x) { return fast_sin(x); }
+    static bool in_domain(T x) { return std::fabs(x) <= math_constants<T>::trig_limit(); }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_cos {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::cos(x); }
+    static T fast(T x) { return fast_cos(x); }
+    static bool in_domain(T x) { return std::fabs(x) <= math_constants<T>::trig_limit(); }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_tan {
+    static const int fast_ulp = fast_math_ulp;
+
+    static T precise(T x) { return std::tan(x); }
+    static T fast(T x) { return fast_tan(x); }
+    static bool in_domain(T x) { return std::fabs(x) <= math_constants<T>::trig_limit(); }
+    static T safe() { return 0; }
+  };
+
+  // IEEE square root is correctly rounded, so the block path is always used
+  template <typename T>
+  struct math_sqrt {
+    static const int fast_ulp = 0;
+
+    static T precise(T x) { return std::sqrt(x); }
+    static T fast(T x) { return std::sqrt(x); }
+    static bool in_domain(T x) { return x >= 0; }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_cbrt {
+    static const int fast_ulp = no_fast_math_ulp;
+
+    static T precise(T x) { return std::cbrt(x); }
+    static T fast(T x) { return std::cbrt(x); }
+    static bool in_domain(T DYND_UNUSED(x)) { return false; }
+    static T safe() { return 0; }
+  };
+
+  template <typename T>
+  struct math_pow;
+
+  // Evaluated as exp(y log(x)) in double precision, which rounds to within
+  // one unit in the last place of float
+  template <>
+  struct math_pow<float> {
+    static const int fast_ulp = precise_math_ulp;
+
+    static float precise(float x, float y) { return std::pow(x, y); }
+    static float fast(float x, float y) {
+      double d = static_cast<double>(y) * fast_log(static_cast<double>(x));
+      d = select(d < 700.0, d, 700.0);
+      d = select(d > -700.0, d, -700.0);
+      return static_cast<float>(fast_exp(d));
+    }
+    static bool in_domain(float x, float y) {
+      return x > 0 && x <= std::numeric_limits<float>::max() && std::fabs(y) <= std::numeric_limits<float>::max();
+    }
+    static float safe() { return 1; }
+  };
+
+  template <>
+  struct math_pow<double> {
+    static const int fast_ulp = no_fast_math_ulp;
+
+    static double precise(double x, double y) { return std::pow(x, y); }
+    static double fast(double x, double y) { return std::pow(x, y); }
+    static bool in_domain(double DYND_UNUSED(x), double DYND_UNUSED(y)) { return false; }
+    static double safe() { return 1; }
+  };
+
+} // namespace dynd::detail
+} // namespace dynd
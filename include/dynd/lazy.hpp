@@ -0,0 +1,68 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * A deferred elementwise expression. Operators on a lazy_array build an
+   * expression graph instead of allocating a temporary for every operation.
+   * Calling eval() fuses the whole graph into one kernel that streams
+   * DYND_BUFFER_CHUNK_SIZE elements at a time through every operation, so
+   * intermediate results stay in cache.
+   *
+   * Operators on plain nd::array values are unaffected and evaluate eagerly.
+   */
+  class DYND_API lazy_array {
+  public:
+    struct node;
+
+  private:
+    std::shared_ptr<const node> m_node;
+
+  public:
+    /** Wraps an evaluated array as a leaf of an expression */
+    lazy_array(const array &value);
+
+    /**
+     * Defers applying an elementwise callable to the given operands. The
+     * callable is resolved against the scalar types of the operands.
+     */
+    lazy_array(const callable &op, std::initializer_list<lazy_array> args);
+
+    /** Evaluates the expression into a new array */
+    array eval() const;
+  };
+
+  /** Starts a deferred expression from an array */
+  inline lazy_array lazy(const array &a) { return lazy_array(a); }
+
+  DYND_API lazy_array operator+(const lazy_array &a0);
+  DYND_API lazy_array operator-(const lazy_array &a0);
+
+  DYND_API lazy_array operator+(const lazy_array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator-(const lazy_array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator*(const lazy_array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator/(const lazy_array &a0, const lazy_array &a1);
+
+  DYND_API lazy_array operator+(const lazy_array &a0, const array &a1);
+  DYND_API lazy_array operator-(const lazy_array &a0, const array &a1);
+  DYND_API lazy_array operator*(const lazy_array &a0, const array &a1);
+  DYND_API lazy_array operator/(const lazy_array &a0, const array &a1);
+
+  DYND_API lazy_array operator+(const array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator-(const array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator*(const array &a0, const lazy_array &a1);
+  DYND_API lazy_array operator/(const array &a0, const lazy_array &a1);
+
+} // namespace dynd::nd
+} // namespace dynd
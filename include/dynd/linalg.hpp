@@ -0,0 +1,29 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <dynd/callable.hpp>
+
+namespace dynd {
+namespace nd {
+
+  /**
+   * The matrix product of two float32, float64, complex[float32] or
+   * complex[float64] arrays of the same type, over their last two dimensions
+   * and broadcast over the rest, as numpy.matmul. An argument with one
+   * dimension is treated as a vector.
+   */
+  extern DYND_API callable matmul;
+
+  /**
+   * The sum of products over the last ``axes`` dimensions of the first
+   * argument and the first ``axes`` dimensions of the second, as
+   * numpy.tensordot with an integer ``axes``, which defaults to 2.
+   */
+  extern DYND_API callable tensordot;
+
+} // namespace dynd::nd
+} // namespace dynd
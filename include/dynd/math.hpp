@@ -362,10 +362,20 @@ complex<T> sin(complex<T> z) {
 
 namespace nd {
 
+  /**
+   * Elementwise elementary functions of float32 and float64 arrays. By
+   * default they match the C library. Passing ``ulp`` of 4 or more accepts
+   * that error, in units in the last place, and selects branch-free
+   * polynomial implementations that process contiguous blocks with SIMD.
+   */
   extern DYND_API callable cos;
   extern DYND_API callable sin;
   extern DYND_API callable tan;
   extern DYND_API callable exp;
+  extern DYND_API callable expm1;
+  extern DYND_API callable log;
+  extern DYND_API callable log1p;
+  extern DYND_API callable tanh;
 
   extern DYND_API callable real;
   extern DYND_API callable imag;
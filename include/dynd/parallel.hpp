@@ -0,0 +1,38 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#pragma once
+
+#include <functional>
+
+#include <dynd/config.hpp>
+
+namespace dynd {
+
+/**
+ * The number of threads that parallel kernels split their work across. This
+ * defaults to the DYND_NUM_THREADS environment variable if it is set, and to
+ * the hardware concurrency otherwise.
+ */
+DYND_API size_t get_num_threads();
+
+/**
+ * Sets the number of threads that parallel kernels use. A value of 1
+ * disables threading, and 0 restores the default.
+ */
+DYND_API void set_num_threads(size_t nthread);
+
+/**
+ * Calls ``task(i)`` for every ``i`` in ``[0, ntask)`` on up to
+ * get_num_threads() threads, including the calling one, and returns once all
+ * of them have finished. Tasks are handed out in order as threads become
+ * free. If a task throws, the first exception is rethrown here.
+ *
+ * A parallel_for called from inside a task runs its tasks serially on that
+ * thread.
+ */
+DYND_API void parallel_for(size_t ntask, const std::function<void(size_t)> &task);
+
+} // namespace dynd
@@ -15,8 +15,29 @@ namespace dynd {
 namespace nd {
   namespace random {
 
+    /**
+     * The random callables take an optional integer ``seed`` and ``stream``.
+     * The same seed and stream always give the same values, however many
+     * threads fill them in, and different streams with the same seed are
+     * independent. Without a seed, every call is seeded differently.
+     */
+
+    /** Draws values uniformly from ``[a, b]`` for integers, and ``[a, b)`` otherwise. */
     extern DYND_API callable uniform;
 
+    /** Draws reals from the normal distribution with mean ``loc`` and standard deviation ``scale``. */
+    extern DYND_API callable normal;
+
+    /** Draws reals from the exponential distribution with mean ``scale``. */
+    extern DYND_API callable exponential;
+
+    /** Shuffles an array in place along its outermost dimension. */
+    extern DYND_API callable shuffle;
+
+    /** Returns the integers ``0`` through ``n - 1`` in a random order, as int64. */
+    DYND_API array permutation(intptr_t n);
+    DYND_API array permutation(intptr_t n, uint64_t seed, uint32_t stream = 0);
+
   } // namespace dynd::nd::random
 
   inline array rand(const ndt::type &tp) { return random::uniform({}, {{"dst_tp", tp}}); }
@@ -10,7 +10,18 @@
 namespace dynd {
 namespace nd {
 
+  /**
+   * Sorts a one-dimensional array in place, or each row of a two-dimensional
+   * one. Integer and floating point arrays are radix sorted, with NaNs at
+   * the end, and large inputs are sorted on get_num_threads() threads.
+   */
   extern DYND_API callable sort;
+
+  /** Like sort, but keeps equal elements in their original order. */
+  extern DYND_API callable stable_sort;
+
+  /** Returns the permutation that stably sorts an array, or each row of one, as int64 indices. */
+  extern DYND_API callable argsort;
   extern DYND_API callable unique;
 
 } // namespace dynd::nd
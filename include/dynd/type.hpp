@@ -145,7 +145,27 @@ namespace ndt {
     type(const char *rep_begin, const char *rep_end);
 
     bool operator==(const type &rhs) const {
-      return m_ptr == rhs.m_ptr || (!is_builtin() && !rhs.is_builtin() && *m_ptr == *rhs.m_ptr);
+      if (m_ptr == rhs.m_ptr) {
+        return true;
+      } else if (is_builtin() || rhs.is_builtin()) {
+        return false;
+      } else if (m_ptr->is_interned() && rhs.m_ptr->is_interned()) {
+        // Equal types share one interned instance
+        return false;
+      }
+
+      return *m_ptr == *rhs.m_ptr;
+    }
+
+    /**
+     * The structural hash of the type, which is the same for equal types.
+     */
+    std::size_t get_hash() const {
+      if (is_builtin()) {
+        return detail::hash_combine(0, reinterpret_cast<uintptr_t>(m_ptr));
+      }
+
+      return m_ptr->is_interned() ? m_ptr->get_hash() : m_ptr->compute_hash();
     }
 
     bool operator!=(const type &rhs) const { return !(operator==(rhs)); }
@@ -724,66 +744,66 @@ namespace ndt {
   }
 
   /**
-   * Allocates and constructs a type with a use count of 1.
+   * Allocates and constructs a type, returning its interned instance.
    */
   template <typename T, typename... ArgTypes>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type> make_type(ArgTypes &&... args) {
-    return type(new T(id_of<T>::value, std::forward<ArgTypes>(args)...), false);
+    return detail::intern(type(new T(id_of<T>::value, std::forward<ArgTypes>(args)...), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type> make_type(std::initializer_list<type> field_tp) {
-    return type(new T(id_of<T>::value, field_tp), false);
+    return detail::intern(type(new T(id_of<T>::value, field_tp), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type> make_type(std::initializer_list<type> field_tp,
                                                                          bool variadic) {
-    return type(new T(id_of<T>::value, field_tp, variadic), false);
+    return detail::intern(type(new T(id_of<T>::value, field_tp, variadic), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type> make_type(std::initializer_list<std::string> field_names,
                                                                          std::initializer_list<type> field_tp) {
-    return type(new T(id_of<T>::value, field_names, field_tp), false);
+    return detail::intern(type(new T(id_of<T>::value, field_names, field_tp), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type>
   make_type(std::initializer_list<std::pair<type, std::string>> fields) {
-    return type(new T(id_of<T>::value, fields), false);
+    return detail::intern(type(new T(id_of<T>::value, fields), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type>
   make_type(std::initializer_list<std::pair<type, std::string>> fields, bool variadic) {
-    return type(new T(id_of<T>::value, fields, variadic), false);
+    return detail::intern(type(new T(id_of<T>::value, fields, variadic), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type>
   make_type(std::initializer_list<std::string> field_names, std::initializer_list<type> field_tp, bool variadic) {
-    return type(new T(id_of<T>::value, field_names, field_tp, variadic), false);
+    return detail::intern(type(new T(id_of<T>::value, field_names, field_tp, variadic), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type> make_type(const type &ret_tp,
                                                                          std::initializer_list<type> arg_tp) {
-    return type(new T(id_of<T>::value, ret_tp, arg_tp), false);
+    return detail::intern(type(new T(id_of<T>::value, ret_tp, arg_tp), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type>
   make_type(const type &ret_tp, std::initializer_list<type> arg_tp,
             std::initializer_list<std::pair<type, std::string>> kwd_tp) {
-    return type(new T(id_of<T>::value, ret_tp, arg_tp, kwd_tp), false);
+    return detail::intern(type(new T(id_of<T>::value, ret_tp, arg_tp, kwd_tp), false));
   }
 
   template <typename T>
   std::enable_if_t<std::is_base_of<base_type, T>::value, type>
   make_type(const type &ret_tp, std::initializer_list<type> arg_tp,
             const std::vector<std::pair<type, std::string>> &kwd_tp) {
-    return type(new T(id_of<T>::value, ret_tp, arg_tp, kwd_tp), false);
+    return detail::intern(type(new T(id_of<T>::value, ret_tp, arg_tp, kwd_tp), false));
   }
 
   /*
@@ -1151,3 +1171,12 @@ DYNDT_API void print_indented(std::ostream &o, const std::string &indent, const
 DYNDT_API bool is_lossless_assignment(const ndt::type &dst_tp, const ndt::type &src_tp);
 
 } // namespace dynd
+
+namespace std {
+
+template <>
+struct hash<dynd::ndt::type> {
+  size_t operator()(const dynd::ndt::type &tp) const { return tp.get_hash(); }
+};
+
+} // namespace std
@@ -74,6 +74,13 @@ namespace detail {
 
   extern DYNDT_API std::vector<id_info> &infos();
 
+  /**
+   * The number of type ids registered and of type constructors registered
+   * for them, which changes whenever what a datashape means may change. It
+   * can be read without the lock of the registry.
+   */
+  extern DYNDT_API size_t get_registration_count();
+
 } // namespace dynd::detail
 
 DYNDT_API type_id_t new_id(const char *name, type_id_t base_id);
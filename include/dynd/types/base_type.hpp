@@ -20,6 +20,22 @@ namespace ndt {
 
   class type;
 
+  namespace detail {
+
+    /**
+     * Returns the interned instance of a type, which is either the instance
+     * of an equal type that is alive or, if there is none, ``tp`` itself,
+     * added to the intern table. Every non-builtin type is interned by
+     * ndt::make_type, so equal types share one instance.
+     */
+    DYNDT_API type intern(type &&tp);
+
+    inline std::size_t hash_combine(std::size_t seed, std::size_t value) {
+      return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+  } // namespace dynd::ndt::detail
+
 } // namespace dynd::ndt
 
 struct iterdata_common;
@@ -86,6 +102,10 @@ namespace ndt {
   class DYNDT_API base_type {
     /** Embedded reference counting */
     mutable std::atomic_long m_use_count;
+    /** The structural hash, set when the type is interned */
+    std::size_t m_hash;
+    /** Whether the type is in the intern table, which it leaves when it is destroyed */
+    bool m_interned;
 
   protected:
     type_id_t m_id;          // The type id
@@ -100,7 +120,7 @@ namespace ndt {
     /** Starts off the extended type instance with a use count of 1. */
     base_type(type_id_t id, size_t data_size, size_t data_alignment, uint32_t flags, size_t arrmeta_size, size_t ndim,
               size_t strided_ndim)
-        : m_use_count(1), m_id(id), m_metadata_size(arrmeta_size), m_data_size(data_size),
+        : m_use_count(1), m_hash(0), m_interned(false), m_id(id), m_metadata_size(arrmeta_size), m_data_size(data_size),
           m_data_alignment(data_alignment), flags(flags), m_ndim(ndim), m_fixed_ndim(strided_ndim) {}
 
     virtual ~base_type();
@@ -108,6 +128,18 @@ namespace ndt {
     /** For debugging purposes, the type's use count */
     int32_t get_use_count() const { return m_use_count; }
 
+    /**
+     * The structural hash of the type, which is the same for equal types.
+     * It is computed once, when the type is interned, and is 0 before.
+     */
+    std::size_t get_hash() const { return m_hash; }
+
+    /**
+     * Whether the type is the interned instance of its value. Two distinct
+     * interned instances are never equal.
+     */
+    bool is_interned() const { return m_interned; }
+
     /**
       * The type's id.
       */
@@ -372,6 +404,13 @@ namespace ndt {
 
     virtual bool operator==(const base_type &rhs) const = 0;
 
+    /**
+     * Computes the structural hash of the type, which must be the same for
+     * types that compare equal. The default hashes the type id, and types
+     * with parameters should combine them in.
+     */
+    virtual std::size_t compute_hash() const;
+
     /**
      * Constructs the nd::array arrmeta for this type using default settings.
      * The element size of the result must match that from
@@ -484,6 +523,7 @@ namespace ndt {
     friend long intrusive_ptr_use_count(const base_type *ptr);
 
     friend type make_dynamic_type(type_id_t tp_id);
+    friend type detail::intern(type &&tp);
   };
 
   /**
@@ -52,6 +52,8 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    std::size_t compute_hash() const;
+
     void data_destruct(const char *arrmeta, char *data) const;
     void data_destruct_strided(const char *arrmeta, char *data, intptr_t stride, size_t count) const;
 
@@ -130,6 +130,8 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    std::size_t compute_hash() const;
+
     void arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const;
     void arrmeta_copy_construct(char *dst_arrmeta, const char *src_arrmeta,
                                 const nd::memory_block &embedded_reference) const;
@@ -7,9 +7,15 @@
 
 #pragma once
 
+#include <cstring>
+#include <sstream>
+#include <vector>
+
 #include <dynd/array.hpp>
+#include <dynd/bytes.hpp>
 #include <dynd/type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/string_type.hpp>
 
 namespace {
 
@@ -18,6 +24,183 @@ struct assign_to_same_category_type;
 } // anonymous namespace
 
 namespace dynd {
+namespace detail {
+
+  /**
+   * An open-addressed hash table of the distinct values in a strided
+   * one-dimensional array, storing the index of the first occurrence of each.
+   * Values are hashed and compared by the bytes that make them up, which are
+   * the data itself for POD types and the referenced characters for string
+   * and bytes. This is what categorical_type uses to find the category of a
+   * value, and what factor_categorical uses to find the distinct values.
+   */
+  class category_hash_table {
+    struct slot {
+      uint64_t hash;
+      intptr_t index;
+    };
+
+    type_id_t m_id;
+    size_t m_data_size;
+    const char *m_origin;
+    intptr_t m_stride;
+    std::vector<slot> m_slots;
+    size_t m_size;
+
+    void get_key(const char *data, const char *&begin, size_t &size) const {
+      switch (m_id) {
+      case string_id:
+        begin = reinterpret_cast<const dynd::string *>(data)->data();
+        size = reinterpret_cast<const dynd::string *>(data)->size();
+        break;
+      case bytes_id:
+        begin = reinterpret_cast<const dynd::bytes *>(data)->data();
+        size = reinterpret_cast<const dynd::bytes *>(data)->size();
+        break;
+      default:
+        begin = data;
+        size = m_data_size;
+        break;
+      }
+    }
+
+    static uint64_t mix(uint64_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      return h ^ (h >> 33);
+    }
+
+    void grow() {
+      std::vector<slot> slots(m_slots.empty() ? 16 : 2 * m_slots.size(), slot{0, -1});
+      size_t mask = slots.size() - 1;
+      for (const slot &s : m_slots) {
+        if (s.index >= 0) {
+          size_t j = s.hash & mask;
+          while (slots[j].index >= 0) {
+            j = (j + 1) & mask;
+          }
+          slots[j] = s;
+        }
+      }
+      m_slots.swap(slots);
+    }
+
+  public:
+    category_hash_table() : m_id(uninitialized_id), m_data_size(0), m_origin(NULL), m_stride(0), m_size(0) {}
+
+    /**
+     * Creates an empty table over the values ``origin + i * stride`` of type
+     * ``tp``, with room for ``capacity`` of them before it has to grow.
+     */
+    category_hash_table(const ndt::type &tp, const char *origin, intptr_t stride, size_t capacity = 0)
+        : m_id(tp.get_id()), m_data_size(tp.get_data_size()), m_origin(origin), m_stride(stride), m_size(0) {
+      if (m_id != string_id && m_id != bytes_id && !tp.is_pod()) {
+        std::stringstream ss;
+        ss << "categorical values of type " << tp << " are not supported";
+        throw type_error(ss.str());
+      }
+
+      size_t nslot = 16;
+      while (nslot < 2 * capacity) {
+        nslot *= 2;
+      }
+      m_slots.assign(nslot, slot{0, -1});
+    }
+
+    size_t size() const { return m_size; }
+
+    uint64_t hash(const char *data) const {
+      const char *begin;
+      size_t size;
+      get_key(data, begin, size);
+
+      uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+      for (; size >= 8; begin += 8, size -= 8) {
+        uint64_t word;
+        memcpy(&word, begin, 8);
+        h = mix(h ^ word);
+      }
+      if (size > 0) {
+        uint64_t word = 0;
+        memcpy(&word, begin, size);
+        h = mix(h ^ word);
+      }
+
+      return mix(h);
+    }
+
+    bool equal(const char *lhs, const char *rhs) const {
+      const char *lhs_begin, *rhs_begin;
+      size_t lhs_size, rhs_size;
+      get_key(lhs, lhs_begin, lhs_size);
+      get_key(rhs, rhs_begin, rhs_size);
+
+      return lhs_size == rhs_size && memcmp(lhs_begin, rhs_begin, lhs_size) == 0;
+    }
+
+    /**
+     * Hints that a lookup of a value with hash ``h`` is coming, so a batch of
+     * lookups can overlap their cache misses.
+     */
+    void prefetch(uint64_t h) const {
+#if defined(__GNUC__)
+      __builtin_prefetch(&m_slots[h & (m_slots.size() - 1)]);
+#else
+      (void)h;
+#endif
+    }
+
+    /**
+     * Returns the index of the value equal to the one at ``data``, which has
+     * hash ``h``, or -1 if there is none.
+     */
+    intptr_t find(const char *data, uint64_t h) const {
+      size_t mask = m_slots.size() - 1;
+      for (size_t j = h & mask;; j = (j + 1) & mask) {
+        const slot &s = m_slots[j];
+        if (s.index < 0) {
+          return -1;
+        }
+        if (s.hash == h && equal(m_origin + s.index * m_stride, data)) {
+          return s.index;
+        }
+      }
+    }
+
+    intptr_t find(const char *data) const { return find(data, hash(data)); }
+
+    /**
+     * Adds the value at ``index``, unless an equal one is in the table already,
+     * and returns the index of the value in the table.
+     */
+    intptr_t insert(intptr_t index, uint64_t h) {
+      if (2 * (m_size + 1) > m_slots.size()) {
+        grow();
+      }
+
+      const char *data = m_origin + index * m_stride;
+      size_t mask = m_slots.size() - 1;
+      for (size_t j = h & mask;; j = (j + 1) & mask) {
+        slot &s = m_slots[j];
+        if (s.index < 0) {
+          s.hash = h;
+          s.index = index;
+          ++m_size;
+          return index;
+        }
+        if (s.hash == h && equal(m_origin + s.index * m_stride, data)) {
+          return s.index;
+        }
+      }
+    }
+
+    intptr_t insert(intptr_t index) { return insert(index, hash(m_origin + index * m_stride)); }
+  };
+
+} // namespace dynd::detail
+
 namespace ndt {
 
   class DYND_API categorical_type : public base_type {
@@ -31,6 +214,8 @@ namespace ndt {
     nd::array m_category_index_to_value;
     // mapping from values to category indices
     nd::array m_value_to_category_index;
+    // hash table from category values to category indices
+    dynd::detail::category_hash_table m_category_table;
 
   public:
     categorical_type(type_id_t new_id, const nd::array &categories, bool presorted = false);
@@ -59,6 +244,25 @@ namespace ndt {
     uint32_t get_value_from_category(const char *category_arrmeta, const char *category_data) const;
     uint32_t get_value_from_category(const nd::array &category) const;
 
+    /**
+     * Returns the hash table from category values, which must have the
+     * category type, to their index in the sorted categories.
+     */
+    const dynd::detail::category_hash_table &get_category_table() const { return m_category_table; }
+
+    /**
+     * Returns the value stored for the category at ``index`` in the sorted
+     * categories.
+     */
+    uint32_t get_value_from_category_index(intptr_t index) const {
+      return static_cast<uint32_t>(unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, index));
+    }
+
+    /**
+     * Raises the error for a value that is not one of the categories.
+     */
+    void throw_unrecognized_category(const char *category_arrmeta, const char *category_data) const;
+
     const char *get_category_data_from_value(uint32_t value) const {
       if (value >= get_category_count()) {
         throw std::runtime_error("category value is out of bounds");
@@ -95,8 +299,13 @@ namespace ndt {
   };
 
   template <>
-  struct id_of<categorical_type> : std::integral_constant<type_id_t, categorical_kind_id> {};
+  struct id_of<categorical_type> : std::integral_constant<type_id_t, categorical_id> {};
 
+  /**
+   * Returns the categorical type whose categories are the distinct values in
+   * the one-dimensional array ``values``, in sorted order. Large arrays are
+   * split across get_num_threads() threads.
+   */
   DYND_API type factor_categorical(const nd::array &values);
 
 } // namespace dynd::ndt
@@ -59,6 +59,8 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    std::size_t compute_hash() const;
+
     void arrmeta_default_construct(char *DYND_UNUSED(arrmeta), bool DYND_UNUSED(blockref_alloc)) const {}
     void arrmeta_copy_construct(char *DYND_UNUSED(dst_arrmeta), const char *DYND_UNUSED(src_arrmeta),
                                 const nd::memory_block &DYND_UNUSED(embedded_reference)) const {}
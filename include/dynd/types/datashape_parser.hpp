@@ -16,6 +16,9 @@ namespace dynd {
  *
  * The string buffer should be encoded with UTF-8.
  *
+ * Parsed types are cached for the process, so parsing a datashape again
+ * skips the parser.
+ *
  * \param datashape_begin  The start of the buffer containing the datashape.
  * \param datashape_end    The end of the buffer containing the datashape.
  */
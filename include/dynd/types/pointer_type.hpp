@@ -80,6 +80,8 @@ namespace ndt {
 
     bool operator==(const base_type &rhs) const;
 
+    std::size_t compute_hash() const;
+
     type with_replaced_storage_type(const type &replacement_type) const;
 
     void arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const;
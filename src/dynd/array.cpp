@@ -27,6 +27,7 @@
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/option_type.hpp>
 #include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
 #include <dynd/types/tuple_type.hpp>
 #include <dynd/types/type_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
@@ -965,6 +966,97 @@ nd::array nd::combine_into_tuple(size_t field_count, const array *field_values)
   return result;
 }
 
+namespace {
+
+// The struct type of the elements of a ``N * struct`` type
+const ndt::type &get_row_struct_type(const ndt::type &tp) {
+  if (tp.get_id() == fixed_dim_id) {
+    const ndt::type &element_tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    if (element_tp.get_id() == struct_id) {
+      return element_tp;
+    }
+  }
+
+  stringstream ss;
+  ss << "expected a fixed dimension of structs, not " << tp;
+  throw type_error(ss.str());
+}
+
+// The struct of ``dim_size * T`` columns for a struct of fields ``T``
+ndt::type make_columns_type(intptr_t dim_size, const ndt::type &struct_tp) {
+  const ndt::struct_type *sd = struct_tp.extended<ndt::struct_type>();
+  vector<ndt::type> column_types;
+  for (const ndt::type &field_tp : sd->get_field_types()) {
+    column_types.push_back(ndt::make_fixed_dim(dim_size, field_tp));
+  }
+
+  return ndt::make_type<ndt::struct_type>(sd->get_field_names(), column_types);
+}
+
+} // unnamed namespace
+
+nd::array nd::empty_columnar(intptr_t dim_size, const ndt::type &struct_tp) {
+  if (struct_tp.get_id() != struct_id) {
+    stringstream ss;
+    ss << "expected a struct to store in columns, not " << struct_tp;
+    throw type_error(ss.str());
+  }
+
+  // The default layout of a struct places each field, here a column, after the one before it
+  return empty(make_columns_type(dim_size, struct_tp));
+}
+
+bool nd::is_columnar(const array &a) {
+  const ndt::type &tp = a.get_type();
+  if (tp.get_id() != struct_id) {
+    return false;
+  }
+
+  intptr_t dim_size = -1;
+  for (const ndt::type &column_tp : tp.extended<ndt::struct_type>()->get_field_types()) {
+    if (column_tp.get_id() != fixed_dim_id ||
+        (dim_size != -1 && column_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size() != dim_size)) {
+      return false;
+    }
+    dim_size = column_tp.extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+  }
+
+  return dim_size != -1;
+}
+
+nd::array nd::to_columnar(const array &a) {
+  const ndt::type &struct_tp = get_row_struct_type(a.get_type());
+  array res = empty_columnar(a.get_dim_size(), struct_tp);
+  for (const std::string &name : struct_tp.extended<ndt::struct_type>()->get_field_names()) {
+    res.p(name).assign(a.p(name));
+  }
+
+  return res;
+}
+
+nd::array nd::to_rowwise(const array &a) {
+  if (!is_columnar(a)) {
+    stringstream ss;
+    ss << "expected a struct of columns of the same size, not " << a.get_type();
+    throw type_error(ss.str());
+  }
+
+  const ndt::struct_type *sd = a.get_type().extended<ndt::struct_type>();
+  vector<ndt::type> field_types;
+  for (const ndt::type &column_tp : sd->get_field_types()) {
+    field_types.push_back(column_tp.extended<ndt::fixed_dim_type>()->get_element_type());
+  }
+
+  intptr_t dim_size = sd->get_field_type(0).extended<ndt::fixed_dim_type>()->get_fixed_dim_size();
+  ndt::type struct_tp = ndt::make_type<ndt::struct_type>(sd->get_field_names(), field_types);
+  array res = empty(ndt::make_fixed_dim(dim_size, struct_tp));
+  for (const std::string &name : sd->get_field_names()) {
+    res.p(name).assign(a.p(name));
+  }
+
+  return res;
+}
+
 inline std::string broadcast_error_message(intptr_t ninputs, const nd::array *inputs) {
   stringstream ss;
 
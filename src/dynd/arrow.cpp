@@ -0,0 +1,842 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dynd/arrow.hpp>
+#include <dynd/irange.hpp>
+#include <dynd/memblock/external_memory_block.hpp>
+#include <dynd/option.hpp>
+#include <dynd/types/bytes_type.hpp>
+#include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/string_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+// The type of a primitive Arrow format that has the same layout in dynd, or a null type
+ndt::type arrow_primitive_type(const char *format) {
+  if (format[0] == '\0' || format[1] != '\0') {
+    return ndt::type();
+  }
+
+  switch (format[0]) {
+  case 'c':
+    return ndt::make_type<int8_t>();
+  case 'C':
+    return ndt::make_type<uint8_t>();
+  case 's':
+    return ndt::make_type<int16_t>();
+  case 'S':
+    return ndt::make_type<uint16_t>();
+  case 'i':
+    return ndt::make_type<int32_t>();
+  case 'I':
+    return ndt::make_type<uint32_t>();
+  case 'l':
+    return ndt::make_type<int64_t>();
+  case 'L':
+    return ndt::make_type<uint64_t>();
+  case 'e':
+    return ndt::make_type<float16>();
+  case 'f':
+    return ndt::make_type<float>();
+  case 'g':
+    return ndt::make_type<double>();
+  default:
+    return ndt::type();
+  }
+}
+
+// The Arrow format of a primitive type, or NULL
+const char *arrow_primitive_format(type_id_t id) {
+  switch (id) {
+  case int8_id:
+    return "c";
+  case uint8_id:
+    return "C";
+  case int16_id:
+    return "s";
+  case uint16_id:
+    return "S";
+  case int32_id:
+    return "i";
+  case uint32_id:
+    return "I";
+  case int64_id:
+    return "l";
+  case uint64_id:
+    return "L";
+  case float16_id:
+    return "e";
+  case float32_id:
+    return "f";
+  case float64_id:
+    return "g";
+  default:
+    return NULL;
+  }
+}
+
+inline bool get_bit(const uint8_t *bits, int64_t i) { return (bits[i >> 3] >> (i & 7)) & 1; }
+
+inline void set_bit(uint8_t *bits, int64_t i) { bits[i >> 3] |= static_cast<uint8_t>(1 << (i & 7)); }
+
+/**
+ * A view of ``size`` elements, ``stride`` bytes apart, whose element arrmeta
+ * is copied from ``element_arrmeta``.
+ */
+nd::array make_column_view(intptr_t size, intptr_t stride, const ndt::type &element_tp, const char *element_arrmeta,
+                           const char *data, const nd::memory_block &owner, uint64_t flags) {
+  nd::array res = nd::make_array(ndt::make_fixed_dim(size, element_tp), const_cast<char *>(data), owner, flags);
+  size_stride_t *ss = reinterpret_cast<size_stride_t *>(res->metadata());
+  ss->dim_size = size;
+  ss->stride = stride;
+  if (element_tp.get_arrmeta_size() > 0) {
+    element_tp.extended()->arrmeta_copy_construct(res->metadata() + sizeof(size_stride_t), element_arrmeta, owner);
+  }
+
+  return res;
+}
+
+// The columns of a struct of columns
+vector<nd::array> get_columns(const nd::array &a) {
+  const ndt::struct_type *struct_tp = a.get_type().extended<ndt::struct_type>();
+  const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(a->metadata());
+  const vector<uintptr_t> &arrmeta_offsets = struct_tp->get_arrmeta_offsets();
+
+  vector<nd::array> columns;
+  for (intptr_t i = 0; i < struct_tp->get_field_count(); ++i) {
+    const ndt::type &field_tp = struct_tp->get_field_type(i);
+    nd::array column = nd::make_array(field_tp, const_cast<char *>(a.cdata()) + data_offsets[i], nd::memory_block(a),
+                                      nd::read_access_flag);
+    if (field_tp.get_arrmeta_size() > 0) {
+      field_tp.extended()->arrmeta_copy_construct(column->metadata(), a->metadata() + arrmeta_offsets[i],
+                                                  nd::memory_block(a));
+    }
+    columns.push_back(column);
+  }
+
+  return columns;
+}
+
+void delete_columns(void *columns) { delete static_cast<vector<nd::array> *>(columns); }
+
+// A struct of columns, which refers to their data in place
+nd::array make_columns(const vector<std::string> &names, const vector<nd::array> &columns) {
+  vector<ndt::type> types;
+  const char *base = NULL;
+  for (const nd::array &column : columns) {
+    types.push_back(column.get_type());
+    if (base == NULL || column.cdata() < base) {
+      base = column.cdata();
+    }
+  }
+
+  ndt::type tp = ndt::make_type<ndt::struct_type>(names, types);
+  nd::array res = nd::make_array(
+      tp, const_cast<char *>(base),
+      nd::make_memory_block<nd::external_memory_block>(new vector<nd::array>(columns), &delete_columns),
+      nd::read_access_flag);
+
+  const ndt::struct_type *struct_tp = tp.extended<ndt::struct_type>();
+  uintptr_t *data_offsets = reinterpret_cast<uintptr_t *>(res->metadata());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    data_offsets[i] = columns[i].cdata() - base;
+    if (types[i].get_arrmeta_size() > 0) {
+      types[i].extended()->arrmeta_copy_construct(res->metadata() + struct_tp->get_arrmeta_offsets()[i],
+                                                  columns[i]->metadata(), nd::memory_block(columns[i]));
+    }
+  }
+
+  return res;
+}
+
+void release_imported_array(void *array) {
+  ArrowArray *a = static_cast<ArrowArray *>(array);
+  if (a->release != NULL) {
+    a->release(a);
+  }
+  delete a;
+}
+
+/**
+ * Imports Arrow arrays, whose buffers are kept alive by ``m_owner``. Each
+ * column is a range of ``size`` values from ``begin``, which is relative to
+ * the offset of its Arrow array.
+ */
+class arrow_importer {
+  nd::memory_block m_owner;
+
+public:
+  arrow_importer(const nd::memory_block &owner) : m_owner(owner) {}
+
+  static const char *get_buffer(const ArrowArray *array, int64_t i) {
+    if (i >= array->n_buffers) {
+      throw invalid_argument("nd::from_arrow: the Arrow array is missing a buffer");
+    }
+
+    return static_cast<const char *>(array->buffers[i]);
+  }
+
+  static const ArrowArray *get_child(const ArrowSchema *schema, const ArrowArray *array, int64_t i,
+                                     const ArrowSchema **child_schema) {
+    if (i >= schema->n_children || i >= array->n_children) {
+      throw invalid_argument("nd::from_arrow: the Arrow array is missing a child");
+    }
+
+    *child_schema = schema->children[i];
+    return array->children[i];
+  }
+
+  static bool has_nulls(const ArrowArray *array, int64_t begin, int64_t size) {
+    if (array->null_count == 0 || array->n_buffers == 0 || array->buffers[0] == NULL) {
+      return false;
+    }
+
+    const uint8_t *validity = static_cast<const uint8_t *>(array->buffers[0]);
+    for (int64_t i = array->offset + begin; i < array->offset + begin + size; ++i) {
+      if (!get_bit(validity, i)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  static void check_no_nulls(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    if (has_nulls(array, begin, size)) {
+      stringstream ss;
+      ss << "nd::from_arrow: cannot import nulls in an Arrow array of format " << schema->format;
+      throw type_error(ss.str());
+    }
+  }
+
+  /**
+   * Copies the values of a primitive or boolean array into ``N * ?T``. A
+   * valid value that is the sentinel of ``?T``, such as a uint8 255 or a
+   * NaN, would read back as missing, so it is an error.
+   */
+  nd::array import_nullable(const ndt::type &tp, const ArrowArray *array, int64_t begin, int64_t size) {
+    nd::array res = nd::empty(size, ndt::make_type<ndt::option_type>(tp));
+    const uint8_t *validity = static_cast<const uint8_t *>(array->buffers[0]);
+    const char *values = get_buffer(array, 1);
+    char *dst = res.data();
+    size_t data_size = tp.get_data_size();
+    for (int64_t i = array->offset + begin; i < array->offset + begin + size; ++i, dst += data_size) {
+      if (!get_bit(validity, i)) {
+        assign_na_builtin(tp.get_id(), dst);
+      } else if (tp.get_id() == bool_id) {
+        *dst = get_bit(reinterpret_cast<const uint8_t *>(values), i);
+      } else {
+        memcpy(dst, values + i * data_size, data_size);
+        if (!is_avail_builtin(tp.get_id(), dst)) {
+          stringstream ss;
+          ss << "nd::from_arrow: the valid value at index " << i - array->offset << " would be missing as a "
+             << ndt::make_type<ndt::option_type>(tp);
+          throw type_error(ss.str());
+        }
+      }
+    }
+
+    return res;
+  }
+
+  // Copies strings or bytes, which own their characters. An option of them has no missing value in dynd.
+  template <typename OffsetType>
+  nd::array import_strings(const ndt::type &tp, const ArrowSchema *schema, const ArrowArray *array, int64_t begin,
+                           int64_t size) {
+    check_no_nulls(schema, array, begin, size);
+    const OffsetType *offsets = reinterpret_cast<const OffsetType *>(get_buffer(array, 1)) + array->offset + begin;
+    const char *values = get_buffer(array, 2);
+
+    nd::array res = nd::empty(size, tp);
+    char *dst = res.data();
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(res->metadata())->stride;
+    for (int64_t i = 0; i < size; ++i, dst += stride) {
+      // string and bytes have the same layout
+      reinterpret_cast<bytes *>(dst)->assign(values + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    return res;
+  }
+
+  template <typename OffsetType>
+  nd::array import_list(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    check_no_nulls(schema, array, begin, size);
+    const OffsetType *offsets = reinterpret_cast<const OffsetType *>(get_buffer(array, 1)) + array->offset + begin;
+    const ArrowSchema *child_schema;
+    const ArrowArray *child = get_child(schema, array, 0, &child_schema);
+    nd::array values = import_column(child_schema, child, offsets[0], offsets[size] - offsets[0]);
+
+    // The elements of each list refer to the values in place
+    const ndt::type &element_tp = values.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+    const size_stride_t *values_ss = reinterpret_cast<const size_stride_t *>(values->metadata());
+    nd::array res = nd::empty(size, ndt::make_type<ndt::var_dim_type>(element_tp));
+    ndt::var_dim_type::metadata_type *md =
+        reinterpret_cast<ndt::var_dim_type::metadata_type *>(res->metadata() + sizeof(size_stride_t));
+    md->blockref = nd::memory_block(values);
+    md->stride = values_ss->stride;
+    md->offset = 0;
+    if (element_tp.get_arrmeta_size() > 0) {
+      element_tp.extended()->arrmeta_destruct(reinterpret_cast<char *>(md + 1));
+      element_tp.extended()->arrmeta_copy_construct(reinterpret_cast<char *>(md + 1),
+                                                    values->metadata() + sizeof(size_stride_t), md->blockref);
+    }
+
+    ndt::var_dim_type::data_type *d = reinterpret_cast<ndt::var_dim_type::data_type *>(res.data());
+    for (int64_t i = 0; i < size; ++i) {
+      d[i].begin = const_cast<char *>(values.cdata()) + (offsets[i] - offsets[0]) * values_ss->stride;
+      d[i].size = offsets[i + 1] - offsets[i];
+    }
+
+    return res;
+  }
+
+  nd::array import_fixed_size_list(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    check_no_nulls(schema, array, begin, size);
+    intptr_t list_size = strtol(schema->format + 3, NULL, 10);
+    const ArrowSchema *child_schema;
+    const ArrowArray *child = get_child(schema, array, 0, &child_schema);
+    nd::array values = import_column(child_schema, child, (array->offset + begin) * list_size, size * list_size);
+
+    // The values in place, with their dimension split in two
+    const ndt::type &element_tp = values.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(values->metadata())->stride;
+    nd::array res = nd::make_array(ndt::make_fixed_dim(size, ndt::make_fixed_dim(list_size, element_tp)),
+                                   const_cast<char *>(values.cdata()), nd::memory_block(values), nd::read_access_flag);
+    size_stride_t *ss = reinterpret_cast<size_stride_t *>(res->metadata());
+    ss[0].dim_size = size;
+    ss[0].stride = list_size * stride;
+    ss[1].dim_size = list_size;
+    ss[1].stride = stride;
+    if (element_tp.get_arrmeta_size() > 0) {
+      element_tp.extended()->arrmeta_copy_construct(
+          reinterpret_cast<char *>(ss + 2), values->metadata() + sizeof(size_stride_t), nd::memory_block(values));
+    }
+
+    return res;
+  }
+
+  // A struct in a list, which is copied into ``N * {name: T, ...}``
+  nd::array import_struct(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    check_no_nulls(schema, array, begin, size);
+    nd::array columns = import_columns(schema, array, begin, size);
+    const ndt::struct_type *columns_tp = columns.get_type().extended<ndt::struct_type>();
+
+    vector<ndt::type> field_tps;
+    for (const ndt::type &column_tp : columns_tp->get_field_types()) {
+      field_tps.push_back(column_tp.extended<ndt::fixed_dim_type>()->get_element_type());
+    }
+    nd::array res = nd::empty(size, ndt::make_type<ndt::struct_type>(columns_tp->get_field_names(), field_tps));
+    const ndt::struct_type *struct_tp = res.get_type().extended<ndt::fixed_dim_type>()->get_element_type().extended<
+        ndt::struct_type>();
+    const char *struct_arrmeta = res->metadata() + sizeof(size_stride_t);
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(res->metadata())->stride;
+
+    vector<nd::array> column_values = get_columns(columns);
+    for (size_t i = 0; i < field_tps.size(); ++i) {
+      make_column_view(size, stride, field_tps[i], struct_arrmeta + struct_tp->get_arrmeta_offsets()[i],
+                       res.data() + reinterpret_cast<const uintptr_t *>(struct_arrmeta)[i], nd::memory_block(res),
+                       nd::readwrite_access_flags)
+          .assign(column_values[i]);
+    }
+
+    return res;
+  }
+
+  // Imports an Arrow array as ``N * T``
+  nd::array import_column(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    if (schema->dictionary != NULL) {
+      throw type_error("nd::from_arrow: cannot import a dictionary-encoded Arrow array");
+    }
+
+    const char *format = schema->format;
+    ndt::type tp = arrow_primitive_type(format);
+    if (!tp.is_null()) {
+      if (has_nulls(array, begin, size)) {
+        return import_nullable(tp, array, begin, size);
+      }
+
+      return make_column_view(size, tp.get_data_size(), tp, NULL,
+                              get_buffer(array, 1) + (array->offset + begin) * tp.get_data_size(), m_owner,
+                              nd::read_access_flag);
+    }
+
+    if (strcmp(format, "b") == 0) {
+      if (has_nulls(array, begin, size)) {
+        return import_nullable(ndt::make_type<bool1>(), array, begin, size);
+      }
+
+      nd::array res = nd::empty(size, ndt::make_type<bool1>());
+      const uint8_t *values = reinterpret_cast<const uint8_t *>(get_buffer(array, 1));
+      for (int64_t i = 0; i < size; ++i) {
+        res.data()[i] = get_bit(values, array->offset + begin + i);
+      }
+      return res;
+    } else if (strcmp(format, "u") == 0) {
+      return import_strings<int32_t>(ndt::make_type<ndt::string_type>(), schema, array, begin, size);
+    } else if (strcmp(format, "U") == 0) {
+      return import_strings<int64_t>(ndt::make_type<ndt::string_type>(), schema, array, begin, size);
+    } else if (strcmp(format, "z") == 0) {
+      return import_strings<int32_t>(ndt::make_type<ndt::bytes_type>(), schema, array, begin, size);
+    } else if (strcmp(format, "Z") == 0) {
+      return import_strings<int64_t>(ndt::make_type<ndt::bytes_type>(), schema, array, begin, size);
+    } else if (strcmp(format, "+l") == 0) {
+      return import_list<int32_t>(schema, array, begin, size);
+    } else if (strcmp(format, "+L") == 0) {
+      return import_list<int64_t>(schema, array, begin, size);
+    } else if (strncmp(format, "+w:", 3) == 0) {
+      return import_fixed_size_list(schema, array, begin, size);
+    } else if (strcmp(format, "+s") == 0) {
+      return import_struct(schema, array, begin, size);
+    }
+
+    stringstream ss;
+    ss << "nd::from_arrow: cannot import an Arrow array of format " << format;
+    throw type_error(ss.str());
+  }
+
+  // Imports an Arrow struct array as ``{name: N * T, ...}``, with each child in place
+  nd::array import_columns(const ArrowSchema *schema, const ArrowArray *array, int64_t begin, int64_t size) {
+    check_no_nulls(schema, array, begin, size);
+
+    vector<std::string> names;
+    vector<nd::array> columns;
+    for (int64_t i = 0; i < schema->n_children; ++i) {
+      const ArrowSchema *child_schema;
+      const ArrowArray *child = get_child(schema, array, i, &child_schema);
+      names.push_back(child_schema->name == NULL ? "f" + to_string(i) : child_schema->name);
+      columns.push_back(strcmp(child_schema->format, "+s") == 0
+                            ? import_columns(child_schema, child, array->offset + begin, size)
+                            : import_column(child_schema, child, array->offset + begin, size));
+    }
+
+    return make_columns(names, columns);
+  }
+};
+
+struct exported_schema {
+  std::string format;
+  std::string name;
+  vector<ArrowSchema> children;
+  vector<ArrowSchema *> child_pointers;
+};
+
+void release_exported_schema(ArrowSchema *schema) {
+  exported_schema *private_data = static_cast<exported_schema *>(schema->private_data);
+  for (ArrowSchema &child : private_data->children) {
+    if (child.release != NULL) {
+      child.release(&child);
+    }
+  }
+  delete private_data;
+  schema->release = NULL;
+}
+
+struct exported_array {
+  // The arrays whose memory the buffers point into
+  vector<nd::array> owners;
+  vector<const void *> buffers;
+  vector<ArrowArray> children;
+  vector<ArrowArray *> child_pointers;
+};
+
+void release_exported_array(ArrowArray *array) {
+  exported_array *private_data = static_cast<exported_array *>(array->private_data);
+  for (ArrowArray &child : private_data->children) {
+    if (child.release != NULL) {
+      child.release(&child);
+    }
+  }
+  delete private_data;
+  array->release = NULL;
+}
+
+/**
+ * Exports ``N * T`` columns and structs of them. The exported schema and
+ * array own their private data, and keep the memory they point into alive.
+ */
+class arrow_exporter {
+  exported_schema *m_schema_data;
+  exported_array *m_array_data;
+  ArrowSchema *m_schema;
+  ArrowArray *m_array;
+
+public:
+  arrow_exporter(const std::string &name, int64_t length, ArrowSchema *schema, ArrowArray *array)
+      : m_schema_data(new exported_schema), m_array_data(new exported_array), m_schema(schema), m_array(array) {
+    m_schema_data->name = name;
+    m_schema->format = NULL;
+    m_schema->name = m_schema_data->name.c_str();
+    m_schema->metadata = NULL;
+    m_schema->flags = 0;
+    m_schema->n_children = 0;
+    m_schema->children = NULL;
+    m_schema->dictionary = NULL;
+    m_schema->release = &release_exported_schema;
+    m_schema->private_data = m_schema_data;
+
+    m_array->length = length;
+    m_array->null_count = 0;
+    m_array->offset = 0;
+    m_array->n_buffers = 0;
+    m_array->n_children = 0;
+    m_array->buffers = NULL;
+    m_array->children = NULL;
+    m_array->dictionary = NULL;
+    m_array->release = &release_exported_array;
+    m_array->private_data = m_array_data;
+  }
+
+  void set_format(const std::string &format, bool nullable) {
+    m_schema_data->format = format;
+    m_schema->format = m_schema_data->format.c_str();
+    if (nullable) {
+      m_schema->flags |= ARROW_FLAG_NULLABLE;
+    }
+  }
+
+  void set_buffers(const vector<const void *> &buffers) {
+    m_array_data->buffers = buffers;
+    m_array->n_buffers = buffers.size();
+    m_array->buffers = m_array_data->buffers.data();
+  }
+
+  void keep_alive(const nd::array &a) { m_array_data->owners.push_back(a); }
+
+  // Exports each child with a new exporter, whose results the parent releases
+  vector<arrow_exporter> add_children(const vector<std::string> &names, const vector<int64_t> &lengths) {
+    size_t n = names.size();
+    m_schema_data->children.resize(n);
+    m_array_data->children.resize(n);
+    vector<arrow_exporter> res;
+    for (size_t i = 0; i < n; ++i) {
+      m_schema_data->child_pointers.push_back(&m_schema_data->children[i]);
+      m_array_data->child_pointers.push_back(&m_array_data->children[i]);
+      res.emplace_back(names[i], lengths[i], &m_schema_data->children[i], &m_array_data->children[i]);
+    }
+    m_schema->n_children = n;
+    m_schema->children = m_schema_data->child_pointers.data();
+    m_array->n_children = n;
+    m_array->children = m_array_data->child_pointers.data();
+
+    return res;
+  }
+
+  // A contiguous copy of a column that is not contiguous
+  static nd::array make_contiguous(const nd::array &column, size_t element_size) {
+    if (reinterpret_cast<const size_stride_t *>(column->metadata())->stride ==
+            static_cast<intptr_t>(element_size) ||
+        column.get_dim_size() <= 1) {
+      return column;
+    }
+
+    nd::array res = nd::empty(column.get_type());
+    res.assign(column);
+    return res;
+  }
+
+  // The validity bitmap of an option column, or NULL if all of its values are available
+  const void *export_validity(const ndt::type &option_tp, const char *arrmeta, const char *data, intptr_t stride) {
+    intptr_t size = m_array->length;
+    nd::array validity = nd::empty((size + 7) / 8, ndt::make_type<uint8_t>());
+    uint8_t *bits = reinterpret_cast<uint8_t *>(validity.data());
+    memset(bits, 0, (size + 7) / 8);
+    for (intptr_t i = 0; i < size; ++i, data += stride) {
+      if (nd::old_is_avail(option_tp, arrmeta, data)) {
+        set_bit(bits, i);
+      } else {
+        ++m_array->null_count;
+      }
+    }
+
+    if (m_array->null_count == 0) {
+      return NULL;
+    }
+    keep_alive(validity);
+    return bits;
+  }
+
+  template <typename OffsetType>
+  void export_strings(const char *data, intptr_t stride, const uint8_t *validity, size_t total_size) {
+    intptr_t size = m_array->length;
+    nd::array offsets = nd::empty(size + 1, ndt::make_type<OffsetType>());
+    nd::array values = nd::empty(total_size, ndt::make_type<uint8_t>());
+    OffsetType *dst_offsets = reinterpret_cast<OffsetType *>(offsets.data());
+    char *dst = values.data();
+    dst_offsets[0] = 0;
+    for (intptr_t i = 0; i < size; ++i, data += stride) {
+      const bytes *b = reinterpret_cast<const bytes *>(data);
+      size_t value_size = (validity == NULL || get_bit(validity, i)) ? b->size() : 0;
+      memcpy(dst + dst_offsets[i], b->data(), value_size);
+      dst_offsets[i + 1] = static_cast<OffsetType>(dst_offsets[i] + value_size);
+    }
+
+    keep_alive(offsets);
+    keep_alive(values);
+    set_buffers({validity, dst_offsets, dst});
+  }
+
+  void export_column(const nd::array &column) {
+    const ndt::type &element_tp = column.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+    const ndt::type &value_tp =
+        element_tp.get_id() == option_id ? element_tp.extended<ndt::option_type>()->get_value_type() : element_tp;
+    const char *element_arrmeta = column->metadata() + sizeof(size_stride_t);
+    const char *data = column.cdata();
+    intptr_t size = m_array->length;
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(column->metadata())->stride;
+
+    const void *validity = NULL;
+    if (element_tp.get_id() == option_id) {
+      validity = export_validity(element_tp, element_arrmeta, data, stride);
+    }
+
+    if (const char *format = arrow_primitive_format(value_tp.get_id())) {
+      // An option has the layout of its value, so the values are exported in place
+      nd::array values = make_contiguous(column, value_tp.get_data_size());
+      keep_alive(values);
+      set_format(format, element_tp.get_id() == option_id);
+      set_buffers({validity, values.cdata()});
+      return;
+    }
+
+    switch (value_tp.get_id()) {
+    case bool_id: {
+      nd::array values = nd::empty((size + 7) / 8, ndt::make_type<uint8_t>());
+      uint8_t *bits = reinterpret_cast<uint8_t *>(values.data());
+      memset(bits, 0, (size + 7) / 8);
+      for (intptr_t i = 0; i < size; ++i) {
+        if (*reinterpret_cast<const uint8_t *>(data + i * stride) == 1) {
+          set_bit(bits, i);
+        }
+      }
+      keep_alive(values);
+      set_format("b", element_tp.get_id() == option_id);
+      set_buffers({validity, bits});
+      return;
+    }
+    case string_id:
+    case bytes_id: {
+      size_t total_size = 0;
+      for (intptr_t i = 0; i < size; ++i) {
+        if (validity == NULL || get_bit(static_cast<const uint8_t *>(validity), i)) {
+          total_size += reinterpret_cast<const bytes *>(data + i * stride)->size();
+        }
+      }
+
+      bool large = total_size > static_cast<size_t>(numeric_limits<int32_t>::max());
+      std::string format = (value_tp.get_id() == string_id) ? "u" : "z";
+      set_format(large ? std::string(1, toupper(format[0])) : format, element_tp.get_id() == option_id);
+      if (large) {
+        export_strings<int64_t>(data, stride, static_cast<const uint8_t *>(validity), total_size);
+      } else {
+        export_strings<int32_t>(data, stride, static_cast<const uint8_t *>(validity), total_size);
+      }
+      return;
+    }
+    default:
+      break;
+    }
+
+    if (element_tp.get_id() == option_id) {
+      stringstream ss;
+      ss << "nd::to_arrow: cannot export values of type " << element_tp;
+      throw type_error(ss.str());
+    }
+
+    switch (element_tp.get_id()) {
+    case fixed_dim_id: {
+      // The child is the column with its first two dimensions merged, which needs a copy if they cannot be
+      nd::array values = column;
+      const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(values->metadata());
+      intptr_t list_size = ss[1].dim_size;
+      if (size > 1 && ss[0].stride != list_size * ss[1].stride) {
+        values = nd::empty(column.get_type());
+        values.assign(column);
+        ss = reinterpret_cast<const size_stride_t *>(values->metadata());
+      }
+      const ndt::type &child_tp = element_tp.extended<ndt::fixed_dim_type>()->get_element_type();
+      set_format("+w:" + to_string(list_size), false);
+      set_buffers({NULL});
+      add_children({"item"}, {size * list_size})[0].export_column(
+          make_column_view(size * list_size, ss[1].stride, child_tp, reinterpret_cast<const char *>(ss + 2),
+                           values.cdata(), nd::memory_block(values), nd::read_access_flag));
+      return;
+    }
+    case var_dim_id:
+      export_list(column);
+      return;
+    case struct_id: {
+      // Each field is a strided column, which is made contiguous
+      const ndt::struct_type *struct_tp = element_tp.extended<ndt::struct_type>();
+      const uintptr_t *data_offsets = reinterpret_cast<const uintptr_t *>(element_arrmeta);
+      set_format("+s", false);
+      set_buffers({NULL});
+      vector<arrow_exporter> children =
+          add_children(struct_tp->get_field_names(), vector<int64_t>(struct_tp->get_field_count(), size));
+      for (size_t i = 0; i < children.size(); ++i) {
+        children[i].export_column(make_column_view(size, stride, struct_tp->get_field_type(i),
+                                                   element_arrmeta + struct_tp->get_arrmeta_offsets()[i],
+                                                   data + data_offsets[i], nd::memory_block(column),
+                                                   nd::read_access_flag));
+      }
+      return;
+    }
+    default:
+      break;
+    }
+
+    stringstream ss;
+    ss << "nd::to_arrow: cannot export values of type " << element_tp;
+    throw type_error(ss.str());
+  }
+
+  void export_list(const nd::array &column) {
+    const ndt::type &element_tp = column.get_type().extended<ndt::fixed_dim_type>()->get_element_type();
+    const ndt::type &child_tp = element_tp.extended<ndt::var_dim_type>()->get_element_type();
+    const ndt::var_dim_type::metadata_type *md =
+        reinterpret_cast<const ndt::var_dim_type::metadata_type *>(column->metadata() + sizeof(size_stride_t));
+    const char *child_arrmeta = reinterpret_cast<const char *>(md + 1);
+    intptr_t size = m_array->length;
+    intptr_t stride = reinterpret_cast<const size_stride_t *>(column->metadata())->stride;
+
+    // The lists are in place if each one follows the one before it
+    nd::array offsets = nd::empty(size + 1, ndt::make_type<int64_t>());
+    int64_t *dst_offsets = reinterpret_cast<int64_t *>(offsets.data());
+    dst_offsets[0] = 0;
+    const char *begin = NULL, *end = NULL;
+    bool in_place = true;
+    for (intptr_t i = 0; i < size; ++i) {
+      const ndt::var_dim_type::data_type *d =
+          reinterpret_cast<const ndt::var_dim_type::data_type *>(column.cdata() + i * stride);
+      dst_offsets[i + 1] = dst_offsets[i] + d->size;
+      if (d->size > 0) {
+        const char *list_begin = d->begin + md->offset;
+        if (begin == NULL) {
+          begin = list_begin;
+        } else if (list_begin != end) {
+          in_place = false;
+        }
+        end = list_begin + d->size * md->stride;
+      }
+    }
+
+    intptr_t total_size = dst_offsets[size];
+    nd::array values;
+    if (in_place && total_size > 0) {
+      values = make_column_view(total_size, md->stride, child_tp, child_arrmeta, begin, md->blockref,
+                                nd::read_access_flag);
+    } else {
+      values = nd::empty(total_size, child_tp);
+      for (intptr_t i = 0; i < size; ++i) {
+        const ndt::var_dim_type::data_type *d =
+            reinterpret_cast<const ndt::var_dim_type::data_type *>(column.cdata() + i * stride);
+        if (d->size > 0) {
+          values(irange(dst_offsets[i], dst_offsets[i + 1]))
+              .assign(make_column_view(d->size, md->stride, child_tp, child_arrmeta, d->begin + md->offset,
+                                       md->blockref, nd::read_access_flag));
+        }
+      }
+    }
+
+    bool large = total_size > numeric_limits<int32_t>::max();
+    if (!large) {
+      nd::array narrow_offsets = nd::empty(size + 1, ndt::make_type<int32_t>());
+      copy(dst_offsets, dst_offsets + size + 1, reinterpret_cast<int32_t *>(narrow_offsets.data()));
+      offsets = narrow_offsets;
+    }
+    keep_alive(offsets);
+    set_format(large ? "+L" : "+l", false);
+    set_buffers({NULL, offsets.cdata()});
+    add_children({"item"}, {total_size})[0].export_column(values);
+  }
+
+  // Exports a struct of columns, whose children are the columns
+  void export_columns(const nd::array &a) {
+    const ndt::struct_type *struct_tp = a.get_type().extended<ndt::struct_type>();
+    vector<nd::array> columns = get_columns(a);
+    set_format("+s", false);
+    set_buffers({NULL});
+    vector<arrow_exporter> children =
+        add_children(struct_tp->get_field_names(), vector<int64_t>(columns.size(), m_array->length));
+    for (size_t i = 0; i < columns.size(); ++i) {
+      children[i].export_array(columns[i]);
+    }
+  }
+
+  void export_array(const nd::array &a) {
+    if (a.get_type().get_id() == struct_id) {
+      export_columns(a);
+    } else {
+      export_column(a);
+    }
+  }
+};
+
+// The length of an array to export, which is either a column or a struct of columns of the same length
+int64_t get_export_length(const nd::array &a) {
+  if (a.get_type().get_id() == fixed_dim_id) {
+    return a.get_dim_size();
+  }
+
+  if (a.get_type().get_id() == struct_id) {
+    int64_t length = -1;
+    for (const nd::array &column : get_columns(a)) {
+      int64_t column_length = get_export_length(column);
+      if (length != -1 && column_length != length) {
+        throw invalid_argument("nd::to_arrow: the columns of a struct must have the same length");
+      }
+      length = column_length;
+    }
+    if (length != -1) {
+      return length;
+    }
+  }
+
+  stringstream ss;
+  ss << "nd::to_arrow: expected a fixed dimension or a struct of them, not " << a.get_type();
+  throw invalid_argument(ss.str());
+}
+
+} // unnamed namespace
+
+nd::array nd::from_arrow(const ArrowSchema *schema, ArrowArray *array) {
+  // Move the array into the memory block that owns it
+  ArrowArray *moved = new ArrowArray(*array);
+  array->release = NULL;
+  memory_block owner = make_memory_block<external_memory_block>(moved, &release_imported_array);
+
+  arrow_importer importer(owner);
+  if (strcmp(schema->format, "+s") == 0) {
+    return importer.import_columns(schema, moved, 0, moved->length);
+  }
+
+  return importer.import_column(schema, moved, 0, moved->length);
+}
+
+void nd::to_arrow(const array &a, ArrowSchema *out_schema, ArrowArray *out_array) {
+  int64_t length = get_export_length(a);
+  arrow_exporter exporter("", length, out_schema, out_array);
+  try {
+    exporter.export_array(a);
+  } catch (...) {
+    out_schema->release(out_schema);
+    out_array->release(out_array);
+    throw;
+  }
+}
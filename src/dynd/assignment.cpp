@@ -100,6 +100,7 @@ nd::callable make_assign() {
   dispatcher.insert(nd::make_callable<nd::assign_callable<double, dynd::string>>());
   dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::tuple_type, ndt::tuple_type>>());
   dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::struct_type, ndt::struct_type>>());
+  dispatcher.insert(nd::make_callable<nd::assign_callable<ndt::categorical_type, ndt::scalar_kind_type>>());
   dispatcher.insert(
       {nd::get_elwise(ndt::make_type<ndt::callable_type>(
            ndt::make_type<ndt::scalar_kind_type>(),
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+
+#include <dynd/bitmap_option.hpp>
+#include <dynd/callables/bitmap_option_callable.hpp>
+#include <dynd/callables/type_id_dispatch_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Picks the child for the value type of the bitmap options, which must be
+ * the same.
+ */
+class bitmap_option_dispatch_callable : public nd::type_id_dispatch_callable {
+public:
+  bitmap_option_dispatch_callable(const char *name, const ndt::type &tp, const map<type_id_t, nd::callable> &children)
+      : type_id_dispatch_callable(std::string("bitmap_option::") + name, tp, 2, children) {}
+
+  ndt::type get_dispatch_type(const ndt::type &arg_tp) const {
+    return arg_tp.extended<ndt::struct_type>()->get_field_type(0).get_dtype();
+  }
+};
+
+template <typename OpType>
+nd::callable make_bitmap_option_binary(const char *name) {
+  ndt::type pattern = nd::detail::make_bitmap_option_pattern("Scalar");
+  return nd::make_callable<bitmap_option_dispatch_callable>(
+      name, ndt::make_type<ndt::callable_type>(pattern, {pattern, pattern}),
+      map<type_id_t, nd::callable>{
+          {int32_id, nd::make_callable<nd::bitmap_option_binary_callable<int32_t, OpType>>(name)},
+          {int64_id, nd::make_callable<nd::bitmap_option_binary_callable<int64_t, OpType>>(name)},
+          {uint32_id, nd::make_callable<nd::bitmap_option_binary_callable<uint32_t, OpType>>(name)},
+          {uint64_id, nd::make_callable<nd::bitmap_option_binary_callable<uint64_t, OpType>>(name)},
+          {float32_id, nd::make_callable<nd::bitmap_option_binary_callable<float, OpType>>(name)},
+          {float64_id, nd::make_callable<nd::bitmap_option_binary_callable<double, OpType>>(name)}});
+}
+
+template <typename OpType>
+nd::callable make_bitmap_option_reduce(const char *name) {
+  return nd::make_callable<bitmap_option_dispatch_callable>(
+      name, ndt::make_type<ndt::callable_type>(nd::detail::make_bitmap_option_pattern("Scalar"),
+                                               {nd::detail::make_bitmap_option_pattern("Scalar")}),
+      map<type_id_t, nd::callable>{
+          {int32_id, nd::make_callable<nd::bitmap_option_reduce_callable<int32_t, OpType>>(name)},
+          {int64_id, nd::make_callable<nd::bitmap_option_reduce_callable<int64_t, OpType>>(name)},
+          {uint32_id, nd::make_callable<nd::bitmap_option_reduce_callable<uint32_t, OpType>>(name)},
+          {uint64_id, nd::make_callable<nd::bitmap_option_reduce_callable<uint64_t, OpType>>(name)},
+          {float32_id, nd::make_callable<nd::bitmap_option_reduce_callable<float, OpType>>(name)},
+          {float64_id, nd::make_callable<nd::bitmap_option_reduce_callable<double, OpType>>(name)}});
+}
+
+// The value type of a ``N * ?T`` or ``N * T`` array, which must be builtin
+const ndt::type &get_bitmap_value_type(const char *name, const ndt::type &tp) {
+  if (tp.get_id() == fixed_dim_id) {
+    const ndt::type &element_tp = tp.extended<ndt::fixed_dim_type>()->get_element_type();
+    const ndt::type &value_tp = (element_tp.get_id() == option_id)
+                                    ? element_tp.extended<ndt::option_type>()->get_value_type()
+                                    : element_tp;
+    if (value_tp.is_builtin() && value_tp.get_id() != void_id) {
+      return value_tp;
+    }
+  }
+
+  stringstream ss;
+  ss << "nd::" << name << ": expected a fixed dimension of builtin values or options, not " << tp;
+  throw type_error(ss.str());
+}
+
+} // unnamed namespace
+
+nd::array nd::to_bitmap_option(const array &a) {
+  const ndt::type &value_tp = get_bitmap_value_type("to_bitmap_option", a.get_type());
+  bool is_option = a.get_type().extended<ndt::fixed_dim_type>()->get_element_type().get_id() == option_id;
+  size_t value_size = value_tp.get_data_size();
+
+  intptr_t size = a.get_dim_size();
+  intptr_t word_count = detail::get_bitmap_word_count(size);
+  array res = empty(detail::make_bitmap_option_type(size, value_tp));
+
+  intptr_t src_stride = reinterpret_cast<const size_stride_t *>(a->metadata())->stride;
+  const char *src = a.cdata();
+  char *values = res.p("values").data();
+  uint64_t *valid = reinterpret_cast<uint64_t *>(res.p("valid").data());
+  memset(values, 0, size * value_size);
+  memset(valid, 0, word_count * sizeof(uint64_t));
+  for (intptr_t i = 0; i < size; ++i, src += src_stride) {
+    if (!is_option || is_avail_builtin(value_tp.get_id(), src)) {
+      memcpy(values + i * value_size, src, value_size);
+      valid[i / detail::bitmap_word_size] |= uint64_t(1) << (i % detail::bitmap_word_size);
+    }
+  }
+
+  return res;
+}
+
+nd::array nd::from_bitmap_option(const array &a) {
+  if (a.get_type().get_id() != struct_id || !detail::make_bitmap_option_pattern("Scalar").match(a.get_type())) {
+    stringstream ss;
+    ss << "nd::from_bitmap_option: expected a bitmap option, not " << a.get_type();
+    throw type_error(ss.str());
+  }
+
+  const ndt::type &value_tp = a.get_type().extended<ndt::struct_type>()->get_field_type(0).get_dtype();
+  intptr_t size = detail::get_bitmap_option_size("from_bitmap_option", a.get_type());
+  size_t value_size = value_tp.get_data_size();
+  array res = empty(size, ndt::make_type<ndt::option_type>(value_tp));
+
+  detail::bitmap_option_layout layout(a.get_type(), a->metadata());
+  char *dst = res.data();
+  for (intptr_t i = 0; i < size; ++i, dst += value_size) {
+    if ((layout.get_valid(a.cdata(), i / detail::bitmap_word_size) >> (i % detail::bitmap_word_size)) & 1) {
+      memcpy(dst, a.cdata() + layout.values_offset + i * layout.values_stride, value_size);
+    } else {
+      assign_na_builtin(value_tp.get_id(), dst);
+    }
+  }
+
+  return res;
+}
+
+DYND_API nd::callable nd::bitmap_option::add = make_bitmap_option_binary<nd::bitmap_option_add>("add");
+DYND_API nd::callable nd::bitmap_option::subtract = make_bitmap_option_binary<nd::bitmap_option_subtract>("subtract");
+DYND_API nd::callable nd::bitmap_option::multiply = make_bitmap_option_binary<nd::bitmap_option_multiply>("multiply");
+DYND_API nd::callable nd::bitmap_option::divide = make_bitmap_option_binary<nd::bitmap_option_divide>("divide");
+
+DYND_API nd::callable nd::bitmap_option::sum = make_bitmap_option_reduce<nd::bitmap_option_sum>("sum");
+DYND_API nd::callable nd::bitmap_option::min = make_bitmap_option_reduce<nd::bitmap_option_min>("min");
+DYND_API nd::callable nd::bitmap_option::max = make_bitmap_option_reduce<nd::bitmap_option_max>("max");
+
+DYND_API nd::callable nd::bitmap_option::count = nd::make_callable<nd::bitmap_option_count_callable>();
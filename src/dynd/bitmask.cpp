@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <functional>
+#include <map>
+
+#include <dynd/bitmask.hpp>
+#include <dynd/callables/base_dispatch_callable.hpp>
+#include <dynd/callables/bitmask_callable.hpp>
+#include <dynd/callables/type_id_dispatch_callable.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * Picks the child for a bitmask or for a ``N * bool``.
+ */
+class count_nonzero_dispatch_callable : public nd::base_dispatch_callable {
+  nd::callable m_bitmask_child;
+  nd::callable m_bool_child;
+
+public:
+  count_nonzero_dispatch_callable()
+      : base_dispatch_callable(ndt::type("(Any) -> int64")),
+        m_bitmask_child(nd::make_callable<nd::bitmask_count_nonzero_callable>()),
+        m_bool_child(nd::make_callable<nd::bool_count_nonzero_callable>()) {}
+
+  const nd::callable &specialize(const ndt::type &DYND_UNUSED(dst_tp), intptr_t DYND_UNUSED(nsrc),
+                                 const ndt::type *src_tp) {
+    if (src_tp[0].get_id() == struct_id && nd::detail::make_bitmask_pattern().match(src_tp[0])) {
+      return m_bitmask_child;
+    }
+    if (src_tp[0].get_id() == fixed_dim_id && src_tp[0].get_ndim() == 1 && src_tp[0].get_dtype().get_id() == bool_id) {
+      return m_bool_child;
+    }
+
+    stringstream ss;
+    ss << "nd::count_nonzero: expected a bitmask or a fixed dimension of bool, not " << src_tp[0];
+    throw type_error(ss.str());
+  }
+};
+
+template <typename OpType>
+nd::callable make_bitmask_compare(const char *name) {
+  return nd::make_callable<nd::type_id_dispatch_callable>(
+      std::string("bitmask::") + name,
+      ndt::make_type<ndt::callable_type>(nd::detail::make_bitmask_pattern(),
+                                         {ndt::type("Fixed * Scalar"), ndt::type("Fixed * Scalar")}),
+      2, map<type_id_t, nd::callable>{
+          {int32_id, nd::make_callable<nd::bitmask_compare_callable<int32_t, OpType>>(name)},
+          {int64_id, nd::make_callable<nd::bitmask_compare_callable<int64_t, OpType>>(name)},
+          {uint32_id, nd::make_callable<nd::bitmask_compare_callable<uint32_t, OpType>>(name)},
+          {uint64_id, nd::make_callable<nd::bitmask_compare_callable<uint64_t, OpType>>(name)},
+          {float32_id, nd::make_callable<nd::bitmask_compare_callable<float, OpType>>(name)},
+          {float64_id, nd::make_callable<nd::bitmask_compare_callable<double, OpType>>(name)}});
+}
+
+} // unnamed namespace
+
+nd::array nd::to_bitmask(const array &a) {
+  const ndt::type &tp = a.get_type();
+  if (tp.get_id() != fixed_dim_id || tp.extended<ndt::fixed_dim_type>()->get_element_type().get_id() != bool_id) {
+    stringstream ss;
+    ss << "nd::to_bitmask: expected a fixed dimension of bool, not " << tp;
+    throw type_error(ss.str());
+  }
+
+  intptr_t size = a.get_dim_size();
+  array res = empty(detail::make_bitmask_type(size));
+  detail::bitmask_layout layout(res.get_type(), res->metadata());
+
+  intptr_t src_stride = reinterpret_cast<const size_stride_t *>(a->metadata())->stride;
+  const char *src = a.cdata();
+  for (intptr_t begin = 0, word = 0; begin < size; begin += detail::bitmap_word_size, ++word) {
+    intptr_t count = std::min(size - begin, detail::bitmap_word_size);
+    uint64_t bits = 0;
+    for (intptr_t i = 0; i < count; ++i, src += src_stride) {
+      bits |= static_cast<uint64_t>(*src != 0) << i;
+    }
+    layout.set_word(res.data(), word, bits);
+  }
+  layout.set_size(res.data(), size);
+
+  return res;
+}
+
+nd::array nd::from_bitmask(const array &mask) {
+  if (mask.get_type().get_id() != struct_id || !detail::make_bitmask_pattern().match(mask.get_type())) {
+    stringstream ss;
+    ss << "nd::from_bitmask: expected a bitmask, not " << mask.get_type();
+    throw type_error(ss.str());
+  }
+
+  detail::bitmask_layout layout(mask.get_type(), mask->metadata());
+  intptr_t size = layout.get_size(mask.cdata());
+  array res = empty(size, ndt::make_type<bool1>());
+
+  char *dst = res.data();
+  for (intptr_t i = 0; i < size; ++i) {
+    dst[i] = (layout.get_word(mask.cdata(), i / detail::bitmap_word_size) >> (i % detail::bitmap_word_size)) & 1;
+  }
+
+  return res;
+}
+
+DYND_API nd::callable nd::count_nonzero = nd::make_callable<count_nonzero_dispatch_callable>();
+
+DYND_API nd::callable nd::bitmask::less = make_bitmask_compare<std::less<>>("less");
+DYND_API nd::callable nd::bitmask::less_equal = make_bitmask_compare<std::less_equal<>>("less_equal");
+DYND_API nd::callable nd::bitmask::equal = make_bitmask_compare<std::equal_to<>>("equal");
+DYND_API nd::callable nd::bitmask::not_equal = make_bitmask_compare<std::not_equal_to<>>("not_equal");
+DYND_API nd::callable nd::bitmask::greater_equal = make_bitmask_compare<std::greater_equal<>>("greater_equal");
+DYND_API nd::callable nd::bitmask::greater = make_bitmask_compare<std::greater<>>("greater");
+
+DYND_API nd::callable nd::bitmask::logical_and =
+    nd::make_callable<nd::bitmask_logical_callable<std::bit_and<>>>("logical_and");
+DYND_API nd::callable nd::bitmask::logical_or =
+    nd::make_callable<nd::bitmask_logical_callable<std::bit_or<>>>("logical_or");
+DYND_API nd::callable nd::bitmask::logical_xor =
+    nd::make_callable<nd::bitmask_logical_callable<std::bit_xor<>>>("logical_xor");
+DYND_API nd::callable nd::bitmask::logical_not = nd::make_callable<nd::bitmask_logical_not_callable>();
+
+DYND_API nd::callable nd::bitmask::take = nd::make_callable<nd::bitmask_take_callable>();
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+#include <mutex>
+
+#include <dynd/callables/dft_callable.hpp>
+#include <dynd/callables/type_id_dispatch_callable.hpp>
+#include <dynd/fft.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+/**
+ * A process-wide cache of plans of type PlanType, keyed on length and
+ * direction. Plans are built outside of the lock, as Bluestein plans get
+ * their sub-plans from the cache too. If two threads build the same plan,
+ * the first one stored is kept.
+ */
+template <typename PlanType>
+shared_ptr<const PlanType> get_cached_plan(size_t size, bool inverse) {
+  static mutex m;
+  static map<pair<size_t, bool>, shared_ptr<const PlanType>> plans;
+
+  pair<size_t, bool> key(size, inverse);
+  {
+    lock_guard<mutex> lock(m);
+    auto it = plans.find(key);
+    if (it != plans.end()) {
+      return it->second;
+    }
+  }
+
+  shared_ptr<const PlanType> plan = make_shared<PlanType>(size, inverse);
+
+  lock_guard<mutex> lock(m);
+  return plans.emplace(key, plan).first->second;
+}
+
+} // unnamed namespace
+
+template <typename Real>
+shared_ptr<const nd::fft_plan<Real>> nd::get_fft_plan(size_t size, bool inverse) {
+  return get_cached_plan<fft_plan<Real>>(size, inverse);
+}
+
+template <typename Real>
+shared_ptr<const nd::real_fft_plan<Real>> nd::get_real_fft_plan(size_t size, bool inverse) {
+  return get_cached_plan<real_fft_plan<Real>>(size, inverse);
+}
+
+template DYND_API shared_ptr<const nd::fft_plan<float>> nd::get_fft_plan<float>(size_t size, bool inverse);
+template DYND_API shared_ptr<const nd::fft_plan<double>> nd::get_fft_plan<double>(size_t size, bool inverse);
+template DYND_API shared_ptr<const nd::real_fft_plan<float>> nd::get_real_fft_plan<float>(size_t size, bool inverse);
+template DYND_API shared_ptr<const nd::real_fft_plan<double>> nd::get_real_fft_plan<double>(size_t size,
+                                                                                          bool inverse);
+
+DYND_API nd::callable nd::fft = nd::make_callable<nd::type_id_dispatch_callable>(
+    "fft", ndt::type("(Fixed**N * Scalar, scale: ?float64) -> Fixed**N * Scalar"),
+    1, map<type_id_t, nd::callable>{{complex_float32_id, nd::make_callable<nd::dft_callable<float>>(false)},
+                                    {complex_float64_id, nd::make_callable<nd::dft_callable<double>>(false)}});
+
+DYND_API nd::callable nd::ifft = nd::make_callable<nd::type_id_dispatch_callable>(
+    "ifft", ndt::type("(Fixed**N * Scalar, scale: ?float64) -> Fixed**N * Scalar"),
+    1, map<type_id_t, nd::callable>{{complex_float32_id, nd::make_callable<nd::dft_callable<float>>(true)},
+                                    {complex_float64_id, nd::make_callable<nd::dft_callable<double>>(true)}});
+
+DYND_API nd::callable nd::rfft = nd::make_callable<nd::type_id_dispatch_callable>(
+    "rfft", ndt::type("(Fixed**N * Scalar, scale: ?float64) -> Fixed**N * Scalar"),
+    1, map<type_id_t, nd::callable>{{float32_id, nd::make_callable<nd::real_dft_callable<float>>()},
+                                    {float64_id, nd::make_callable<nd::real_dft_callable<double>>()}});
+
+DYND_API nd::callable nd::irfft = nd::make_callable<nd::type_id_dispatch_callable>(
+    "irfft", ndt::type("(Fixed**N * Scalar, n: ?Int, scale: ?float64) -> Fixed**N * Scalar"),
+    1, map<type_id_t, nd::callable>{{complex_float32_id, nd::make_callable<nd::real_idft_callable<float>>()},
+                                    {complex_float64_id, nd::make_callable<nd::real_idft_callable<double>>()}});
@@ -3,9 +3,13 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <map>
+
 #include <dynd/callables/index_callable.hpp>
 #include <dynd/callables/multidispatch_callable.hpp>
+#include <dynd/callables/scatter_callable.hpp>
 #include <dynd/callables/take_dispatch_callable.hpp>
+#include <dynd/callables/type_id_dispatch_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/index.hpp>
 
@@ -19,6 +23,39 @@ static std::vector<ndt::type> func_ptr(const ndt::type &DYND_UNUSED(dst_tp), siz
   return {src_tp[0]};
 }
 
+/**
+ * Picks the child for the data type of the array a scatter accumulates into,
+ * which is passed as ``dst``.
+ */
+class scatter_dispatch_callable : public nd::type_id_dispatch_callable {
+public:
+  scatter_dispatch_callable(const char *name, const map<type_id_t, nd::callable> &children)
+      : type_id_dispatch_callable(name, ndt::type("(Fixed * intptr, Any) -> Fixed * Scalar"), 1, children) {}
+
+  const nd::callable &specialize(const ndt::type &dst_tp, intptr_t DYND_UNUSED(nsrc),
+                                 const ndt::type *DYND_UNUSED(src_tp)) {
+    if (dst_tp.is_symbolic()) {
+      stringstream ss;
+      ss << "nd::" << get_name() << ": the array to accumulate into should be passed as \"dst\"";
+      throw invalid_argument(ss.str());
+    }
+
+    return type_id_dispatch_callable::specialize(dst_tp, 1, &dst_tp);
+  }
+};
+
+template <typename OpType>
+nd::callable make_scatter(const char *name) {
+  return nd::make_callable<scatter_dispatch_callable>(
+      name, map<type_id_t, nd::callable>{
+                {int32_id, nd::make_callable<nd::scatter_callable<int32_t, OpType>>(name)},
+                {int64_id, nd::make_callable<nd::scatter_callable<int64_t, OpType>>(name)},
+                {uint32_id, nd::make_callable<nd::scatter_callable<uint32_t, OpType>>(name)},
+                {uint64_id, nd::make_callable<nd::scatter_callable<uint64_t, OpType>>(name)},
+                {float32_id, nd::make_callable<nd::scatter_callable<float, OpType>>(name)},
+                {float64_id, nd::make_callable<nd::scatter_callable<double, OpType>>(name)}});
+}
+
 } // unnamed namespace
 
 DYND_API nd::callable nd::index = nd::make_callable<nd::multidispatch_callable<1>>(
@@ -27,3 +64,9 @@ DYND_API nd::callable nd::index = nd::make_callable<nd::multidispatch_callable<1
     nd::callable::make_all<nd::index_callable, type_sequence<int32_t, ndt::fixed_dim_kind_type>>(func_ptr));
 
 DYND_API nd::callable nd::take = nd::make_callable<nd::take_dispatch_callable>();
+
+DYND_API nd::callable nd::put = nd::make_callable<nd::put_callable>();
+
+DYND_API nd::callable nd::scatter_add = make_scatter<nd::scatter_add_op>("scatter_add");
+
+DYND_API nd::callable nd::scatter_max = make_scatter<nd::scatter_max_op>("scatter_max");
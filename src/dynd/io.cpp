@@ -4,11 +4,204 @@
 //
 
 #include <dynd/callables/serialize_callable.hpp>
-#include <dynd/functional.hpp>
 #include <dynd/io.hpp>
 
 using namespace std;
 using namespace dynd;
 
-DYND_API nd::callable nd::serialize = nd::functional::reduction(
-    [] { return bytes(); }, nd::make_callable<nd::serialize_callable<ndt::scalar_kind_type>>());
+namespace {
+
+/**
+ * Reads an array in the binary format of nd::serialize. Blocks of values
+ * without references that are aligned in memory are used in place, and the
+ * rest are copied, as are strings and bytes, which own their characters.
+ * Every offset is checked against the size of the buffer.
+ */
+class binary_reader {
+  const char *m_data;
+  size_t m_size;
+  nd::memory_block m_owner;
+
+public:
+  binary_reader(const char *data, size_t size, const nd::memory_block &owner)
+      : m_data(data), m_size(size), m_owner(owner) {}
+
+  void check_range(uint64_t offset, uint64_t count, size_t size) const {
+    if (offset > m_size || (size > 0 && count > (m_size - offset) / size)) {
+      throw invalid_argument("nd::deserialize: the buffer is truncated or corrupt");
+    }
+  }
+
+  nd::detail::serialize_ref read_ref(uint64_t offset) const {
+    check_range(offset, 1, sizeof(nd::detail::serialize_ref));
+
+    nd::detail::serialize_ref ref;
+    memcpy(&ref, m_data + offset, sizeof(nd::detail::serialize_ref));
+    return ref;
+  }
+
+  // Whether values of the type that are at ``offset`` can be used in place
+  bool is_in_place(const ndt::type &tp, uint64_t offset) const {
+    return !nd::detail::has_references(tp) &&
+           reinterpret_cast<uintptr_t>(m_data + offset) % tp.get_data_alignment() == 0;
+  }
+
+  // Points each var dimension whose elements are used in place at the buffer
+  void init_arrmeta(const ndt::type &tp, char *arrmeta) const {
+    switch (tp.get_id()) {
+    case fixed_dim_id:
+      init_arrmeta(tp.extended<ndt::base_dim_type>()->get_element_type(), arrmeta + sizeof(size_stride_t));
+      break;
+    case var_dim_id: {
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      if (is_in_place(element_tp, 0)) {
+        reinterpret_cast<ndt::var_dim_type::metadata_type *>(arrmeta)->blockref = m_owner;
+      }
+      init_arrmeta(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type));
+      break;
+    }
+    case tuple_id:
+    case struct_id:
+      nd::detail::for_each_field(
+          tp, arrmeta, [&](const ndt::type &field_tp, const char *field_arrmeta, uintptr_t DYND_UNUSED(offset)) {
+            init_arrmeta(field_tp, const_cast<char *>(field_arrmeta));
+          });
+      break;
+    case option_id:
+      init_arrmeta(tp.extended<ndt::option_type>()->get_value_type(), arrmeta);
+      break;
+    default:
+      break;
+    }
+  }
+
+  void read_block(const ndt::type &tp, const char *arrmeta, char *dst, uint64_t offset, uint64_t count) const {
+    size_t size = tp.get_default_data_size();
+    check_range(offset, count, size);
+    if (!nd::detail::has_references(tp)) {
+      memcpy(dst, m_data + offset, count * size);
+      return;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+      read_value(tp, arrmeta, dst + i * size, offset + i * size);
+    }
+  }
+
+  void read_value(const ndt::type &tp, const char *arrmeta, char *dst, uint64_t offset) const {
+    if (!nd::detail::has_references(tp)) {
+      read_block(tp, arrmeta, dst, offset, 1);
+      return;
+    }
+
+    switch (tp.get_id()) {
+    case fixed_dim_id: {
+      const size_stride_t *ss = reinterpret_cast<const size_stride_t *>(arrmeta);
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      for (intptr_t i = 0; i < ss->dim_size; ++i) {
+        read_value(element_tp, arrmeta + sizeof(size_stride_t), dst + i * ss->stride, offset + i * ss->stride);
+      }
+      break;
+    }
+    case var_dim_id: {
+      const ndt::var_dim_type::metadata_type *md =
+          reinterpret_cast<const ndt::var_dim_type::metadata_type *>(arrmeta);
+      const ndt::type &element_tp = tp.extended<ndt::base_dim_type>()->get_element_type();
+      nd::detail::serialize_ref ref = read_ref(offset);
+      ndt::var_dim_type::data_type *d = reinterpret_cast<ndt::var_dim_type::data_type *>(dst);
+      check_range(ref.offset, ref.size, element_tp.get_default_data_size());
+      if (is_in_place(element_tp, 0)) {
+        // nd::serialize aligns every block, and the dimension refers to the buffer, so a misaligned one is corrupt
+        if (ref.offset % element_tp.get_data_alignment() != 0) {
+          throw invalid_argument("nd::deserialize: the buffer is truncated or corrupt");
+        }
+        d->begin = const_cast<char *>(m_data + ref.offset);
+      } else {
+        d->begin = md->blockref->alloc(ref.size);
+        read_block(element_tp, arrmeta + sizeof(ndt::var_dim_type::metadata_type), d->begin, ref.offset, ref.size);
+      }
+      d->size = ref.size;
+      break;
+    }
+    case tuple_id:
+    case struct_id:
+      nd::detail::for_each_field(tp, arrmeta,
+                                 [&](const ndt::type &field_tp, const char *field_arrmeta, uintptr_t field_offset) {
+                                   read_value(field_tp, field_arrmeta, dst + field_offset, offset + field_offset);
+                                 });
+      break;
+    case option_id:
+      read_value(tp.extended<ndt::option_type>()->get_value_type(), arrmeta, dst, offset);
+      break;
+    case string_id: {
+      nd::detail::serialize_ref ref = read_ref(offset);
+      check_range(ref.offset, ref.size, 1);
+      reinterpret_cast<dynd::string *>(dst)->assign(m_data + ref.offset, ref.size);
+      break;
+    }
+    case bytes_id: {
+      nd::detail::serialize_ref ref = read_ref(offset);
+      check_range(ref.offset, ref.size, 1);
+      reinterpret_cast<bytes *>(dst)->assign(m_data + ref.offset, ref.size);
+      break;
+    }
+    default:
+      throw invalid_argument("nd::deserialize: the buffer is truncated or corrupt");
+    }
+  }
+
+  nd::array read() const {
+    nd::detail::serialize_header header;
+    check_range(0, 1, sizeof(nd::detail::serialize_header));
+    memcpy(&header, m_data, sizeof(nd::detail::serialize_header));
+    if (memcmp(header.magic, nd::detail::serialize_magic, sizeof(nd::detail::serialize_magic)) != 0) {
+      throw invalid_argument("nd::deserialize: the buffer was not written by nd::serialize");
+    }
+    if (header.version != nd::detail::serialize_version) {
+      stringstream ss;
+      ss << "nd::deserialize: unsupported format version " << header.version;
+      throw invalid_argument(ss.str());
+    }
+    if (header.byte_order != nd::detail::serialize_byte_order) {
+      throw invalid_argument("nd::deserialize: the buffer was written with a different byte order");
+    }
+    check_range(sizeof(nd::detail::serialize_header), header.datashape_size, 1);
+
+    ndt::type tp(std::string(m_data + sizeof(nd::detail::serialize_header), header.datashape_size));
+    nd::detail::check_serializable(tp);
+    check_range(header.root_offset, 1, tp.get_default_data_size());
+
+    if (is_in_place(tp, header.root_offset)) {
+      nd::array res =
+          nd::make_array(tp, const_cast<char *>(m_data + header.root_offset), m_owner, nd::read_access_flag);
+      if (tp.get_arrmeta_size() > 0) {
+        tp->arrmeta_default_construct(res->metadata(), false);
+      }
+      return res;
+    }
+
+    nd::array res = nd::empty(tp, nd::read_access_flag);
+    init_arrmeta(tp, res->metadata());
+    read_value(tp, res->metadata(), const_cast<char *>(res.cdata()), header.root_offset);
+    return res;
+  }
+};
+
+} // unnamed namespace
+
+DYND_API nd::callable nd::serialize = nd::make_callable<nd::serialize_callable>();
+
+nd::array nd::deserialize(const array &buffer) {
+  if (buffer.get_type().get_id() != bytes_id) {
+    stringstream ss;
+    ss << "nd::deserialize: expected a bytes array, not " << buffer.get_type();
+    throw invalid_argument(ss.str());
+  }
+
+  const bytes *b = reinterpret_cast<const bytes *>(buffer.cdata());
+  return deserialize(b->data(), b->size(), buffer);
+}
+
+nd::array nd::deserialize(const char *data, size_t size, const memory_block &owner) {
+  return binary_reader(data, size, owner).read();
+}
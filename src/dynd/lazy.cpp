@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <unordered_map>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/callables/fused_callable.hpp>
+#include <dynd/functional.hpp>
+#include <dynd/lazy.hpp>
+#include <dynd/types/any_kind_type.hpp>
+#include <dynd/types/scalar_kind_type.hpp>
+
+using namespace std;
+using namespace dynd;
+
+struct nd::lazy_array::node {
+  // A leaf holds an evaluated array and no operation
+  array value;
+  callable op;
+  vector<shared_ptr<const node>> args;
+};
+
+nd::lazy_array::lazy_array(const array &value) : m_node(make_shared<node>()) {
+  const_cast<node *>(m_node.get())->value = value;
+}
+
+nd::lazy_array::lazy_array(const callable &op, std::initializer_list<lazy_array> args) : m_node(make_shared<node>()) {
+  node *n = const_cast<node *>(m_node.get());
+  n->op = op;
+  for (const lazy_array &arg : args) {
+    n->args.push_back(arg.m_node);
+  }
+}
+
+namespace {
+
+typedef shared_ptr<const nd::lazy_array::node> node_ptr;
+
+/**
+ * Flattens an expression graph into the inputs and the topologically sorted
+ * operations of a fused callable. Shared subexpressions are evaluated once,
+ * and an array used in several places is passed in once.
+ */
+struct lazy_flattener {
+  vector<nd::array> inputs;
+  unordered_map<const void *, size_t> input_index;
+  vector<const nd::lazy_array::node *> ops;
+  unordered_map<const nd::lazy_array::node *, size_t> op_index;
+
+  void collect(const nd::lazy_array::node *n) {
+    if (n->op.is_null()) {
+      if (input_index.emplace(n->value.get(), inputs.size()).second) {
+        inputs.push_back(n->value);
+      }
+      return;
+    }
+
+    if (op_index.count(n) != 0) {
+      return;
+    }
+    for (const node_ptr &arg : n->args) {
+      collect(arg.get());
+    }
+    op_index.emplace(n, ops.size());
+    ops.push_back(n);
+  }
+
+  vector<nd::functional::fused_node> make_nodes() const {
+    vector<nd::functional::fused_node> nodes;
+    for (const nd::lazy_array::node *n : ops) {
+      nd::functional::fused_node fn;
+      fn.op = n->op;
+      for (const node_ptr &arg : n->args) {
+        if (arg->op.is_null()) {
+          fn.args.push_back(input_index.at(arg->value.get()));
+        } else {
+          fn.args.push_back(inputs.size() + op_index.at(arg.get()));
+        }
+      }
+      nodes.push_back(fn);
+    }
+
+    return nodes;
+  }
+};
+
+} // unnamed namespace
+
+nd::array nd::lazy_array::eval() const {
+  if (m_node->op.is_null()) {
+    return m_node->value;
+  }
+
+  lazy_flattener flattener;
+  flattener.collect(m_node.get());
+
+  vector<ndt::type> arg_tp(flattener.inputs.size(), ndt::make_type<ndt::scalar_kind_type>());
+  callable fused = functional::elwise(make_callable<functional::fused_callable>(
+      ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::any_kind_type>(), arg_tp), flattener.make_nodes()));
+
+  return fused.call(flattener.inputs.size(), flattener.inputs.data(), 0, nullptr);
+}
+
+nd::lazy_array nd::operator+(const lazy_array &a0) { return lazy_array(plus, {a0}); }
+
+nd::lazy_array nd::operator-(const lazy_array &a0) { return lazy_array(minus, {a0}); }
+
+nd::lazy_array nd::operator+(const lazy_array &a0, const lazy_array &a1) { return lazy_array(add, {a0, a1}); }
+
+nd::lazy_array nd::operator-(const lazy_array &a0, const lazy_array &a1) { return lazy_array(subtract, {a0, a1}); }
+
+nd::lazy_array nd::operator*(const lazy_array &a0, const lazy_array &a1) { return lazy_array(multiply, {a0, a1}); }
+
+nd::lazy_array nd::operator/(const lazy_array &a0, const lazy_array &a1) { return lazy_array(divide, {a0, a1}); }
+
+nd::lazy_array nd::operator+(const lazy_array &a0, const array &a1) { return lazy_array(add, {a0, a1}); }
+
+nd::lazy_array nd::operator-(const lazy_array &a0, const array &a1) { return lazy_array(subtract, {a0, a1}); }
+
+nd::lazy_array nd::operator*(const lazy_array &a0, const array &a1) { return lazy_array(multiply, {a0, a1}); }
+
+nd::lazy_array nd::operator/(const lazy_array &a0, const array &a1) { return lazy_array(divide, {a0, a1}); }
+
+nd::lazy_array nd::operator+(const array &a0, const lazy_array &a1) { return lazy_array(add, {a0, a1}); }
+
+nd::lazy_array nd::operator-(const array &a0, const lazy_array &a1) { return lazy_array(subtract, {a0, a1}); }
+
+nd::lazy_array nd::operator*(const array &a0, const lazy_array &a1) { return lazy_array(multiply, {a0, a1}); }
+
+nd::lazy_array nd::operator/(const array &a0, const lazy_array &a1) { return lazy_array(divide, {a0, a1}); }
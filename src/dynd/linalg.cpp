@@ -0,0 +1,34 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <map>
+
+#include <dynd/callables/matmul_callable.hpp>
+#include <dynd/callables/tensordot_callable.hpp>
+#include <dynd/callables/type_id_dispatch_callable.hpp>
+#include <dynd/linalg.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+template <template <typename> class CallableType>
+map<type_id_t, nd::callable> make_linalg_children() {
+  return map<type_id_t, nd::callable>{{float32_id, nd::make_callable<CallableType<float>>()},
+                                      {float64_id, nd::make_callable<CallableType<double>>()},
+                                      {complex_float32_id, nd::make_callable<CallableType<dynd::complex<float>>>()},
+                                      {complex_float64_id, nd::make_callable<CallableType<dynd::complex<double>>>()}};
+}
+
+} // unnamed namespace
+
+DYND_API nd::callable nd::matmul = nd::make_callable<nd::type_id_dispatch_callable>(
+    "matmul", ndt::type("(Fixed**N * Scalar, Fixed**M * Scalar) -> Fixed**R * Scalar"),
+    2, make_linalg_children<nd::matmul_callable>());
+
+DYND_API nd::callable nd::tensordot = nd::make_callable<nd::type_id_dispatch_callable>(
+    "tensordot", ndt::type("(Fixed**N * Scalar, Fixed**M * Scalar, axes: ?Int) -> Fixed**R * Scalar"),
+    2, make_linalg_children<nd::tensordot_callable>());
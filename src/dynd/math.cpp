@@ -5,6 +5,7 @@
 
 #include <dynd/callables/conj_callable.hpp>
 #include <dynd/callables/imag_callable.hpp>
+#include <dynd/callables/math_callable.hpp>
 #include <dynd/callables/multidispatch_callable.hpp>
 #include <dynd/callables/real_callable.hpp>
 #include <dynd/functional.hpp>
@@ -14,19 +15,34 @@ using namespace std;
 using namespace dynd;
 
 namespace {
-// CUDA and MSVC 2015 WORKAROUND: Using these functions directly in the apply
-//                                template does not compile.
-double mycos(double x) { return cos(x); }
-double mysin(double x) { return sin(x); }
-double mytan(double x) { return tan(x); }
-double myexp(double x) { return exp(x); }
+
+template <template <typename> class FuncType>
+struct math_callable_alias {
+  template <typename T>
+  using type = nd::math_callable<FuncType, T>;
+};
+
+template <template <typename> class FuncType>
+nd::callable make_math() {
+  return nd::functional::elwise(nd::make_callable<nd::multidispatch_callable<1>>(
+      ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::scalar_kind_type>(),
+                                         {ndt::make_type<ndt::scalar_kind_type>()},
+                                         {{ndt::make_type<ndt::option_type>(ndt::make_type<int32_t>()), "ulp"}}),
+      nd::callable::make_all<math_callable_alias<FuncType>::template type, type_sequence<float, double>>(
+          [](const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc),
+             const ndt::type *src_tp) -> std::vector<ndt::type> { return {src_tp[0]}; })));
+}
 
 } // anonymous namespace
 
-DYND_API nd::callable nd::cos = nd::functional::elwise(nd::functional::apply<double (*)(double), &mycos>());
-DYND_API nd::callable nd::sin = nd::functional::elwise(nd::functional::apply<double (*)(double), &mysin>());
-DYND_API nd::callable nd::tan = nd::functional::elwise(nd::functional::apply<double (*)(double), &mytan>());
-DYND_API nd::callable nd::exp = nd::functional::elwise(nd::functional::apply<double (*)(double), &myexp>());
+DYND_API nd::callable nd::cos = make_math<dynd::detail::math_cos>();
+DYND_API nd::callable nd::sin = make_math<dynd::detail::math_sin>();
+DYND_API nd::callable nd::tan = make_math<dynd::detail::math_tan>();
+DYND_API nd::callable nd::exp = make_math<dynd::detail::math_exp>();
+DYND_API nd::callable nd::expm1 = make_math<dynd::detail::math_expm1>();
+DYND_API nd::callable nd::log = make_math<dynd::detail::math_log>();
+DYND_API nd::callable nd::log1p = make_math<dynd::detail::math_log1p>();
+DYND_API nd::callable nd::tanh = make_math<dynd::detail::math_tanh>();
 
 DYND_API nd::callable nd::real = nd::functional::elwise(nd::make_callable<nd::multidispatch_callable<1>>(
     ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::scalar_kind_type>(),
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <dynd/parallel.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+size_t default_num_threads() {
+  const char *env = getenv("DYND_NUM_THREADS");
+  if (env != nullptr) {
+    long nthread = strtol(env, nullptr, 10);
+    if (nthread > 0) {
+      return static_cast<size_t>(nthread);
+    }
+  }
+
+  unsigned int nthread = thread::hardware_concurrency();
+  return (nthread == 0) ? 1 : nthread;
+}
+
+atomic<size_t> &num_threads() {
+  static atomic<size_t> nthread(default_num_threads());
+  return nthread;
+}
+
+// Set on the threads running parallel_for tasks, so nested calls stay serial
+thread_local bool in_parallel_for = false;
+
+} // unnamed namespace
+
+size_t dynd::get_num_threads() { return num_threads().load(); }
+
+void dynd::set_num_threads(size_t nthread) { num_threads().store((nthread == 0) ? default_num_threads() : nthread); }
+
+void dynd::parallel_for(size_t ntask, const function<void(size_t)> &task) {
+  size_t nthread = min(get_num_threads(), ntask);
+  if (nthread <= 1 || in_parallel_for) {
+    for (size_t i = 0; i < ntask; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  atomic<size_t> next(0);
+  exception_ptr error;
+  mutex error_mutex;
+
+  auto worker = [&] {
+    in_parallel_for = true;
+    for (size_t i = next++; i < ntask; i = next++) {
+      try {
+        task(i);
+      }
+      catch (...) {
+        lock_guard<mutex> lock(error_mutex);
+        if (!error) {
+          error = current_exception();
+        }
+        // Skip the remaining tasks
+        next = ntask;
+      }
+    }
+    in_parallel_for = false;
+  };
+
+  vector<thread> threads;
+  threads.reserve(nthread - 1);
+  for (size_t i = 1; i < nthread; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  if (error) {
+    rethrow_exception(error);
+  }
+}
@@ -4,8 +4,12 @@
 //
 
 #include <chrono>
+#include <numeric>
 
+#include <dynd/callables/exponential_callable.hpp>
 #include <dynd/callables/multidispatch_callable.hpp>
+#include <dynd/callables/normal_callable.hpp>
+#include <dynd/callables/shuffle_callable.hpp>
 #include <dynd/callables/uniform_callable.hpp>
 #include <dynd/functional.hpp>
 #include <dynd/random.hpp>
@@ -27,13 +31,59 @@ struct uniform_callable_alias {
   using type = nd::random::uniform_callable<ReturnType, GeneratorType>;
 };
 
+template <typename GeneratorType>
+struct normal_callable_alias {
+  template <typename ReturnType>
+  using type = nd::random::normal_callable<ReturnType, GeneratorType>;
+};
+
+template <typename GeneratorType>
+struct exponential_callable_alias {
+  template <typename ReturnType>
+  using type = nd::random::exponential_callable<ReturnType, GeneratorType>;
+};
+
+// The keywords of a random callable with the given distribution parameters
+std::vector<std::pair<ndt::type, std::string>> random_kwds(std::initializer_list<const char *> names) {
+  std::vector<std::pair<ndt::type, std::string>> kwds;
+  for (const char *name : names) {
+    kwds.emplace_back(ndt::make_type<ndt::option_type>(ndt::make_type<ndt::typevar_type>("R")), name);
+  }
+  for (const auto &kwd : nd::random::detail::seed_and_stream_kwds()) {
+    kwds.push_back(kwd);
+  }
+
+  return kwds;
+}
+
 } // unnamed namespace
 
 DYND_API nd::callable nd::random::uniform = nd::functional::elwise(nd::make_callable<nd::multidispatch_callable<1>>(
-    ndt::make_type<ndt::callable_type>(
-        ndt::make_type<ndt::typevar_type>("R"), {},
-        {{ndt::make_type<ndt::option_type>(ndt::make_type<ndt::typevar_type>("R")), "a"},
-         {ndt::make_type<ndt::option_type>(ndt::make_type<ndt::typevar_type>("R")), "b"}}),
-    nd::callable::make_all<uniform_callable_alias<std::default_random_engine>::type,
+    ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::typevar_type>("R"), {}, random_kwds({"a", "b"})),
+    nd::callable::make_all<uniform_callable_alias<dynd::random::philox4x32>::type,
                            type_sequence<int32_t, int64_t, uint32_t, uint64_t, float, double, dynd::complex<float>,
                                          dynd::complex<double>>>(func_ptr)));
+
+DYND_API nd::callable nd::random::normal = nd::functional::elwise(nd::make_callable<nd::multidispatch_callable<1>>(
+    ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::typevar_type>("R"), {}, random_kwds({"loc", "scale"})),
+    nd::callable::make_all<normal_callable_alias<dynd::random::philox4x32>::type, type_sequence<float, double>>(
+        func_ptr)));
+
+DYND_API nd::callable nd::random::exponential =
+    nd::functional::elwise(nd::make_callable<nd::multidispatch_callable<1>>(
+        ndt::make_type<ndt::callable_type>(ndt::make_type<ndt::typevar_type>("R"), {}, random_kwds({"scale"})),
+        nd::callable::make_all<exponential_callable_alias<dynd::random::philox4x32>::type,
+                               type_sequence<float, double>>(func_ptr)));
+
+DYND_API nd::callable nd::random::shuffle = nd::make_callable<nd::random::shuffle_callable<dynd::random::philox4x32>>();
+
+DYND_API nd::array nd::random::permutation(intptr_t n) { return permutation(n, dynd::random::make_seed()); }
+
+DYND_API nd::array nd::random::permutation(intptr_t n, uint64_t seed, uint32_t stream) {
+  nd::array res = nd::empty(n, ndt::make_type<int64_t>());
+  int64_t *res_data = reinterpret_cast<int64_t *>(res.data());
+  std::iota(res_data, res_data + n, 0);
+  detail::shuffle(dynd::random::philox4x32(seed), stream, res.data(), n, sizeof(int64_t), sizeof(int64_t));
+
+  return res;
+}
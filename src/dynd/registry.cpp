@@ -36,6 +36,7 @@ registry_entry &dynd::registered() {
                                                 {"divide", nd::divide},
                                                 {"equal", nd::equal},
                                                 {"exp", nd::exp},
+                                                {"expm1", nd::expm1},
                                                 {"greater", nd::greater},
                                                 {"greater_equal", nd::greater_equal},
                                                 {"imag", nd::imag},
@@ -43,6 +44,8 @@ registry_entry &dynd::registered() {
                                                 {"left_shift", nd::left_shift},
                                                 {"less", nd::less},
                                                 {"less_equal", nd::less_equal},
+                                                {"log", nd::log},
+                                                {"log1p", nd::log1p},
                                                 {"logical_and", nd::logical_and},
                                                 {"logical_not", nd::logical_not},
                                                 {"logical_or", nd::logical_or},
@@ -65,6 +68,7 @@ registry_entry &dynd::registered() {
                                                 {"sum", nd::sum},
                                                 {"take", nd::take},
                                                 {"tan", nd::tan},
+                                                {"tanh", nd::tanh},
                                                 {"total_order", nd::total_order},
                                                 {"random", {{"uniform", nd::random::uniform}}}}}}}};
 
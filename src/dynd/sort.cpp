@@ -3,6 +3,7 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <dynd/callables/argsort_callable.hpp>
 #include <dynd/callables/sort_callable.hpp>
 #include <dynd/callables/unique_callable.hpp>
 #include <dynd/sort.hpp>
@@ -12,4 +13,8 @@ using namespace dynd;
 
 DYND_API nd::callable nd::sort = nd::make_callable<nd::sort_callable>();
 
+DYND_API nd::callable nd::stable_sort = nd::make_callable<nd::sort_callable>(true);
+
+DYND_API nd::callable nd::argsort = nd::make_callable<nd::argsort_callable>();
+
 DYND_API nd::callable nd::unique = nd::make_callable<nd::unique_callable>();
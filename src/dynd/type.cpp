@@ -211,7 +211,12 @@ ndt::type ndt::type::at_array(int nindices, const irange *indices) const {
 }
 
 bool ndt::type::match(const type &other, std::map<std::string, type> &tp_vars) const {
-  return m_ptr == other.m_ptr || (!is_builtin() && m_ptr->match(other, tp_vars));
+  // A symbolic type may be the same instance as the candidate, as types are interned, and still bind type variables
+  if (m_ptr == other.m_ptr && (is_builtin() || !m_ptr->is_symbolic())) {
+    return true;
+  }
+
+  return !is_builtin() && m_ptr->match(other, tp_vars);
 }
 
 ndt::type ndt::type::apply_linear_index(intptr_t nindices, const irange *indices, size_t current_i,
@@ -3,6 +3,11 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 #include <dynd/parse_util.hpp>
 #include <dynd/type_registry.hpp>
 #include <dynd/types/any_kind_type.hpp>
@@ -125,25 +130,59 @@ ndt::type dynd::default_parse_type_args(type_id_t id, const char *&begin, const
   return result;
 }
 
+namespace {
+
+/**
+ * The ids of the registered names, where a name registered more than once
+ * is the first id with it. New ids are added under the exclusive lock, so
+ * parsing on other threads can look names up.
+ */
+struct id_names {
+  shared_timed_mutex m;
+  unordered_map<std::string, type_id_t> ids;
+
+  id_names() {
+    const vector<id_info> &infos = detail::infos();
+    for (size_t i = 0, iend = infos.size(); i != iend; ++i) {
+      ids.emplace(infos[i].name, type_id_t(i));
+    }
+  }
+};
+
+id_names &get_id_names() {
+  static id_names names;
+  return names;
+}
+
+std::atomic<size_t> &get_registration_counter() {
+  static std::atomic<size_t> count(0);
+  return count;
+}
+
+} // unnamed namespace
+
 DYNDT_API type_id_t dynd::new_id(const char *name, type_id_t base_id) {
   vector<id_info> &infos = detail::infos();
+  id_names &names = get_id_names();
+  unique_lock<shared_timed_mutex> lock(names.m);
 
   type_id_t id = static_cast<type_id_t>(infos.size());
 
   infos.emplace_back(name, base_id, ndt::type(), nullptr, nullptr);
+  names.ids.emplace(name, id);
+  get_registration_counter().fetch_add(1, memory_order_release);
 
   return id;
 }
 
 DYNDT_API std::pair<type_id_t, const id_info *> dynd::lookup_id_by_name(const std::string &name) {
-  // TODO: Create a hash map {name: id_info} for this
-  const vector<id_info> &infos = detail::infos();
-  for (size_t i = 0, iend = infos.size(); i != iend; ++i) {
-    if (infos[i].name == name) {
-      return {type_id_t(i), &infos[i]};
-    }
+  id_names &names = get_id_names();
+  shared_lock<shared_timed_mutex> lock(names.m);
+  auto it = names.ids.find(name);
+  if (it == names.ids.end()) {
+    return {uninitialized_id, nullptr};
   }
-  return {uninitialized_id, nullptr};
+  return {it->second, &detail::infos()[it->second]};
 }
 
 DYNDT_API void dynd::register_known_type_id_constructor(type_id_t id, ndt::type &&singleton_type,
@@ -168,4 +207,9 @@ DYNDT_API void dynd::register_known_type_id_constructor(type_id_t id, ndt::type
         "Type ID " + to_string(id) + ", " + ii.name +
         ", type construction registration needs a type constructor function along with the type args parser");
   }
+  get_registration_counter().fetch_add(1, memory_order_release);
+}
+
+DYNDT_API size_t dynd::detail::get_registration_count() {
+  return get_registration_counter().load(memory_order_acquire);
 }
@@ -3,6 +3,9 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <mutex>
+#include <unordered_map>
+
 #include <dynd/type.hpp>
 
 #include <dynd/buffer.hpp>
@@ -10,8 +13,85 @@
 using namespace std;
 using namespace dynd;
 
-// Default destructor for the extended type does nothing
-ndt::base_type::~base_type() {}
+namespace {
+
+/**
+ * The interned types, by structural hash. The table does not hold
+ * references, so a type leaves it when it is destroyed, and a type that is
+ * being destroyed is never handed out again. It is never freed, so that
+ * types destroyed during static destruction can still leave it.
+ */
+struct intern_table {
+  mutex m;
+  unordered_multimap<size_t, const ndt::base_type *> types;
+  // Counts the types added, starting at 1
+  size_t generation = 1;
+};
+
+intern_table &get_intern_table() {
+  static intern_table *table = new intern_table;
+  return *table;
+}
+
+} // unnamed namespace
+
+ndt::type ndt::detail::intern(type &&tp) {
+  if (tp.is_builtin() || tp->m_interned) {
+    return std::move(tp);
+  }
+
+  base_type *ptr = const_cast<base_type *>(tp.get());
+  ptr->m_hash = tp->compute_hash();
+
+  // Comparing types may make other types, so candidates are compared outside of the lock
+  intern_table &table = get_intern_table();
+  for (size_t generation = 0;;) {
+    vector<type> candidates;
+    {
+      lock_guard<mutex> lock(table.m);
+      if (generation != 0 && generation == table.generation) {
+        table.types.emplace(ptr->m_hash, ptr);
+        ++table.generation;
+        ptr->m_interned = true;
+        return std::move(tp);
+      }
+
+      generation = table.generation;
+      auto range = table.types.equal_range(ptr->m_hash);
+      for (auto it = range.first; it != range.second; ++it) {
+        // A type whose use count has reached 0 is being destroyed
+        long count = it->second->m_use_count.load();
+        while (count != 0 && !it->second->m_use_count.compare_exchange_weak(count, count + 1)) {
+        }
+        if (count != 0) {
+          candidates.emplace_back(it->second, false);
+        }
+      }
+    }
+
+    for (const type &candidate : candidates) {
+      if (*candidate.get() == *ptr) {
+        return candidate;
+      }
+    }
+  }
+}
+
+ndt::base_type::~base_type() {
+  if (m_interned) {
+    intern_table &table = get_intern_table();
+    lock_guard<mutex> lock(table.m);
+    auto range = table.types.equal_range(m_hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == this) {
+        table.types.erase(it);
+        break;
+      }
+    }
+  }
+}
+
+size_t ndt::base_type::compute_hash() const { return detail::hash_combine(0, m_id); }
 
 bool ndt::base_type::is_type_subarray(const type &subarray_tp) const {
   // The default implementation is to check by-value equality.
@@ -91,6 +91,10 @@ bool ndt::bytes_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::bytes_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_alignment);
+}
+
 void ndt::bytes_type::data_destruct(const char *DYND_UNUSED(arrmeta), char *data) const {
   reinterpret_cast<bytes *>(data)->~bytes();
 }
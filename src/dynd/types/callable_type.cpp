@@ -151,6 +151,12 @@ bool ndt::callable_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::callable_type::compute_hash() const {
+  size_t res = detail::hash_combine(base_type::compute_hash(), m_return_type.get_hash());
+  res = detail::hash_combine(res, m_pos_tuple.get_hash());
+  return detail::hash_combine(res, m_kwd_struct.get_hash());
+}
+
 void ndt::callable_type::arrmeta_default_construct(char *DYND_UNUSED(arrmeta), bool DYND_UNUSED(blockref_alloc)) const {
 }
 
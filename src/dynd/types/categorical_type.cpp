@@ -3,15 +3,18 @@
 // BSD 2-Clause License, see LICENSE.txt
 //
 
+#include <algorithm>
 #include <cstring>
 #include <map>
-#include <set>
+#include <vector>
 
 #include <dynd/array_range.hpp>
 #include <dynd/assignment.hpp>
 #include <dynd/callable.hpp>
+#include <dynd/index.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/parse_util.hpp>
-#include <dynd/search.hpp>
+#include <dynd/sort.hpp>
 #include <dynd/types/categorical_type.hpp>
 #include <dynd/types/datashape_parser.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
@@ -21,41 +24,6 @@ using namespace std;
 
 namespace {
 
-class sorter {
-  char *m_originptr;
-  intptr_t m_stride;
-  const kernel_single_t m_less;
-  nd::kernel_prefix *m_less_self;
-
-public:
-  sorter(const char *originptr, intptr_t stride, const kernel_single_t less, nd::kernel_prefix *less_self)
-      : m_originptr(const_cast<char *>(originptr)), m_stride(stride), m_less(less), m_less_self(less_self) {}
-
-  bool operator()(intptr_t i, intptr_t j) const {
-    int dst;
-    char *s[2] = {m_originptr + i * m_stride, m_originptr + j * m_stride};
-    m_less(m_less_self, reinterpret_cast<char *>(&dst), s);
-
-    return dst != 0;
-  }
-};
-
-class cmp {
-  const kernel_single_t m_less;
-  nd::kernel_prefix *m_less_self;
-
-public:
-  cmp(const kernel_single_t less, nd::kernel_prefix *less_self) : m_less(less), m_less_self(less_self) {}
-
-  bool operator()(const char *a, const char *b) const {
-    int dst;
-    char *s[2] = {const_cast<char *>(a), const_cast<char *>(b)};
-
-    m_less(m_less_self, reinterpret_cast<char *>(&dst), s);
-    return dst != 0;
-  }
-};
-
 // struct assign_from_commensurate_category {
 //     static void general_kernel(char *dst, intptr_t dst_stride, const char
 //     *src, intptr_t src_stride,
@@ -106,28 +74,6 @@ public:
 
 } // anoymous namespace
 
-/** This function converts the set of char* pointers into a strided immutable
- * nd::array of the categories */
-static nd::array make_sorted_categories(const set<const char *, cmp> &uniques, const ndt::type &element_tp,
-                                        const char *DYND_UNUSED(arrmeta)) {
-  nd::array categories = nd::empty(uniques.size(), element_tp);
-  nd::kernel_builder k;
-  //  make_assignment_kernel(&k, element_tp, categories.get()->metadata() + sizeof(fixed_dim_type_arrmeta), element_tp,
-  //                       arrmeta, kernel_request_single, &eval::default_eval_context);
-  kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-  intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(categories.get()->metadata())->stride;
-  char *dst_ptr = categories.data();
-  for (set<const char *, cmp>::const_iterator it = uniques.begin(); it != uniques.end(); ++it) {
-    char *src = const_cast<char *>(*it);
-    fn(k.get(), dst_ptr, &src);
-    dst_ptr += stride;
-  }
-  categories.get_type().extended()->arrmeta_finalize_buffers(categories.get()->metadata());
-
-  return categories;
-}
-
 ndt::categorical_type::categorical_type(type_id_t id, const nd::array &categories, bool presorted)
     : base_type(id, 4, 4, type_flag_none, 0, 0, 0) {
   intptr_t category_count;
@@ -159,45 +105,33 @@ ndt::categorical_type::categorical_type(type_id_t id, const nd::array &categorie
     intptr_t categories_stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(categories.get()->metadata())->stride;
 
     const char *categories_element_arrmeta = categories.get()->metadata() + sizeof(fixed_dim_type_arrmeta);
-    nd::kernel_builder k;
-    kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-    cmp less(fn, k.get());
-    set<const char *, cmp> uniques(less);
-
-    m_value_to_category_index = nd::empty(category_count, make_type<intptr_t>());
-    m_category_index_to_value = nd::empty(category_count, make_type<intptr_t>());
-
-    // create the mapping from indices of (to be lexicographically sorted)
-    // categories to values
-    for (size_t i = 0; i != (size_t)category_count; ++i) {
-      unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, i) = i;
-      const char *category_value = categories.cdata() + i * categories_stride;
-
-      if (uniques.find(category_value) == uniques.end()) {
-        uniques.insert(category_value);
-      } else {
+    dynd::detail::category_hash_table uniques(m_category_tp, categories.cdata(), categories_stride, category_count);
+    for (intptr_t i = 0; i < category_count; ++i) {
+      if (uniques.insert(i) != i) {
         stringstream ss;
         ss << "categories must be unique: category value ";
-        m_category_tp.print_data(ss, categories_element_arrmeta, category_value);
+        m_category_tp.print_data(ss, categories_element_arrmeta, categories.cdata() + i * categories_stride);
         ss << " appears more than once";
         throw std::runtime_error(ss.str());
       }
     }
-    // TODO: Putting everything in a set already caused a sort operation to
-    // occur,
-    //       there's no reason we should need a second sort.
-    std::sort(&unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, 0),
-              &unchecked_fixed_dim_get_rw<intptr_t>(m_category_index_to_value, category_count),
-              sorter(categories.cdata(), categories_stride, fn, k.get()));
-
-    // invert the m_category_index_to_value permutation
+
+    // The value of each category is its position in the given categories, and
+    // its index is its position in sorted order
+    m_category_index_to_value = nd::argsort(categories);
+    m_categories = nd::take(categories, m_category_index_to_value);
+
+    m_value_to_category_index = nd::empty(category_count, make_type<intptr_t>());
     for (intptr_t i = 0; i < category_count; ++i) {
       unchecked_fixed_dim_get_rw<intptr_t>(m_value_to_category_index,
                                            unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i)) = i;
     }
+  }
 
-    m_categories = make_sorted_categories(uniques, m_category_tp, categories_element_arrmeta);
+  intptr_t stride = reinterpret_cast<const fixed_dim_type_arrmeta *>(m_categories.get()->metadata())->stride;
+  m_category_table = dynd::detail::category_hash_table(m_category_tp, m_categories.cdata(), stride, category_count);
+  for (intptr_t i = 0; i < category_count; ++i) {
+    m_category_table.insert(i);
   }
 
   // Use the number of categories to set which underlying integer storage to use
@@ -262,22 +196,12 @@ void ndt::categorical_type::get_shape(intptr_t ndim, intptr_t i, intptr_t *out_s
 }
 
 uint32_t ndt::categorical_type::get_value_from_category(const char *category_arrmeta, const char *category_data) const {
-  type dst_tp = make_type<intptr_t>();
-  type src_tp[2] = {m_categories.get_type(), m_category_tp};
-  const char *src_arrmeta[2] = {m_categories.get()->metadata(), category_arrmeta};
-  char *src_data[2] = {const_cast<char *>(m_categories.cdata()), const_cast<char *>(category_data)};
-  intptr_t i =
-      nd::binary_search->call(dst_tp, 2, src_tp, src_arrmeta, src_data, 0, NULL, std::map<std::string, ndt::type>())
-          .as<intptr_t>();
+  intptr_t i = m_category_table.find(category_data);
   if (i < 0) {
-    stringstream ss;
-    ss << "Unrecognized category value ";
-    m_category_tp.print_data(ss, category_arrmeta, category_data);
-    ss << " assigning to dynd type " << type(this, true);
-    throw std::runtime_error(ss.str());
-  } else {
-    return (uint32_t)unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
+    throw_unrecognized_category(category_arrmeta, category_data);
   }
+
+  return get_value_from_category_index(i);
 }
 
 uint32_t ndt::categorical_type::get_value_from_category(const nd::array &category) const {
@@ -291,16 +215,16 @@ uint32_t ndt::categorical_type::get_value_from_category(const nd::array &categor
     c.assign(category);
   }
 
-  intptr_t i = nd::binary_search(m_categories, c).as<intptr_t>();
-  if (i < 0) {
-    stringstream ss;
-    ss << "Unrecognized category value ";
-    m_category_tp.print_data(ss, c.get()->metadata(), c.data());
-    ss << " assigning to dynd type " << type(this, true);
-    throw std::runtime_error(ss.str());
-  } else {
-    return (uint32_t)unchecked_fixed_dim_get<intptr_t>(m_category_index_to_value, i);
-  }
+  return get_value_from_category(c.get()->metadata(), c.cdata());
+}
+
+void ndt::categorical_type::throw_unrecognized_category(const char *category_arrmeta,
+                                                        const char *category_data) const {
+  stringstream ss;
+  ss << "Unrecognized category value ";
+  m_category_tp.print_data(ss, category_arrmeta, category_data);
+  ss << " assigning to dynd type " << type(this, true);
+  throw std::runtime_error(ss.str());
 }
 
 const char *ndt::categorical_type::get_category_arrmeta() const {
@@ -384,22 +308,39 @@ ndt::type ndt::factor_categorical(const nd::array &values) {
   type el_tp;
   const char *el_arrmeta;
   values_eval.get_type().get_as_strided(values_eval.get()->metadata(), &dim_size, &stride, &el_tp, &el_arrmeta);
-
-  nd::kernel_builder k;
-  kernel_single_t fn = k.get()->get_function<kernel_single_t>();
-
-  cmp less(fn, k.get());
-  set<const char *, cmp> uniques(less);
-
-  for (intptr_t i = 0; i < dim_size; ++i) {
-    const char *data = values_eval.cdata() + i * stride;
-    if (uniques.find(data) == uniques.end()) {
-      uniques.insert(data);
+  const char *data = values_eval.cdata();
+
+  // Each chunk finds the first occurrences of the values in it, and then
+  // those are merged in order
+  size_t nchunk = std::max<size_t>(1, std::min<size_t>(get_num_threads(), dim_size / 65536));
+  std::vector<std::vector<intptr_t>> chunk_uniques(nchunk);
+  parallel_for(nchunk, [&](size_t i) {
+    intptr_t begin = dim_size * i / nchunk, end = dim_size * (i + 1) / nchunk;
+    dynd::detail::category_hash_table uniques(el_tp, data, stride);
+    for (intptr_t j = begin; j < end; ++j) {
+      if (uniques.insert(j) == j) {
+        chunk_uniques[i].push_back(j);
+      }
+    }
+  });
+
+  dynd::detail::category_hash_table uniques(el_tp, data, stride, chunk_uniques[0].size());
+  std::vector<intptr_t> indices;
+  for (const std::vector<intptr_t> &chunk : chunk_uniques) {
+    for (intptr_t j : chunk) {
+      if (uniques.insert(j) == j) {
+        indices.push_back(j);
+      }
     }
   }
 
-  // Copy the values (now sorted and unique) into a new nd::array
-  nd::array categories = make_sorted_categories(uniques, el_tp, el_arrmeta);
+  // Copy the distinct values into a new nd::array, and sort them
+  nd::array index = nd::empty(indices.size(), make_type<intptr_t>());
+  if (!indices.empty()) {
+    memcpy(index.data(), indices.data(), indices.size() * sizeof(intptr_t));
+  }
+  nd::array categories = nd::take(values_eval, index);
+  nd::sort(categories);
 
   return make_type<categorical_type>(categories, true);
 }
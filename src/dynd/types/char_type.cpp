@@ -66,6 +66,10 @@ bool ndt::char_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::char_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_encoding);
+}
+
 // char_type : char | char[encoding]
 ndt::type ndt::char_type::parse_type_args(type_id_t DYND_UNUSED(id), const char *&rbegin, const char *end,
                                           std::map<std::string, ndt::type> &DYND_UNUSED(symtable)) {
@@ -4,8 +4,11 @@
 //
 
 #include <map>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <dynd/parse_util.hpp>
 #include <dynd/type_registry.hpp>
@@ -29,19 +32,16 @@ using namespace dynd;
 // Simple recursive descent parser for a subset of the Blaze datashape grammar.
 // (Blaze grammar modified slightly to work this way)
 
+// Initialized once, as datashapes are parsed on any thread
 static const map<std::string, ndt::type> &builtin_types() {
-  static map<std::string, ndt::type> bit;
-  if (bit.empty()) {
-    bit["int"] = ndt::make_type<int>();
-    bit["intptr"] = ndt::make_type<intptr_t>();
-    bit["uintptr"] = ndt::make_type<uintptr_t>();
-    bit["size"] = ndt::make_type<size_t>();
-    bit["real"] = ndt::make_type<double>();
-    bit["complex64"] = ndt::make_type<dynd::complex<float32>>();
-    bit["complex128"] = ndt::make_type<dynd::complex<float64>>();
-    bit["complex"] = ndt::make_type<dynd::complex<double>>();
-  }
-
+  static const map<std::string, ndt::type> bit{{"int", ndt::make_type<int>()},
+                                               {"intptr", ndt::make_type<intptr_t>()},
+                                               {"uintptr", ndt::make_type<uintptr_t>()},
+                                               {"size", ndt::make_type<size_t>()},
+                                               {"real", ndt::make_type<double>()},
+                                               {"complex64", ndt::make_type<dynd::complex<float32>>()},
+                                               {"complex128", ndt::make_type<dynd::complex<float64>>()},
+                                               {"complex", ndt::make_type<dynd::complex<double>>()}};
   return bit;
 }
 
@@ -951,7 +951,7 @@ static void get_error_line_column(const char *begin, const char *end, const char
   throw runtime_error("Cannot get line number of error, its position is out of range");
 }
 
-ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *datashape_end) {
+static ndt::type parse_datashape(const char *datashape_begin, const char *datashape_end) {
   try {
     // Symbol table for intermediate types declared in the datashape
     map<std::string, ndt::type> symtable;
@@ -977,6 +977,69 @@ ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *dat
   }
 }
 
+namespace {
+
+/**
+ * A process-wide cache of parsed datashapes. Lookups share the lock, and the
+ * cache is dropped when it is full or when types are registered, which may
+ * change what a datashape means. The registrations are counted by the type
+ * registry, so the cache never reads the registry outside of its lock.
+ */
+class datashape_cache {
+  static const size_t max_size = 4096;
+
+  shared_timed_mutex m_mutex;
+  unordered_map<std::string, ndt::type> m_types;
+  size_t m_registration_count = 0;
+
+public:
+  bool find(const std::string &datashape, size_t registration_count, ndt::type &out_tp) {
+    shared_lock<shared_timed_mutex> lock(m_mutex);
+    auto it = m_types.find(datashape);
+    if (it == m_types.end() || m_registration_count != registration_count) {
+      return false;
+    }
+
+    out_tp = it->second;
+    return true;
+  }
+
+  /**
+   * Stores a type parsed when ``registration_count`` types were registered,
+   * returning the one to use if another thread stored it first.
+   */
+  ndt::type insert(const std::string &datashape, size_t registration_count, const ndt::type &tp) {
+    unique_lock<shared_timed_mutex> lock(m_mutex);
+    if (m_registration_count != registration_count || m_types.size() == max_size) {
+      m_types.clear();
+      m_registration_count = registration_count;
+    }
+
+    return m_types.emplace(datashape, tp).first->second;
+  }
+};
+
+datashape_cache &get_datashape_cache() {
+  static datashape_cache cache;
+  return cache;
+}
+
+} // unnamed namespace
+
+ndt::type dynd::type_from_datashape(const char *datashape_begin, const char *datashape_end) {
+  std::string datashape(datashape_begin, datashape_end);
+  datashape_cache &cache = get_datashape_cache();
+
+  // Counted before parsing, so a type parsed while one is registered is not kept past it
+  size_t registration_count = detail::get_registration_count();
+  ndt::type tp;
+  if (!cache.find(datashape, registration_count, tp)) {
+    tp = cache.insert(datashape, registration_count, parse_datashape(datashape_begin, datashape_end));
+  }
+
+  return tp;
+}
+
 nd::buffer datashape::parse_type_constr_args(const std::string &str) {
   nd::buffer result;
   std::map<std::string, ndt::type> symtable;
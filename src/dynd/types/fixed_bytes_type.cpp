@@ -69,6 +69,10 @@ bool ndt::fixed_bytes_type::operator==(const base_type &rhs) const
   }
 }
 
+size_t ndt::fixed_bytes_type::compute_hash() const {
+  return detail::hash_combine(detail::hash_combine(base_type::compute_hash(), get_data_size()), get_data_alignment());
+}
+
 ndt::type ndt::fixed_bytes_type::parse_type_args(type_id_t DYND_UNUSED(id), const char *&rbegin, const char *end,
                                                  std::map<std::string, ndt::type> &DYND_UNUSED(symtable)) {
   const char *begin = rbegin;
@@ -94,6 +94,10 @@ bool ndt::fixed_dim_kind_type::operator==(const base_type &rhs) const {
                           m_element_tp == reinterpret_cast<const fixed_dim_kind_type *>(&rhs)->m_element_tp);
 }
 
+size_t ndt::fixed_dim_kind_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_element_tp.get_hash());
+}
+
 void ndt::fixed_dim_kind_type::arrmeta_default_construct(char *DYND_UNUSED(arrmeta),
                                                          bool DYND_UNUSED(blockref_alloc)) const {
   stringstream ss;
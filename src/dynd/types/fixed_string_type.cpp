@@ -131,6 +131,10 @@ bool ndt::fixed_string_type::operator==(const base_type &rhs) const
   }
 }
 
+size_t ndt::fixed_string_type::compute_hash() const {
+  return detail::hash_combine(detail::hash_combine(base_type::compute_hash(), m_encoding), m_stringsize);
+}
+
 std::map<std::string, std::pair<ndt::type, const char *>> ndt::fixed_string_type::get_dynamic_type_properties() const
 {
   std::map<std::string, std::pair<ndt::type, const char *>> properties;
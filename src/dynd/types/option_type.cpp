@@ -31,6 +31,18 @@ void dynd::assign_na_builtin(type_id_t value_id, char *data) {
   case int128_id:
     *reinterpret_cast<int128 *>(data) = DYND_INT128_NA;
     return;
+  case uint8_id:
+    *reinterpret_cast<uint8_t *>(data) = numeric_limits<uint8_t>::max();
+    return;
+  case uint16_id:
+    *reinterpret_cast<uint16_t *>(data) = numeric_limits<uint16_t>::max();
+    return;
+  case uint32_id:
+    *reinterpret_cast<uint32_t *>(data) = DYND_UINT32_NA;
+    return;
+  case uint64_id:
+    *reinterpret_cast<uint64_t *>(data) = numeric_limits<uint64_t>::max();
+    return;
   case float32_id:
     *reinterpret_cast<uint32_t *>(data) = DYND_FLOAT32_NA_AS_UINT;
     return;
@@ -61,8 +73,14 @@ bool dynd::is_avail_builtin(type_id_t value_id, const char *data) {
     return *reinterpret_cast<const int16_t *>(data) != DYND_INT16_NA;
   case int32_id:
     return *reinterpret_cast<const int32_t *>(data) != DYND_INT32_NA;
+  case uint8_id:
+    return *reinterpret_cast<const uint8_t *>(data) != numeric_limits<uint8_t>::max();
+  case uint16_id:
+    return *reinterpret_cast<const uint16_t *>(data) != numeric_limits<uint16_t>::max();
   case uint32_id:
     return *reinterpret_cast<const uint32_t *>(data) != DYND_UINT32_NA;
+  case uint64_id:
+    return *reinterpret_cast<const uint64_t *>(data) != numeric_limits<uint64_t>::max();
   case int64_id:
     return *reinterpret_cast<const int64_t *>(data) != DYND_INT64_NA;
   case int128_id:
@@ -151,6 +169,10 @@ bool ndt::option_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::option_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_value_tp.get_hash());
+}
+
 void ndt::option_type::arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const {
   if (!m_value_tp.is_builtin()) {
     m_value_tp.extended()->arrmeta_default_construct(arrmeta, blockref_alloc);
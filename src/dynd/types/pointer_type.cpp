@@ -165,6 +165,10 @@ bool ndt::pointer_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::pointer_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_target_tp.get_hash());
+}
+
 ndt::type ndt::pointer_type::with_replaced_storage_type(const type & /*replacement_tp*/) const {
   throw runtime_error("TODO: implement pointer_type::with_replaced_storage_type");
 }
@@ -168,6 +168,15 @@ bool ndt::struct_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::struct_type::compute_hash() const {
+  size_t res = detail::hash_combine(detail::hash_combine(base_type::compute_hash(), get_data_alignment()), m_variadic);
+  for (size_t i = 0; i < m_field_types.size(); ++i) {
+    res = detail::hash_combine(detail::hash_combine(res, std::hash<std::string>()(m_field_names[i])),
+                               m_field_types[i].get_hash());
+  }
+  return res;
+}
+
 void ndt::struct_type::arrmeta_debug_print(const char *arrmeta, std::ostream &o, const std::string &indent) const {
   const size_t *offsets = reinterpret_cast<const size_t *>(arrmeta);
   o << indent << "struct arrmeta\n";
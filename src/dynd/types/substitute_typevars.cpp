@@ -363,6 +363,11 @@ ndt::type ndt::detail::internal_substitute(const ndt::type &pattern, const std::
       return pattern;
     }
   }
+  case bool_kind_id:
+  case int_kind_id:
+  case uint_kind_id:
+  case float_kind_id:
+  case complex_kind_id:
   case scalar_kind_id: {
     if (concrete) {
       stringstream ss;
@@ -254,6 +254,14 @@ bool ndt::tuple_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::tuple_type::compute_hash() const {
+  size_t res = detail::hash_combine(detail::hash_combine(base_type::compute_hash(), get_data_alignment()), m_variadic);
+  for (const type &field_tp : m_field_types) {
+    res = detail::hash_combine(res, field_tp.get_hash());
+  }
+  return res;
+}
+
 void ndt::tuple_type::arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const {
   uintptr_t *data_offsets = reinterpret_cast<uintptr_t *>(arrmeta);
   const vector<type> &field_tps = get_field_types();
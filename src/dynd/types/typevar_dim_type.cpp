@@ -52,6 +52,11 @@ bool ndt::typevar_dim_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::typevar_dim_type::compute_hash() const {
+  return detail::hash_combine(detail::hash_combine(base_type::compute_hash(), std::hash<std::string>()(m_name)),
+                             m_element_tp.get_hash());
+}
+
 ndt::type ndt::typevar_dim_type::get_type_at_dimension(char **DYND_UNUSED(inout_arrmeta), intptr_t i,
                                                        intptr_t total_ndim) const {
   if (i == 0) {
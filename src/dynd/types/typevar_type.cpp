@@ -60,6 +60,10 @@ bool ndt::typevar_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::typevar_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), std::hash<std::string>()(m_name));
+}
+
 void ndt::typevar_type::arrmeta_default_construct(char *DYND_UNUSED(arrmeta), bool DYND_UNUSED(blockref_alloc)) const {
   throw type_error("Cannot store data of typevar type");
 }
@@ -307,6 +307,10 @@ bool ndt::var_dim_type::operator==(const base_type &rhs) const {
   }
 }
 
+size_t ndt::var_dim_type::compute_hash() const {
+  return detail::hash_combine(base_type::compute_hash(), m_element_tp.get_hash());
+}
+
 void ndt::var_dim_type::arrmeta_default_construct(char *arrmeta, bool blockref_alloc) const {
   size_t element_size =
       m_element_tp.is_builtin() ? m_element_tp.get_data_size() : m_element_tp.extended()->get_default_data_size();
@@ -449,6 +449,52 @@ TEST(Arithmetic, OptionArrayNotOptionFloat64) {
   }
 }
 
+TEST(Arithmetic, OptionArrayBlockwiseFloat64) {
+  // More elements than one block of the blockwise kernel, with runs of NAs across the blocks
+  intptr_t size = 300;
+  nd::array a = nd::empty(size, ndt::type("?float64"));
+  nd::array b = nd::empty(size, ndt::type("?float64"));
+  for (intptr_t i = 0; i < size; ++i) {
+    if (i % 7 == 0 || (i >= 120 && i < 140)) {
+      a(i).assign_na();
+    } else {
+      a(i).assign(0.5 * i);
+    }
+    if (i % 5 == 0) {
+      b(i).assign_na();
+    } else {
+      b(i).assign(2.0);
+    }
+  }
+
+  nd::array c = a * b;
+  nd::array d = a + 1.5;
+  for (intptr_t i = 0; i < size; ++i) {
+    bool a_na = i % 7 == 0 || (i >= 120 && i < 140);
+    EXPECT_EQ(a_na || i % 5 == 0, c(i).is_na());
+    EXPECT_EQ(a_na, d(i).is_na());
+    if (!c(i).is_na()) {
+      EXPECT_EQ(1.0 * i, c(i).as<double>());
+    }
+    if (!a_na) {
+      EXPECT_EQ(0.5 * i + 1.5, d(i).as<double>());
+    }
+  }
+
+  // A strided view and a scalar
+  nd::array e = a(irange().by(3)) - b(irange().by(3));
+  EXPECT_TRUE(e(0).is_na());
+  EXPECT_EQ(-0.5, e(1).as<double>());
+  EXPECT_TRUE(e(5).is_na());
+  EXPECT_TRUE((a(0) + b(1)).is_na());
+  EXPECT_EQ(2.5, (a(1) + b(1)).as<double>());
+
+  // The same NA is copied through the assignment of the same option type
+  nd::array f = nd::empty(size, ndt::type("?float64")).assign(a);
+  EXPECT_ARRAY_EQ(nd::is_na(a), nd::is_na(f));
+  EXPECT_EQ(2.0, f(4).as<double>());
+}
+
 REGISTER_TYPED_TEST_CASE_P(Arithmetic, SimpleBroadcast, StridedScalarBroadcast, ScalarOnTheRight, ScalarOnTheLeft,
                            ComplexScalar);
 
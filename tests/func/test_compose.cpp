@@ -35,6 +35,38 @@ TEST(Compose, Simple) {
   EXPECT_DOUBLE_EQ(sin(3.1), a.as<double>());
 }
 
+TEST(Compose, Strided) {
+  // More elements than fit in the buffer at once, so it is reused across chunks
+  nd::callable composed = nd::functional::elwise(
+      nd::functional::compose(nd::functional::apply([](float x) { return static_cast<double>(x); }),
+                              nd::functional::apply([](double x) { return sin(x); }), ndt::make_type<double>()));
+  nd::array a = nd::empty(3 * DYND_BUFFER_CHUNK_SIZE + 5, ndt::make_type<float>());
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    a(i).assign(0.01f * i);
+  }
+
+  nd::array b = composed(a);
+  ASSERT_EQ(a.get_dim_size(), b.get_dim_size());
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    EXPECT_DOUBLE_EQ(sin(static_cast<double>(0.01f * i)), b(i).as<double>());
+  }
+}
+
+TEST(Compose, StringBuffer) {
+  nd::callable composed = nd::functional::elwise(nd::functional::compose(
+      nd::functional::apply([](int x) { return dynd::string(std::to_string(x) + " is longer than a short string"); }),
+      nd::functional::apply([](dynd::string s) { return static_cast<int>(s.size()); }), ndt::type("string")));
+  nd::array a = nd::empty(2 * DYND_BUFFER_CHUNK_SIZE + 1, ndt::make_type<int>());
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    a(i).assign(i);
+  }
+
+  nd::array b = composed(a);
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    EXPECT_EQ(static_cast<int>(std::to_string(i).size() + 30), b(i).as<int>());
+  }
+}
+
 /*
 TEST(Convert, Unary)
 {
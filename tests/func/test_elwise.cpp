@@ -218,6 +218,26 @@ TEST(Elwise, Binary_FixedDim) {
   EXPECT_ARRAY_EQ((nd::array{3, 5, 7}), f({{0, 1, 2}, {3, 4, 5}}, {}));
 }
 
+TEST(Elwise, Binary_MultiFixedDim) {
+  nd::callable f = nd::functional::elwise(nd::functional::apply([](int x, int y) { return 10 * x + y; }));
+
+  // Contiguous dimensions
+  nd::array a{{1, 2, 3}, {4, 5, 6}};
+  EXPECT_ARRAY_EQ((nd::array{{10, 21, 32}, {43, 54, 65}}), f(a, nd::array{{0, 1, 2}, {3, 4, 5}}));
+  EXPECT_ARRAY_EQ((nd::array{{{11, 21}, {31, 41}}, {{51, 61}, {71, 81}}}),
+                  f(nd::array{{{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}}, 1));
+
+  // Broadcast dimensions
+  EXPECT_ARRAY_EQ((nd::array{{17, 28, 39}, {47, 58, 69}}), f(a, nd::array{7, 8, 9}));
+  EXPECT_ARRAY_EQ((nd::array{{17, 18, 19}, {47, 48, 49}}), f(nd::array{{1}, {4}}, nd::array{7, 8, 9}));
+
+  // Transposed and strided dimensions
+  intptr_t axes[2] = {1, 0};
+  EXPECT_ARRAY_EQ((nd::array{{10, 41}, {22, 53}, {34, 65}}),
+                  f(a.permute(2, axes), nd::array{{0, 1}, {2, 3}, {4, 5}}));
+  EXPECT_ARRAY_EQ((nd::array{{10, 31}, {42, 63}}), f(a(irange(), irange().by(2)), nd::array{{0, 1}, {2, 3}}));
+}
+
 /*
 // TODO Reenable once there's a convenient way to make the binary callable
 TEST(LiftCallable, Expr_MultiDimVarToVarDim) {
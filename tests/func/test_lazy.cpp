@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/arithmetic.hpp>
+#include <dynd/array.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/lazy.hpp>
+#include <dynd/math.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Lazy, Leaf) {
+  nd::array a{1.0, 2.0, 3.0};
+  EXPECT_ARRAY_EQ(a, nd::lazy(a).eval());
+}
+
+TEST(Lazy, Scalar) {
+  nd::array a = 3.0;
+  EXPECT_ARRAY_EQ(-(a * a + 1.0), (-(nd::lazy(a) * a + 1.0)).eval());
+}
+
+TEST(Lazy, Fused) {
+  // More elements than fit in one block, so the intermediates are reused
+  size_t size = 3 * DYND_BUFFER_CHUNK_SIZE + 7;
+  nd::array a = nd::empty(size, ndt::make_type<double>());
+  nd::array b = nd::empty(size, ndt::make_type<double>());
+  nd::array c = nd::empty(size, ndt::make_type<double>());
+  for (size_t i = 0; i < size; ++i) {
+    a(i).vals() = static_cast<double>(i);
+    b(i).vals() = 0.5 * i - 3.0;
+    c(i).vals() = 2.0;
+  }
+
+  EXPECT_ARRAY_EQ(a * b + c, (nd::lazy(a) * b + c).eval());
+  EXPECT_ARRAY_EQ((a - b) / (c + a), ((nd::lazy(a) - b) / (nd::lazy(c) + a)).eval());
+  EXPECT_ARRAY_EQ(nd::sin(a * b) - c, (nd::lazy_array(nd::sin, {nd::lazy(a) * b}) - c).eval());
+}
+
+TEST(Lazy, Shared) {
+  nd::array a{1.0, 2.0, 3.0, 4.0};
+  nd::lazy_array x = nd::lazy(a) + 1.0;
+  EXPECT_ARRAY_EQ((a + 1.0) * (a + 1.0), (x * x).eval());
+}
+
+TEST(Lazy, MixedTypes) {
+  nd::array a{1, 2, 3};
+  nd::array b{0.5f, 1.5f, 2.5f};
+  nd::array c{1.0, 2.0, 4.0};
+  EXPECT_ARRAY_EQ(a * b + c, (nd::lazy(a) * b + c).eval());
+}
+
+TEST(Lazy, Broadcast) {
+  nd::array a{{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+  nd::array b{10.0, 20.0, 30.0};
+  EXPECT_ARRAY_EQ(a * b - 2.0, (nd::lazy(a) * b - 2.0).eval());
+}
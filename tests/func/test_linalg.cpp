@@ -0,0 +1,200 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cmath>
+#include <stdexcept>
+
+#include <dynd/gtest.hpp>
+#include <dynd/linalg.hpp>
+#include <dynd/parallel.hpp>
+#include <dynd/random.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+template <typename T>
+struct unit_bounds {
+  static T a() { return T(-1, -1); }
+  static T b() { return T(1, 1); }
+};
+
+template <>
+struct unit_bounds<float> {
+  static float a() { return -1; }
+  static float b() { return 1; }
+};
+
+template <>
+struct unit_bounds<double> {
+  static double a() { return -1; }
+  static double b() { return 1; }
+};
+
+template <typename T>
+nd::array random_matrix(intptr_t m, intptr_t n, int seed) {
+  ndt::type tp = ndt::make_fixed_dim(m, ndt::make_fixed_dim(n, ndt::make_type<T>()));
+  return nd::random::uniform(
+      {}, {{"a", unit_bounds<T>::a()}, {"b", unit_bounds<T>::b()}, {"seed", seed}, {"dst_tp", tp}});
+}
+
+template <typename T>
+T element(const nd::array &a, intptr_t i, intptr_t j) {
+  return a(i, j).as<T>();
+}
+
+double magnitude(float x) { return fabs(x); }
+double magnitude(double x) { return fabs(x); }
+double magnitude(dynd::complex<float> x) { return abs(x); }
+double magnitude(dynd::complex<double> x) { return abs(x); }
+
+template <typename T>
+double tolerance() {
+  return is_same<T, float>::value || is_same<T, dynd::complex<float>>::value ? 1e-5 : 1e-13;
+}
+
+// Checks the product of two matrices against its definition
+template <typename T>
+void expect_product(const nd::array &a, const nd::array &b, const nd::array &c) {
+  intptr_t m = a.get_dim_size(), k = b.get_dim_size(), n = c(0).get_dim_size();
+  ASSERT_EQ(m, c.get_dim_size());
+  for (intptr_t i = 0; i < m; i += max<intptr_t>(1, m / 17)) {
+    for (intptr_t j = 0; j < n; j += max<intptr_t>(1, n / 13)) {
+      T expected = T();
+      for (intptr_t p = 0; p < k; ++p) {
+        expected = expected + element<T>(a, i, p) * element<T>(b, p, j);
+      }
+      EXPECT_LE(magnitude(expected - element<T>(c, i, j)), tolerance<T>() * (1 + k)) << "at " << i << ", " << j;
+    }
+  }
+}
+
+} // unnamed namespace
+
+template <typename T>
+class Linalg : public ::testing::Test {};
+
+typedef ::testing::Types<float, double, dynd::complex<float>, dynd::complex<double>> FloatingTypes;
+
+TYPED_TEST_CASE_P(Linalg);
+
+TYPED_TEST_P(Linalg, Matmul) {
+  // Sizes around the register and cache blocks
+  const intptr_t sizes[][3] = {{1, 1, 1}, {3, 4, 5}, {17, 33, 9}, {64, 64, 64}, {129, 257, 70}, {200, 300, 150}};
+  for (const auto &size : sizes) {
+    nd::array a = random_matrix<TypeParam>(size[0], size[1], 1);
+    nd::array b = random_matrix<TypeParam>(size[1], size[2], 2);
+    nd::array c = nd::matmul(a, b);
+    EXPECT_EQ(ndt::make_fixed_dim(size[0], ndt::make_fixed_dim(size[2], ndt::make_type<TypeParam>())),
+              c.get_type());
+    expect_product<TypeParam>(a, b, c);
+  }
+}
+
+TYPED_TEST_P(Linalg, MatmulViews) {
+  // Strided and transposed operands are read in place
+  nd::array a = random_matrix<TypeParam>(300, 140, 3);
+  nd::array b = random_matrix<TypeParam>(150, 280, 4);
+  nd::array as = a(irange().by(2), irange());
+  nd::array bt = b.transpose()(irange().by(2), irange());
+  expect_product<TypeParam>(as, bt, nd::matmul(as, bt));
+
+  // So is a strided destination
+  nd::array c = nd::empty(150, 2 * 75, ndt::make_type<TypeParam>());
+  nd::matmul({as, bt(irange(), irange().by(2))}, {{"dst", c(irange(), irange(0, 75))}});
+  expect_product<TypeParam>(as, bt(irange(), irange().by(2)), c(irange(), irange(0, 75)));
+}
+
+REGISTER_TYPED_TEST_CASE_P(Linalg, Matmul, MatmulViews);
+INSTANTIATE_TYPED_TEST_CASE_P(Floating, Linalg, FloatingTypes);
+
+TEST(Linalg, MatmulBatched) {
+  nd::array a = nd::random::uniform({}, {{"seed", 5}, {"dst_tp", ndt::type("3 * 2 * 20 * 30 * float64")}});
+  nd::array b = nd::random::uniform({}, {{"seed", 6}, {"dst_tp", ndt::type("2 * 30 * 10 * float64")}});
+  nd::array c = nd::matmul(a, b);
+  EXPECT_EQ(ndt::type("3 * 2 * 20 * 10 * float64"), c.get_type());
+  for (intptr_t i = 0; i < 3; ++i) {
+    for (intptr_t j = 0; j < 2; ++j) {
+      expect_product<double>(a(i, j), b(j), c(i, j));
+    }
+  }
+
+  // A dimension of size 1 is broadcast
+  nd::array d = nd::matmul(a, b(irange(0, 1)));
+  EXPECT_EQ(ndt::type("3 * 2 * 20 * 10 * float64"), d.get_type());
+  expect_product<double>(a(2, 1), b(0), d(2, 1));
+}
+
+TEST(Linalg, MatmulVectors) {
+  nd::array a = {{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}};
+  nd::array v = {1.0, 0.0, -1.0};
+  nd::array w = {2.0, 1.0};
+
+  EXPECT_ARRAY_EQ((nd::array{-2.0, -2.0}), nd::matmul(a, v));
+  EXPECT_ARRAY_EQ((nd::array{6.0, 9.0, 12.0}), nd::matmul(w, a));
+  EXPECT_EQ(-2.0, nd::matmul(v, v(irange().by(-1))).as<double>());
+  EXPECT_EQ(ndt::make_type<double>(), nd::matmul(v, v).get_type());
+}
+
+TEST(Linalg, MatmulThreads) {
+  nd::array a = random_matrix<float>(400, 300, 7);
+  nd::array b = random_matrix<float>(300, 500, 8);
+
+  set_num_threads(1);
+  nd::array c = nd::matmul(a, b);
+  set_num_threads(4);
+  nd::array d = nd::matmul(a, b);
+  set_num_threads(0);
+  EXPECT_ARRAY_EQ(c, d);
+  expect_product<float>(a, b, d);
+}
+
+TEST(Linalg, MatmulEmpty) {
+  nd::array a = nd::empty(4, 0, ndt::make_type<double>());
+  nd::array b = nd::empty(0, 3, ndt::make_type<double>());
+  EXPECT_ARRAY_EQ(nd::array({{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}}),
+                  nd::matmul(a, b));
+}
+
+TEST(Linalg, MatmulErrors) {
+  nd::array a = nd::empty(4, 3, ndt::make_type<double>());
+  EXPECT_THROW(nd::matmul(a, a), invalid_argument);
+  EXPECT_THROW(nd::matmul(a, nd::empty(3, ndt::make_type<float>())), type_error);
+  EXPECT_THROW(nd::matmul(a, nd::empty(3, ndt::make_type<int32_t>())), type_error);
+  EXPECT_THROW(nd::matmul(nd::empty(2, 4, 3, ndt::make_type<double>()), nd::empty(3, 3, 2, ndt::make_type<double>())),
+               invalid_argument);
+}
+
+TEST(Linalg, Tensordot) {
+  nd::array a = nd::random::uniform({}, {{"seed", 9}, {"dst_tp", ndt::type("5 * 6 * 7 * float64")}});
+  nd::array b = nd::random::uniform({}, {{"seed", 10}, {"dst_tp", ndt::type("6 * 7 * 4 * float64")}});
+
+  nd::array c = nd::tensordot(a, b);
+  EXPECT_EQ(ndt::type("5 * 4 * float64"), c.get_type());
+  for (intptr_t i = 0; i < 5; ++i) {
+    for (intptr_t j = 0; j < 4; ++j) {
+      double expected = 0;
+      for (intptr_t p = 0; p < 6; ++p) {
+        for (intptr_t q = 0; q < 7; ++q) {
+          expected += a(i, p, q).as<double>() * b(p, q, j).as<double>();
+        }
+      }
+      EXPECT_NEAR(expected, c(i, j).as<double>(), 1e-12);
+    }
+  }
+
+  // One contracted dimension is a batch of matrix products, and none is the outer product
+  nd::array d = nd::tensordot({a(irange(), irange(), 0), b}, {{"axes", 1}});
+  EXPECT_EQ(ndt::type("5 * 7 * 4 * float64"), d.get_type());
+  EXPECT_NEAR(d(1, 2, 3).as<double>(), nd::matmul(a(irange(), irange(), 0), b(irange(), 2))(1, 3).as<double>(),
+              1e-12);
+  nd::array e = nd::tensordot({a(0, 0), b(0, 0)}, {{"axes", 0}});
+  EXPECT_EQ(ndt::type("7 * 4 * float64"), e.get_type());
+  EXPECT_EQ(a(0, 0, 3).as<double>() * b(0, 0, 2).as<double>(), e(3, 2).as<double>());
+
+  EXPECT_THROW(nd::tensordot({a, b}, {{"axes", 3}}), invalid_argument);
+  EXPECT_THROW(nd::tensordot({a, b}, {{"axes", 1}}), invalid_argument);
+}
@@ -6,8 +6,10 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
+#include <dynd/arithmetic.hpp>
 #include <dynd/gtest.hpp>
 #include <dynd/math.hpp>
 #include <dynd/random.hpp>
@@ -19,3 +21,148 @@ TEST(Math, Sin) {
   nd::array x = nd::random::uniform({}, {{"dst_tp", ndt::type("100 * float64")}});
   nd::sin(x);
 }
+
+namespace {
+
+// The distance between two values in units in the last place
+template <typename T>
+double ulp_error(T expected, T actual) {
+  if (std::isnan(expected) || std::isnan(actual)) {
+    return (std::isnan(expected) && std::isnan(actual)) ? 0 : std::numeric_limits<double>::infinity();
+  }
+  if (expected == actual) {
+    return 0;
+  }
+
+  T ulp = std::nextafter(expected, std::numeric_limits<T>::infinity()) - expected;
+  return std::fabs(static_cast<double>(actual) - static_cast<double>(expected)) / ulp;
+}
+
+// Compares ``f`` on every element of ``x``, a one dimensional array, against the
+// C library function ``g``
+template <typename T>
+void check_math(const nd::callable &f, T (*g)(T), const nd::array &x, int ulp) {
+  nd::array y = (ulp == 0) ? f(x) : f({x}, {{"ulp", ulp}});
+  ASSERT_EQ(x.get_type(), y.get_type());
+
+  for (intptr_t i = 0; i < x.get_dim_size(); ++i) {
+    T expected = g(x(i).as<T>());
+    T actual = y(i).as<T>();
+    if (ulp == 0) {
+      EXPECT_EQ(0, ulp_error(expected, actual)) << "at " << x(i).as<T>();
+    } else {
+      EXPECT_LE(ulp_error(expected, actual), ulp) << "at " << x(i).as<T>();
+    }
+  }
+}
+
+template <typename T>
+nd::array make_math_args(T lo, T hi, size_t size) {
+  nd::array x = nd::empty(size, ndt::make_type<T>());
+  for (size_t i = 0; i < size; ++i) {
+    x(i).vals() = lo + (hi - lo) * static_cast<T>(i) / static_cast<T>(size - 1);
+  }
+
+  return x;
+}
+
+} // unnamed namespace
+
+template <typename T>
+class MathFunctions : public ::testing::Test {};
+
+typedef ::testing::Types<float, double> MathFunctionTypes;
+TYPED_TEST_CASE_P(MathFunctions);
+
+TYPED_TEST_P(MathFunctions, Precise) {
+  typedef TypeParam T;
+
+  // More elements than fit in one block
+  nd::array x = make_math_args<T>(-20, 20, 3 * DYND_BUFFER_CHUNK_SIZE + 5);
+  nd::array pos = make_math_args<T>(static_cast<T>(0.001), 50, 3 * DYND_BUFFER_CHUNK_SIZE + 5);
+
+  check_math<T>(nd::sin, &std::sin, x, 0);
+  check_math<T>(nd::cos, &std::cos, x, 0);
+  check_math<T>(nd::tan, &std::tan, x, 0);
+  check_math<T>(nd::exp, &std::exp, x, 0);
+  check_math<T>(nd::expm1, &std::expm1, x, 0);
+  check_math<T>(nd::tanh, &std::tanh, x, 0);
+  check_math<T>(nd::log, &std::log, pos, 0);
+  check_math<T>(nd::log1p, &std::log1p, pos, 0);
+}
+
+TYPED_TEST_P(MathFunctions, Fast) {
+  typedef TypeParam T;
+
+  nd::array x = make_math_args<T>(-80, 80, 10007);
+  nd::array small = make_math_args<T>(static_cast<T>(-0.01), static_cast<T>(0.01), 1001);
+  nd::array pos = make_math_args<T>(std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), 10007);
+  nd::array unit = make_math_args<T>(static_cast<T>(-0.999), 10, 10007);
+
+  for (const nd::array &a : {x, small}) {
+    check_math<T>(nd::sin, &std::sin, a, 4);
+    check_math<T>(nd::cos, &std::cos, a, 4);
+    check_math<T>(nd::tan, &std::tan, a, 4);
+    check_math<T>(nd::exp, &std::exp, a, 4);
+    check_math<T>(nd::expm1, &std::expm1, a, 4);
+    check_math<T>(nd::tanh, &std::tanh, a, 4);
+  }
+  check_math<T>(nd::log, &std::log, pos, 4);
+  check_math<T>(nd::log1p, &std::log1p, unit, 4);
+  check_math<T>(nd::log1p, &std::log1p, small, 4);
+}
+
+TYPED_TEST_P(MathFunctions, SpecialValues) {
+  typedef TypeParam T;
+
+  // Arguments outside the domain of the polynomials fall back to the C library
+  T inf = std::numeric_limits<T>::infinity();
+  nd::array x{std::numeric_limits<T>::quiet_NaN(), inf, -inf, static_cast<T>(0), static_cast<T>(-1),
+              static_cast<T>(1.0e6), static_cast<T>(-800), std::numeric_limits<T>::denorm_min()};
+
+  check_math<T>(nd::sin, &std::sin, x, 4);
+  check_math<T>(nd::cos, &std::cos, x, 4);
+  check_math<T>(nd::exp, &std::exp, x, 4);
+  check_math<T>(nd::expm1, &std::expm1, x, 4);
+  check_math<T>(nd::tanh, &std::tanh, x, 4);
+  check_math<T>(nd::log, &std::log, x, 4);
+  check_math<T>(nd::log1p, &std::log1p, x, 4);
+}
+
+TYPED_TEST_P(MathFunctions, Strided) {
+  typedef TypeParam T;
+
+  nd::array x = make_math_args<T>(-5, 5, 2 * (2 * DYND_BUFFER_CHUNK_SIZE + 3));
+  nd::array a = x(irange().by(2));
+  nd::array y = nd::exp({a}, {{"ulp", 4}});
+  for (intptr_t i = 0; i < a.get_dim_size(); ++i) {
+    EXPECT_LE(ulp_error(std::exp(a(i).as<T>()), y(i).as<T>()), 4);
+  }
+}
+
+REGISTER_TYPED_TEST_CASE_P(MathFunctions, Precise, Fast, SpecialValues, Strided);
+INSTANTIATE_TYPED_TEST_CASE_P(Float, MathFunctions, MathFunctionTypes);
+
+TEST(Math, Pow) {
+  nd::array x{0.5f, 2.0f, 3.0f, -2.0f, 0.0f, 10.0f};
+  nd::array y{3.0f, 0.5f, -1.5f, 3.0f, 2.0f, 30.0f};
+  nd::array z = nd::pow(x, y);
+  EXPECT_EQ(ndt::type("6 * float32"), z.get_type());
+  for (intptr_t i = 0; i < x.get_dim_size(); ++i) {
+    EXPECT_LE(ulp_error(std::pow(x(i).as<float>(), y(i).as<float>()), z(i).as<float>()), 1);
+  }
+
+  nd::array a{0.5, 2.0, -2.0};
+  nd::array b{3.0, 0.5, 3.0};
+  EXPECT_ARRAY_EQ((nd::array{0.125, std::pow(2.0, 0.5), -8.0}), nd::pow(a, b));
+}
+
+TEST(Math, Sqrt) {
+  nd::array x{4.0f, 2.0f, 0.0f, -1.0f};
+  nd::array y = nd::sqrt(x);
+  EXPECT_EQ(ndt::type("4 * float32"), y.get_type());
+  EXPECT_EQ(2.0f, y(0).as<float>());
+  EXPECT_EQ(std::sqrt(2.0f), y(1).as<float>());
+  EXPECT_EQ(0.0f, y(2).as<float>());
+  EXPECT_TRUE(std::isnan(y(3).as<float>()));
+}
@@ -8,8 +8,12 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <dynd/comparison.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/kernels/philox.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/random.hpp>
+#include <dynd/sort.hpp>
 
 typedef testing::Types<int32_t, int64_t, uint32_t, uint64_t> IntegralTypes;
 typedef testing::Types<float, double> RealTypes;
@@ -45,3 +49,198 @@ TYPED_TEST_P(Random, Uniform) {
 REGISTER_TYPED_TEST_CASE_P(Random, Uniform);
 INSTANTIATE_TYPED_TEST_CASE_P(Integral, Random, IntegralTypes);
 INSTANTIATE_TYPED_TEST_CASE_P(Real, Random, RealTypes);
+
+TEST(Philox, KnownAnswer) {
+  // Known-answer values from the Random123 distribution
+  uint32_t res[4];
+
+  dynd::random::philox4x32(0).generate(0, 0, 0, 1, res);
+  EXPECT_EQ(0x6627e8d5u, res[0]);
+  EXPECT_EQ(0xe169c58du, res[1]);
+  EXPECT_EQ(0xbc57ac4cu, res[2]);
+  EXPECT_EQ(0x9b00dbd8u, res[3]);
+
+  dynd::random::philox4x32(0xFFFFFFFFFFFFFFFFULL).generate(0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFF, 0xFFFFFFFF, 1, res);
+  EXPECT_EQ(0x408f276du, res[0]);
+  EXPECT_EQ(0x41c83b0eu, res[1]);
+  EXPECT_EQ(0xa20bc7c6u, res[2]);
+  EXPECT_EQ(0x6d5451fdu, res[3]);
+}
+
+TEST(Philox, GenerateWords) {
+  dynd::random::philox4x32 g(17);
+
+  uint32_t blocks[40];
+  g.generate(3, 1, 0, 10, blocks);
+
+  uint32_t words[37];
+  g.generate_words(13, 1, 0, 37, words);
+  for (int i = 0; i < 37; ++i) {
+    EXPECT_EQ(blocks[i + 1], words[i]);
+  }
+}
+
+TEST(Random, UniformSeed) {
+  ndt::type dst_tp = ndt::make_fixed_dim(1000, ndt::make_type<double>());
+
+  nd::array a = nd::random::uniform({}, {{"seed", 42}, {"dst_tp", dst_tp}});
+  nd::array b = nd::random::uniform({}, {{"seed", 42}, {"dst_tp", dst_tp}});
+  nd::array c = nd::random::uniform({}, {{"seed", 42}, {"stream", 1}, {"dst_tp", dst_tp}});
+  nd::array d = nd::random::uniform({}, {{"seed", 43}, {"dst_tp", dst_tp}});
+  EXPECT_ARRAY_EQ(a, b);
+
+  intptr_t c_equal = 0, d_equal = 0;
+  for (intptr_t i = 0; i < 1000; ++i) {
+    c_equal += a(i).as<double>() == c(i).as<double>();
+    d_equal += a(i).as<double>() == d(i).as<double>();
+  }
+  EXPECT_EQ(0, c_equal);
+  EXPECT_EQ(0, d_equal);
+
+  EXPECT_THROW(nd::random::uniform({}, {{"stream", -1}, {"dst_tp", dst_tp}}), invalid_argument);
+}
+
+TEST(Random, UniformThreads) {
+  ndt::type dst_tp = ndt::make_fixed_dim(1000000, ndt::make_type<int64_t>());
+
+  set_num_threads(1);
+  nd::array a = nd::random::uniform({}, {{"a", int64_t(-5)}, {"b", int64_t(5)}, {"seed", 7}, {"dst_tp", dst_tp}});
+  set_num_threads(4);
+  nd::array b = nd::random::uniform({}, {{"a", int64_t(-5)}, {"b", int64_t(5)}, {"seed", 7}, {"dst_tp", dst_tp}});
+  set_num_threads(0);
+  EXPECT_ARRAY_EQ(a, b);
+
+  const int64_t *data = reinterpret_cast<const int64_t *>(a.cdata());
+  int64_t counts[11] = {0};
+  for (intptr_t i = 0; i < 1000000; ++i) {
+    ASSERT_LE(-5, data[i]);
+    ASSERT_GE(5, data[i]);
+    ++counts[data[i] + 5];
+  }
+  for (int64_t count : counts) {
+    EXPECT_NEAR(1000000 / 11, count, 1000);
+  }
+}
+
+TEST(Random, UniformFullRange) {
+  ndt::type dst_tp = ndt::make_fixed_dim(10000, ndt::make_type<uint32_t>());
+
+  nd::array res = nd::random::uniform(
+      {}, {{"a", 0u}, {"b", numeric_limits<uint32_t>::max()}, {"seed", 3}, {"dst_tp", dst_tp}});
+  const uint32_t *data = reinterpret_cast<const uint32_t *>(res.cdata());
+  EXPECT_TRUE(any_of(data, data + 10000, [](uint32_t x) { return x > 0xF0000000u; }));
+
+  EXPECT_THROW(nd::random::uniform({}, {{"a", 5}, {"b", 4}, {"dst_tp", ndt::make_type<int32_t>()}}),
+               invalid_argument);
+}
+
+TEST(Random, Normal) {
+  intptr_t size = 100001;
+  ndt::type dst_tp = ndt::make_fixed_dim(size, ndt::make_type<double>());
+
+  nd::array res = nd::random::normal({}, {{"loc", 3.0}, {"scale", 2.0}, {"seed", 5}, {"dst_tp", dst_tp}});
+  const double *data = reinterpret_cast<const double *>(res.cdata());
+  double mean = 0, var = 0;
+  for (intptr_t i = 0; i < size; ++i) {
+    mean += data[i];
+  }
+  mean /= size;
+  for (intptr_t i = 0; i < size; ++i) {
+    var += (data[i] - mean) * (data[i] - mean);
+  }
+  var /= size;
+  EXPECT_NEAR(3.0, mean, 0.05);
+  EXPECT_NEAR(4.0, var, 0.1);
+
+  // Rows of odd length split the pairs of the transform, which must not change the values
+  nd::array rows = nd::random::normal(
+      {}, {{"loc", 3.0}, {"scale", 2.0}, {"seed", 5}, {"dst_tp", ndt::make_fixed_dim(33333, ndt::make_fixed_dim(3, ndt::make_type<double>()))}});
+  const double *rows_data = reinterpret_cast<const double *>(rows.cdata());
+  EXPECT_TRUE(equal(rows_data, rows_data + 99999, data));
+
+  EXPECT_THROW(nd::random::normal({}, {{"scale", -1.0}, {"dst_tp", dst_tp}}), invalid_argument);
+}
+
+TEST(Random, NormalStrided) {
+  nd::array a = nd::empty(1001, ndt::make_type<float>());
+  nd::random::normal({}, {{"seed", 9}, {"dst", a}});
+
+  nd::array b = nd::empty(2002, ndt::make_type<float>());
+  nd::random::normal({}, {{"seed", 9}, {"dst", b(irange().by(2))}});
+  EXPECT_ARRAY_EQ(a, b(irange().by(2)));
+}
+
+TEST(Random, Exponential) {
+  intptr_t size = 100000;
+  ndt::type dst_tp = ndt::make_fixed_dim(size, ndt::make_type<double>());
+
+  nd::array res = nd::random::exponential({}, {{"scale", 0.5}, {"seed", 11}, {"dst_tp", dst_tp}});
+  const double *data = reinterpret_cast<const double *>(res.cdata());
+  double mean = 0;
+  for (intptr_t i = 0; i < size; ++i) {
+    ASSERT_LE(0.0, data[i]);
+    mean += data[i];
+  }
+  EXPECT_NEAR(0.5, mean / size, 0.01);
+
+  EXPECT_THROW(nd::random::exponential({}, {{"scale", 0.0}, {"dst_tp", dst_tp}}), invalid_argument);
+}
+
+TEST(Random, Permutation) {
+  nd::array a = nd::random::permutation(1000, 1);
+  EXPECT_EQ(ndt::make_fixed_dim(1000, ndt::make_type<int64_t>()), a.get_type());
+  EXPECT_ARRAY_EQ(a, nd::random::permutation(1000, 1));
+  EXPECT_FALSE(nd::all_equal(a, nd::random::permutation(1000, 1, 1)).as<bool>());
+
+  nd::array sorted = a.eval_copy();
+  nd::sort(sorted);
+  const int64_t *data = reinterpret_cast<const int64_t *>(sorted.cdata());
+  for (int64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i, data[i]);
+  }
+
+  EXPECT_EQ(0, nd::random::permutation(0).get_dim_size());
+  EXPECT_EQ(0, nd::random::permutation(1)(0).as<int64_t>());
+}
+
+TEST(Random, PermutationUniform) {
+  // Each of the 6 orders of 3 elements should come up equally often
+  int counts[3][3] = {{0}};
+  for (uint64_t seed = 0; seed < 6000; ++seed) {
+    nd::array a = nd::random::permutation(3, seed);
+    for (intptr_t i = 0; i < 3; ++i) {
+      ++counts[i][a(i).as<int64_t>()];
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(2000, counts[i][j], 200);
+    }
+  }
+}
+
+TEST(Random, Shuffle) {
+  nd::array a = {"a", "b", "c", "d", "e", "f", "g"};
+  nd::random::shuffle({a}, {{"seed", 2}});
+  nd::array b = {"a", "b", "c", "d", "e", "f", "g"};
+  nd::random::shuffle({b}, {{"seed", 2}});
+  EXPECT_ARRAY_EQ(a, b);
+  nd::sort(b);
+  EXPECT_ARRAY_EQ((nd::array{"a", "b", "c", "d", "e", "f", "g"}), b);
+
+  // The rows of a matrix are moved whole
+  nd::array m = nd::empty(50, 3, ndt::make_type<int32_t>());
+  for (int i = 0; i < 50; ++i) {
+    m(i, 0).vals() = i;
+    m(i, 1).vals() = 10 * i;
+    m(i, 2).vals() = 100 * i;
+  }
+  nd::random::shuffle({m}, {{"seed", 3}});
+  for (int i = 0; i < 50; ++i) {
+    int32_t row = m(i, 0).as<int32_t>();
+    EXPECT_EQ(10 * row, m(i, 1).as<int32_t>());
+    EXPECT_EQ(100 * row, m(i, 2).as<int32_t>());
+  }
+
+  EXPECT_THROW(nd::random::shuffle(m(irange(), irange().by(2))), invalid_argument);
+}
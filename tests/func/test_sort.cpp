@@ -6,9 +6,12 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
 #include <dynd/gtest.hpp>
+#include <dynd/index.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/sort.hpp>
 
 using namespace std;
@@ -24,6 +27,121 @@ TEST(Sort, 1D) {
   EXPECT_ARRAY_EQ((nd::array{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19}), a);
 }
 
+TEST(Sort, Strided) {
+  nd::array a{5, 0, 4, 1, 3, 2, 2, 3, 1, 4, 0, 5};
+  nd::sort(a(irange().by(2)));
+  EXPECT_ARRAY_EQ((nd::array{0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5}), a);
+}
+
+TEST(Sort, Medium) {
+  // Below the radix sort threshold, with runs and duplicates
+  nd::array a = nd::empty(200, ndt::make_type<int32_t>());
+  for (int i = 0; i < 200; ++i) {
+    a(i).vals() = (i < 100) ? 100 - i : i % 17;
+  }
+  nd::sort(a);
+  for (int i = 1; i < 200; ++i) {
+    EXPECT_LE(a(i - 1).as<int32_t>(), a(i).as<int32_t>());
+  }
+}
+
+TEST(Sort, NaN) {
+  double nan = numeric_limits<double>::quiet_NaN();
+  nd::array a{3.0, nan, -1.0, -numeric_limits<double>::infinity(), 0.5, nan, -0.25};
+  nd::sort(a);
+  EXPECT_EQ(-numeric_limits<double>::infinity(), a(0).as<double>());
+  EXPECT_EQ(-1.0, a(1).as<double>());
+  EXPECT_EQ(-0.25, a(2).as<double>());
+  EXPECT_EQ(0.5, a(3).as<double>());
+  EXPECT_EQ(3.0, a(4).as<double>());
+  EXPECT_TRUE(std::isnan(a(5).as<double>()));
+  EXPECT_TRUE(std::isnan(a(6).as<double>()));
+}
+
+template <typename T>
+class SortRadix : public ::testing::Test {};
+
+TYPED_TEST_CASE_P(SortRadix);
+
+TYPED_TEST_P(SortRadix, Large) {
+  // Large enough to take the radix sort path
+  size_t size = 5000;
+  std::vector<TypeParam> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = static_cast<TypeParam>((i * 7919) % 251) - static_cast<TypeParam>(100);
+  }
+
+  nd::array a = nd::empty(size, ndt::make_type<TypeParam>());
+  for (size_t i = 0; i < size; ++i) {
+    a(i).vals() = values[i];
+  }
+  nd::array index = nd::argsort(a);
+  nd::sort(a);
+
+  std::vector<TypeParam> expected(values);
+  std::stable_sort(expected.begin(), expected.end());
+  for (size_t i = 0; i < size; ++i) {
+    EXPECT_EQ(expected[i], a(i).as<TypeParam>());
+    EXPECT_EQ(expected[i], values[index(i).as<int64_t>()]);
+    if (i > 0 && expected[i - 1] == expected[i]) {
+      EXPECT_LT(index(i - 1).as<int64_t>(), index(i).as<int64_t>());
+    }
+  }
+}
+
+REGISTER_TYPED_TEST_CASE_P(SortRadix, Large);
+
+typedef ::testing::Types<int8_t, int16_t, int32_t, int64_t, uint16_t, uint64_t, float, double> radix_sort_types;
+INSTANTIATE_TYPED_TEST_CASE_P(Builtin, SortRadix, radix_sort_types);
+
+TEST(Sort, Rows) {
+  nd::array a{{3, 1, 2}, {9, 8, 7}, {4, 6, 5}};
+  nd::sort(a);
+  EXPECT_ARRAY_EQ((nd::array{{1, 2, 3}, {7, 8, 9}, {4, 5, 6}}), a);
+
+  nd::array b{{"c", "a", "b"}, {"y", "z", "x"}};
+  nd::stable_sort(b);
+  EXPECT_ARRAY_EQ((nd::array{{"a", "b", "c"}, {"x", "y", "z"}}), b);
+
+  EXPECT_ARRAY_EQ((nd::array{{int64_t(1), int64_t(2), int64_t(0)}, {int64_t(2), int64_t(1), int64_t(0)}}),
+                  nd::argsort(nd::array{{3.0, 1.0, 2.0}, {9.0, 8.0, 7.0}}));
+
+  EXPECT_THROW(nd::sort(nd::empty(2, 2, 2, ndt::make_type<int>())), invalid_argument);
+}
+
+TEST(Sort, Parallel) {
+  size_t nthread = get_num_threads();
+  set_num_threads(4);
+
+  // Long enough to be split into runs that are merged; lots of ties exercise the stable merge
+  size_t size = 200003;
+  nd::array a = nd::empty(size, ndt::make_type<double>());
+  double *data = reinterpret_cast<double *>(a.data());
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<double>((i * 2654435761u) % 1009) - 500.0;
+  }
+  std::vector<double> values(data, data + size);
+
+  nd::array index = nd::argsort(a);
+  nd::sort(a);
+  set_num_threads(nthread);
+
+  const int64_t *index_data = reinterpret_cast<const int64_t *>(index.cdata());
+  for (size_t i = 1; i < size; ++i) {
+    ASSERT_LE(data[i - 1], data[i]);
+    ASSERT_EQ(data[i], values[index_data[i]]);
+    if (data[i - 1] == data[i]) {
+      ASSERT_LT(index_data[i - 1], index_data[i]);
+    }
+  }
+}
+
+TEST(Argsort, 1D) {
+  EXPECT_ARRAY_EQ((nd::array{int64_t(2), int64_t(0), int64_t(3), int64_t(1)}),
+                  nd::argsort(nd::array{3.5, 5.0, -1.0, 3.5}));
+  EXPECT_ARRAY_EQ((nd::array{int64_t(1), int64_t(2), int64_t(0)}), nd::argsort(nd::array{"c", "a", "b"}));
+}
+
 /*
 TEST(Unique, 1D)
 {
@@ -5,11 +5,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 #include <dynd/gtest.hpp>
 #include <dynd/index.hpp>
+#include <dynd/parallel.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -34,14 +37,12 @@ TEST(Callable, Take) {
   intptr_t bvals2[4] = {3, 0, -1, 4};
   b = bvals2;
   c = nd::take(a, b);
-  /*
-    EXPECT_EQ(ndt::type("4 * int"), c.get_type());
-    ASSERT_EQ(4, c.get_dim_size());
-    EXPECT_EQ(4, c(0).as<int>());
-    EXPECT_EQ(1, c(1).as<int>());
-    EXPECT_EQ(5, c(2).as<int>());
-    EXPECT_EQ(5, c(3).as<int>());
-  */
+  EXPECT_EQ(ndt::type("4 * int"), c.get_type());
+  ASSERT_EQ(4, c.get_dim_size());
+  EXPECT_EQ(4, c(0).as<int>());
+  EXPECT_EQ(1, c(1).as<int>());
+  EXPECT_EQ(5, c(2).as<int>());
+  EXPECT_EQ(5, c(3).as<int>());
 }
 
 TEST(Callable, TakeOfArray) {
@@ -62,21 +63,253 @@ TEST(Callable, TakeOfArray) {
   EXPECT_EQ(4, c(1, 0).as<int>());
   EXPECT_EQ(5, c(1, 1).as<int>());
 
-  /*
-    // Indexed take
-    intptr_t bvals2[4] = {1, 0, -1, -2};
-    b = bvals2;
-    c = nd::take(a, b);
-    EXPECT_EQ(ndt::type("4 * 2 * int"), c.get_type());
-    ASSERT_EQ(4, c.get_dim_size());
-    ASSERT_EQ(2, c.get_shape()[1]);
-    EXPECT_EQ(2, c(0, 0).as<int>());
-    EXPECT_EQ(3, c(0, 1).as<int>());
-    EXPECT_EQ(0, c(1, 0).as<int>());
-    EXPECT_EQ(1, c(1, 1).as<int>());
-    EXPECT_EQ(4, c(2, 0).as<int>());
-    EXPECT_EQ(5, c(2, 1).as<int>());
-    EXPECT_EQ(2, c(3, 0).as<int>());
-    EXPECT_EQ(3, c(3, 1).as<int>());
-  */
+  // Indexed take
+  intptr_t bvals2[4] = {1, 0, -1, -2};
+  b = bvals2;
+  c = nd::take(a, b);
+  EXPECT_EQ(ndt::type("4 * 2 * int"), c.get_type());
+  ASSERT_EQ(4, c.get_dim_size());
+  ASSERT_EQ(2, c.get_shape()[1]);
+  EXPECT_EQ(2, c(0, 0).as<int>());
+  EXPECT_EQ(3, c(0, 1).as<int>());
+  EXPECT_EQ(0, c(1, 0).as<int>());
+  EXPECT_EQ(1, c(1, 1).as<int>());
+  EXPECT_EQ(4, c(2, 0).as<int>());
+  EXPECT_EQ(5, c(2, 1).as<int>());
+  EXPECT_EQ(2, c(3, 0).as<int>());
+  EXPECT_EQ(3, c(3, 1).as<int>());
+}
+
+TEST(Callable, MaskedTakeCompress) {
+  // Runs of every length, including whole blocks of eight true and false values
+  intptr_t size = 1000;
+  nd::array a = nd::empty(size, ndt::make_type<int16_t>());
+  nd::array b = nd::empty(size, ndt::make_type<dynd::complex<double>>());
+  nd::array m = nd::empty(size, ndt::make_type<bool1>());
+  std::vector<intptr_t> expected;
+  for (intptr_t i = 0; i < size; ++i) {
+    a(i).vals() = static_cast<int16_t>(i);
+    b(i).vals() = dynd::complex<double>(static_cast<double>(i), -1.0);
+    bool value = (i < 100) ? (i % 3 == 0) : (i < 200) ? ((i / 16) % 2 == 0) : ((i * 7) % 5 < 2);
+    m(i).vals() = value;
+    if (value) {
+      expected.push_back(i);
+    }
+  }
+
+  nd::array c = nd::take(a, m);
+  ASSERT_EQ(static_cast<intptr_t>(expected.size()), c.get_dim_size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], c(i).as<int16_t>());
+  }
+  nd::array d = nd::take(b, m);
+  ASSERT_EQ(static_cast<intptr_t>(expected.size()), d.get_dim_size());
+  EXPECT_EQ(dynd::complex<double>(static_cast<double>(expected.back()), -1.0),
+            d(expected.size() - 1).as<dynd::complex<double>>());
+
+  // Strided data and mask
+  nd::array e = nd::take(a(irange().by(2)), m(irange().by(2)));
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < size; i += 2) {
+    if (m(i).as<bool>()) {
+      ASSERT_EQ(i, e(count++).as<int16_t>());
+    }
+  }
+  EXPECT_EQ(count, e.get_dim_size());
+
+  // Strings are taken by the child
+  nd::array s = nd::take(nd::array{"a", "b", "c"}, nd::array{true, false, true});
+  EXPECT_EQ(ndt::type("var * string"), s.get_type());
+  EXPECT_EQ("c", s(1).as<std::string>());
+}
+
+TEST(Callable, MaskedTakeParallel) {
+  size_t nthread = get_num_threads();
+  set_num_threads(4);
+
+  intptr_t size = 300007;
+  nd::array a = nd::empty(size, ndt::make_type<int64_t>());
+  nd::array m = nd::empty(size, ndt::make_type<bool1>());
+  int64_t *a_data = reinterpret_cast<int64_t *>(a.data());
+  bool1 *m_data = reinterpret_cast<bool1 *>(m.data());
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < size; ++i) {
+    a_data[i] = i;
+    m_data[i] = bool1((i * 2654435761u) % 7 < 3);
+    count += m_data[i];
+  }
+
+  nd::array c = nd::take(a, m);
+  set_num_threads(nthread);
+
+  ASSERT_EQ(count, c.get_dim_size());
+  const int64_t *c_data = reinterpret_cast<const int64_t *>(c(0).cdata());
+  for (intptr_t i = 0, j = 0; i < size; ++i) {
+    if (m_data[i]) {
+      ASSERT_EQ(i, c_data[j++]);
+    }
+  }
+}
+
+TEST(Callable, IndexedTakeGather) {
+  intptr_t size = 1000;
+  nd::array a = nd::empty(size, ndt::make_type<double>());
+  nd::array b = nd::empty(size, ndt::make_type<int8_t>());
+  for (intptr_t i = 0; i < size; ++i) {
+    a(i).vals() = 0.5 * i;
+    b(i).vals() = static_cast<int8_t>(i % 100);
+  }
+
+  // Scattered indices, negative ones among them, more of them than the prefetch distance
+  nd::array index = nd::empty(500, ndt::make_type<intptr_t>());
+  for (intptr_t i = 0; i < 500; ++i) {
+    intptr_t ix = static_cast<intptr_t>((i * 2654435761u) % size);
+    index(i).vals() = (i % 3 == 0) ? ix - size : ix;
+  }
+
+  nd::array c = nd::take(a, index);
+  nd::array d = nd::take(b, index);
+  EXPECT_EQ(ndt::type("500 * float64"), c.get_type());
+  for (intptr_t i = 0; i < 500; ++i) {
+    intptr_t ix = index(i).as<intptr_t>();
+    ix += (ix < 0) ? size : 0;
+    ASSERT_EQ(0.5 * ix, c(i).as<double>());
+    ASSERT_EQ(ix % 100, d(i).as<int8_t>());
+  }
+
+  // Strided data and indices
+  nd::array strided_index = nd::array{intptr_t(7), intptr_t(3), intptr_t(-1), intptr_t(0)}(irange().by(2));
+  nd::array e = nd::take(a(irange().by(2)), strided_index);
+  EXPECT_EQ(ndt::type("2 * float64"), e.get_type());
+  EXPECT_EQ(7.0, e(0).as<double>());
+  EXPECT_EQ(499.0, e(1).as<double>());
+
+  // Out of bounds indices are caught before anything is copied
+  index(400).vals() = size;
+  EXPECT_THROW(nd::take(a, index), index_out_of_bounds);
+  index(400).vals() = -size - 1;
+  EXPECT_THROW(nd::take(a, index), index_out_of_bounds);
+}
+
+TEST(Callable, IndexedTakeParallel) {
+  size_t nthread = get_num_threads();
+  set_num_threads(4);
+
+  intptr_t size = 100003, count = 300007;
+  nd::array a = nd::empty(size, ndt::make_type<int32_t>());
+  int32_t *a_data = reinterpret_cast<int32_t *>(a.data());
+  for (intptr_t i = 0; i < size; ++i) {
+    a_data[i] = static_cast<int32_t>(3 * i);
+  }
+  nd::array index = nd::empty(count, ndt::make_type<intptr_t>());
+  intptr_t *index_data = reinterpret_cast<intptr_t *>(index.data());
+  for (intptr_t i = 0; i < count; ++i) {
+    index_data[i] = static_cast<intptr_t>((i * 2654435761u) % size);
+  }
+
+  nd::array c = nd::take(a, index);
+  set_num_threads(nthread);
+
+  const int32_t *c_data = reinterpret_cast<const int32_t *>(c.cdata());
+  for (intptr_t i = 0; i < count; ++i) {
+    ASSERT_EQ(3 * index_data[i], c_data[i]);
+  }
+}
+
+TEST(Callable, Put) {
+  nd::array a = {1, 2, 3, 4, 5};
+
+  intptr_t ivals[3] = {0, -1, 2};
+  nd::put({nd::array(ivals), nd::array{10, 20, 30}}, {{"dst", a}});
+  EXPECT_ARRAY_EQ((nd::array{10, 2, 30, 4, 20}), a);
+
+  // The last value for an index repeated is kept, and a single value is assigned at every index
+  intptr_t repeated[3] = {1, 3, 1};
+  nd::put({nd::array(repeated), nd::array{7, 8, 9}}, {{"dst", a}});
+  EXPECT_ARRAY_EQ((nd::array{10, 9, 30, 8, 20}), a);
+  nd::put({nd::array(ivals), nd::array(0)}, {{"dst", a}});
+  EXPECT_ARRAY_EQ((nd::array{0, 9, 0, 8, 0}), a);
+
+  // Values of another type are converted, and a strided array is written in place
+  nd::array b = nd::empty(ndt::type("6 * float64"));
+  b.assign(0.0);
+  intptr_t strided_ivals[2] = {2, 0};
+  nd::put({nd::array(strided_ivals), nd::array{1, 2}}, {{"dst", b(irange().by(2))}});
+  EXPECT_ARRAY_EQ((nd::array{2.0, 0.0, 0.0, 0.0, 1.0, 0.0}), b);
+
+  // Nothing is assigned when an index is out of bounds
+  intptr_t bad_ivals[2] = {1, 5};
+  EXPECT_THROW(nd::put({nd::array(bad_ivals), nd::array{1, 2}}, {{"dst", a}}), index_out_of_bounds);
+  EXPECT_ARRAY_EQ((nd::array{0, 9, 0, 8, 0}), a);
+  EXPECT_THROW(nd::put({nd::array(ivals), nd::array{1, 2}}, {{"dst", a}}), invalid_argument);
+
+  // The array assigned into is passed as dst, and must be writable
+  nd::array c = nd::array{1, 2, 3}.eval_copy(nd::read_access_flag | nd::immutable_access_flag);
+  EXPECT_THROW(nd::put({nd::array(ivals), nd::array(99)}, {{"dst", c}}), invalid_argument);
+  EXPECT_ARRAY_EQ((nd::array{1, 2, 3}), c);
+  EXPECT_THROW(nd::put(nd::array(ivals), nd::array(99)), invalid_argument);
+}
+
+TEST(Callable, Scatter) {
+  nd::array counts = nd::empty(ndt::type("4 * int64"));
+  counts.assign(0);
+  intptr_t ivals[6] = {0, 3, 3, -1, 1, 3};
+  nd::scatter_add({nd::array(ivals), nd::array(int64_t(1))}, {{"dst", counts}});
+  EXPECT_ARRAY_EQ((nd::array{int64_t(1), int64_t(1), int64_t(0), int64_t(4)}), counts);
+
+  nd::array sums = {0.5, 0.0};
+  intptr_t sum_ivals[3] = {1, 0, 1};
+  nd::scatter_add({nd::array(sum_ivals), nd::array{1.0, 2.0, 3.0}}, {{"dst", sums}});
+  EXPECT_ARRAY_EQ((nd::array{2.5, 4.0}), sums);
+
+  nd::array maxima = {5, -3, 0};
+  intptr_t max_ivals[4] = {0, 1, 1, 2};
+  nd::scatter_max({nd::array(max_ivals), nd::array{2, -7, -4, 6}}, {{"dst", maxima}});
+  EXPECT_ARRAY_EQ((nd::array{5, -3, 6}), maxima);
+
+  EXPECT_THROW(nd::scatter_add({nd::array(ivals), nd::array(1.0)}, {{"dst", counts}}), type_error);
+  intptr_t bad_ivals[1] = {4};
+  EXPECT_THROW(nd::scatter_max({nd::array(bad_ivals), nd::array(1)}, {{"dst", maxima}}), index_out_of_bounds);
+
+  // The array accumulated into is passed as dst, and must be writable
+  nd::array frozen = counts.eval_copy(nd::read_access_flag | nd::immutable_access_flag);
+  EXPECT_THROW(nd::scatter_add({nd::array(ivals), nd::array(int64_t(1))}, {{"dst", frozen}}), invalid_argument);
+  EXPECT_ARRAY_EQ((nd::array{int64_t(1), int64_t(1), int64_t(0), int64_t(4)}), frozen);
+  EXPECT_THROW(nd::scatter_add(nd::array(ivals), nd::array(int64_t(1))), invalid_argument);
+}
+
+TEST(Callable, ScatterParallel) {
+  size_t num_threads = get_num_threads();
+  set_num_threads(4);
+
+  // A histogram of many indices into few bins is split across threads
+  intptr_t n = 300000, nbin = 100;
+  vector<intptr_t> ivals(n);
+  vector<double> vals(n);
+  vector<int64_t> expected_counts(nbin, 0);
+  vector<double> expected_maxima(nbin, -1.0);
+  for (intptr_t i = 0; i < n; ++i) {
+    ivals[i] = (i * 7919) % nbin;
+    vals[i] = static_cast<double>(i % 1000);
+    ++expected_counts[ivals[i]];
+    expected_maxima[ivals[i]] = max(expected_maxima[ivals[i]], vals[i]);
+  }
+
+  nd::array index = nd::empty(n, ndt::make_type<intptr_t>());
+  memcpy(index.data(), ivals.data(), n * sizeof(intptr_t));
+  nd::array values = nd::empty(n, ndt::make_type<double>());
+  memcpy(values.data(), vals.data(), n * sizeof(double));
+
+  nd::array counts = nd::empty(nbin, ndt::make_type<int64_t>());
+  counts.assign(0);
+  nd::scatter_add({index, nd::array(int64_t(1))}, {{"dst", counts}});
+  nd::array maxima = nd::empty(nbin, ndt::make_type<double>());
+  maxima.assign(-1.0);
+  nd::scatter_max({index, values}, {{"dst", maxima}});
+  for (intptr_t j = 0; j < nbin; ++j) {
+    EXPECT_EQ(expected_counts[j], counts(j).as<int64_t>());
+    EXPECT_EQ(expected_maxima[j], maxima(j).as<double>());
+  }
+
+  set_num_threads(num_threads);
 }
@@ -0,0 +1,285 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <dynd/arrow.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+namespace {
+
+int release_count = 0;
+
+void release_test_array(ArrowArray *array) {
+  ++release_count;
+  array->release = NULL;
+}
+
+// An Arrow array whose buffers and children belong to the test
+struct test_array {
+  vector<const void *> buffers;
+  vector<ArrowArray *> children;
+  ArrowArray array;
+
+  test_array(int64_t length, const vector<const void *> &buffers, const vector<ArrowArray *> &children = {},
+             int64_t offset = 0, int64_t null_count = 0)
+      : buffers(buffers), children(children) {
+    array.length = length;
+    array.null_count = null_count;
+    array.offset = offset;
+    array.n_buffers = this->buffers.size();
+    array.n_children = this->children.size();
+    array.buffers = this->buffers.data();
+    array.children = this->children.data();
+    array.dictionary = NULL;
+    array.release = &release_test_array;
+    array.private_data = NULL;
+  }
+};
+
+struct test_schema {
+  vector<ArrowSchema *> children;
+  ArrowSchema schema;
+
+  test_schema(const char *format, const char *name = NULL, const vector<ArrowSchema *> &children = {})
+      : children(children) {
+    schema.format = format;
+    schema.name = name;
+    schema.metadata = NULL;
+    schema.flags = 0;
+    schema.n_children = this->children.size();
+    schema.children = this->children.data();
+    schema.dictionary = NULL;
+    schema.release = NULL;
+    schema.private_data = NULL;
+  }
+};
+
+// Exports an array and imports it back
+nd::array round_trip(const nd::array &a) {
+  ArrowSchema schema;
+  ArrowArray array;
+  nd::to_arrow(a, &schema, &array);
+  nd::array res = nd::from_arrow(&schema, &array);
+  schema.release(&schema);
+  return res;
+}
+
+} // unnamed namespace
+
+TEST(Arrow, ImportPrimitive) {
+  int32_t values[] = {1, 2, 3, 4, 5};
+  test_array array(3, {NULL, values}, {}, 1);
+  test_schema schema("i");
+
+  release_count = 0;
+  {
+    nd::array a = nd::from_arrow(&schema.schema, &array.array);
+    EXPECT_EQ(NULL, array.array.release);
+    EXPECT_EQ(ndt::type("3 * int32"), a.get_type());
+    EXPECT_ARRAY_EQ((nd::array{2, 3, 4}), a);
+
+    // The values are used in place
+    EXPECT_EQ(reinterpret_cast<const char *>(values + 1), a.cdata());
+    EXPECT_EQ(0, release_count);
+  }
+  EXPECT_EQ(1, release_count);
+}
+
+TEST(Arrow, ImportNulls) {
+  double values[] = {0.5, 1.5, 2.5, 3.5};
+  uint8_t validity[] = {0x0D};
+  test_array array(4, {validity, values}, {}, 0, 1);
+  test_schema schema("g");
+  nd::array a = nd::from_arrow(&schema.schema, &array.array);
+  EXPECT_EQ(ndt::type("4 * ?float64"), a.get_type());
+  EXPECT_EQ(0.5, a(0).as<double>());
+  EXPECT_TRUE(a(1).is_na());
+  EXPECT_EQ(3.5, a(3).as<double>());
+
+  // A range of the array without nulls is used in place
+  test_array slice(2, {validity, values}, {}, 2, 1);
+  nd::array b = nd::from_arrow(&schema.schema, &slice.array);
+  EXPECT_EQ(ndt::type("2 * float64"), b.get_type());
+  EXPECT_EQ(reinterpret_cast<const char *>(values + 2), b.cdata());
+
+  // A valid value that is the sentinel of the option type is not turned into a null
+  uint8_t bytes[] = {1, 255, 3};
+  uint8_t bytes_validity[] = {0x03};
+  test_array sentinel(3, {bytes_validity, bytes}, {}, 0, 1);
+  test_schema bytes_schema("C");
+  EXPECT_THROW(nd::from_arrow(&bytes_schema.schema, &sentinel.array), type_error);
+
+  // The same value under a null is fine
+  bytes_validity[0] = 0x05;
+  test_array sentinel_null(3, {bytes_validity, bytes}, {}, 0, 1);
+  nd::array c = nd::from_arrow(&bytes_schema.schema, &sentinel_null.array);
+  EXPECT_TRUE(c(1).is_na());
+  EXPECT_EQ(3, *reinterpret_cast<const uint8_t *>(c(2).cdata()));
+}
+
+TEST(Arrow, ImportBoolAndStrings) {
+  uint8_t bits[] = {0x05};
+  test_array bools(3, {NULL, bits});
+  test_schema bool_schema("b");
+  EXPECT_ARRAY_EQ((nd::array{true, false, true}), nd::from_arrow(&bool_schema.schema, &bools.array));
+
+  int32_t offsets[] = {0, 5, 5, 10};
+  test_array strings(3, {NULL, offsets, "helloworld"});
+  test_schema string_schema("u");
+  nd::array a = nd::from_arrow(&string_schema.schema, &strings.array);
+  EXPECT_EQ(ndt::type("3 * string"), a.get_type());
+  EXPECT_EQ("hello", a(0).as<std::string>());
+  EXPECT_EQ("", a(1).as<std::string>());
+  EXPECT_EQ("world", a(2).as<std::string>());
+
+  // Strings have no missing value
+  uint8_t validity[] = {0x05};
+  test_array nullable_strings(3, {validity, offsets, "helloworld"}, {}, 0, 1);
+  EXPECT_THROW(nd::from_arrow(&string_schema.schema, &nullable_strings.array), type_error);
+}
+
+TEST(Arrow, ImportLists) {
+  float values[] = {0, 1, 2, 3, 4, 5, 6, 7};
+  test_array items(8, {NULL, values});
+  test_schema item_schema("f");
+
+  // A fixed-size list is a view of its values
+  test_array fixed(3, {NULL}, {&items.array}, 1);
+  test_schema fixed_schema("+w:2", NULL, {&item_schema.schema});
+  nd::array a = nd::from_arrow(&fixed_schema.schema, &fixed.array);
+  EXPECT_EQ(ndt::type("3 * 2 * float32"), a.get_type());
+  EXPECT_ARRAY_EQ((nd::array{{2.0f, 3.0f}, {4.0f, 5.0f}, {6.0f, 7.0f}}), a);
+  EXPECT_EQ(reinterpret_cast<const char *>(values + 2), a.cdata());
+
+  // So are the elements of a list
+  int32_t offsets[] = {1, 4, 4, 6};
+  test_array list(3, {NULL, offsets}, {&items.array});
+  test_schema list_schema("+l", NULL, {&item_schema.schema});
+  nd::array b = nd::from_arrow(&list_schema.schema, &list.array);
+  EXPECT_EQ(ndt::type("3 * var * float32"), b.get_type());
+  ASSERT_EQ(3, b(0).get_dim_size());
+  EXPECT_EQ(3.0f, b(0, 2).as<float>());
+  EXPECT_EQ(0, b(1).get_dim_size());
+  ASSERT_EQ(2, b(2).get_dim_size());
+  EXPECT_EQ(5.0f, b(2, 1).as<float>());
+  EXPECT_EQ(reinterpret_cast<const char *>(values + 4), b(2, 0).cdata());
+}
+
+TEST(Arrow, ImportStruct) {
+  int64_t ids[] = {10, 20, 30};
+  int32_t offsets[] = {0, 1, 3, 3};
+  int16_t values[] = {7, 8, 9};
+  int32_t name_offsets[] = {0, 1, 2, 3};
+  test_array id_array(3, {NULL, ids});
+  test_array value_array(3, {NULL, values});
+  test_array list_array(3, {NULL, offsets}, {&value_array.array});
+  test_array name_array(3, {NULL, name_offsets, "abc"});
+  test_array array(3, {NULL}, {&id_array.array, &list_array.array, &name_array.array});
+
+  test_schema id_schema("l", "id");
+  test_schema value_schema("s", "item");
+  test_schema list_schema("+l", "values", {&value_schema.schema});
+  test_schema name_schema("u", "name");
+  test_schema schema("+s", NULL, {&id_schema.schema, &list_schema.schema, &name_schema.schema});
+
+  // A struct is a struct of columns
+  nd::array a = nd::from_arrow(&schema.schema, &array.array);
+  EXPECT_EQ(ndt::type("{id: 3 * int64, values: 3 * var * int16, name: 3 * string}"), a.get_type());
+  EXPECT_EQ(reinterpret_cast<const char *>(ids), a.p("id").cdata());
+  EXPECT_ARRAY_EQ((nd::array{int64_t(10), int64_t(20), int64_t(30)}), a.p("id"));
+  ASSERT_EQ(2, a.p("values")(1).get_dim_size());
+  EXPECT_EQ(9, a.p("values")(1, 1).as<int16_t>());
+  EXPECT_EQ("c", a.p("name")(2).as<std::string>());
+
+  // A struct in a list is copied into rows
+  test_array struct_array(3, {NULL}, {&id_array.array, &name_array.array});
+  test_schema struct_schema("+s", "item", {&id_schema.schema, &name_schema.schema});
+  int32_t row_offsets[] = {0, 2, 3};
+  test_array rows(2, {NULL, row_offsets}, {&struct_array.array});
+  test_schema row_schema("+l", NULL, {&struct_schema.schema});
+  nd::array b = nd::from_arrow(&row_schema.schema, &rows.array);
+  EXPECT_EQ(ndt::type("2 * var * {id: int64, name: string}"), b.get_type());
+  EXPECT_EQ(20, b(0, 1).p("id").as<int64_t>());
+  EXPECT_EQ("c", b(1, 0).p("name").as<std::string>());
+}
+
+TEST(Arrow, Export) {
+  nd::array a = {1.5, 2.5, 3.5};
+  ArrowSchema schema;
+  ArrowArray array;
+  nd::to_arrow(a, &schema, &array);
+  EXPECT_STREQ("g", schema.format);
+  EXPECT_EQ(3, array.length);
+  EXPECT_EQ(2, array.n_buffers);
+  EXPECT_EQ(NULL, array.buffers[0]);
+
+  // The values are exported in place
+  EXPECT_EQ(a.cdata(), array.buffers[1]);
+  schema.release(&schema);
+  array.release(&array);
+  EXPECT_EQ(NULL, array.release);
+
+  // A strided view is copied
+  nd::array b = nd::array{0, 1, 2, 3, 4, 5}(irange().by(2));
+  nd::to_arrow(b, &schema, &array);
+  EXPECT_STREQ("i", schema.format);
+  EXPECT_EQ(2, reinterpret_cast<const int32_t *>(array.buffers[1])[1]);
+  schema.release(&schema);
+  array.release(&array);
+
+  // Missing values are in the validity bitmap
+  nd::array c = parse_json("4 * ?int32", "[1, null, 3, null]");
+  nd::to_arrow(c, &schema, &array);
+  EXPECT_EQ(ARROW_FLAG_NULLABLE, schema.flags);
+  EXPECT_EQ(2, array.null_count);
+  EXPECT_EQ(0x05, *reinterpret_cast<const uint8_t *>(array.buffers[0]));
+  schema.release(&schema);
+  array.release(&array);
+
+  EXPECT_THROW(nd::to_arrow(nd::array(1), &schema, &array), invalid_argument);
+  EXPECT_THROW(nd::to_arrow(nd::array{dynd::complex<double>(1, 1)}, &schema, &array), type_error);
+}
+
+TEST(Arrow, RoundTrip) {
+  nd::array a = parse_json("3 * string", "[\"a\", \"a longer string than fits inline\", \"\"]");
+  nd::array b = round_trip(a);
+  EXPECT_EQ(a.get_type(), b.get_type());
+  for (intptr_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(a(i).as<std::string>(), b(i).as<std::string>());
+  }
+
+  a = parse_json("4 * ?int16", "[1, null, 3, null]");
+  b = round_trip(a);
+  EXPECT_EQ(a.get_type(), b.get_type());
+  EXPECT_TRUE(b(3).is_na());
+  EXPECT_EQ(3, b(2).as<int16_t>());
+
+  a = parse_json("3 * var * 2 * int32", "[[[1, 2]], [], [[3, 4], [5, 6]]]");
+  b = round_trip(a);
+  EXPECT_EQ(a.get_type(), b.get_type());
+  for (intptr_t i = 0; i < 3; ++i) {
+    EXPECT_ARRAY_EQ(a(i), b(i));
+  }
+
+  a = parse_json("3 * {x: float32, flag: bool}", "[{\"x\": 1, \"flag\": true}, {\"x\": 2, \"flag\": false}, "
+                                                 "{\"x\": 3, \"flag\": true}]");
+  b = round_trip(a);
+  EXPECT_EQ(ndt::type("{x: 3 * float32, flag: 3 * bool}"), b.get_type());
+  EXPECT_ARRAY_EQ((nd::array{1.0f, 2.0f, 3.0f}), b.p("x"));
+  EXPECT_ARRAY_EQ((nd::array{true, false, true}), b.p("flag"));
+
+  // A struct of columns is exported in place
+  nd::array c = round_trip(b);
+  EXPECT_EQ(b.get_type(), c.get_type());
+  EXPECT_EQ(b.p("x").cdata(), c.p("x").cdata());
+}
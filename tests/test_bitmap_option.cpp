@@ -0,0 +1,158 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/bitmap_option.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+// The value of a bitmap option of one value, as the reductions return, which must be valid
+template <typename T>
+static T reduced(const nd::array &a) {
+  if ((a.p("valid")(0).as<uint64_t>() & 1) == 0) {
+    throw invalid_argument("the reduction is missing");
+  }
+  return a.p("values")(0).as<T>();
+}
+
+TEST(BitmapOption, Pack) {
+  nd::array a = nd::to_bitmap_option(parse_json("5 * ?int32", "[1, null, 3, null, 5]"));
+  EXPECT_EQ(ndt::type("{values: 5 * int32, valid: 1 * uint64}"), a.get_type());
+  EXPECT_ARRAY_EQ((nd::array{1, 0, 3, 0, 5}), a.p("values"));
+  EXPECT_EQ(0x15u, a.p("valid")(0).as<uint64_t>());
+
+  nd::array b = nd::from_bitmap_option(a);
+  EXPECT_EQ(ndt::type("5 * ?int32"), b.get_type());
+  EXPECT_EQ(3, b(2).as<int32_t>());
+  EXPECT_TRUE(b(1).is_na());
+  EXPECT_TRUE(b(3).is_na());
+
+  // Values without options are all valid, including the sentinel of the option
+  nd::array c = nd::to_bitmap_option(nd::array{numeric_limits<int32_t>::min(), 2});
+  EXPECT_EQ(2, nd::bitmap_option::count(c).as<int64_t>());
+
+  EXPECT_THROW(nd::to_bitmap_option(nd::array(1)), type_error);
+  EXPECT_THROW(nd::from_bitmap_option(nd::array{1, 2}), type_error);
+}
+
+TEST(BitmapOption, Arithmetic) {
+  nd::array a = nd::to_bitmap_option(parse_json("4 * ?int64", "[1, null, 3, 4]"));
+  nd::array b = nd::to_bitmap_option(parse_json("4 * ?int64", "[10, 20, null, 0]"));
+
+  nd::array c = nd::bitmap_option::add(a, b);
+  EXPECT_EQ(ndt::type("{values: 4 * int64, valid: 1 * uint64}"), c.get_type());
+  EXPECT_EQ(0x9u, c.p("valid")(0).as<uint64_t>());
+  EXPECT_EQ(11, c.p("values")(0).as<int64_t>());
+  EXPECT_EQ(4, c.p("values")(3).as<int64_t>());
+
+  // Integer division by zero is missing
+  nd::array d = nd::from_bitmap_option(nd::bitmap_option::divide(b, a));
+  EXPECT_EQ(10, d(0).as<int64_t>());
+  EXPECT_TRUE(d(1).is_na());
+  EXPECT_TRUE(d(2).is_na());
+  EXPECT_EQ(0, d(3).as<int64_t>());
+  d = nd::from_bitmap_option(nd::bitmap_option::divide(a, b));
+  EXPECT_TRUE(d(3).is_na());
+
+  // The lowest value divided by -1 wraps around instead of trapping
+  nd::array g = nd::bitmap_option::divide(nd::to_bitmap_option(nd::array{numeric_limits<int64_t>::min(), int64_t(7)}),
+                                          nd::to_bitmap_option(nd::array{int64_t(-1), int64_t(-1)}));
+  EXPECT_EQ(0x3u, g.p("valid")(0).as<uint64_t>());
+  EXPECT_EQ(numeric_limits<int64_t>::min(), g.p("values")(0).as<int64_t>());
+  EXPECT_EQ(-7, g.p("values")(1).as<int64_t>());
+
+  nd::array e = nd::to_bitmap_option(parse_json("2 * ?float64", "[1.5, null]"));
+  nd::array f = nd::to_bitmap_option(parse_json("2 * ?float64", "[0.5, 2]"));
+  EXPECT_EQ(0.75, nd::bitmap_option::multiply(e, f).p("values")(0).as<double>());
+  EXPECT_EQ(1.0, nd::bitmap_option::subtract(e, f).p("values")(0).as<double>());
+
+  // The arguments must have the same size and value type
+  EXPECT_THROW(nd::bitmap_option::add(a, nd::to_bitmap_option(parse_json("3 * ?int64", "[1, 2, 3]"))),
+               invalid_argument);
+  EXPECT_THROW(nd::bitmap_option::add(a, e), type_error);
+}
+
+TEST(BitmapOption, Reduce) {
+  nd::array a = nd::to_bitmap_option(parse_json("5 * ?float32", "[2, null, -1, 7, null]"));
+  EXPECT_EQ(8.0f, reduced<float>(nd::bitmap_option::sum(a)));
+  EXPECT_EQ(-1.0f, reduced<float>(nd::bitmap_option::min(a)));
+  EXPECT_EQ(7.0f, reduced<float>(nd::bitmap_option::max(a)));
+  EXPECT_EQ(3, nd::bitmap_option::count(a).as<int64_t>());
+
+  // With no valid value, the result is missing
+  nd::array b = nd::to_bitmap_option(parse_json("3 * ?uint32", "[null, null, null]"));
+  EXPECT_EQ(ndt::type("{values: 1 * uint32, valid: 1 * uint64}"), nd::bitmap_option::sum(b).get_type());
+  EXPECT_EQ(0u, nd::bitmap_option::sum(b).p("valid")(0).as<uint64_t>());
+  EXPECT_EQ(0u, nd::bitmap_option::max(b).p("valid")(0).as<uint64_t>());
+  EXPECT_EQ(0, nd::bitmap_option::count(b).as<int64_t>());
+
+  // A result equal to the sentinel of ``?T`` is still valid
+  nd::array c = nd::to_bitmap_option(nd::array{0xFFFFFFF0u, 0xFu});
+  EXPECT_EQ(0xFFFFFFFFu, reduced<uint32_t>(nd::bitmap_option::sum(c)));
+  EXPECT_EQ(0xFFFFFFF0u, reduced<uint32_t>(nd::bitmap_option::max(c)));
+}
+
+TEST(BitmapOption, Words) {
+  // 150 values span three words, the last one partly
+  nd::array values = nd::empty(150, ndt::make_type<ndt::option_type>(ndt::make_type<int32_t>()));
+  int64_t sum = 0, count = 0;
+  for (int32_t i = 0; i < 150; ++i) {
+    if (i % 3 == 0) {
+      values(i).assign_na();
+    } else {
+      values(i).assign(i);
+      sum += i;
+      ++count;
+    }
+  }
+
+  nd::array a = nd::to_bitmap_option(values);
+  EXPECT_EQ(ndt::type("{values: 150 * int32, valid: 3 * uint64}"), a.get_type());
+  EXPECT_EQ(0u, a.p("valid")(2).as<uint64_t>() >> (150 - 128));
+  EXPECT_EQ(sum, reduced<int32_t>(nd::bitmap_option::sum(a)));
+  EXPECT_EQ(count, nd::bitmap_option::count(a).as<int64_t>());
+  EXPECT_EQ(1, reduced<int32_t>(nd::bitmap_option::min(a)));
+  EXPECT_EQ(149, reduced<int32_t>(nd::bitmap_option::max(a)));
+
+  nd::array b = nd::from_bitmap_option(nd::bitmap_option::add(a, a));
+  for (int32_t i = 0; i < 150; ++i) {
+    if (i % 3 == 0) {
+      EXPECT_TRUE(b(i).is_na());
+    } else {
+      EXPECT_EQ(2 * i, b(i).as<int32_t>());
+    }
+  }
+}
+
+TEST(BitmapOption, Strided) {
+  struct {
+    int32_t values[6];
+    uint64_t valid;
+  } data = {{1, 100, 2, 100, 3, 100}, 0x5};
+
+  // A bitmap option whose values are every other element of a buffer
+  ndt::type tp("{values: 3 * int32, valid: 1 * uint64}");
+  nd::array a = nd::make_array(tp, reinterpret_cast<char *>(&data), nd::readwrite_access_flags);
+  tp->arrmeta_default_construct(a->metadata(), true);
+  uintptr_t *data_offsets = reinterpret_cast<uintptr_t *>(a->metadata());
+  data_offsets[1] = offsetof(decltype(data), valid);
+  reinterpret_cast<size_stride_t *>(a->metadata() + tp.extended<ndt::struct_type>()->get_arrmeta_offset(0))->stride =
+      2 * sizeof(int32_t);
+
+  EXPECT_EQ(4, reduced<int32_t>(nd::bitmap_option::sum(a)));
+  EXPECT_EQ(2, nd::bitmap_option::count(a).as<int64_t>());
+
+  nd::array b = nd::from_bitmap_option(nd::bitmap_option::add(a, nd::to_bitmap_option(nd::array{10, 20, 30})));
+  EXPECT_EQ(11, b(0).as<int32_t>());
+  EXPECT_TRUE(b(1).is_na());
+  EXPECT_EQ(33, b(2).as<int32_t>());
+}
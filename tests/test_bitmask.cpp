@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2011-16 DyND Developers
+// BSD 2-Clause License, see LICENSE.txt
+//
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include <dynd/bitmask.hpp>
+#include <dynd/gtest.hpp>
+#include <dynd/index.hpp>
+#include <dynd/json_parser.hpp>
+
+using namespace std;
+using namespace dynd;
+
+TEST(Bitmask, Pack) {
+  nd::array a = nd::to_bitmask(nd::array{true, false, true, true, false});
+  EXPECT_EQ(ndt::type("{size: int64, bits: 1 * uint64}"), a.get_type());
+  EXPECT_EQ(5, a.p("size").as<int64_t>());
+  EXPECT_EQ(0xDu, a.p("bits")(0).as<uint64_t>());
+  EXPECT_ARRAY_EQ((nd::array{true, false, true, true, false}), nd::from_bitmask(a));
+  EXPECT_EQ(3, nd::count_nonzero(a).as<int64_t>());
+  EXPECT_EQ(3, nd::count_nonzero(nd::array{true, false, true, true, false}).as<int64_t>());
+
+  EXPECT_THROW(nd::to_bitmask(nd::array{1, 2}), type_error);
+  EXPECT_THROW(nd::from_bitmask(nd::array{true}), type_error);
+  EXPECT_THROW(nd::count_nonzero(nd::array{1, 2}), type_error);
+
+  // The size must fit the words
+  a.p("size").vals() = 100;
+  EXPECT_THROW(nd::count_nonzero(a), invalid_argument);
+}
+
+TEST(Bitmask, Compare) {
+  // 200 values span four words, the last one partly
+  intptr_t size = 200;
+  nd::array a = nd::empty(size, ndt::make_type<double>());
+  nd::array b = nd::empty(size, ndt::make_type<double>());
+  for (intptr_t i = 0; i < size; ++i) {
+    a(i).vals() = static_cast<double>(i % 10);
+    b(i).vals() = 4.5;
+  }
+
+  nd::array less = nd::bitmask::less(a, b);
+  EXPECT_EQ(ndt::type("{size: int64, bits: 4 * uint64}"), less.get_type());
+  EXPECT_EQ(100, nd::count_nonzero(less).as<int64_t>());
+  EXPECT_EQ(0u, less.p("bits")(3).as<uint64_t>() >> (200 - 192));
+  nd::array unpacked = nd::from_bitmask(less);
+  for (intptr_t i = 0; i < size; ++i) {
+    EXPECT_EQ(i % 10 < 5, unpacked(i).as<bool>());
+  }
+
+  EXPECT_EQ(100, nd::count_nonzero(nd::bitmask::greater(a, b)).as<int64_t>());
+  EXPECT_EQ(0, nd::count_nonzero(nd::bitmask::equal(a, b)).as<int64_t>());
+  EXPECT_EQ(200, nd::count_nonzero(nd::bitmask::not_equal(a, b)).as<int64_t>());
+  EXPECT_EQ(60, nd::count_nonzero(nd::bitmask::less(a(irange().by(2)), b(irange().by(2)))).as<int64_t>());
+
+  nd::array c = {1, 5, 3};
+  nd::array d = {2, 5, 1};
+  EXPECT_ARRAY_EQ((nd::array{true, true, false}), nd::from_bitmask(nd::bitmask::less_equal(c, d)));
+  EXPECT_ARRAY_EQ((nd::array{false, true, true}), nd::from_bitmask(nd::bitmask::greater_equal(c, d)));
+
+  EXPECT_THROW(nd::bitmask::less(c, nd::array{1, 2}), invalid_argument);
+  EXPECT_THROW(nd::bitmask::less(c, nd::array{1.0, 2.0, 3.0}), type_error);
+}
+
+TEST(Bitmask, Logical) {
+  nd::array a = nd::to_bitmask(nd::array{true, true, false, false, true});
+  nd::array b = nd::to_bitmask(nd::array{true, false, true, false, true});
+  EXPECT_ARRAY_EQ((nd::array{true, false, false, false, true}), nd::from_bitmask(nd::bitmask::logical_and(a, b)));
+  EXPECT_ARRAY_EQ((nd::array{true, true, true, false, true}), nd::from_bitmask(nd::bitmask::logical_or(a, b)));
+  EXPECT_ARRAY_EQ((nd::array{false, true, true, false, false}), nd::from_bitmask(nd::bitmask::logical_xor(a, b)));
+
+  // The bits after the size stay clear
+  nd::array c = nd::bitmask::logical_not(a);
+  EXPECT_EQ(0x0Cu, c.p("bits")(0).as<uint64_t>());
+  EXPECT_EQ(2, nd::count_nonzero(c).as<int64_t>());
+
+  EXPECT_THROW(nd::bitmask::logical_and(a, nd::to_bitmask(nd::array{true, false})), invalid_argument);
+}
+
+TEST(Bitmask, Take) {
+  intptr_t size = 150;
+  nd::array a = nd::empty(size, ndt::make_type<int32_t>());
+  nd::array m = nd::empty(size, ndt::make_type<bool1>());
+  for (intptr_t i = 0; i < size; ++i) {
+    a(i).vals() = static_cast<int32_t>(i);
+    // A run across the first two words, and sparse bits after it
+    m(i).vals() = (i >= 60 && i < 70) || (i > 100 && i % 7 == 0);
+  }
+
+  nd::array mask = nd::to_bitmask(m);
+  nd::array b = nd::bitmask::take(a, mask);
+  EXPECT_EQ(ndt::type("var * int32"), b.get_type());
+  EXPECT_ARRAY_EQ(nd::take(a, m), b);
+
+  nd::array c = nd::bitmask::take(nd::array{{1, 2}, {3, 4}, {5, 6}}, nd::to_bitmask(nd::array{false, true, true}));
+  EXPECT_EQ(ndt::type("var * 2 * int32"), c.get_type());
+  EXPECT_EQ(3, c(0, 0).as<int32_t>());
+  EXPECT_EQ(6, c(1, 1).as<int32_t>());
+
+  // No bits and all bits
+  EXPECT_EQ(0, nd::bitmask::take(a, nd::bitmask::logical_xor(mask, mask)).get_dim_size());
+  EXPECT_EQ(size, nd::bitmask::take(a, nd::bitmask::logical_or(mask, nd::bitmask::logical_not(mask))).get_dim_size());
+
+  EXPECT_THROW(nd::bitmask::take(nd::array{1, 2}, nd::to_bitmask(nd::array{true})), invalid_argument);
+}
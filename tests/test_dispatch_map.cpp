@@ -9,7 +9,9 @@
 #include <stdexcept>
 
 #include <dynd/dispatcher.hpp>
+#include <dynd/functional.hpp>
 #include <dynd/gtest.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/type_registry.hpp>
 #include <dynd/types/bool_kind_type.hpp>
 
@@ -129,3 +131,34 @@ TEST(Dispatcher, Ternary) {
   EXPECT_EQ(0, dispatcher(option_id, int64_id));
 }
 */
+
+namespace {
+
+vector<ndt::type> dispatch_arg0(const ndt::type &DYND_UNUSED(dst_tp), size_t DYND_UNUSED(nsrc),
+                                const ndt::type *src_tp) {
+  return {src_tp[0]};
+}
+
+} // unnamed namespace
+
+TEST(Dispatcher, Lazy) {
+  nd::callable f0 = nd::functional::apply([](int32) { return 0; });
+  nd::callable f1 = nd::functional::apply([](float64) { return 1; });
+  nd::callable f2 = nd::functional::apply([](float32) { return 2; });
+
+  // The children are sorted on first use, which may race between threads
+  dispatcher<1, nd::callable> d(dispatch_arg0, {f0, f1});
+  d.insert(f2);
+
+  ndt::type tps[3] = {ndt::make_type<int32>(), ndt::make_type<float64>(), ndt::make_type<float32>()};
+  nd::callable children[3] = {f0, f1, f2};
+  vector<int> res(64);
+  parallel_for(res.size(),
+               [&](size_t i) { res[i] = d(ndt::make_type<int>(), 1, &tps[i % 3]).get() == children[i % 3].get(); });
+  for (int found : res) {
+    EXPECT_TRUE(found != 0);
+  }
+
+  ndt::type int64_tp = ndt::make_type<int64>();
+  EXPECT_THROW(d(ndt::make_type<int>(), 1, &int64_tp), out_of_range);
+}
@@ -5,21 +5,128 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 #include <dynd/gtest.hpp>
 #include <dynd/io.hpp>
+#include <dynd/json_parser.hpp>
+#include <dynd/kernels/serialize_kernel.hpp>
 
 using namespace std;
 using namespace dynd;
 
+namespace {
+
+// The data of the value of a serialized array, which follows the header and the datashape
+std::string serialized_data(const nd::array &a) {
+  const bytes &b = *reinterpret_cast<const bytes *>(a.cdata());
+  nd::detail::serialize_header header;
+  memcpy(&header, b.data(), sizeof(header));
+  return std::string(b.data() + header.root_offset, b.size() - header.root_offset);
+}
+
+} // unnamed namespace
+
 TEST(Serialize, FixedDim) {
-  EXPECT_ARRAY_EQ(bytes("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00\x04\x00\x00\x00"),
-                  nd::serialize(nd::array{0, 1, 2, 3, 4}));
+  EXPECT_EQ(std::string("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00\x04\x00\x00\x00", 20),
+            serialized_data(nd::serialize(nd::array{0, 1, 2, 3, 4})));
 }
 
 TEST(Serialize, FixedDimFixedDim) {
-  EXPECT_ARRAY_EQ(bytes("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00"),
-                  nd::serialize(nd::array{{0, 1}, {2, 3}}));
+  EXPECT_EQ(std::string("\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03\x00\x00\x00", 16),
+            serialized_data(nd::serialize(nd::array{{0, 1}, {2, 3}})));
+}
+
+TEST(Serialize, View) {
+  // A strided view is written in the default layout
+  nd::array a = {{0, 1, 2}, {3, 4, 5}};
+  EXPECT_EQ(std::string("\x02\x00\x00\x00\x05\x00\x00\x00", 8), serialized_data(nd::serialize(a(irange(), 2))));
+}
+
+TEST(Deserialize, InPlace) {
+  nd::array a = {{0.5, 1.5, 2.5}, {3.5, 4.5, 5.5}};
+  nd::array buffer = nd::serialize(a);
+  nd::array b = nd::deserialize(buffer);
+  EXPECT_EQ(a.get_type(), b.get_type());
+  EXPECT_ARRAY_EQ(a, b);
+
+  // The values are read where they are in the buffer
+  const bytes &data = *reinterpret_cast<const bytes *>(buffer.cdata());
+  EXPECT_TRUE(b.cdata() >= data.begin() && b.cdata() < data.end());
+  EXPECT_THROW(b.data(), runtime_error);
+}
+
+TEST(Deserialize, Scalar) {
+  EXPECT_ARRAY_EQ(nd::array(dynd::complex<double>(1, -2)),
+                  nd::deserialize(nd::serialize(nd::array(dynd::complex<double>(1, -2)))));
+  EXPECT_ARRAY_EQ(nd::array("hello"), nd::deserialize(nd::serialize(nd::array("hello"))));
+  nd::array b = bytes("\x00\x01\x02", 3);
+  EXPECT_ARRAY_EQ(b, nd::deserialize(nd::serialize(b)));
+}
+
+TEST(Deserialize, VarDim) {
+  nd::array a = parse_json(ndt::type("3 * var * int32"), "[[0, 1, 2], [], [3]]");
+  nd::array buffer = nd::serialize(a);
+  nd::array b = nd::deserialize(buffer);
+  EXPECT_EQ(a.get_type(), b.get_type());
+  for (intptr_t i = 0; i < 3; ++i) {
+    EXPECT_ARRAY_EQ(a(i), b(i));
+  }
+
+  // The elements are read where they are in the buffer
+  const bytes &data = *reinterpret_cast<const bytes *>(buffer.cdata());
+  EXPECT_TRUE(b(0, 0).cdata() >= data.begin() && b(0, 0).cdata() < data.end());
+
+  a = parse_json(ndt::type("var * var * float64"), "[[0.5, 1], [2], [3, 4, 5, 6]]");
+  b = nd::deserialize(nd::serialize(a));
+  ASSERT_EQ(3, b.get_dim_size());
+  for (intptr_t i = 0; i < 3; ++i) {
+    EXPECT_ARRAY_EQ(a(i), b(i));
+  }
+}
+
+TEST(Deserialize, Struct) {
+  ndt::type tp("2 * {name: string, values: var * float64, id: ?int32}");
+  nd::array a = parse_json(tp, "[{\"name\": \"a name that does not fit inline\", \"values\": [1, 2], \"id\": 7}, "
+                               "{\"name\": \"b\", \"values\": [], \"id\": null}]");
+  nd::array b = nd::deserialize(nd::serialize(a));
+  EXPECT_EQ(tp, b.get_type());
+  EXPECT_EQ("a name that does not fit inline", b(0).p("name").as<std::string>());
+  EXPECT_EQ("b", b(1).p("name").as<std::string>());
+  EXPECT_ARRAY_EQ(a(0).p("values"), b(0).p("values"));
+  EXPECT_EQ(0, b(1).p("values").get_dim_size());
+  EXPECT_EQ(7, b(0).p("id").as<int32_t>());
+  EXPECT_TRUE(b(1).p("id").is_na());
+}
+
+TEST(Deserialize, Errors) {
+  nd::array buffer = nd::serialize(parse_json(ndt::type("3 * var * int32"), "[[0, 1, 2], [], [3]]"));
+  const bytes &data = *reinterpret_cast<const bytes *>(buffer.cdata());
+
+  // Any truncation of the buffer is caught
+  for (size_t size = 0; size < data.size(); size += 7) {
+    EXPECT_THROW(nd::deserialize(data.data(), size, buffer), invalid_argument);
+  }
+
+  std::string corrupt(data.data(), data.size());
+  corrupt[0] = 'X';
+  EXPECT_THROW(nd::deserialize(corrupt.data(), corrupt.size(), buffer), invalid_argument);
+
+  // A var dimension whose elements would be misaligned in the buffer, with the buffer itself aligned
+  vector<uint64_t> aligned((data.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  memcpy(aligned.data(), data.data(), data.size());
+  char *aligned_data = reinterpret_cast<char *>(aligned.data());
+  nd::detail::serialize_header header;
+  memcpy(&header, aligned_data, sizeof(header));
+  nd::detail::serialize_ref ref;
+  memcpy(&ref, aligned_data + header.root_offset, sizeof(ref));
+  ref.offset += 1;
+  memcpy(aligned_data + header.root_offset, &ref, sizeof(ref));
+  EXPECT_THROW(nd::deserialize(aligned_data, data.size(), buffer), invalid_argument);
+
+  EXPECT_THROW(nd::deserialize(nd::array{0, 1}), invalid_argument);
+  EXPECT_THROW(nd::serialize(nd::array(ndt::make_type<int32_t>())), type_error);
 }
@@ -6,204 +6,196 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
-#include "inc_gtest.hpp"
 
 #include <dynd/array.hpp>
+#include <dynd/array_range.hpp>
+#include <dynd/parallel.hpp>
 #include <dynd/types/categorical_type.hpp>
-#include <dynd/types/fixed_string_type.hpp>
 #include <dynd/types/string_type.hpp>
-#include <dynd/types/convert_type.hpp>
-#include <dynd/array_range.hpp>
-#include <dynd/func/comparison.hpp>
+#include <dynd/gtest.hpp>
 
 using namespace std;
 using namespace dynd;
 
-TEST(CategoricalType, Create)
-{
-  const char *a_vals[] = {"foo", "bar", "baz"};
-  nd::array a = nd::empty(3, ndt::make_type<ndt::string_type>());
-  a.vals() = a_vals;
+TEST(CategoricalType, Create) {
+  nd::array a{"foo", "bar", "baz"};
 
-  ndt::type d;
-  d = ndt::categorical_type::make(a);
+  ndt::type d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(categorical_id, d.get_id());
-  EXPECT_EQ(scalar_kind_id, d.get_base_id());
+  EXPECT_EQ(categorical_kind_id, d.get_base_id());
   EXPECT_EQ(1u, d.get_data_alignment());
   EXPECT_EQ(1u, d.get_data_size());
   EXPECT_FALSE(d.is_expression());
-  EXPECT_EQ(ndt::make_type<uint8_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(a.get_dtype(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint8_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
+  EXPECT_EQ(ndt::make_type<dynd::string>(), d.extended<ndt::categorical_type>()->get_category_type());
 
   // With <= 256 categories, storage is a uint8
-  a = nd::range(256);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(256);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(1u, d.get_data_alignment());
   EXPECT_EQ(1u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint8_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint8_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
+  EXPECT_EQ(ndt::make_type<int32_t>(), d.extended<ndt::categorical_type>()->get_category_type());
 
   // With <= 65536 categories, storage is a uint16
-  a = nd::range(257);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(257);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(2u, d.get_data_alignment());
   EXPECT_EQ(2u, d.get_data_size());
-  a = nd::range(65536);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(65536);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(2u, d.get_data_alignment());
   EXPECT_EQ(2u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint16_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint16_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
 
   // Otherwise, storage is a uint32
-  a = nd::range(65537);
-  d = ndt::categorical_type::make(a);
+  a = nd::old_range(65537);
+  d = ndt::make_type<ndt::categorical_type>(a);
   EXPECT_EQ(4u, d.get_data_alignment());
   EXPECT_EQ(4u, d.get_data_size());
-  EXPECT_EQ(ndt::make_type<uint32_t>(), d.p("storage_type").as<ndt::type>());
-  EXPECT_EQ(ndt::make_type<int32_t>(), d.p("category_type").as<ndt::type>());
+  EXPECT_EQ(ndt::make_type<uint32_t>(), d.extended<ndt::categorical_type>()->get_storage_type());
 }
 
-TEST(CategoricalType, Convert)
-{
-  const char *a_vals[] = {"foo", "bar", "baz"};
-  nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
-  a.vals() = a_vals;
+TEST(CategoricalType, Compare) {
+  nd::array a{"foo", "bar", "baz"};
+  nd::array b{"foo", "bar"};
 
-  ndt::type cd = ndt::categorical_type::make(a);
-  ndt::type sd = ndt::make_type<ndt::string_type>();
-
-  // String conversions report false, so that assignments encodings
-  // get validated on assignment
-  EXPECT_FALSE(is_lossless_assignment(sd, cd));
-  EXPECT_FALSE(is_lossless_assignment(cd, sd));
-
-  // This operation was crashing, hence the test
-  ndt::type cvt = ndt::convert_type::make(sd, cd);
-  EXPECT_EQ(cd, cvt.operand_type());
-  EXPECT_EQ(sd, cvt.value_type());
-}
-
-TEST(CategoricalType, Compare)
-{
-  const char *a_vals[] = {"foo", "bar", "baz"};
-  nd::array a = nd::empty(3, ndt::make_type<ndt::string_type>());
-  a.vals() = a_vals;
-
-  const char *b_vals[] = {"foo", "bar"};
-  nd::array b = nd::empty(2, ndt::make_type<ndt::string_type>());
-  b.vals() = b_vals;
-
-  ndt::type da = ndt::categorical_type::make(a);
-  ndt::type da2 = ndt::categorical_type::make(a);
-  ndt::type db = ndt::categorical_type::make(b);
+  ndt::type da = ndt::make_type<ndt::categorical_type>(a);
+  ndt::type da2 = ndt::make_type<ndt::categorical_type>(a);
+  ndt::type db = ndt::make_type<ndt::categorical_type>(b);
 
   EXPECT_EQ(da, da);
   EXPECT_EQ(da, da2);
   EXPECT_NE(da, db);
 
-  nd::array i = nd::empty(3, ndt::make_type<int32_t>());
-  i(0).vals() = 0;
-  i(1).vals() = 10;
-  i(2).vals() = 100;
-
-  ndt::type di = ndt::categorical_type::make(i);
+  ndt::type di = ndt::make_type<ndt::categorical_type>(nd::array{0, 10, 100});
   EXPECT_FALSE(da == di);
 }
 
-TEST(CategoricalType, Unique)
-{
-  const char *a_vals[] = {"foo", "bar", "foo"};
-  nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
-  a.vals() = a_vals;
-
-  EXPECT_THROW(ndt::categorical_type::make(a), std::runtime_error);
+TEST(CategoricalType, Unique) {
+  EXPECT_THROW(ndt::make_type<ndt::categorical_type>(nd::array{"foo", "bar", "foo"}), std::runtime_error);
+  EXPECT_THROW(ndt::make_type<ndt::categorical_type>(nd::array{0, 10, 10}), std::runtime_error);
+}
 
-  int i_vals[] = {0, 10, 10};
-  nd::array i = i_vals;
+TEST(CategoricalType, FactorString) {
+  nd::array cats{"bar", "foo", "foot"};
+  nd::array a{"foo", "bar", "foot", "foo", "bar"};
 
-  EXPECT_THROW(ndt::categorical_type::make(i), std::runtime_error);
+  ndt::type da = ndt::factor_categorical(a);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(cats), da);
 }
 
-TEST(CategoricalType, FactorFixedString)
-{
-  const char *string_cats_vals[] = {"bar", "foo"};
-  nd::array string_cats = nd::empty(2, ndt::make_type<ndt::string_type>());
-  string_cats.vals() = string_cats_vals;
-
-  const char *a_vals[] = {"foo", "bar", "foo"};
-  nd::array a = nd::empty(3, ndt::make_type<ndt::string_type>());
-  a.vals() = a_vals;
+TEST(CategoricalType, FactorStringLonger) {
+  nd::array cats{"a", "abcdefghijklmnopqrstuvwxyz", "bar", "foo", "foot", "z"};
+  nd::array a{"foo",  "bar", "foot", "foo", "bar", "abcdefghijklmnopqrstuvwxyz",
+              "foot", "foo", "z",    "a",   "abcdefghijklmnopqrstuvwxyz"};
 
   ndt::type da = ndt::factor_categorical(a);
-  EXPECT_EQ(ndt::categorical_type::make(string_cats), da);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(cats), da);
 }
 
-TEST(CategoricalType, FactorString)
-{
-  const char *cats_vals[] = {"bar", "foo", "foot"};
-  const char *a_vals[] = {"foo", "bar", "foot", "foo", "bar"};
-  nd::array cats = cats_vals, a = a_vals;
+TEST(CategoricalType, FactorInt) {
+  nd::array i{10, 10, 0};
 
-  ndt::type da = ndt::factor_categorical(a);
-  EXPECT_EQ(ndt::categorical_type::make(cats), da);
+  ndt::type di = ndt::factor_categorical(i);
+  EXPECT_EQ(ndt::make_type<ndt::categorical_type>(nd::array{0, 10}), di);
 }
 
-TEST(CategoricalType, FactorStringLonger)
-{
-  const char *cats_vals[] = {"a", "abcdefghijklmnopqrstuvwxyz", "bar", "foo", "foot", "z"};
-  const char *a_vals[] = {"foo",
-                          "bar",
-                          "foot",
-                          "foo",
-                          "bar",
-                          "abcdefghijklmnopqrstuvwxyz",
-                          "foot",
-                          "foo",
-                          "z",
-                          "a",
-                          "abcdefghijklmnopqrstuvwxyz"};
-  ndt::type da = ndt::factor_categorical(a_vals);
-  EXPECT_EQ(ndt::categorical_type::make(cats_vals), da);
+TEST(CategoricalType, FactorParallel) {
+  // Enough values that they are split into several chunks, with each
+  // category first appearing in a different one
+  intptr_t size = 1 << 20;
+  nd::array a = nd::empty(size, ndt::make_type<int32_t>());
+  int32_t *data = reinterpret_cast<int32_t *>(a.data());
+  for (intptr_t i = 0; i < size; ++i) {
+    data[i] = static_cast<int32_t>((i / 1000) % 37) * 3;
+  }
+
+  size_t nthread = get_num_threads();
+  set_num_threads(4);
+  ndt::type d = ndt::factor_categorical(a);
+  set_num_threads(nthread);
+
+  const ndt::categorical_type *cd = d.extended<ndt::categorical_type>();
+  ASSERT_EQ(37u, cd->get_category_count());
+  for (uint32_t i = 0; i < 37; ++i) {
+    EXPECT_EQ(static_cast<int32_t>(3 * i), *reinterpret_cast<const int32_t *>(cd->get_category_data_from_value(i)));
+  }
 }
 
-TEST(CategoricalType, FactorInt)
-{
-  int int_cats_vals[] = {0, 10};
-  nd::array int_cats = nd::empty(2, ndt::make_type<int32_t>());
-  int_cats.vals() = int_cats_vals;
+TEST(CategoricalType, Values) {
+  nd::array a{"foo", "bar", "baz"};
+
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(a);
+  const ndt::categorical_type *cd = dt.extended<ndt::categorical_type>();
+
+  EXPECT_EQ(0u, cd->get_value_from_category(a(0)));
+  EXPECT_EQ(1u, cd->get_value_from_category(a(1)));
+  EXPECT_EQ(2u, cd->get_value_from_category(a(2)));
+  EXPECT_EQ(0u, cd->get_value_from_category("foo"));
+  EXPECT_EQ(1u, cd->get_value_from_category("bar"));
+  EXPECT_EQ(2u, cd->get_value_from_category("baz"));
+  EXPECT_THROW(cd->get_value_from_category("aaa"), std::runtime_error);
+  EXPECT_THROW(cd->get_value_from_category("ddd"), std::runtime_error);
+  EXPECT_THROW(cd->get_value_from_category("zzz"), std::runtime_error);
+}
 
-  int i_vals[] = {10, 10, 0};
-  nd::array i = nd::empty(3, ndt::make_type<int32_t>());
-  i.vals() = i_vals;
+TEST(CategoricalType, Assign) {
+  nd::array cats{"foo", "abcdefghijklmnopqrstuvwxyz", "z", "bar", "a", "foot"};
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(cats);
 
-  ndt::type di = ndt::factor_categorical(i);
-  EXPECT_EQ(ndt::categorical_type::make(int_cats), di);
+  // More values than fit in one block, with a stride
+  intptr_t size = 3 * DYND_BUFFER_CHUNK_SIZE + 5;
+  nd::array values = nd::empty(2 * size, ndt::make_type<dynd::string>());
+  for (intptr_t i = 0; i < 2 * size; ++i) {
+    values(i).assign(cats((i * 7) % 6));
+  }
+
+  nd::array a = nd::empty(size, dt);
+  a.assign(values(irange().by(2)));
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(a.cdata());
+  for (intptr_t i = 0; i < size; ++i) {
+    EXPECT_EQ((i * 14) % 6, data[i]);
+  }
+
+  values(17).assign("bad");
+  EXPECT_THROW(a.assign(values), std::runtime_error);
+}
+
+TEST(CategoricalType, AssignFromOther) {
+  ndt::type dt = ndt::make_type<ndt::categorical_type>(nd::array{3, 6, 100, 1000});
+
+  nd::array a = nd::empty(8, dt);
+  a.assign(nd::array{int16_t(6), int16_t(3), int16_t(100), int16_t(3), int16_t(1000), int16_t(100), int16_t(6),
+                     int16_t(1000)});
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(a.cdata());
+  uint8_t expected[8] = {1, 0, 2, 0, 3, 2, 1, 3};
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(expected[i], data[i]);
+  }
 }
 
-TEST(CategoricalType, Values)
+/*
+TEST(CategoricalType, Convert)
 {
   const char *a_vals[] = {"foo", "bar", "baz"};
   nd::array a = nd::empty(3, ndt::fixed_string_type::make(3, string_encoding_ascii));
   a.vals() = a_vals;
 
-  ndt::type dt = ndt::categorical_type::make(a);
-
-  EXPECT_EQ(0u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(0)));
-  EXPECT_EQ(1u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(1)));
-  EXPECT_EQ(2u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category(a(2)));
-  EXPECT_EQ(0u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("foo"));
-  EXPECT_EQ(1u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("bar"));
-  EXPECT_EQ(2u, static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("baz"));
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("aaa"),
-               std::runtime_error);
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("ddd"),
-               std::runtime_error);
-  EXPECT_THROW(static_cast<const ndt::categorical_type *>(dt.extended())->get_value_from_category("zzz"),
-               std::runtime_error);
+  ndt::type cd = ndt::categorical_type::make(a);
+  ndt::type sd = ndt::make_type<ndt::string_type>();
+
+  // String conversions report false, so that assignments encodings
+  // get validated on assignment
+  EXPECT_FALSE(is_lossless_assignment(sd, cd));
+  EXPECT_FALSE(is_lossless_assignment(cd, sd));
+
+  // This operation was crashing, hence the test
+  ndt::type cvt = ndt::convert_type::make(sd, cd);
+  EXPECT_EQ(cd, cvt.operand_type());
+  EXPECT_EQ(sd, cvt.value_type());
 }
 
-/*
 TEST(CategoricalType, ValuesLonger)
 {
   const char *cats_vals[] = {"foo", "abcdefghijklmnopqrstuvwxyz", "z", "bar", "a", "foot"};
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <dynd/callable.hpp>
 #include <dynd/gtest.hpp>
@@ -17,6 +19,7 @@
 #include <dynd/types/struct_type.hpp>
 #include <dynd/types/typevar_constructed_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
+#include <dynd/type_registry.hpp>
 
 using namespace std;
 using namespace dynd;
@@ -766,3 +769,41 @@ TEST(DataShapeParser, TypeConstructorArgs) {
   a = parse_json(b.get_type(), "[[[1, 2, 3]], [[\"2 * int32\", \"float32\", \"3 * int8\"], [\"x\", \"yz\"]]]");
   EXPECT_EQ(to_str(a), to_str(b));
 }
+
+TEST(DataShapeParser, Cache) {
+  // A datashape parsed again is the same instance
+  ndt::type tp("10 * {x: float64, y: ?int32}");
+  EXPECT_EQ(tp.extended(), ndt::type("10 * {x: float64, y: ?int32}").extended());
+
+  // So is another spelling of it, once its canonical datashape is cached
+  EXPECT_EQ(tp.extended(), ndt::type("10*{x : float64,y : option[int32]}").extended());
+  EXPECT_EQ(tp.extended(), ndt::type(tp.str()).extended());
+  EXPECT_NE(tp.extended(), ndt::type("10 * {x: float64, y: int32}").extended());
+
+  // Errors are not cached
+  EXPECT_THROW(ndt::type("10 * {x: float64"), type_error);
+  EXPECT_THROW(ndt::type("10 * {x: float64"), type_error);
+
+  std::vector<const ndt::base_type *> parsed(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    threads.emplace_back([&parsed, i] {
+      for (int j = 0; j < 100; ++j) {
+        parsed[i] = ndt::type("var * (string, " + std::to_string(j % 10) + " * int16)").extended();
+      }
+    });
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+  for (const ndt::base_type *p : parsed) {
+    EXPECT_EQ(ndt::type("var * (string, 9 * int16)").extended(), p);
+  }
+}
+
+TEST(DataShapeParser, LookupIdByName) {
+  EXPECT_EQ(int32_id, lookup_id_by_name("int32").first);
+  EXPECT_EQ("var", lookup_id_by_name("var").second->name);
+  EXPECT_EQ(uninitialized_id, lookup_id_by_name("int33").first);
+  EXPECT_EQ(nullptr, lookup_id_by_name("int33").second);
+}
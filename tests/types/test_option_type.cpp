@@ -82,6 +82,31 @@ TEST(OptionType, OptionIntAssign) {
   EXPECT_ARRAY_EQ(nd::old_view(c, "Fixed * int32"), nd::old_view(b, "Fixed * int32"));
 }
 
+TEST(OptionType, OptionBoolAssign) {
+  nd::array a = parse_json("4 * ?bool", "[true, null, false, null]");
+
+  // The NAs are kept, which a value assignment of bool would turn into true
+  nd::array b = nd::empty("4 * ?bool");
+  b.vals() = a;
+  EXPECT_FALSE(nd::is_na(b(0)).as<bool>());
+  EXPECT_TRUE(nd::is_na(b(1)).as<bool>());
+  EXPECT_FALSE(nd::is_na(b(2)).as<bool>());
+  EXPECT_TRUE(nd::is_na(b(3)).as<bool>());
+  EXPECT_TRUE(b(0).as<bool>());
+  EXPECT_FALSE(b(2).as<bool>());
+
+  nd::array c = nd::empty("?bool");
+  c.vals() = a(1);
+  EXPECT_TRUE(nd::is_na(c).as<bool>());
+  c.vals() = a(0);
+  EXPECT_FALSE(nd::is_na(c).as<bool>());
+
+  nd::array d = nd::empty("2 * ?bool");
+  d.vals() = a(irange(1, 4).by(2));
+  EXPECT_TRUE(nd::is_na(d(0)).as<bool>());
+  EXPECT_TRUE(nd::is_na(d(1)).as<bool>());
+}
+
 TEST(OptionType, Cast) {
   nd::array a, b;
 
@@ -220,6 +220,122 @@ TEST(StructType, DifferentTypeAssign) {
   EXPECT_EQ(8, b(1, 1).as<short>());
 }
 
+TEST(StructType, StridedAssign) {
+  ndt::type tp("{a: int32, b: int32, c: float64, d: string, e: int16, f: float32}");
+  nd::array a = nd::empty(100, tp);
+  for (int i = 0; i < 100; ++i) {
+    a(i, 0).vals() = i;
+    a(i, 1).vals() = -i;
+    a(i, 2).vals() = i + 0.5;
+    a(i, 3).vals() = "value " + std::to_string(i);
+    a(i, 4).vals() = 2 * i;
+    a(i, 5).vals() = i + 0.25;
+  }
+
+  nd::array b = nd::empty(100, tp);
+  b.assign(a);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, b(i, 0).as<int>());
+    EXPECT_EQ(-i, b(i, 1).as<int>());
+    EXPECT_EQ(i + 0.5, b(i, 2).as<double>());
+    EXPECT_EQ("value " + std::to_string(i), b(i, 3).as<std::string>());
+    EXPECT_EQ(2 * i, b(i, 4).as<short>());
+    EXPECT_EQ(i + 0.25f, b(i, 5).as<float>());
+  }
+
+  // Into a strided view, with the fields in another order and of other types
+  nd::array c = nd::empty(200, ndt::type("{f: float32, e: int32, d: string, c: float64, a: int32, b: int32}"));
+  c(irange().by(2)).assign(a);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i + 0.25f, c(2 * i, 0).as<float>());
+    EXPECT_EQ(2 * i, c(2 * i, 1).as<int>());
+    EXPECT_EQ("value " + std::to_string(i), c(2 * i, 2).as<std::string>());
+    EXPECT_EQ(i + 0.5, c(2 * i, 3).as<double>());
+    EXPECT_EQ(i, c(2 * i, 4).as<int>());
+    EXPECT_EQ(-i, c(2 * i, 5).as<int>());
+  }
+}
+
+TEST(StructType, ManyFieldAssign) {
+  std::vector<std::pair<ndt::type, std::string>> fields;
+  for (int i = 0; i < 12; ++i) {
+    fields.push_back({i % 4 == 3 ? ndt::make_type<ndt::string_type>() : ndt::make_type<int64_t>(),
+                      "f" + std::to_string(i)});
+  }
+  ndt::type tp = ndt::make_type<ndt::struct_type>(fields);
+
+  nd::array a = nd::empty(10, tp);
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 12; ++j) {
+      if (j % 4 == 3) {
+        a(i, j).vals() = std::to_string(i * j);
+      } else {
+        a(i, j).vals() = i * j;
+      }
+    }
+  }
+
+  nd::array b = nd::empty(10, tp);
+  b.assign(a);
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 12; ++j) {
+      if (j % 4 == 3) {
+        EXPECT_EQ(std::to_string(i * j), b(i, j).as<std::string>());
+      } else {
+        EXPECT_EQ(i * j, b(i, j).as<int64_t>());
+      }
+    }
+  }
+}
+
+TEST(StructType, Columnar) {
+  ndt::type tp("{id: int64, x: float64, flag: int8, name: string}");
+  nd::array a = parse_json(ndt::make_fixed_dim(4, tp), "[{\"id\": 1, \"x\": 0.5, \"flag\": 1, \"name\": \"a\"}, "
+                                                       "{\"id\": 2, \"x\": 1.5, \"flag\": 0, \"name\": \"b\"}, "
+                                                       "{\"id\": 3, \"x\": 2.5, \"flag\": 1, \"name\": \"c\"}, "
+                                                       "{\"id\": 4, \"x\": 3.5, \"flag\": 0, \"name\": "
+                                                       "\"a name that is longer than fits inline\"}]");
+  EXPECT_FALSE(nd::is_columnar(a));
+
+  nd::array c = nd::to_columnar(a);
+  EXPECT_TRUE(nd::is_columnar(c));
+  EXPECT_EQ(ndt::type("{id: 4 * int64, x: 4 * float64, flag: 4 * int8, name: 4 * string}"), c.get_type());
+  for (intptr_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(a(i).p("id").as<int64_t>(), c.p("id")(i).as<int64_t>());
+    EXPECT_EQ(a(i).p("x").as<double>(), c.p("x")(i).as<double>());
+    EXPECT_EQ(a(i).p("flag").as<int8_t>(), c.p("flag")(i).as<int8_t>());
+    EXPECT_EQ(a(i).p("name").as<std::string>(), c.p("name")(i).as<std::string>());
+  }
+
+  // Each field is a contiguous column at its own size, after the one before it
+  EXPECT_EQ(1, c.p("flag")(1).cdata() - c.p("flag")(0).cdata());
+  EXPECT_EQ(8, c.p("x")(1).cdata() - c.p("x")(0).cdata());
+  EXPECT_EQ(4 * 8, c.p("x").cdata() - c.p("id").cdata());
+  EXPECT_EQ(4 * 8, c.p("flag").cdata() - c.p("x").cdata());
+
+  nd::array r = nd::to_rowwise(c);
+  EXPECT_FALSE(nd::is_columnar(r));
+  EXPECT_EQ(a.get_type(), r.get_type());
+  EXPECT_EQ("a name that is longer than fits inline", r(3).p("name").as<std::string>());
+  EXPECT_EQ(2.5, r(2).p("x").as<double>());
+
+  // A column is assigned to and read like any other array
+  nd::array d = nd::empty_columnar(4, tp);
+  d.p("x").vals() = nd::array{0.5, 7.0, 2.5, 3.5};
+  d.p("name").vals() = a.p("name");
+  EXPECT_ARRAY_EQ((nd::array{0.5, 7.0, 2.5, 3.5}), d.p("x"));
+  EXPECT_EQ("c", d.p("name")(2).as<std::string>());
+
+  // Slicing the rows of every column keeps the array columnar
+  nd::array s = c(irange(), irange(1, 3));
+  EXPECT_TRUE(nd::is_columnar(s));
+  EXPECT_EQ(2.5, nd::to_rowwise(s)(1).p("x").as<double>());
+
+  EXPECT_THROW(nd::to_columnar(nd::array{1, 2}), type_error);
+  EXPECT_THROW(nd::empty_columnar(4, ndt::make_type<int32_t>()), type_error);
+  EXPECT_THROW(nd::to_rowwise(a), type_error);
+}
+
 TEST(StructType, SingleCompare) {
   nd::array a, b;
   ndt::type sdt = ndt::make_type<ndt::struct_type>(
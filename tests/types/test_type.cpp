@@ -6,6 +6,7 @@
 #include <complex>
 #include <iostream>
 #include <stdexcept>
+#include <unordered_map>
 
 #include <dynd/array.hpp>
 #include <dynd/type.hpp>
@@ -14,6 +15,9 @@
 #include <dynd/types/bytes_type.hpp>
 #include <dynd/types/fixed_bytes_kind_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
+#include <dynd/types/option_type.hpp>
+#include <dynd/types/struct_type.hpp>
+#include <dynd/types/var_dim_type.hpp>
 #include <dynd/gtest.hpp>
 
 using namespace std;
@@ -161,6 +165,40 @@ TEST(Type, BasicConstructor) {
   EXPECT_EQ(d, ndt::type(d.str()));
 }
 
+TEST(Type, Interned) {
+  // Equal types are made once, however they are made
+  ndt::type tp = ndt::make_fixed_dim(
+      3, ndt::make_type<ndt::struct_type>({{ndt::make_type<ndt::option_type>(ndt::make_type<int32_t>()), "x"},
+                                          {ndt::make_type<ndt::var_dim_type>(ndt::make_type<double>()), "y"}}));
+  EXPECT_TRUE(tp->is_interned());
+  EXPECT_EQ(tp.extended(), ndt::type("3 * {x: ?int32, y: var * float64}").extended());
+  EXPECT_EQ(tp.get_hash(), ndt::type("3 * {x: ?int32, y: var * float64}").get_hash());
+  EXPECT_EQ(tp.extended(), ndt::make_fixed_dim(3, tp.extended<ndt::fixed_dim_type>()->get_element_type()).extended());
+
+  // Types that differ anywhere are distinct
+  EXPECT_NE(tp, ndt::type("3 * {x: ?int32, z: var * float64}"));
+  EXPECT_NE(tp, ndt::type("3 * {x: ?int32, y: var * float32}"));
+  EXPECT_NE(tp, ndt::type("4 * {x: ?int32, y: var * float64}"));
+  EXPECT_NE(ndt::type("(int32, float64)"), ndt::type("{x: int32, y: float64}"));
+
+  // The intern table holds no reference to the types in it
+  EXPECT_EQ(1, ndt::make_fixed_dim(1021, ndt::make_type<ndt::option_type>(ndt::make_type<int16_t>()))->get_use_count());
+}
+
+TEST(Type, Hash) {
+  std::unordered_map<ndt::type, int> counts;
+  for (const char *datashape : {"int32", "float64", "3 * int32", "var * int32", "?int32", "{x: int32}", "3 * int32",
+                                "{x : int32}", "option[int32]", "int32"}) {
+    ++counts[ndt::type(datashape)];
+  }
+  EXPECT_EQ(6u, counts.size());
+  EXPECT_EQ(2, counts[ndt::type("int32")]);
+  EXPECT_EQ(2, counts[ndt::type("3 * int32")]);
+  EXPECT_EQ(2, counts[ndt::type("?int32")]);
+  EXPECT_EQ(2, counts[ndt::type("{x: int32}")]);
+  EXPECT_EQ(std::hash<ndt::type>()(ndt::make_type<int32_t>()), std::hash<ndt::type>()(ndt::type("int32")));
+}
+
 TEST(TypeFor, InitializerList) {
   EXPECT_EQ(ndt::make_type<ndt::fixed_dim_type>(1, ndt::make_type<int>()), ndt::type_for({0}));
   EXPECT_EQ(ndt::make_type<ndt::fixed_dim_type>(2, ndt::make_type<int>()), ndt::type_for({10, -2}));
@@ -8,6 +8,7 @@
 #include <stdexcept>
 
 #include <dynd/array.hpp>
+#include <dynd/types/fixed_dim_kind_type.hpp>
 #include <dynd/types/fixed_dim_type.hpp>
 #include <dynd/types/type_type.hpp>
 #include <dynd/types/var_dim_type.hpp>
@@ -53,7 +54,8 @@ TEST(DTypeDType, StringCasting) {
 TEST(DTypeDType, ScalarRefCount) {
   nd::array a;
   ndt::type d, d2;
-  d = ndt::type("Fixed * 12 * int");
+  // Built directly, as a parsed type is also referenced by the datashape cache
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   a = nd::empty(ndt::make_type<ndt::type_type>());
   EXPECT_EQ(1, d.extended()->get_use_count());
@@ -77,7 +79,7 @@ TEST(DTypeDType, ScalarRefCount) {
 TEST(DTypeDType, StridedArrayRefCount) {
   nd::array a;
   ndt::type d;
-  d = ndt::type("Fixed * 12 * int");
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   // 1D Strided Array
   a = nd::empty(10, ndt::make_type<ndt::type_type>());
@@ -123,7 +125,7 @@ TEST(DTypeDType, StridedArrayRefCount) {
 TEST(DTypeDType, FixedArrayRefCount) {
   nd::array a;
   ndt::type d;
-  d = ndt::type("Fixed * 12 * int");
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   // 1D Fixed Array
   a = nd::empty(ndt::make_fixed_dim(10, ndt::make_type<ndt::type_type>()));
@@ -169,7 +171,7 @@ TEST(DTypeDType, FixedArrayRefCount) {
 TEST(DTypeDType, VarArrayRefCount) {
   nd::array a;
   ndt::type d;
-  d = ndt::type("Fixed * 12 * int");
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   // 1D Var Array
   a = nd::empty(ndt::make_type<ndt::var_dim_type>(ndt::make_type<ndt::type_type>()));
@@ -221,7 +223,7 @@ TEST(DTypeDType, VarArrayRefCount) {
 TEST(DTypeDType, CStructRefCount) {
   nd::array a;
   ndt::type d;
-  d = ndt::type("Fixed * 12 * int");
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   // Single CStruct Instance
   a = nd::empty("{dt: type, more: {a: int32, b: type}, other: string}");
@@ -270,7 +272,7 @@ TEST(DTypeDType, CStructRefCount) {
 TEST(DTypeDType, StructRefCount) {
   nd::array a;
   ndt::type d;
-  d = ndt::type("Fixed * 12 * int");
+  d = ndt::make_type<ndt::fixed_dim_kind_type>(ndt::make_fixed_dim(12, ndt::make_type<int>()));
 
   // Single CStruct Instance
   a = nd::empty("{dt: type, more: {a: int32, b: type}, other: string}")(0 <= irange() < 2);